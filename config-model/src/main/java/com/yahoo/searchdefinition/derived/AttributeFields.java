@@ -166,6 +166,9 @@ public class AttributeFields extends Derived implements AttributesConfig.Produce
         if (attribute.isHuge()) {
             aaB.huge(true);
         }
+        if (attribute.isCompressMultiValues()) {
+            aaB.compressmultivalues(true);
+        }
         if (attribute.getSorting().isDescending()) {
             aaB.sortascending(false);
         }
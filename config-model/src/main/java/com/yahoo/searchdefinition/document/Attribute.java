@@ -52,6 +52,7 @@ public final class Attribute implements Cloneable, Serializable {
     private boolean fastSearch = false;
     private boolean fastAccess = false;
     private boolean huge = false;
+    private boolean compressMultiValues = false;
     private int arity = BooleanIndexDefinition.DEFAULT_ARITY;
     private long lowerBound = BooleanIndexDefinition.DEFAULT_LOWER_BOUND;
     private long upperBound = BooleanIndexDefinition.DEFAULT_UPPER_BOUND;
@@ -174,6 +175,7 @@ public final class Attribute implements Cloneable, Serializable {
     public boolean isFastSearch()         { return fastSearch; }
     public boolean isFastAccess()         { return fastAccess; }
     public boolean isHuge()               { return huge; }
+    public boolean isCompressMultiValues() { return compressMultiValues; }
     public boolean isPosition()           { return isPosition; }
 
     public int arity() { return arity; }
@@ -197,6 +199,7 @@ public final class Attribute implements Cloneable, Serializable {
     public void setFastSearch(boolean fastSearch)                { this.fastSearch = fastSearch; }
     public void setHuge(boolean huge)                            { this.huge = huge; }
     public void setFastAccess(boolean fastAccess)                { this.fastAccess = fastAccess; }
+    public void setCompressMultiValues(boolean compress)         { this.compressMultiValues = compress; }
     public void setPosition(boolean position)                    { this.isPosition = position; }
     public void setArity(int arity)                              { this.arity = arity; }
     public void setLowerBound(long lowerBound)                   { this.lowerBound = lowerBound; }
@@ -315,7 +318,7 @@ public final class Attribute implements Cloneable, Serializable {
     public int hashCode() {
         return Objects.hash(
                 name, type, collectionType, sorting, isPrefetch(), fastAccess, removeIfZero, createIfNonExistent,
-                isPosition, huge, enableBitVectors, enableOnlyBitVector, tensorType, referenceDocumentType);
+                isPosition, huge, compressMultiValues, enableBitVectors, enableOnlyBitVector, tensorType, referenceDocumentType);
     }
 
     @Override
@@ -339,6 +342,7 @@ public final class Attribute implements Cloneable, Serializable {
         // if (this.noSearch != other.noSearch) return false; No backend consequences so compatible for now
         if (this.fastSearch != other.fastSearch) return false;
         if (this.huge != other.huge) return false;
+        if (this.compressMultiValues != other.compressMultiValues) return false;
         if ( ! this.sorting.equals(other.sorting)) return false;
         if (!this.tensorType.equals(other.tensorType)) return false;
         if (!this.referenceDocumentType.equals(other.referenceDocumentType)) return false;
@@ -16,6 +16,7 @@ public class AttributeOperation implements FieldOperation, FieldOperationContain
     private Boolean huge;
     private Boolean fastSearch;
     private Boolean fastAccess;
+    private Boolean compressMultiValues;
     private Boolean prefetch;
     private Boolean enableBitVectors;
     private Boolean enableOnlyBitVector;
@@ -69,6 +70,14 @@ public class AttributeOperation implements FieldOperation, FieldOperationContain
         this.fastAccess = fastAccess;
     }
 
+    public Boolean getCompressMultiValues() {
+        return compressMultiValues;
+    }
+
+    public void setCompressMultiValues(Boolean compressMultiValues) {
+        this.compressMultiValues = compressMultiValues;
+    }
+
     public Boolean getPrefetch() {
         return prefetch;
     }
@@ -137,6 +146,9 @@ public class AttributeOperation implements FieldOperation, FieldOperationContain
         if (fastAccess != null) {
             attribute.setFastAccess(fastAccess);
         }
+        if (compressMultiValues != null) {
+            attribute.setCompressMultiValues(compressMultiValues);
+        }
         if (prefetch != null) {
             attribute.setPrefetch(prefetch);
         }
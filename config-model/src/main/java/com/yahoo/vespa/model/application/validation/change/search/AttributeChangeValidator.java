@@ -89,6 +89,7 @@ public class AttributeChangeValidator {
                 validateAttributeSetting(currAttr, nextAttr, Attribute::isFastSearch, "fast-search", result);
                 validateAttributeSetting(currAttr, nextAttr, Attribute::isFastAccess, "fast-access", result);
                 validateAttributeSetting(currAttr, nextAttr, Attribute::isHuge, "huge", result);
+                validateAttributeSetting(currAttr, nextAttr, Attribute::isCompressMultiValues, "compress-multi-values", result);
                 validateAttributeSetting(currAttr, nextAttr, Attribute::densePostingListThreshold, "dense-posting-list-threshold", result);
             }
         }
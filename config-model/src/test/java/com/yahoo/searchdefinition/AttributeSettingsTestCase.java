@@ -88,4 +88,14 @@ public class AttributeSettingsTestCase extends SearchDefinitionTestCase {
         assertTrue(attr.isFastAccess());
     }
 
+    @Test
+    public void requireThatCompressMultiValuesCanBeSet() throws IOException, ParseException {
+        Search search = SearchBuilder.buildFromFile("src/test/examples/attributesettings.sd");
+        SDField field = (SDField) search.getDocument().getField("compressed");
+        assertTrue(field.getAttributes().size() == 1);
+        Attribute attr = field.getAttributes().get(field.getName());
+        assertTrue(attr.isCompressMultiValues());
+        assertFalse(((SDField) search.getDocument().getField("f1")).getAttributes().get("f1").isCompressMultiValues());
+    }
+
 }
@@ -5,6 +5,7 @@
 #include <vespa/eval/eval/test/eval_spec.h>
 #include <vespa/eval/eval/basic_nodes.h>
 #include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/io/fileutil.h>
 #include <cmath>
 #include <vespa/vespalib/test/insertion_operators.h>
 #include <iostream>
@@ -219,6 +220,63 @@ TEST_MT("require that multithreaded compilation works", 64) {
 
 //-----------------------------------------------------------------------------
 
+TEST("require that compiled code can be stored in and reused from disk object cache") {
+    vespalib::string dir("object_cache_dir");
+    vespalib::rmdir(dir, true);
+    vespalib::mkdir(dir);
+    LLVMWrapper::set_object_cache_dir(dir, 1024 * 1024);
+    {
+        CompiledFunction cf(Function::parse({"a", "b"}, "if(a<b,a*3,b+5)"), PassParams::ARRAY);
+        EXPECT_EQUAL(1u, vespalib::listDirectory(dir).size());
+        EXPECT_EQUAL(3.0, cf.get_function()(&std::vector<double>({1.0, 2.0})[0]));
+    }
+    {
+        CompiledFunction cf(Function::parse({"a", "b"}, "if(a<b,a*3,b+5)"), PassParams::ARRAY);
+        EXPECT_EQUAL(1u, vespalib::listDirectory(dir).size());
+        EXPECT_EQUAL(3.0, cf.get_function()(&std::vector<double>({1.0, 2.0})[0]));
+        EXPECT_EQUAL(6.0, cf.get_function()(&std::vector<double>({2.0, 1.0})[0]));
+    }
+    {
+        CompiledFunction cf(Function::parse({"a", "b"}, "if(a<b,a*3,b+5)"), PassParams::LAZY);
+        EXPECT_EQUAL(2u, vespalib::listDirectory(dir).size());
+        EXPECT_EQUAL(6.0, cf.get_lazy_function()(my_resolve, &std::vector<double>({2.0, 1.0})[0]));
+    }
+    LLVMWrapper::set_object_cache_dir("", 0);
+    {
+        CompiledFunction cf(Function::parse({"a", "b"}, "a+b"), PassParams::ARRAY);
+        EXPECT_EQUAL(2u, vespalib::listDirectory(dir).size());
+    }
+    vespalib::rmdir(dir, true);
+}
+
+size_t object_cache_size(const vespalib::string &dir) {
+    size_t size = 0;
+    for (const auto &name: vespalib::listDirectory(dir)) {
+        size += vespalib::getFileSize(dir + "/" + name);
+    }
+    return size;
+}
+
+TEST("require that disk object cache removes least recently used code when full") {
+    vespalib::string dir("object_cache_limit_dir");
+    vespalib::rmdir(dir, true);
+    vespalib::mkdir(dir);
+    LLVMWrapper::set_object_cache_dir(dir, 1024 * 1024);
+    CompiledFunction(Function::parse({"a", "b"}, "a+b"), PassParams::ARRAY);
+    size_t object_size = object_cache_size(dir);
+    EXPECT_GREATER(object_size, 0u);
+    // room for two objects of about the same size, but not three
+    size_t max_size = (object_size * 5) / 2;
+    LLVMWrapper::set_object_cache_dir(dir, max_size);
+    CompiledFunction(Function::parse({"a", "b"}, "a-b"), PassParams::ARRAY);
+    EXPECT_EQUAL(2u, vespalib::listDirectory(dir).size());
+    CompiledFunction(Function::parse({"a", "b"}, "a*b"), PassParams::ARRAY);
+    EXPECT_EQUAL(2u, vespalib::listDirectory(dir).size());
+    EXPECT_LESS_EQUAL(object_cache_size(dir), max_size);
+    LLVMWrapper::set_object_cache_dir("", 0);
+    vespalib::rmdir(dir, true);
+}
+
 TEST("require that function issues can be detected") {
     auto simple = Function::parse("a+b");
     auto complex = Function::parse("join(a,b,f(a,b)(a+b))");
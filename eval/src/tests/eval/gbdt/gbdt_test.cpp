@@ -2,6 +2,7 @@
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/eval/eval/gbdt.h>
 #include <vespa/eval/eval/vm_forest.h>
+#include <vespa/eval/eval/fast_forest.h>
 #include <vespa/eval/eval/function.h>
 #include <vespa/eval/eval/llvm/deinline_forest.h>
 #include <vespa/eval/eval/llvm/compiled_function.h>
@@ -282,6 +283,61 @@ TEST("require that models with too large sets are rejected by general vm optimiz
     EXPECT_TRUE(!Optimize::apply_chain(general_vm_chain, stats, trees).valid());
 }
 
+double eval_fast_forest(const Function &function, const std::vector<double> &params) {
+    auto trees = extract_trees(function.root());
+    ForestStats stats(trees);
+    auto result = Optimize::apply_chain(FastForest::optimize_chain, stats, trees);
+    ASSERT_TRUE(result.valid());
+    return result.eval(result.forest.get(), &params[0]);
+}
+
+TEST("require that fast forest optimizer works") {
+    Function function = Function::parse("if((a<1),1.0,if((b<1),if((c<1),2.0,3.0),4.0))+"
+                                        "if((d<1),10.0,if((e<1),if((f<1),20.0,30.0),40.0))");
+    EXPECT_EQUAL(11.0, eval_fast_forest(function, {0.5, 0.0, 0.0, 0.5, 0.0, 0.0}));
+    EXPECT_EQUAL(22.0, eval_fast_forest(function, {1.5, 0.5, 0.5, 1.5, 0.5, 0.5}));
+    EXPECT_EQUAL(33.0, eval_fast_forest(function, {1.5, 0.5, 1.5, 1.5, 0.5, 1.5}));
+    EXPECT_EQUAL(44.0, eval_fast_forest(function, {1.5, 1.5, 0.0, 1.5, 1.5, 0.0}));
+    EXPECT_EQUAL(44.0, eval_fast_forest(function, {1.0, 1.0, 1.0, 1.0, 1.0, 1.0}));
+    EXPECT_EQUAL(42.0, eval_fast_forest(function, {std::numeric_limits<double>::quiet_NaN(), 0.5, 0.5,
+                                                   std::numeric_limits<double>::quiet_NaN(), 1.5, 0.5}));
+}
+
+TEST("require that fast forest evaluates large forests like the interpreter") {
+    for (size_t tree_size: std::vector<size_t>({2, 20, 64})) {
+        Function function = Function::parse(Model().less_percent(100).make_forest(600, tree_size));
+        auto trees = extract_trees(function.root());
+        FastForest forest(trees);
+        EXPECT_EQUAL(3u, forest.num_blocks());
+        EXPECT_EQUAL(trees.size() * (tree_size - 1), forest.num_checks());
+        for (double value: {0.0, 0.25, 0.5, 0.75, 1.0}) {
+            std::vector<double> inputs(function.num_params(), value);
+            EXPECT_APPROX(eval_double(function, inputs), FastForest::eval(&forest, &inputs[0]), 1e-6);
+        }
+    }
+}
+
+TEST("require that models with in checks or too large trees are rejected by fast forest optimizer") {
+    Function function = Function::parse(Model().less_percent(100).make_forest(300, 30));
+    auto trees = extract_trees(function.root());
+    ForestStats stats(trees);
+    EXPECT_TRUE(Optimize::apply_chain(FastForest::optimize_chain, stats, trees).valid());
+    stats.total_in_checks = 1;
+    EXPECT_TRUE(!Optimize::apply_chain(FastForest::optimize_chain, stats, trees).valid());
+    stats.total_in_checks = 0;
+    stats.tree_sizes.back().size = 65;
+    EXPECT_TRUE(!Optimize::apply_chain(FastForest::optimize_chain, stats, trees).valid());
+}
+
+TEST("require that large less only forests select the fast forest optimizer") {
+    Function function = Function::parse(Model().less_percent(100).make_forest(1000, 20));
+    auto trees = extract_trees(function.root());
+    ForestStats stats(trees);
+    auto result = Optimize::select_best(stats, trees);
+    ASSERT_TRUE(result.valid());
+    EXPECT_TRUE(dynamic_cast<FastForest*>(result.forest.get()) != nullptr);
+}
+
 //-----------------------------------------------------------------------------
 
 double eval_compiled(const CompiledFunction &cfun, std::vector<double> &params) {
@@ -305,6 +361,7 @@ TEST("require that forests evaluate to approximately the same for all evaluation
                     CompiledFunction none(function, pass_params, Optimize::none);
                     CompiledFunction deinline(function, pass_params, DeinlineForest::optimize_chain);
                     CompiledFunction vm_forest(function, pass_params, VMForest::optimize_chain);
+                    CompiledFunction fast_forest(function, pass_params, FastForest::optimize_chain);
                     EXPECT_EQUAL(0u, none.get_forests().size());
                     ASSERT_EQUAL(1u, deinline.get_forests().size());
                     EXPECT_TRUE(dynamic_cast<DeinlineForest*>(deinline.get_forests()[0].get()) != nullptr);
@@ -315,6 +372,13 @@ TEST("require that forests evaluate to approximately the same for all evaluation
                     EXPECT_APPROX(expected, eval_compiled(none, inputs), 1e-6);
                     EXPECT_APPROX(expected, eval_compiled(deinline, inputs), 1e-6);
                     EXPECT_APPROX(expected, eval_compiled(vm_forest, inputs), 1e-6);
+                    if (less_percent == 100) {
+                        ASSERT_EQUAL(1u, fast_forest.get_forests().size());
+                        EXPECT_TRUE(dynamic_cast<FastForest*>(fast_forest.get_forests()[0].get()) != nullptr);
+                        EXPECT_APPROX(expected, eval_compiled(fast_forest, inputs), 1e-6);
+                    } else {
+                        EXPECT_EQUAL(0u, fast_forest.get_forests().size());
+                    }
                 }
             }
         }
@@ -5,6 +5,8 @@
 #include <vespa/eval/eval/interpreted_function.h>
 #include <vespa/eval/eval/test/eval_spec.h>
 #include <vespa/eval/eval/basic_nodes.h>
+#include <vespa/eval/tensor/default_tensor_engine.h>
+#include <vespa/eval/tensor/dense/dense_tensor.h>
 #include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/util/stash.h>
 #include <vespa/vespalib/test/insertion_operators.h>
@@ -195,6 +197,61 @@ TEST("require that matrix multiplication works with tensor function") {
     EXPECT_EQUAL(expect, engine.to_spec(*result.as_tensor()));
 }
 
+TensorSpec make_dense_spec(const vespalib::string &type, double cell_bias) {
+    TensorSpec spec(type);
+    for (size_t x = 0; x < 2; ++x) {
+        for (size_t y = 0; y < 3; ++y) {
+            spec.add({{"x", x},{"y", y}}, cell_bias + (x * 3) + y);
+        }
+    }
+    return spec;
+}
+
+TEST("require that dense tensor operations with bound types write their results into the stash") {
+    const TensorEngine &engine = vespalib::tensor::DefaultTensorEngine::ref();
+    Function function = Function::parse("sum(map(a,f(x)(x+1))+(-a*b),y)");
+    ValueType type = ValueType::from_spec("tensor(x[2],y[3])");
+    NodeTypes types(function, {type, type});
+    InterpretedFunction interpreted(engine, function, types);
+    InterpretedFunction simple(SimpleTensorEngine::ref(), function, NodeTypes());
+    InterpretedFunction::Context ctx(interpreted);
+    InterpretedFunction::Context simple_ctx(simple);
+    for (double bias: {1.0, 5.0, -2.0}) {
+        auto a = make_dense_spec(type.to_spec(), bias);
+        auto b = make_dense_spec(type.to_spec(), 2 * bias);
+        TensorValue va(engine.create(a));
+        TensorValue vb(engine.create(b));
+        TensorValue simple_va(SimpleTensorEngine::ref().create(a));
+        TensorValue simple_vb(SimpleTensorEngine::ref().create(b));
+        InterpretedFunction::SimpleObjectParams params({va,vb});
+        InterpretedFunction::SimpleObjectParams simple_params({simple_va,simple_vb});
+        const Value &result = interpreted.eval(ctx, params);
+        const Value &expect = simple.eval(simple_ctx, simple_params);
+        ASSERT_TRUE(result.is_tensor());
+        ASSERT_TRUE(expect.is_tensor());
+        EXPECT_EQUAL(SimpleTensorEngine::ref().to_spec(*expect.as_tensor()), engine.to_spec(*result.as_tensor()));
+        // a view into cells in the stash, not a tensor owning its cells
+        EXPECT_TRUE(dynamic_cast<const vespalib::tensor::DenseTensorView *>(result.as_tensor()) != nullptr);
+        EXPECT_TRUE(dynamic_cast<const vespalib::tensor::DenseTensor *>(result.as_tensor()) == nullptr);
+    }
+}
+
+TEST("require that dense tensor operations with unbound types use the generic operations") {
+    const TensorEngine &engine = vespalib::tensor::DefaultTensorEngine::ref();
+    Function function = Function::parse("sum(-a,y)");
+    NodeTypes types(function, {ValueType::from_spec("tensor(x[],y[3])")});
+    InterpretedFunction interpreted(engine, function, types);
+    InterpretedFunction::Context ctx(interpreted);
+    auto a = make_dense_spec("tensor(x[2],y[3])", 1.0);
+    TensorValue va(engine.create(a));
+    InterpretedFunction::SimpleObjectParams params({va});
+    const Value &result = interpreted.eval(ctx, params);
+    ASSERT_TRUE(result.is_tensor());
+    EXPECT_TRUE(dynamic_cast<const vespalib::tensor::DenseTensor *>(result.as_tensor()) != nullptr);
+    EXPECT_EQUAL(TensorSpec("tensor(x[2])").add({{"x", 0}}, -6.0).add({{"x", 1}}, -15.0),
+                 engine.to_spec(*result.as_tensor()));
+}
+
 //-----------------------------------------------------------------------------
 
 TEST("require that functions with non-compilable lambdas cannot be interpreted") {
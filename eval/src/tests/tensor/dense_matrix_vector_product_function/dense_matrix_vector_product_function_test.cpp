@@ -0,0 +1,146 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/log/log.h>
+LOG_SETUP("dense_matrix_vector_product_function_test");
+
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/eval/eval/tensor_function.h>
+#include <vespa/eval/eval/tensor_spec.h>
+#include <vespa/eval/eval/value.h>
+#include <vespa/eval/tensor/default_tensor_engine.h>
+#include <vespa/eval/tensor/dense/dense_matrix_vector_product_function.h>
+#include <vespa/eval/tensor/dense/dense_tensor_function_compiler.h>
+#include <vespa/vespalib/util/stash.h>
+
+using namespace vespalib;
+using namespace vespalib::eval;
+using namespace vespalib::eval::operation;
+using namespace vespalib::eval::tensor_function;
+using namespace vespalib::tensor;
+
+TensorSpec
+makeSpec(const vespalib::string &type, double cellBias)
+{
+    ValueType valueType = ValueType::from_spec(type);
+    TensorSpec spec(type);
+    const auto &dims = valueType.dimensions();
+    size_t numCells = 1;
+    for (const auto &dim : dims) {
+        numCells *= dim.size;
+    }
+    for (size_t cell = 0; cell < numCells; ++cell) {
+        TensorSpec::Address address;
+        size_t rest = cell;
+        for (size_t i = dims.size(); i-- > 0; ) {
+            address.emplace(dims[i].name, TensorSpec::Label(rest % dims[i].size));
+            rest /= dims[i].size;
+        }
+        spec.add(address, cellBias + cell * 0.5);
+    }
+    return spec;
+}
+
+class FunctionInput : public TensorFunction::Input
+{
+private:
+    std::vector<TensorValue> _values;
+public:
+    FunctionInput(const std::vector<vespalib::string> &types) : _values() {
+        _values.reserve(types.size());
+        for (size_t i = 0; i < types.size(); ++i) {
+            _values.emplace_back(DefaultTensorEngine::ref().create(makeSpec(types[i], 1.0 + i)));
+        }
+    }
+    const Value &get_tensor(size_t id) const override { return _values[id]; }
+    const UnaryOperation &get_map_operation(size_t) const override { abort(); }
+};
+
+const vespalib::string vectorX("tensor(x[3])");
+const vespalib::string vectorY("tensor(y[4])");
+const vespalib::string matrix("tensor(x[3],y[4])");
+
+Node_UP
+product(size_t vectorId, const vespalib::string &vectorType, size_t matrixId, const vespalib::string &dimension)
+{
+    return reduce(apply(Mul(),
+                        inject(ValueType::from_spec(vectorType), vectorId),
+                        inject(ValueType::from_spec(matrix), matrixId)),
+                  Add(), {dimension});
+}
+
+Node_UP
+productWithBias(size_t vectorId, const vespalib::string &vectorType, size_t matrixId,
+                const vespalib::string &dimension, size_t biasId, const vespalib::string &biasType)
+{
+    return apply(Add(),
+                 product(vectorId, vectorType, matrixId, dimension),
+                 inject(ValueType::from_spec(biasType), biasId));
+}
+
+void
+assertFusedEval(Node_UP expr, Node_UP expected, const FunctionInput &input, bool expInnermost)
+{
+    TensorFunction::UP function = DenseTensorFunctionCompiler::compile(std::move(expr));
+    auto fused = dynamic_cast<const DenseMatrixVectorProductFunction *>(function.get());
+    ASSERT_TRUE(fused != nullptr);
+    EXPECT_EQUAL(expInnermost, fused->commonDimensionInnermost());
+    Stash stash;
+    const Value &actual = function->eval(input, stash);
+    const Value &generic = expected->eval(input, stash);
+    ASSERT_TRUE(actual.is_tensor());
+    ASSERT_TRUE(generic.is_tensor());
+    EXPECT_EQUAL(generic.as_tensor()->engine().to_spec(*generic.as_tensor()),
+                 actual.as_tensor()->engine().to_spec(*actual.as_tensor()));
+}
+
+TEST("require that product with common outermost dimension is calculated")
+{
+    FunctionInput input({vectorX, matrix});
+    TEST_DO(assertFusedEval(product(0, vectorX, 1, "x"), product(0, vectorX, 1, "x"), input, false));
+}
+
+TEST("require that product with common innermost dimension is calculated")
+{
+    FunctionInput input({vectorY, matrix});
+    TEST_DO(assertFusedEval(product(0, vectorY, 1, "y"), product(0, vectorY, 1, "y"), input, true));
+}
+
+TEST("require that matrix can be the left hand side of the product")
+{
+    FunctionInput input({vectorY, matrix});
+    auto makeExpr = []() {
+        return reduce(apply(Mul(),
+                            inject(ValueType::from_spec(matrix), 1),
+                            inject(ValueType::from_spec(vectorY), 0)),
+                      Add(), {"y"});
+    };
+    TEST_DO(assertFusedEval(makeExpr(), makeExpr(), input, true));
+}
+
+TEST("require that bias is added to the product")
+{
+    FunctionInput input({vectorY, matrix, vectorX});
+    TEST_DO(assertFusedEval(productWithBias(0, vectorY, 1, "y", 2, vectorX),
+                            productWithBias(0, vectorY, 1, "y", 2, vectorX), input, true));
+    auto makeExpr = []() {
+        return apply(Add(),
+                     inject(ValueType::from_spec(vectorY), 2),
+                     product(0, vectorX, 1, "x"));
+    };
+    FunctionInput input2({vectorX, matrix, vectorY});
+    TEST_DO(assertFusedEval(makeExpr(), makeExpr(), input2, false));
+}
+
+TEST("require that wrong sized input falls back to the generic calculation")
+{
+    FunctionInput actual({"tensor(x[2])", "tensor(x[2],y[4])"});
+    TensorFunction::UP function = DenseTensorFunctionCompiler::compile(product(0, vectorX, 1, "x"));
+    ASSERT_TRUE(dynamic_cast<const DenseMatrixVectorProductFunction *>(function.get()) != nullptr);
+    Stash stash;
+    const Value &result = function->eval(actual, stash);
+    const Value &generic = product(0, vectorX, 1, "x")->eval(actual, stash);
+    EXPECT_EQUAL(generic.as_tensor()->engine().to_spec(*generic.as_tensor()),
+                 result.as_tensor()->engine().to_spec(*result.as_tensor()));
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
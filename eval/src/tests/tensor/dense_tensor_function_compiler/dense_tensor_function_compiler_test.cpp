@@ -2,6 +2,10 @@
 
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/eval/tensor/dense/dense_dot_product_function.h>
+#include <vespa/eval/tensor/dense/dense_join_function.h>
+#include <vespa/eval/tensor/dense/dense_map_function.h>
+#include <vespa/eval/tensor/dense/dense_matrix_vector_product_function.h>
+#include <vespa/eval/tensor/dense/dense_reduce_function.h>
 #include <vespa/eval/tensor/dense/dense_tensor_function_compiler.h>
 
 using namespace vespalib::eval;
@@ -53,13 +57,123 @@ TEST("require that dot product with compatible dimensions is compiled")
     TEST_DO(assertCompiledDotProduct("tensor(x[])",  "tensor(x[])"));
 }
 
+TEST("require that dot product with equal multi-dimensional types is compiled")
+{
+    TEST_DO(assertCompiledDotProduct("tensor(x[5],y[7])", "tensor(x[5],y[7])"));
+    TEST_DO(assertCompiledDotProduct("tensor(x[2],y[3],z[4])", "tensor(x[2],y[3],z[4])"));
+}
+
 TEST("require that dot product with incompatible dimensions is NOT compiled")
 {
     TEST_DO(assertNotCompiledDotProduct("tensor(x[5])",      "tensor(y[5])"));
     TEST_DO(assertNotCompiledDotProduct("tensor(y[5])",      "tensor(x[5])"));
     TEST_DO(assertNotCompiledDotProduct("tensor(y[])",       "tensor(x[])"));
     TEST_DO(assertNotCompiledDotProduct("tensor(x[5])",      "tensor(x[5],y[7])"));
-    TEST_DO(assertNotCompiledDotProduct("tensor(x[5],y[7])", "tensor(x[5],y[7])"));
+    TEST_DO(assertNotCompiledDotProduct("tensor(x[5],y[7])", "tensor(x[5],y[8])"));
+    TEST_DO(assertNotCompiledDotProduct("tensor(x[5],y[])",  "tensor(x[5],y[])"));
+}
+
+TensorFunction::UP
+compileMatrixVectorProduct(const vespalib::string &vectorType,
+                           const vespalib::string &matrixType,
+                           const vespalib::string &dimension)
+{
+    Node_UP reduceNode = reduce(apply(Mul(),
+                                      inject(ValueType::from_spec(vectorType), 1),
+                                      inject(ValueType::from_spec(matrixType), 3)),
+                                Add(), {dimension});
+    return DenseTensorFunctionCompiler::compile(std::move(reduceNode));
+}
+
+void
+assertCompiledMatrixVectorProduct(const vespalib::string &vectorType,
+                                  const vespalib::string &matrixType,
+                                  const vespalib::string &dimension,
+                                  bool expInnermost)
+{
+    TensorFunction::UP func = compileMatrixVectorProduct(vectorType, matrixType, dimension);
+    const DenseMatrixVectorProductFunction *product = as<DenseMatrixVectorProductFunction>(*func);
+    ASSERT_TRUE(product);
+    EXPECT_EQUAL(1u, product->vectorTensorId());
+    EXPECT_EQUAL(3u, product->matrixTensorId());
+    EXPECT_EQUAL(DenseMatrixVectorProductFunction::NO_BIAS, product->biasTensorId());
+    EXPECT_EQUAL(expInnermost, product->commonDimensionInnermost());
+}
+
+void
+assertNotCompiledMatrixVectorProduct(const vespalib::string &vectorType,
+                                     const vespalib::string &matrixType,
+                                     const vespalib::string &dimension)
+{
+    TensorFunction::UP func = compileMatrixVectorProduct(vectorType, matrixType, dimension);
+    EXPECT_TRUE(as<Reduce>(*func));
+}
+
+TEST("require that matrix vector product with bound dimensions is compiled")
+{
+    TEST_DO(assertCompiledMatrixVectorProduct("tensor(x[256])", "tensor(x[256],y[128])", "x", false));
+    TEST_DO(assertCompiledMatrixVectorProduct("tensor(y[128])", "tensor(x[256],y[128])", "y", true));
+}
+
+TEST("require that matrix vector product with incompatible dimensions is NOT compiled")
+{
+    TEST_DO(assertNotCompiledMatrixVectorProduct("tensor(x[255])", "tensor(x[256],y[128])", "x"));
+    TEST_DO(assertNotCompiledMatrixVectorProduct("tensor(x[256])", "tensor(x[256],y[128])", "y"));
+    TEST_DO(assertNotCompiledMatrixVectorProduct("tensor(z[256])", "tensor(x[256],y[128])", "z"));
+    TEST_DO(assertNotCompiledMatrixVectorProduct("tensor(x[])", "tensor(x[],y[128])", "x"));
+}
+
+TEST("require that matrix vector product with bias is compiled")
+{
+    Node_UP expr = apply(Add(),
+                         inject(ValueType::from_spec("tensor(y[128])"), 5),
+                         reduce(apply(Mul(),
+                                      inject(ValueType::from_spec("tensor(x[256])"), 1),
+                                      inject(ValueType::from_spec("tensor(x[256],y[128])"), 3)),
+                                Add(), {"x"}));
+    TensorFunction::UP func = DenseTensorFunctionCompiler::compile(std::move(expr));
+    const DenseMatrixVectorProductFunction *product = as<DenseMatrixVectorProductFunction>(*func);
+    ASSERT_TRUE(product);
+    EXPECT_EQUAL(5u, product->biasTensorId());
+}
+
+TEST("require that single operations on bound dense tensors are compiled")
+{
+    ValueType type = ValueType::from_spec("tensor(x[2],y[3],z[4])");
+    TensorFunction::UP mapFunc = DenseTensorFunctionCompiler::compile(map(2, inject(type, 1)));
+    const DenseMapFunction *denseMap = as<DenseMapFunction>(*mapFunc);
+    ASSERT_TRUE(denseMap);
+    EXPECT_EQUAL(1u, denseMap->tensorId());
+    EXPECT_EQUAL(2u, denseMap->mapOperationId());
+
+    TensorFunction::UP joinFunc = DenseTensorFunctionCompiler::compile(apply(Sub(), inject(type, 1), inject(type, 3)));
+    const DenseJoinFunction *denseJoin = as<DenseJoinFunction>(*joinFunc);
+    ASSERT_TRUE(denseJoin);
+    EXPECT_EQUAL(1u, denseJoin->lhsTensorId());
+    EXPECT_EQUAL(3u, denseJoin->rhsTensorId());
+
+    TensorFunction::UP reduceFunc = DenseTensorFunctionCompiler::compile(reduce(inject(type, 1), Max(), {"z", "x"}));
+    const DenseReduceFunction *denseReduce = as<DenseReduceFunction>(*reduceFunc);
+    ASSERT_TRUE(denseReduce);
+    EXPECT_EQUAL(ValueType::from_spec("tensor(y[3])"), denseReduce->resultType());
+    ASSERT_EQUAL(2u, denseReduce->steps().size());
+    EXPECT_EQUAL(6u, denseReduce->steps()[0].outerSize);
+    EXPECT_EQUAL(4u, denseReduce->steps()[0].reduceSize);
+    EXPECT_EQUAL(1u, denseReduce->steps()[0].innerSize);
+    EXPECT_EQUAL(1u, denseReduce->steps()[1].outerSize);
+    EXPECT_EQUAL(2u, denseReduce->steps()[1].reduceSize);
+    EXPECT_EQUAL(3u, denseReduce->steps()[1].innerSize);
+}
+
+TEST("require that single operations on unbound or different dense tensors are NOT compiled")
+{
+    ValueType bound = ValueType::from_spec("tensor(x[2],y[3])");
+    ValueType unbound = ValueType::from_spec("tensor(x[],y[3])");
+    ValueType other = ValueType::from_spec("tensor(x[2],z[3])");
+    EXPECT_TRUE(as<Map>(*DenseTensorFunctionCompiler::compile(map(0, inject(unbound, 1)))));
+    EXPECT_TRUE(as<Apply>(*DenseTensorFunctionCompiler::compile(apply(Add(), inject(bound, 1), inject(other, 3)))));
+    EXPECT_TRUE(as<Apply>(*DenseTensorFunctionCompiler::compile(apply(Add(), inject(unbound, 1), inject(unbound, 3)))));
+    EXPECT_TRUE(as<Reduce>(*DenseTensorFunctionCompiler::compile(reduce(inject(unbound, 1), Add(), {"y"}))));
 }
 
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -0,0 +1,146 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "fast_forest.h"
+#include <vespa/eval/eval/basic_nodes.h>
+#include <vespa/eval/eval/call_nodes.h>
+#include <vespa/eval/eval/operator_nodes.h>
+#include <algorithm>
+#include <cassert>
+
+namespace vespalib {
+namespace eval {
+namespace gbdt {
+
+namespace {
+
+//-----------------------------------------------------------------------------
+
+struct Check {
+    uint32_t feature;
+    double   threshold;
+    uint16_t tree_id;
+    uint64_t mask;
+    Check(uint32_t feature_in, double threshold_in, uint16_t tree_id_in, uint64_t mask_in)
+        : feature(feature_in), threshold(threshold_in), tree_id(tree_id_in), mask(mask_in) {}
+    bool operator<(const Check &rhs) const {
+        if (feature != rhs.feature) {
+            return (feature < rhs.feature);
+        }
+        return (threshold < rhs.threshold);
+    }
+};
+
+uint64_t leaf_range_mask(size_t first_leaf, size_t num_leafs) {
+    uint64_t range = (num_leafs < 64) ? ((uint64_t(1) << num_leafs) - 1) : ~uint64_t(0);
+    return ~(range << first_leaf);
+}
+
+// returns the number of leafs in the sub-tree
+size_t encode_node(const nodes::Node &node_in, uint16_t tree_id, size_t first_leaf,
+                   std::vector<Check> &checks, std::vector<double> &leafs)
+{
+    auto if_node = nodes::as<nodes::If>(node_in);
+    if (if_node) {
+        auto less = nodes::as<nodes::Less>(if_node->cond());
+        assert(less);
+        auto symbol = nodes::as<nodes::Symbol>(less->lhs());
+        assert(symbol && (symbol->id() >= 0));
+        assert(less->rhs().is_const());
+        size_t left_leafs = encode_node(if_node->true_expr(), tree_id, first_leaf, checks, leafs);
+        // when the check is false, none of the leafs to the left can be reached
+        checks.emplace_back(symbol->id(), less->rhs().get_const_value(), tree_id,
+                            leaf_range_mask(first_leaf, left_leafs));
+        size_t right_leafs = encode_node(if_node->false_expr(), tree_id, first_leaf + left_leafs, checks, leafs);
+        return (left_leafs + right_leafs);
+    } else {
+        assert(node_in.is_const());
+        leafs.push_back(node_in.get_const_value());
+        return 1;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace vespalib::eval::gbdt::<unnamed>
+
+FastForest::FastForest(const std::vector<const nodes::Node *> &trees)
+    : _blocks(),
+      _features(),
+      _thresholds(),
+      _tree_ids(),
+      _masks(),
+      _leaf_offsets(),
+      _leafs()
+{
+    for (size_t first_tree = 0; first_tree < trees.size(); first_tree += BLOCK_SIZE) {
+        size_t num_trees = std::min(BLOCK_SIZE, trees.size() - first_tree);
+        std::vector<Check> checks;
+        for (size_t i = 0; i < num_trees; ++i) {
+            _leaf_offsets.push_back(_leafs.size());
+            size_t num_leafs = encode_node(*trees[first_tree + i], i, 0, checks, _leafs);
+            assert(num_leafs <= MAX_LEAFS);
+            (void) num_leafs;
+        }
+        std::sort(checks.begin(), checks.end());
+        size_t first_feature = _features.size();
+        for (const Check &check: checks) {
+            if ((_features.size() == first_feature) || (_features.back().feature != check.feature)) {
+                _features.push_back(FeatureChecks{check.feature, uint32_t(_thresholds.size()), uint32_t(_thresholds.size())});
+            }
+            _thresholds.push_back(check.threshold);
+            _tree_ids.push_back(check.tree_id);
+            _masks.push_back(check.mask);
+            ++_features.back().end;
+        }
+        _blocks.push_back(Block{uint32_t(first_tree), uint32_t(num_trees),
+                                uint32_t(first_feature), uint32_t(_features.size() - first_feature)});
+    }
+}
+
+FastForest::~FastForest() = default;
+
+Optimize::Result
+FastForest::optimize(const ForestStats &stats,
+                     const std::vector<const nodes::Node *> &trees)
+{
+    if ((stats.total_in_checks > 0) || (stats.tree_sizes.back().size > MAX_LEAFS)) {
+        return Optimize::Result();
+    }
+    return Optimize::Result(Forest::UP(new FastForest(trees)), eval);
+}
+
+double
+FastForest::eval(const Forest *forest, const double *input)
+{
+    const FastForest &self = *((const FastForest *)forest);
+    const double *thresholds = self._thresholds.data();
+    const uint16_t *tree_ids = self._tree_ids.data();
+    const uint64_t *masks = self._masks.data();
+    uint64_t state[BLOCK_SIZE];
+    double sum = 0.0;
+    for (const Block &block: self._blocks) {
+        std::fill(state, state + block.num_trees, ~uint64_t(0));
+        const FeatureChecks *feature = &self._features[block.first_feature];
+        const FeatureChecks *end = feature + block.num_features;
+        for (; feature < end; ++feature) {
+            double value = input[feature->feature];
+            // NaN makes all checks false, like when walking the tree
+            for (uint32_t i = feature->begin; (i < feature->end) && !(value < thresholds[i]); ++i) {
+                state[tree_ids[i]] &= masks[i];
+            }
+        }
+        const uint32_t *leaf_offset = &self._leaf_offsets[block.first_tree];
+        for (uint32_t i = 0; i < block.num_trees; ++i) {
+            sum += self._leafs[leaf_offset[i] + __builtin_ctzll(state[i])];
+        }
+    }
+    return sum;
+}
+
+Optimize::Chain FastForest::optimize_chain({optimize});
+
+//-----------------------------------------------------------------------------
+
+} // namespace vespalib::eval::gbdt
+} // namespace vespalib::eval
+} // namespace vespalib
@@ -0,0 +1,64 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "gbdt.h"
+#include <cstdint>
+
+namespace vespalib {
+namespace eval {
+namespace gbdt {
+
+/**
+ * GBDT forest optimizer for forests with only less checks, using a
+ * bitvector representation of each tree (QuickScorer). The leaves of
+ * a tree are numbered from left to right, and each check holds a
+ * mask removing the leaves that can not be reached when the check is
+ * false. The checks are grouped by feature and sorted on threshold,
+ * so all false checks for a feature are found with a single scan
+ * that stops at the first check that is true. The exit leaf of each
+ * tree is the leftmost leaf that was not masked away. Trees are
+ * evaluated in blocks to keep the state small enough for the stack.
+ * Trees may not have more than 64 leaves.
+ **/
+class FastForest : public Forest
+{
+public:
+    static constexpr size_t MAX_LEAFS = 64;
+    static constexpr size_t BLOCK_SIZE = 256;
+
+    struct FeatureChecks {
+        uint32_t feature;
+        uint32_t begin;
+        uint32_t end;
+    };
+    struct Block {
+        uint32_t first_tree;
+        uint32_t num_trees;
+        uint32_t first_feature;
+        uint32_t num_features;
+    };
+
+private:
+    std::vector<Block>         _blocks;
+    std::vector<FeatureChecks> _features;
+    std::vector<double>        _thresholds;
+    std::vector<uint16_t>      _tree_ids; // within block
+    std::vector<uint64_t>      _masks;
+    std::vector<uint32_t>      _leaf_offsets;
+    std::vector<double>        _leafs;
+
+public:
+    explicit FastForest(const std::vector<const nodes::Node *> &trees);
+    ~FastForest();
+    size_t num_blocks() const { return _blocks.size(); }
+    size_t num_checks() const { return _thresholds.size(); }
+    static Optimize::Result optimize(const ForestStats &stats,
+                                     const std::vector<const nodes::Node *> &trees);
+    static double eval(const Forest *forest, const double *input);
+    static Optimize::Chain optimize_chain;
+};
+
+} // namespace vespalib::eval::gbdt
+} // namespace vespalib::eval
+} // namespace vespalib
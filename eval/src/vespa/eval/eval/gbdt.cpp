@@ -1,6 +1,7 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "gbdt.h"
+#include "fast_forest.h"
 #include "vm_forest.h"
 #include "node_traverser.h"
 #include <vespa/eval/eval/basic_nodes.h>
@@ -142,8 +143,14 @@ Optimize::select_best(const ForestStats &stats,
                       const std::vector<const nodes::Node *> &trees)
 {
     double path_len = stats.total_average_path_length;
-    if ((stats.tree_sizes.back().size > 12) && (path_len > 2500.0)) {
-        return apply_chain(VMForest::optimize_chain, stats, trees);
+    if (path_len > 2500.0) {
+        Result result = apply_chain(FastForest::optimize_chain, stats, trees);
+        if (result.valid()) {
+            return result;
+        }
+        if (stats.tree_sizes.back().size > 12) {
+            return apply_chain(VMForest::optimize_chain, stats, trees);
+        }
     }
     return Optimize::Result();
 }
@@ -188,6 +188,47 @@ void op_tensor_function_arg_arg(State &state, uint64_t param) {
     state.stack.push_back(meta.function->eval(input, state.stash));
 }
 
+/**
+ * A map operation calling the compiled lambda of a tensor map.
+ **/
+class CompiledMapOperation : public CustomUnaryOperation
+{
+private:
+    double (*_function)(double);
+public:
+    CompiledMapOperation(double (*function)(double)) : _function(function) {}
+    double eval(double a) const override { return _function(a); }
+};
+
+struct TensorFunctionStackMeta {
+    TensorFunction::UP function;
+    size_t num_tensors;
+    std::unique_ptr<UnaryOperation> map_operation;
+    TensorFunctionStackMeta(TensorFunction::UP function_in, size_t num_tensors_in,
+                            std::unique_ptr<UnaryOperation> map_operation_in)
+        : function(std::move(function_in)), num_tensors(num_tensors_in), map_operation(std::move(map_operation_in)) {}
+};
+
+// input tensors are the topmost values on the stack, first one deepest
+struct StackInput : TensorFunction::Input {
+    const TensorFunctionStackMeta &meta;
+    State &state;
+    StackInput(const TensorFunctionStackMeta &meta_in, State &state_in)
+        : meta(meta_in), state(state_in) {}
+    const Value &get_tensor(size_t id) const override {
+        return state.peek(meta.num_tensors - 1 - id);
+    }
+    const UnaryOperation &get_map_operation(size_t) const override {
+        return *meta.map_operation;
+    }
+};
+
+void op_tensor_function_stack(State &state, uint64_t param) {
+    const TensorFunctionStackMeta &meta = unwrap_param<TensorFunctionStackMeta>(param);
+    StackInput input(meta, state);
+    state.replace(meta.num_tensors, meta.function->eval(input, state.stash));
+}
+
 //-----------------------------------------------------------------------------
 
 bool step_labels(std::vector<double> &labels, const ValueType &type) {
@@ -202,6 +243,21 @@ bool step_labels(std::vector<double> &labels, const ValueType &type) {
     return false;
 }
 
+// binary operation for aggregators that can be calculated pairwise
+const BinaryOperation *reduce_operation(Aggr aggr) {
+    static const operation::Add add;
+    static const operation::Mul mul;
+    static const operation::Max max;
+    static const operation::Min min;
+    switch (aggr) {
+    case Aggr::SUM:  return &add;
+    case Aggr::PROD: return &mul;
+    case Aggr::MAX:  return &max;
+    case Aggr::MIN:  return &min;
+    default:         return nullptr;
+    }
+}
+
 //-----------------------------------------------------------------------------
 
 struct ProgramBuilder : public NodeVisitor, public NodeTraverser {
@@ -209,9 +265,10 @@ struct ProgramBuilder : public NodeVisitor, public NodeTraverser {
     Stash                    &stash;
     const TensorEngine       &tensor_engine;
     const NodeTypes          &types;
+    size_t                    eval_stash_size;
 
     ProgramBuilder(std::vector<Instruction> &program_in, Stash &stash_in, const TensorEngine &tensor_engine_in, const NodeTypes &types_in)
-        : program(program_in), stash(stash_in), tensor_engine(tensor_engine_in), types(types_in) {}
+        : program(program_in), stash(stash_in), tensor_engine(tensor_engine_in), types(types_in), eval_stash_size(0) {}
 
     //-------------------------------------------------------------------------
 
@@ -236,6 +293,76 @@ struct ProgramBuilder : public NodeVisitor, public NodeTraverser {
                 is_typed_tensor_param(mul->rhs()));
     }
 
+    bool is_bound_dense_tensor(const Node &node) const {
+        const ValueType &type = types.get_type(node);
+        return (type.is_dense() && !type.is_abstract());
+    }
+
+    static size_t num_cells(const ValueType &type) {
+        size_t cells = 1;
+        for (const auto &dimension: type.dimensions()) {
+            cells *= dimension.size;
+        }
+        return cells;
+    }
+
+    //-------------------------------------------------------------------------
+
+    // Replace a tensor operation on the topmost stack values with a
+    // tensor function if the engine is able to compile it into
+    // something better than the generic operation. The result cells
+    // typically live in the evaluation stash, so we keep track of how
+    // much memory a single evaluation needs.
+    bool make_tensor_function(tensor_function::Node_UP ir, size_t num_tensors,
+                              std::unique_ptr<UnaryOperation> map_operation = std::unique_ptr<UnaryOperation>())
+    {
+        size_t cells = num_cells(ir->result_type);
+        auto fun = tensor_engine.compile(std::move(ir));
+        if (dynamic_cast<const tensor_function::Node *>(fun.get()) != nullptr) {
+            return false;
+        }
+        eval_stash_size += (cells * num_tensors + cells) * sizeof(double) + 128;
+        const auto &meta = stash.create<TensorFunctionStackMeta>(std::move(fun), num_tensors, std::move(map_operation));
+        program.emplace_back(op_tensor_function_stack, wrap_param<TensorFunctionStackMeta>(meta));
+        return true;
+    }
+
+    template <typename OP1>
+    void make_unary(const Node &node) {
+        const Node &child = node.get_child(0);
+        if (is_bound_dense_tensor(node) && is_bound_dense_tensor(child)) {
+            auto ir = tensor_function::map(0, tensor_function::inject(types.get_type(child), 0));
+            if (make_tensor_function(std::move(ir), 1, std::make_unique<OP1>())) {
+                return;
+            }
+        }
+        program.emplace_back(op_unary<OP1>);
+    }
+
+    template <typename OP2>
+    void make_binary(const Node &node) {
+        const Node &lhs = node.get_child(0);
+        const Node &rhs = node.get_child(1);
+        if (is_bound_dense_tensor(node) && is_bound_dense_tensor(lhs) && is_bound_dense_tensor(rhs)) {
+            auto ir = tensor_function::apply(OP2(),
+                                             tensor_function::inject(types.get_type(lhs), 0),
+                                             tensor_function::inject(types.get_type(rhs), 1));
+            if (make_tensor_function(std::move(ir), 2)) {
+                return;
+            }
+        }
+        program.emplace_back(op_binary<OP2>);
+    }
+
+    bool make_reduce(const Node &node, const BinaryOperation &op, const std::vector<vespalib::string> &dimensions) {
+        const Node &child = node.get_child(0);
+        if (is_typed(node) && is_bound_dense_tensor(child)) {
+            auto ir = tensor_function::reduce(tensor_function::inject(types.get_type(child), 0), op, dimensions);
+            return make_tensor_function(std::move(ir), 1);
+        }
+        return false;
+    }
+
     //-------------------------------------------------------------------------
 
     void visit(const Number&node) override {
@@ -255,11 +382,11 @@ struct ProgramBuilder : public NodeVisitor, public NodeTraverser {
     void visit(const Array&node) override {
         program.emplace_back(op_load_const, wrap_param<Value>(stash.create<DoubleValue>(node.size())));
     }
-    void visit(const Neg &) override {
-        program.emplace_back(op_unary<operation::Neg>);
+    void visit(const Neg &node) override {
+        make_unary<operation::Neg>(node);
     }
-    void visit(const Not &) override {
-        program.emplace_back(op_unary<operation::Not>);
+    void visit(const Not &node) override {
+        make_unary<operation::Not>(node);
     }
     void visit(const If&node) override {
         node.cond().traverse(*this);
@@ -301,20 +428,33 @@ struct ProgramBuilder : public NodeVisitor, public NodeTraverser {
             program.emplace_back(op_tensor_function_arg_arg, wrap_param<TensorFunctionArgArgMeta>(meta));
         } else if (node.dimension().empty()) {
             program.emplace_back(op_tensor_sum);
-        } else {
+        } else if (!make_reduce(node, operation::Add(), {node.dimension()})) {
             program.emplace_back(op_tensor_sum_dimension,
                                  wrap_param<vespalib::string>(stash.create<vespalib::string>(node.dimension())));
         }
     }
     void visit(const TensorMap&node) override {
         const auto &token = stash.create<CompileCache::Token::UP>(CompileCache::compile(node.lambda(), PassParams::SEPARATE));
-        program.emplace_back(op_tensor_map, wrap_param<CompiledFunction>(token.get()->get()));
+        const CompiledFunction &cfun = token.get()->get();
+        const Node &child = node.get_child(0);
+        if (is_bound_dense_tensor(node) && is_bound_dense_tensor(child)) {
+            auto ir = tensor_function::map(0, tensor_function::inject(types.get_type(child), 0));
+            if (make_tensor_function(std::move(ir), 1, std::make_unique<CompiledMapOperation>(cfun.get_function<1>()))) {
+                return;
+            }
+        }
+        program.emplace_back(op_tensor_map, wrap_param<CompiledFunction>(cfun));
     }
     void visit(const TensorJoin&node) override {
         const auto &token = stash.create<CompileCache::Token::UP>(CompileCache::compile(node.lambda(), PassParams::SEPARATE));
         program.emplace_back(op_tensor_join, wrap_param<CompiledFunction>(token.get()->get()));
     }
     void visit(const TensorReduce&node) override {
+        if (const BinaryOperation *op = reduce_operation(node.aggr())) {
+            if (make_reduce(node, *op, node.dimensions())) {
+                return;
+            }
+        }
         ReduceParams &params = stash.create<ReduceParams>(node.aggr(), node.dimensions());
         program.emplace_back(op_tensor_reduce, wrap_param<ReduceParams>(params));
     }
@@ -343,44 +483,44 @@ struct ProgramBuilder : public NodeVisitor, public NodeTraverser {
         vespalib::string &dimension = stash.create<vespalib::string>(node.dimension());
         program.emplace_back(op_tensor_concat, wrap_param<vespalib::string>(dimension));
     }
-    void visit(const Add &) override {
-        program.emplace_back(op_binary<operation::Add>);
+    void visit(const Add &node) override {
+        make_binary<operation::Add>(node);
     }
-    void visit(const Sub &) override {
-        program.emplace_back(op_binary<operation::Sub>);
+    void visit(const Sub &node) override {
+        make_binary<operation::Sub>(node);
     }
-    void visit(const Mul &) override {
-        program.emplace_back(op_binary<operation::Mul>);
+    void visit(const Mul &node) override {
+        make_binary<operation::Mul>(node);
     }
-    void visit(const Div &) override {
-        program.emplace_back(op_binary<operation::Div>);
+    void visit(const Div &node) override {
+        make_binary<operation::Div>(node);
     }
-    void visit(const Mod &) override {
-        program.emplace_back(op_binary<operation::Mod>);
+    void visit(const Mod &node) override {
+        make_binary<operation::Mod>(node);
     }
-    void visit(const Pow &) override {
-        program.emplace_back(op_binary<operation::Pow>);
+    void visit(const Pow &node) override {
+        make_binary<operation::Pow>(node);
     }
-    void visit(const Equal &) override {
-        program.emplace_back(op_binary<operation::Equal>);
+    void visit(const Equal &node) override {
+        make_binary<operation::Equal>(node);
     }
-    void visit(const NotEqual &) override {
-        program.emplace_back(op_binary<operation::NotEqual>);
+    void visit(const NotEqual &node) override {
+        make_binary<operation::NotEqual>(node);
     }
-    void visit(const Approx &) override {
-        program.emplace_back(op_binary<operation::Approx>);
+    void visit(const Approx &node) override {
+        make_binary<operation::Approx>(node);
     }
-    void visit(const Less &) override {
-        program.emplace_back(op_binary<operation::Less>);
+    void visit(const Less &node) override {
+        make_binary<operation::Less>(node);
     }
-    void visit(const LessEqual &) override {
-        program.emplace_back(op_binary<operation::LessEqual>);
+    void visit(const LessEqual &node) override {
+        make_binary<operation::LessEqual>(node);
     }
-    void visit(const Greater &) override {
-        program.emplace_back(op_binary<operation::Greater>);
+    void visit(const Greater &node) override {
+        make_binary<operation::Greater>(node);
     }
-    void visit(const GreaterEqual &) override {
-        program.emplace_back(op_binary<operation::GreaterEqual>);
+    void visit(const GreaterEqual &node) override {
+        make_binary<operation::GreaterEqual>(node);
     }
     void visit(const In&node) override {
         std::vector<size_t> checks;
@@ -402,86 +542,86 @@ struct ProgramBuilder : public NodeVisitor, public NodeTraverser {
         }
         program.emplace_back(op_not_member);
     }
-    void visit(const And &) override {
-        program.emplace_back(op_binary<operation::And>);
+    void visit(const And &node) override {
+        make_binary<operation::And>(node);
     }
-    void visit(const Or &) override {
-        program.emplace_back(op_binary<operation::Or>);
+    void visit(const Or &node) override {
+        make_binary<operation::Or>(node);
     }
-    void visit(const Cos &) override {
-        program.emplace_back(op_unary<operation::Cos>);
+    void visit(const Cos &node) override {
+        make_unary<operation::Cos>(node);
     }
-    void visit(const Sin &) override {
-        program.emplace_back(op_unary<operation::Sin>);
+    void visit(const Sin &node) override {
+        make_unary<operation::Sin>(node);
     }
-    void visit(const Tan &) override {
-        program.emplace_back(op_unary<operation::Tan>);
+    void visit(const Tan &node) override {
+        make_unary<operation::Tan>(node);
     }
-    void visit(const Cosh &) override {
-        program.emplace_back(op_unary<operation::Cosh>);
+    void visit(const Cosh &node) override {
+        make_unary<operation::Cosh>(node);
     }
-    void visit(const Sinh &) override {
-        program.emplace_back(op_unary<operation::Sinh>);
+    void visit(const Sinh &node) override {
+        make_unary<operation::Sinh>(node);
     }
-    void visit(const Tanh &) override {
-        program.emplace_back(op_unary<operation::Tanh>);
+    void visit(const Tanh &node) override {
+        make_unary<operation::Tanh>(node);
     }
-    void visit(const Acos &) override {
-        program.emplace_back(op_unary<operation::Acos>);
+    void visit(const Acos &node) override {
+        make_unary<operation::Acos>(node);
     }
-    void visit(const Asin &) override {
-        program.emplace_back(op_unary<operation::Asin>);
+    void visit(const Asin &node) override {
+        make_unary<operation::Asin>(node);
     }
-    void visit(const Atan &) override {
-        program.emplace_back(op_unary<operation::Atan>);
+    void visit(const Atan &node) override {
+        make_unary<operation::Atan>(node);
     }
-    void visit(const Exp &) override {
-        program.emplace_back(op_unary<operation::Exp>);
+    void visit(const Exp &node) override {
+        make_unary<operation::Exp>(node);
     }
-    void visit(const Log10 &) override {
-        program.emplace_back(op_unary<operation::Log10>);
+    void visit(const Log10 &node) override {
+        make_unary<operation::Log10>(node);
     }
-    void visit(const Log &) override {
-        program.emplace_back(op_unary<operation::Log>);
+    void visit(const Log &node) override {
+        make_unary<operation::Log>(node);
     }
-    void visit(const Sqrt &) override {
-        program.emplace_back(op_unary<operation::Sqrt>);
+    void visit(const Sqrt &node) override {
+        make_unary<operation::Sqrt>(node);
     }
-    void visit(const Ceil &) override {
-        program.emplace_back(op_unary<operation::Ceil>);
+    void visit(const Ceil &node) override {
+        make_unary<operation::Ceil>(node);
     }
-    void visit(const Fabs &) override {
-        program.emplace_back(op_unary<operation::Fabs>);
+    void visit(const Fabs &node) override {
+        make_unary<operation::Fabs>(node);
     }
-    void visit(const Floor &) override {
-        program.emplace_back(op_unary<operation::Floor>);
+    void visit(const Floor &node) override {
+        make_unary<operation::Floor>(node);
     }
-    void visit(const Atan2 &) override {
-        program.emplace_back(op_binary<operation::Atan2>);
+    void visit(const Atan2 &node) override {
+        make_binary<operation::Atan2>(node);
     }
-    void visit(const Ldexp &) override {
-        program.emplace_back(op_binary<operation::Ldexp>);
+    void visit(const Ldexp &node) override {
+        make_binary<operation::Ldexp>(node);
     }
-    void visit(const Pow2 &) override {
-        program.emplace_back(op_binary<operation::Pow>);
+    void visit(const Pow2 &node) override {
+        make_binary<operation::Pow>(node);
     }
-    void visit(const Fmod &) override {
-        program.emplace_back(op_binary<operation::Mod>);
+    void visit(const Fmod &node) override {
+        make_binary<operation::Mod>(node);
     }
-    void visit(const Min &) override {
-        program.emplace_back(op_binary<operation::Min>);
+    void visit(const Min &node) override {
+        make_binary<operation::Min>(node);
     }
-    void visit(const Max &) override {
-        program.emplace_back(op_binary<operation::Max>);
+    void visit(const Max &node) override {
+        make_binary<operation::Max>(node);
     }
-    void visit(const IsNan &) override {
-        program.emplace_back(op_unary<operation::IsNan>);
+    void visit(const IsNan &node) override {
+        make_unary<operation::IsNan>(node);
     }
-    void visit(const Relu &) override {
-        program.emplace_back(op_unary<operation::Relu>);
+    void visit(const Relu &node) override {
+        make_unary<operation::Relu>(node);
     }
-    void visit(const Sigmoid &) override {
-        program.emplace_back(op_unary<operation::Sigmoid>);
+    void visit(const Sigmoid &node) override {
+        make_unary<operation::Sigmoid>(node);
     }
 
     //-------------------------------------------------------------------------
@@ -541,10 +681,10 @@ InterpretedFunction::SimpleObjectParams::resolve(size_t idx, Stash &) const
     return params[idx];
 }
 
-InterpretedFunction::State::State(const TensorEngine &engine_in)
+InterpretedFunction::State::State(const TensorEngine &engine_in, size_t stash_chunk_size)
     : engine(engine_in),
       params(nullptr),
-      stash(),
+      stash(stash_chunk_size),
       stack(),
       let_values(),
       program_offset(0)
@@ -572,7 +712,7 @@ InterpretedFunction::State::replace(size_t prune_cnt, const Value &value) {
 }
 
 InterpretedFunction::Context::Context(const InterpretedFunction &ifun)
-    : _state(ifun._tensor_engine)
+    : _state(ifun._tensor_engine, ifun._eval_stash_chunk_size)
 {
 }
 
@@ -580,10 +720,15 @@ InterpretedFunction::InterpretedFunction(const TensorEngine &engine, const nodes
     : _program(),
       _stash(),
       _num_params(num_params_in),
+      _eval_stash_chunk_size(4096),
       _tensor_engine(engine)
 {
     ProgramBuilder program_builder(_program, _stash, _tensor_engine, types);
     root.traverse(program_builder);
+    // the stash only packs allocations smaller than a quarter of a chunk
+    while (_eval_stash_chunk_size < (4 * program_builder.eval_stash_size)) {
+        _eval_stash_chunk_size *= 2;
+    }
 }
 
 InterpretedFunction::~InterpretedFunction() {}
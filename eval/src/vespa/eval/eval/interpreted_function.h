@@ -21,7 +21,9 @@ class TensorEngine;
  * run-time state related to the evaluation of an interpreted
  * function. The result of an evaluation is only valid until either
  * the context is destructed or the context is re-used to perform
- * another evaluation.
+ * another evaluation. Operations on bound dense tensors write their
+ * results into the stash of the context, which is sized up front
+ * to keep all results of a single evaluation in one reused chunk.
  **/
 class InterpretedFunction
 {
@@ -62,7 +64,7 @@ public:
         uint32_t                 program_offset;
         uint32_t                 if_cnt;
 
-        State(const TensorEngine &engine_in);
+        State(const TensorEngine &engine_in, size_t stash_chunk_size);
         ~State();
 
         void init(const LazyParams &params_in);
@@ -97,6 +99,7 @@ private:
     std::vector<Instruction> _program;
     Stash                    _stash;
     size_t                   _num_params;
+    size_t                   _eval_stash_chunk_size;
     const TensorEngine      &_tensor_engine;
 
 public:
@@ -0,0 +1,187 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "disk_object_cache.h"
+#include <vespa/vespalib/util/md5.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <utime.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".vespalib.eval.llvm.disk_object_cache");
+
+namespace vespalib {
+namespace eval {
+
+namespace {
+
+vespalib::string make_target_id() {
+    std::vector<std::string> features;
+    llvm::StringMap<bool> host_features;
+    if (llvm::sys::getHostCPUFeatures(host_features)) {
+        for (const auto &feature: host_features) {
+            if (feature.getValue()) {
+                features.push_back(feature.getKey().str());
+            }
+        }
+    }
+    std::sort(features.begin(), features.end());
+    vespalib::string id = make_string("%s;%s;%s;", LLVM_VERSION_STRING,
+                                      llvm::sys::getProcessTriple().c_str(),
+                                      llvm::sys::getHostCPUName().str().c_str());
+    for (const auto &feature: features) {
+        id.append(feature);
+        id.append(",");
+    }
+    return id;
+}
+
+struct ObjectFile {
+    vespalib::string path;
+    struct timespec used;
+    size_t size;
+    ObjectFile(const vespalib::string &path_in, const struct stat &st)
+        : path(path_in), used(st.st_mtim), size(st.st_size) {}
+    bool operator<(const ObjectFile &rhs) const {
+        if (used.tv_sec != rhs.used.tv_sec) {
+            return (used.tv_sec < rhs.used.tv_sec);
+        }
+        return (used.tv_nsec < rhs.used.tv_nsec);
+    }
+};
+
+bool is_object_file(const char *name) {
+    size_t len = strlen(name);
+    return ((len > 2) && (strcmp(name + len - 2, ".o") == 0));
+}
+
+} // namespace vespalib::eval::<unnamed>
+
+DiskObjectCache::DiskObjectCache(const vespalib::string &dir, size_t max_size)
+    : _dir(dir),
+      _max_size(max_size),
+      _target_id(make_target_id())
+{
+}
+
+DiskObjectCache::~DiskObjectCache() {}
+
+vespalib::string
+DiskObjectCache::make_key(const llvm::Module *module) const
+{
+    std::string ir;
+    llvm::raw_string_ostream ir_stream(ir);
+    module->print(ir_stream, nullptr);
+    ir_stream << _target_id;
+    ir_stream.flush();
+    unsigned char digest[16];
+    fastc_md5sum(ir.data(), ir.size(), digest);
+    vespalib::string key;
+    for (unsigned char byte: digest) {
+        key.append(make_string("%02x", byte));
+    }
+    return key;
+}
+
+vespalib::string
+DiskObjectCache::make_path(const vespalib::string &key) const
+{
+    return _dir + "/" + key + ".o";
+}
+
+void
+DiskObjectCache::enforce_size_limit()
+{
+    std::vector<ObjectFile> files;
+    size_t total_size = 0;
+    DIR *dir = opendir(_dir.c_str());
+    if (dir == nullptr) {
+        return;
+    }
+    while (struct dirent *entry = readdir(dir)) {
+        if (is_object_file(entry->d_name)) {
+            vespalib::string path = _dir + "/" + entry->d_name;
+            struct stat st;
+            if ((stat(path.c_str(), &st) == 0) && S_ISREG(st.st_mode)) {
+                files.emplace_back(path, st);
+                total_size += files.back().size;
+            }
+        }
+    }
+    closedir(dir);
+    if (total_size <= _max_size) {
+        return;
+    }
+    // the modification time is refreshed on every hit, so the oldest is the least recently used
+    std::sort(files.begin(), files.end());
+    for (const auto &file: files) {
+        if (total_size <= _max_size) {
+            break;
+        }
+        // a file already removed by another process sharing the directory counts as removed
+        if (llvm::sys::fs::remove(file.path.c_str())) {
+            LOG(warning, "could not remove object file '%s'", file.path.c_str());
+            continue;
+        }
+        LOG(debug, "removed object file '%s' to stay below %zu bytes", file.path.c_str(), _max_size);
+        total_size -= file.size;
+    }
+}
+
+void
+DiskObjectCache::notifyObjectCompiled(const llvm::Module *module, llvm::MemoryBufferRef obj)
+{
+    vespalib::string path = make_path(make_key(module));
+    int fd = -1;
+    llvm::SmallString<256> tmp_path;
+    if (llvm::sys::fs::createUniqueFile(llvm::Twine(path.c_str()) + ".%%%%%%.tmp", fd, tmp_path)) {
+        LOG(warning, "could not create object file in '%s'", _dir.c_str());
+        return;
+    }
+    {
+        llvm::raw_fd_ostream out(fd, true);
+        out << obj.getBuffer();
+        out.close();
+        if (out.has_error()) {
+            out.clear_error();
+            LOG(warning, "could not write object file '%s'", tmp_path.c_str());
+            llvm::sys::fs::remove(tmp_path);
+            return;
+        }
+    }
+    // readers only ever see complete files
+    if (llvm::sys::fs::rename(tmp_path, path.c_str())) {
+        LOG(warning, "could not rename object file '%s' to '%s'", tmp_path.c_str(), path.c_str());
+        llvm::sys::fs::remove(tmp_path);
+        return;
+    }
+    enforce_size_limit();
+}
+
+std::unique_ptr<llvm::MemoryBuffer>
+DiskObjectCache::getObject(const llvm::Module *module)
+{
+    vespalib::string path = make_path(make_key(module));
+    auto buffer = llvm::MemoryBuffer::getFile(path.c_str());
+    if (!buffer) {
+        return std::unique_ptr<llvm::MemoryBuffer>();
+    }
+    LOG(debug, "reusing compiled object file '%s'", path.c_str());
+    utime(path.c_str(), nullptr);
+    return std::move(buffer.get());
+}
+
+} // namespace vespalib::eval
+} // namespace vespalib
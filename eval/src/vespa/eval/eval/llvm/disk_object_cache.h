@@ -0,0 +1,43 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/stllike/string.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
+
+namespace vespalib {
+namespace eval {
+
+/**
+ * An LLVM object cache storing the machine code of compiled modules
+ * as files in a directory. This lets a new process reuse code
+ * compiled by an earlier one. Each module is keyed by a hash of its
+ * IR together with the host cpu, its feature set and the LLVM
+ * version, since code compiled for one of these is not valid for
+ * another. Only modules without addresses of objects in the current
+ * process may be passed to this cache. When the object files in the
+ * directory grow beyond the size limit, the least recently used
+ * ones are removed.
+ **/
+class DiskObjectCache : public llvm::ObjectCache
+{
+private:
+    vespalib::string _dir;
+    size_t           _max_size;
+    vespalib::string _target_id;
+
+    vespalib::string make_key(const llvm::Module *module) const;
+    vespalib::string make_path(const vespalib::string &key) const;
+    void enforce_size_limit();
+
+public:
+    DiskObjectCache(const vespalib::string &dir, size_t max_size);
+    ~DiskObjectCache();
+    const vespalib::string &dir() const { return _dir; }
+    size_t max_size() const { return _max_size; }
+    void notifyObjectCompiled(const llvm::Module *module, llvm::MemoryBufferRef obj) override;
+    std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *module) override;
+};
+
+} // namespace vespalib::eval
+} // namespace vespalib
@@ -2,6 +2,7 @@
 
 #include <cmath>
 #include "llvm_wrapper.h"
+#include "disk_object_cache.h"
 #include <vespa/eval/eval/node_visitor.h>
 #include <vespa/eval/eval/node_traverser.h>
 #include <llvm/IR/Verifier.h>
@@ -642,6 +643,7 @@ struct InitializeNativeTarget {
 } initialize_native_target;
 
 std::recursive_mutex LLVMWrapper::_global_llvm_lock;
+std::shared_ptr<DiskObjectCache> LLVMWrapper::_global_object_cache;
 
 LLVMWrapper::LLVMWrapper()
     : _context(),
@@ -649,7 +651,8 @@ LLVMWrapper::LLVMWrapper()
       _engine(),
       _functions(),
       _forests(),
-      _plugin_state()
+      _plugin_state(),
+      _object_cache()
 {
     std::lock_guard<std::recursive_mutex> guard(_global_llvm_lock);
     _context = std::make_unique<llvm::LLVMContext>();
@@ -695,6 +698,12 @@ LLVMWrapper::compile(bool dump_module)
     }
     _engine.reset(llvm::EngineBuilder(std::move(_module)).setOptLevel(llvm::CodeGenOpt::Aggressive).create());
     assert(_engine && "llvm jit not available for your platform");
+    if (_forests.empty() && _plugin_state.empty()) {
+        _object_cache = _global_object_cache;
+        if (_object_cache) {
+            _engine->setObjectCache(_object_cache.get());
+        }
+    }
     _engine->finalizeObject();
 }
 
@@ -705,12 +714,24 @@ LLVMWrapper::get_function_address(size_t function_id)
     return _engine->getPointerToFunction(_functions[function_id]);
 }
 
+void
+LLVMWrapper::set_object_cache_dir(const vespalib::string &dir, size_t max_size)
+{
+    std::lock_guard<std::recursive_mutex> guard(_global_llvm_lock);
+    if (dir.empty()) {
+        _global_object_cache.reset();
+    } else {
+        _global_object_cache = std::make_shared<DiskObjectCache>(dir, max_size);
+    }
+}
+
 LLVMWrapper::~LLVMWrapper() {
     std::lock_guard<std::recursive_mutex> guard(_global_llvm_lock);
     _plugin_state.clear();
     _forests.clear();
     _functions.clear();
     _engine.reset();
+    _object_cache.reset();
     _module.reset();
     _context.reset();
 }
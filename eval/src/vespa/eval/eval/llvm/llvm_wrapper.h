@@ -23,6 +23,8 @@ extern "C" {
 namespace vespalib {
 namespace eval {
 
+class DiskObjectCache;
+
 /**
  * Simple interface used to track and clean up custom state. This is
  * typically used to destruct native objects that are invoked from
@@ -48,8 +50,10 @@ private:
     std::vector<llvm::Function*>           _functions;
     std::vector<gbdt::Forest::UP>          _forests;
     std::vector<PluginState::UP>           _plugin_state;
+    std::shared_ptr<DiskObjectCache>       _object_cache;
 
     static std::recursive_mutex _global_llvm_lock;
+    static std::shared_ptr<DiskObjectCache> _global_object_cache;
 
 public:
     LLVMWrapper();
@@ -61,6 +65,16 @@ public:
     const std::vector<gbdt::Forest::UP> &get_forests() const { return _forests; }
     void compile(bool dump_module = false);
     void *get_function_address(size_t function_id);
+    /**
+     * Store the machine code of compiled modules in the given
+     * directory, and reuse it from there when the same module is
+     * compiled again, also by later processes. Modules that refer to
+     * objects in the current process (optimized forests and plugin
+     * state) are always compiled. The least recently used object
+     * files are removed when the directory grows beyond max_size
+     * bytes. An empty directory name turns the cache off again.
+     **/
+    static void set_object_cache_dir(const vespalib::string &dir, size_t max_size);
     ~LLVMWrapper();
 };
 
@@ -0,0 +1,48 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "dense_join_function.h"
+#include "dense_tensor_view.h"
+#include <vespa/eval/eval/value.h>
+#include <vespa/eval/eval/operation.h>
+#include <vespa/vespalib/util/stash.h>
+
+namespace vespalib {
+namespace tensor {
+
+using CellsRef = DenseTensorView::CellsRef;
+
+DenseJoinFunction::DenseJoinFunction(const eval::ValueType &resultType,
+                                     size_t lhsTensorId,
+                                     size_t rhsTensorId,
+                                     std::unique_ptr<eval::BinaryOperation> op,
+                                     eval::tensor_function::Node_UP fallback)
+    : _resultType(resultType),
+      _lhsTensorId(lhsTensorId),
+      _rhsTensorId(rhsTensorId),
+      _op(std::move(op)),
+      _fallback(std::move(fallback))
+{
+}
+
+DenseJoinFunction::~DenseJoinFunction() = default;
+
+const eval::Value &
+DenseJoinFunction::eval(const Input &input, Stash &stash) const
+{
+    auto lhs = dynamic_cast<const DenseTensorView *>(input.get_tensor(_lhsTensorId).as_tensor());
+    auto rhs = dynamic_cast<const DenseTensorView *>(input.get_tensor(_rhsTensorId).as_tensor());
+    if (!lhs || !rhs || (lhs->type() != _resultType) || (rhs->type() != _resultType)) {
+        return _fallback->eval(input, stash);
+    }
+    CellsRef lhsCells = lhs->cellsRef();
+    CellsRef rhsCells = rhs->cellsRef();
+    ArrayRef<double> result = stash.create_array<double>(lhsCells.size());
+    for (size_t i = 0; i < lhsCells.size(); ++i) {
+        result[i] = _op->eval(lhsCells[i], rhsCells[i]);
+    }
+    const DenseTensorView &resultTensor = stash.create<DenseTensorView>(_resultType, CellsRef(result.begin(), result.size()));
+    return stash.create<eval::TensorValue>(resultTensor);
+}
+
+} // namespace tensor
+} // namespace vespalib
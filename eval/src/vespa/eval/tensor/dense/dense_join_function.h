@@ -0,0 +1,44 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/eval/eval/tensor_function.h>
+
+namespace vespalib {
+namespace tensor {
+
+/**
+ * Tensor function joining two bound dense tensors of the same type
+ * cell by cell with a binary operation:
+ *
+ *   join(lhs, rhs, f(x,y)(...))
+ *
+ * As the cells of both tensors are laid out the same way, the result
+ * cells are calculated directly into an array allocated in the
+ * stash. The original expression is used if the input tensors do not
+ * have the expected type.
+ */
+class DenseJoinFunction : public eval::TensorFunction
+{
+private:
+    eval::ValueType _resultType;
+    size_t _lhsTensorId;
+    size_t _rhsTensorId;
+    std::unique_ptr<eval::BinaryOperation> _op;
+    eval::tensor_function::Node_UP _fallback;
+
+public:
+    DenseJoinFunction(const eval::ValueType &resultType,
+                      size_t lhsTensorId,
+                      size_t rhsTensorId,
+                      std::unique_ptr<eval::BinaryOperation> op,
+                      eval::tensor_function::Node_UP fallback);
+    ~DenseJoinFunction();
+    const eval::ValueType &resultType() const { return _resultType; }
+    size_t lhsTensorId() const { return _lhsTensorId; }
+    size_t rhsTensorId() const { return _rhsTensorId; }
+    const eval::Value &eval(const Input &input, Stash &stash) const override;
+};
+
+} // namespace tensor
+} // namespace vespalib
@@ -0,0 +1,45 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "dense_map_function.h"
+#include "dense_tensor_view.h"
+#include <vespa/eval/eval/value.h>
+#include <vespa/eval/eval/operation.h>
+#include <vespa/vespalib/util/stash.h>
+
+namespace vespalib {
+namespace tensor {
+
+using CellsRef = DenseTensorView::CellsRef;
+
+DenseMapFunction::DenseMapFunction(const eval::ValueType &resultType,
+                                   size_t tensorId,
+                                   size_t mapOperationId,
+                                   eval::tensor_function::Node_UP fallback)
+    : _resultType(resultType),
+      _tensorId(tensorId),
+      _mapOperationId(mapOperationId),
+      _fallback(std::move(fallback))
+{
+}
+
+DenseMapFunction::~DenseMapFunction() = default;
+
+const eval::Value &
+DenseMapFunction::eval(const Input &input, Stash &stash) const
+{
+    auto tensor = dynamic_cast<const DenseTensorView *>(input.get_tensor(_tensorId).as_tensor());
+    if (!tensor || (tensor->type() != _resultType)) {
+        return _fallback->eval(input, stash);
+    }
+    const eval::UnaryOperation &op = input.get_map_operation(_mapOperationId);
+    CellsRef cells = tensor->cellsRef();
+    ArrayRef<double> result = stash.create_array<double>(cells.size());
+    for (size_t i = 0; i < cells.size(); ++i) {
+        result[i] = op.eval(cells[i]);
+    }
+    const DenseTensorView &resultTensor = stash.create<DenseTensorView>(_resultType, CellsRef(result.begin(), result.size()));
+    return stash.create<eval::TensorValue>(resultTensor);
+}
+
+} // namespace tensor
+} // namespace vespalib
@@ -0,0 +1,41 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/eval/eval/tensor_function.h>
+
+namespace vespalib {
+namespace tensor {
+
+/**
+ * Tensor function mapping all cells of a bound dense tensor with a
+ * unary operation:
+ *
+ *   map(tensor, f(x)(...))
+ *
+ * The result cells are allocated in the stash. The original
+ * expression is used if the input tensor does not have the expected
+ * type.
+ */
+class DenseMapFunction : public eval::TensorFunction
+{
+private:
+    eval::ValueType _resultType;
+    size_t _tensorId;
+    size_t _mapOperationId;
+    eval::tensor_function::Node_UP _fallback;
+
+public:
+    DenseMapFunction(const eval::ValueType &resultType,
+                     size_t tensorId,
+                     size_t mapOperationId,
+                     eval::tensor_function::Node_UP fallback);
+    ~DenseMapFunction();
+    const eval::ValueType &resultType() const { return _resultType; }
+    size_t tensorId() const { return _tensorId; }
+    size_t mapOperationId() const { return _mapOperationId; }
+    const eval::Value &eval(const Input &input, Stash &stash) const override;
+};
+
+} // namespace tensor
+} // namespace vespalib
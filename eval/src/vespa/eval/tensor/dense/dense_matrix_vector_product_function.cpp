@@ -0,0 +1,100 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "dense_matrix_vector_product_function.h"
+#include "dense_tensor_view.h"
+#include <vespa/eval/eval/value.h>
+#include <vespa/eval/tensor/tensor.h>
+#include <vespa/vespalib/util/stash.h>
+#include <cstring>
+
+namespace vespalib {
+namespace tensor {
+
+using CellsRef = DenseTensorView::CellsRef;
+
+namespace {
+
+CellsRef
+getCellsRef(const eval::Value &value)
+{
+    const Tensor *tensor = static_cast<const Tensor *>(value.as_tensor());
+    const DenseTensorView *denseTensor = static_cast<const DenseTensorView *>(tensor);
+    return denseTensor->cellsRef();
+}
+
+}
+
+DenseMatrixVectorProductFunction::DenseMatrixVectorProductFunction(const eval::ValueType &resultType,
+                                                                   size_t vectorTensorId,
+                                                                   size_t matrixTensorId,
+                                                                   size_t biasTensorId,
+                                                                   size_t vectorSize,
+                                                                   size_t resultSize,
+                                                                   bool commonDimensionInnermost,
+                                                                   eval::tensor_function::Node_UP fallback)
+    : _resultType(resultType),
+      _vectorTensorId(vectorTensorId),
+      _matrixTensorId(matrixTensorId),
+      _biasTensorId(biasTensorId),
+      _vectorSize(vectorSize),
+      _resultSize(resultSize),
+      _commonDimensionInnermost(commonDimensionInnermost),
+      _fallback(std::move(fallback)),
+      _hwAccelerator(hwaccelrated::IAccelrated::getAccelrator())
+{
+}
+
+DenseMatrixVectorProductFunction::~DenseMatrixVectorProductFunction() = default;
+
+void
+DenseMatrixVectorProductFunction::multiplyRows(const double *vector, const double *matrix, double *result) const
+{
+    // Each result cell is the dot product between the vector and a contiguous matrix row.
+    for (size_t i = 0; i < _resultSize; ++i) {
+        result[i] += _hwAccelerator->dotProduct(vector, matrix + (i * _vectorSize), _vectorSize);
+    }
+}
+
+void
+DenseMatrixVectorProductFunction::multiplyColumns(const double *vector, const double *matrix, double *result) const
+{
+    // Each vector cell scales a contiguous matrix row that is added to all result cells.
+    for (size_t i = 0; i < _vectorSize; ++i) {
+        const double factor = vector[i];
+        const double *row = matrix + (i * _resultSize);
+        for (size_t j = 0; j < _resultSize; ++j) {
+            result[j] += factor * row[j];
+        }
+    }
+}
+
+const eval::Value &
+DenseMatrixVectorProductFunction::eval(const Input &input, Stash &stash) const
+{
+    CellsRef vectorCells = getCellsRef(input.get_tensor(_vectorTensorId));
+    CellsRef matrixCells = getCellsRef(input.get_tensor(_matrixTensorId));
+    CellsRef biasCells;
+    if (_biasTensorId != NO_BIAS) {
+        biasCells = getCellsRef(input.get_tensor(_biasTensorId));
+    }
+    if ((vectorCells.size() != _vectorSize) ||
+        (matrixCells.size() != _vectorSize * _resultSize) ||
+        ((_biasTensorId != NO_BIAS) && (biasCells.size() != _resultSize)))
+    {
+        return _fallback->eval(input, stash);
+    }
+    ArrayRef<double> result = stash.create_array<double>(_resultSize);
+    if (_biasTensorId != NO_BIAS) {
+        memcpy(result.begin(), biasCells.cbegin(), _resultSize * sizeof(double));
+    }
+    if (_commonDimensionInnermost) {
+        multiplyRows(vectorCells.cbegin(), matrixCells.cbegin(), result.begin());
+    } else {
+        multiplyColumns(vectorCells.cbegin(), matrixCells.cbegin(), result.begin());
+    }
+    const DenseTensorView &tensor = stash.create<DenseTensorView>(_resultType, CellsRef(result.begin(), _resultSize));
+    return stash.create<eval::TensorValue>(tensor);
+}
+
+} // namespace tensor
+} // namespace vespalib
@@ -0,0 +1,59 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/eval/eval/tensor_function.h>
+#include <vespa/vespalib/hwaccelrated/iaccelrated.h>
+
+namespace vespalib {
+namespace tensor {
+
+/**
+ * Tensor function for a product between a 1-dimensional dense vector
+ * and a 2-dimensional dense matrix, summed over their common
+ * dimension, optionally followed by adding a bias vector:
+ *
+ *   reduce(join(vector, matrix, f(x,y)(x*y)), sum, common) [+ bias]
+ *
+ * The result is calculated directly into a single cell array
+ * allocated in the stash, without any intermediate tensors. The
+ * original expression is kept and used if the input tensors do not
+ * have the expected number of cells.
+ */
+class DenseMatrixVectorProductFunction : public eval::TensorFunction
+{
+public:
+    static constexpr size_t NO_BIAS = -1;
+private:
+    eval::ValueType _resultType;
+    size_t _vectorTensorId;
+    size_t _matrixTensorId;
+    size_t _biasTensorId;
+    size_t _vectorSize;
+    size_t _resultSize;
+    bool _commonDimensionInnermost;
+    eval::tensor_function::Node_UP _fallback;
+    hwaccelrated::IAccelrated::UP _hwAccelerator;
+
+    void multiplyRows(const double *vector, const double *matrix, double *result) const;
+    void multiplyColumns(const double *vector, const double *matrix, double *result) const;
+public:
+    DenseMatrixVectorProductFunction(const eval::ValueType &resultType,
+                                     size_t vectorTensorId,
+                                     size_t matrixTensorId,
+                                     size_t biasTensorId,
+                                     size_t vectorSize,
+                                     size_t resultSize,
+                                     bool commonDimensionInnermost,
+                                     eval::tensor_function::Node_UP fallback);
+    ~DenseMatrixVectorProductFunction();
+    const eval::ValueType &resultType() const { return _resultType; }
+    size_t vectorTensorId() const { return _vectorTensorId; }
+    size_t matrixTensorId() const { return _matrixTensorId; }
+    size_t biasTensorId() const { return _biasTensorId; }
+    bool commonDimensionInnermost() const { return _commonDimensionInnermost; }
+    const eval::Value &eval(const Input &input, Stash &stash) const override;
+};
+
+} // namespace tensor
+} // namespace vespalib
@@ -0,0 +1,95 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "dense_reduce_function.h"
+#include "dense_tensor_view.h"
+#include <vespa/eval/eval/value.h>
+#include <vespa/eval/eval/operation.h>
+#include <vespa/vespalib/util/stash.h>
+#include <cassert>
+#include <cstring>
+
+namespace vespalib {
+namespace tensor {
+
+using CellsRef = DenseTensorView::CellsRef;
+
+namespace {
+
+size_t
+numCells(const std::vector<eval::ValueType::Dimension> &dimensions, size_t begin, size_t end)
+{
+    size_t result = 1;
+    for (size_t i = begin; i < end; ++i) {
+        result *= dimensions[i].size;
+    }
+    return result;
+}
+
+}
+
+DenseReduceFunction::DenseReduceFunction(const eval::ValueType &tensorType,
+                                         const eval::ValueType &resultType,
+                                         size_t tensorId,
+                                         std::unique_ptr<eval::BinaryOperation> op,
+                                         const std::vector<vespalib::string> &dimensions,
+                                         eval::tensor_function::Node_UP fallback)
+    : _tensorType(tensorType),
+      _resultType(resultType),
+      _tensorId(tensorId),
+      _op(std::move(op)),
+      _steps(),
+      _fallback(std::move(fallback))
+{
+    const auto &tensorDimensions = _tensorType.dimensions();
+    if (dimensions.empty()) {
+        _steps.emplace_back(1, numCells(tensorDimensions, 0, tensorDimensions.size()), 1);
+        return;
+    }
+    eval::ValueType type = _tensorType;
+    for (const auto &dimension : dimensions) {
+        const auto &typeDimensions = type.dimensions();
+        size_t idx = type.dimension_index(dimension);
+        assert(idx != eval::ValueType::Dimension::npos);
+        _steps.emplace_back(numCells(typeDimensions, 0, idx),
+                            typeDimensions[idx].size,
+                            numCells(typeDimensions, idx + 1, typeDimensions.size()));
+        type = type.reduce({dimension});
+    }
+}
+
+DenseReduceFunction::~DenseReduceFunction() = default;
+
+const eval::Value &
+DenseReduceFunction::eval(const Input &input, Stash &stash) const
+{
+    auto tensor = dynamic_cast<const DenseTensorView *>(input.get_tensor(_tensorId).as_tensor());
+    if (!tensor || (tensor->type() != _tensorType)) {
+        return _fallback->eval(input, stash);
+    }
+    CellsRef cells = tensor->cellsRef();
+    for (const Step &step : _steps) {
+        const double *src = cells.cbegin();
+        ArrayRef<double> result = stash.create_array<double>(step.outerSize * step.innerSize);
+        double *dst = result.begin();
+        for (size_t outer = 0; outer < step.outerSize; ++outer) {
+            memcpy(dst, src, step.innerSize * sizeof(double));
+            src += step.innerSize;
+            for (size_t reduce = 1; reduce < step.reduceSize; ++reduce) {
+                for (size_t inner = 0; inner < step.innerSize; ++inner) {
+                    dst[inner] = _op->eval(dst[inner], src[inner]);
+                }
+                src += step.innerSize;
+            }
+            dst += step.innerSize;
+        }
+        cells = CellsRef(result.begin(), result.size());
+    }
+    if (_resultType.is_double()) {
+        return stash.create<eval::DoubleValue>(cells[0]);
+    }
+    const DenseTensorView &resultTensor = stash.create<DenseTensorView>(_resultType, cells);
+    return stash.create<eval::TensorValue>(resultTensor);
+}
+
+} // namespace tensor
+} // namespace vespalib
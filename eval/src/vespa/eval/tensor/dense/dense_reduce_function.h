@@ -0,0 +1,59 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/eval/eval/tensor_function.h>
+
+namespace vespalib {
+namespace tensor {
+
+/**
+ * Tensor function reducing one or more dimensions of a bound dense
+ * tensor with a binary operation:
+ *
+ *   reduce(tensor, aggr, dimensions...)
+ *
+ * The dimensions are removed one at a time. The layout of each step
+ * is calculated up front, and the cells of each step are allocated in
+ * the stash. The result is a double if all dimensions are
+ * removed. The original expression is used if the input tensor does
+ * not have the expected type.
+ */
+class DenseReduceFunction : public eval::TensorFunction
+{
+public:
+    /**
+     * Removing a single dimension, with the number of cells in the
+     * dimensions outside, of, and inside the removed dimension.
+     */
+    struct Step {
+        size_t outerSize;
+        size_t reduceSize;
+        size_t innerSize;
+        Step(size_t outerSize_in, size_t reduceSize_in, size_t innerSize_in)
+            : outerSize(outerSize_in), reduceSize(reduceSize_in), innerSize(innerSize_in) {}
+    };
+private:
+    eval::ValueType _tensorType;
+    eval::ValueType _resultType;
+    size_t _tensorId;
+    std::unique_ptr<eval::BinaryOperation> _op;
+    std::vector<Step> _steps;
+    eval::tensor_function::Node_UP _fallback;
+
+public:
+    DenseReduceFunction(const eval::ValueType &tensorType,
+                        const eval::ValueType &resultType,
+                        size_t tensorId,
+                        std::unique_ptr<eval::BinaryOperation> op,
+                        const std::vector<vespalib::string> &dimensions,
+                        eval::tensor_function::Node_UP fallback);
+    ~DenseReduceFunction();
+    const eval::ValueType &resultType() const { return _resultType; }
+    size_t tensorId() const { return _tensorId; }
+    const std::vector<Step> &steps() const { return _steps; }
+    const eval::Value &eval(const Input &input, Stash &stash) const override;
+};
+
+} // namespace tensor
+} // namespace vespalib
@@ -1,6 +1,10 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "dense_dot_product_function.h"
+#include "dense_join_function.h"
+#include "dense_map_function.h"
+#include "dense_matrix_vector_product_function.h"
+#include "dense_reduce_function.h"
 #include "dense_tensor_function_compiler.h"
 #include <vespa/eval/eval/operation_visitor.h>
 #include <vespa/eval/eval/operation_visitor.h>
@@ -35,19 +39,79 @@ is1dDenseTensor(const ValueType &type)
     return (type.is_dense() && (type.dimensions().size() == 1));
 }
 
+bool
+isBoundDenseTensor(const ValueType &type, size_t numDimensions)
+{
+    return (type.is_dense() && !type.is_abstract() && (type.dimensions().size() == numDimensions));
+}
+
 bool
 isCompatibleTensorsForDotProduct(const ValueType &lhsType, const ValueType &rhsType)
 {
-    return (is1dDenseTensor(lhsType) &&
-            is1dDenseTensor(rhsType) &&
-            (lhsType.dimensions()[0].name == rhsType.dimensions()[0].name));
+    if (is1dDenseTensor(lhsType) && is1dDenseTensor(rhsType)) {
+        return (lhsType.dimensions()[0].name == rhsType.dimensions()[0].name);
+    }
+    // Cells of multi-dimensional tensors are only laid out the same way when the types are equal.
+    return (lhsType.is_dense() && !lhsType.is_abstract() && (lhsType == rhsType));
+}
+
+bool
+willReduceAllDimensions(const Reduce &reduce, const ValueType &tensorType)
+{
+    if (tensorType.dimensions().size() > 1) {
+        return reduce.result_type.is_double();
+    }
+    return willReduceAllDimensions(reduce.dimensions);
+}
+
+bool
+isBoundDenseTensor(const ValueType &type)
+{
+    return (type.is_dense() && !type.is_abstract());
 }
 
+/**
+ * Compiles a single map, join or reduce of injected bound dense tensors
+ * to a function that writes the result cells into the stash.
+ */
+struct SingleOperationFunctionCompiler
+{
+    static TensorFunction::UP compile(Node_UP expr) {
+        if (const Map *map = as<Map>(*expr)) {
+            const Inject *tensor = as<Inject>(*map->tensor);
+            if (tensor && isBoundDenseTensor(tensor->result_type)) {
+                ValueType resultType = map->result_type;
+                return std::make_unique<DenseMapFunction>(resultType, tensor->tensor_id, map->map_operation_id,
+                                                          std::move(expr));
+            }
+        } else if (const Apply *apply = as<Apply>(*expr)) {
+            const Inject *lhsTensor = as<Inject>(*apply->lhs_tensor);
+            const Inject *rhsTensor = as<Inject>(*apply->rhs_tensor);
+            if (lhsTensor && rhsTensor && isBoundDenseTensor(lhsTensor->result_type) &&
+                (lhsTensor->result_type == rhsTensor->result_type))
+            {
+                ValueType resultType = apply->result_type;
+                return std::make_unique<DenseJoinFunction>(resultType, lhsTensor->tensor_id, rhsTensor->tensor_id,
+                                                           apply->op->clone(), std::move(expr));
+            }
+        } else if (const Reduce *reduce = as<Reduce>(*expr)) {
+            const Inject *tensor = as<Inject>(*reduce->tensor);
+            if (tensor && isBoundDenseTensor(tensor->result_type) && !reduce->result_type.is_error()) {
+                ValueType tensorType = tensor->result_type;
+                ValueType resultType = reduce->result_type;
+                return std::make_unique<DenseReduceFunction>(tensorType, resultType, tensor->tensor_id,
+                                                             reduce->op->clone(), reduce->dimensions, std::move(expr));
+            }
+        }
+        return std::move(expr);
+    }
+};
+
 struct DotProductFunctionCompiler
 {
     static TensorFunction::UP compile(Node_UP expr) {
         const Reduce *reduce = as<Reduce>(*expr);
-        if (reduce && isType<Add>(*reduce->op) && willReduceAllDimensions(reduce->dimensions)) {
+        if (reduce && isType<Add>(*reduce->op) && willReduceAllDimensions(*reduce, reduce->tensor->result_type)) {
             const Apply *apply = as<Apply>(*reduce->tensor);
             if (apply && isType<Mul>(*apply->op)) {
                 const Inject *lhsTensor = as<Inject>(*apply->lhs_tensor);
@@ -59,7 +123,98 @@ struct DotProductFunctionCompiler
                 }
             }
         }
-        return std::move(expr);
+        return SingleOperationFunctionCompiler::compile(std::move(expr));
+    }
+};
+
+/**
+ * Recognizes the product between a vector and a matrix, summed over their
+ * common dimension, when all tensors have bound dimensions.
+ */
+struct MatrixVectorProduct
+{
+    const Reduce *reduce = nullptr;
+    const Inject *vector = nullptr;
+    const Inject *matrix = nullptr;
+
+    bool match(const Node &node) {
+        reduce = as<Reduce>(node);
+        if (!reduce || !isType<Add>(*reduce->op) || (reduce->dimensions.size() != 1) ||
+            !isBoundDenseTensor(reduce->result_type, 1))
+        {
+            return false;
+        }
+        const Apply *apply = as<Apply>(*reduce->tensor);
+        if (!apply || !isType<Mul>(*apply->op)) {
+            return false;
+        }
+        const Inject *lhsTensor = as<Inject>(*apply->lhs_tensor);
+        const Inject *rhsTensor = as<Inject>(*apply->rhs_tensor);
+        if (!lhsTensor || !rhsTensor) {
+            return false;
+        }
+        if (isBoundDenseTensor(lhsTensor->result_type, 1) && isBoundDenseTensor(rhsTensor->result_type, 2)) {
+            vector = lhsTensor;
+            matrix = rhsTensor;
+        } else if (isBoundDenseTensor(lhsTensor->result_type, 2) && isBoundDenseTensor(rhsTensor->result_type, 1)) {
+            vector = rhsTensor;
+            matrix = lhsTensor;
+        } else {
+            return false;
+        }
+        const auto &vectorDimension = vector->result_type.dimensions()[0];
+        const auto &matrixDimensions = matrix->result_type.dimensions();
+        const auto &resultDimension = reduce->result_type.dimensions()[0];
+        if (vectorDimension.name != reduce->dimensions[0]) {
+            return false;
+        }
+        for (const auto &dimension : matrixDimensions) {
+            if (dimension.name == vectorDimension.name && dimension.size != vectorDimension.size) {
+                return false;
+            }
+            if (dimension.name == resultDimension.name && dimension.size != resultDimension.size) {
+                return false;
+            }
+        }
+        return (matrix->result_type.dimension_index(vectorDimension.name) != ValueType::Dimension::npos);
+    }
+    size_t vectorSize() const { return vector->result_type.dimensions()[0].size; }
+    size_t resultSize() const { return reduce->result_type.dimensions()[0].size; }
+    bool commonDimensionInnermost() const {
+        return (matrix->result_type.dimensions()[1].name == vector->result_type.dimensions()[0].name);
+    }
+};
+
+struct MatrixVectorProductFunctionCompiler
+{
+    static TensorFunction::UP compile(Node_UP expr) {
+        MatrixVectorProduct product;
+        const Inject *bias = nullptr;
+        bool matched = product.match(*expr);
+        if (!matched) {
+            // The product followed by adding a bias vector (xw + b)
+            const Apply *apply = as<Apply>(*expr);
+            if (apply && isType<Add>(*apply->op)) {
+                if (product.match(*apply->lhs_tensor)) {
+                    bias = as<Inject>(*apply->rhs_tensor);
+                } else if (product.match(*apply->rhs_tensor)) {
+                    bias = as<Inject>(*apply->lhs_tensor);
+                }
+                matched = (bias && (bias->result_type == product.reduce->result_type));
+            }
+        }
+        if (!matched) {
+            return DotProductFunctionCompiler::compile(std::move(expr));
+        }
+        ValueType resultType = expr->result_type;
+        return std::make_unique<DenseMatrixVectorProductFunction>(resultType,
+                                                                  product.vector->tensor_id,
+                                                                  product.matrix->tensor_id,
+                                                                  bias ? bias->tensor_id : DenseMatrixVectorProductFunction::NO_BIAS,
+                                                                  product.vectorSize(),
+                                                                  product.resultSize(),
+                                                                  product.commonDimensionInnermost(),
+                                                                  std::move(expr));
     }
 };
 
@@ -68,7 +223,7 @@ struct DotProductFunctionCompiler
 TensorFunction::UP
 DenseTensorFunctionCompiler::compile(Node_UP expr)
 {
-    return DotProductFunctionCompiler::compile(std::move(expr));
+    return MatrixVectorProductFunctionCompiler::compile(std::move(expr));
 }
 
 } // namespace tensor
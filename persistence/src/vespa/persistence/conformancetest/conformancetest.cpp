@@ -953,6 +953,74 @@ void ConformanceTest::testUpdate() {
     }
 }
 
+void ConformanceTest::testApplyBatch() {
+    document::TestDocMan testDocMan;
+    _factory->clear();
+    PersistenceProvider::UP spi(getSpi(*_factory, testDocMan));
+    Document::SP doc1 = testDocMan.createRandomDocumentAtLocation(0x01, 1);
+    Document::SP doc2 = testDocMan.createRandomDocumentAtLocation(0x01, 2);
+    Context context(defaultLoadType, Priority(0), Trace::TraceLevel(0));
+
+    Bucket bucket(document::BucketId(8, 0x01), PartitionId(0));
+    spi->createBucket(bucket, context);
+
+    const document::DocumentType *docType(
+            testDocMan.getTypeRepo().getDocumentType("testdoctype1"));
+    document::DocumentUpdate::SP
+        update(new DocumentUpdate(*docType, doc1->getId()));
+    std::shared_ptr<document::AssignValueUpdate> assignUpdate(
+            new document::AssignValueUpdate(document::IntFieldValue(42)));
+    document::FieldUpdate fieldUpdate(docType->getField("headerval"));
+    fieldUpdate.addUpdate(*assignUpdate);
+    update->addUpdate(fieldUpdate);
+
+    // Later operations in a batch must see the effect of earlier ones.
+    std::vector<BatchOperation> ops;
+    ops.push_back(BatchOperation::put(Timestamp(1), doc1));
+    ops.push_back(BatchOperation::put(Timestamp(2), doc2));
+    ops.push_back(BatchOperation::update(Timestamp(3), update));
+    ops.push_back(BatchOperation::remove(Timestamp(4), doc2->getId()));
+    ops.push_back(BatchOperation::remove(Timestamp(5), doc2->getId()));
+    BatchResult result = spi->applyBatch(bucket, ops, context);
+    spi->flush(bucket, context);
+
+    CPPUNIT_ASSERT_EQUAL(Result::NONE, result.getErrorCode());
+    CPPUNIT_ASSERT_EQUAL(ops.size(), result.getResults().size());
+    CPPUNIT_ASSERT_EQUAL(Result(), *result.getResults()[0]);
+    CPPUNIT_ASSERT_EQUAL(Result(), *result.getResults()[1]);
+    {
+        const UpdateResult &updateResult(
+                dynamic_cast<const UpdateResult &>(*result.getResults()[2]));
+        CPPUNIT_ASSERT_EQUAL(Result::NONE, updateResult.getErrorCode());
+        CPPUNIT_ASSERT_EQUAL(Timestamp(1), updateResult.getExistingTimestamp());
+    }
+    {
+        const RemoveResult &removeResult(
+                dynamic_cast<const RemoveResult &>(*result.getResults()[3]));
+        CPPUNIT_ASSERT_EQUAL(Result::NONE, removeResult.getErrorCode());
+        CPPUNIT_ASSERT(removeResult.wasFound());
+    }
+    {
+        const RemoveResult &removeResult(
+                dynamic_cast<const RemoveResult &>(*result.getResults()[4]));
+        CPPUNIT_ASSERT_EQUAL(Result::NONE, removeResult.getErrorCode());
+        CPPUNIT_ASSERT(!removeResult.wasFound());
+    }
+    {
+        GetResult getResult = spi->get(bucket, document::AllFields(),
+                                       doc1->getId(), context);
+        CPPUNIT_ASSERT_EQUAL(Timestamp(3), getResult.getTimestamp());
+        CPPUNIT_ASSERT_EQUAL(document::IntFieldValue(42),
+                             static_cast<document::IntFieldValue&>(
+                                     *getResult.getDocument().getValue("headerval")));
+    }
+    {
+        GetResult getResult = spi->get(bucket, document::AllFields(),
+                                       doc2->getId(), context);
+        CPPUNIT_ASSERT(!getResult.hasDocument());
+    }
+}
+
 void ConformanceTest::testGet() {
     document::TestDocMan testDocMan;
     _factory->clear();
@@ -24,6 +24,7 @@
     CPPUNIT_TEST(testRemove); \
     CPPUNIT_TEST(testRemoveMerge); \
     CPPUNIT_TEST(testUpdate); \
+    CPPUNIT_TEST(testApplyBatch); \
     CPPUNIT_TEST(testGet); \
     CPPUNIT_TEST(testIterateCreateIterator); \
     CPPUNIT_TEST(testIterateWithUnknownId); \
@@ -222,6 +223,7 @@ public:
     void testRemove();
     void testRemoveMerge();
     void testUpdate();
+    void testApplyBatch();
     void testGet();
 
     /** Test that iterating special cases works. */
@@ -0,0 +1,66 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+/**
+ * \class storage::spi::BatchOperation
+ * \ingroup spi
+ *
+ * \brief A single feed operation in a batch given to applyBatch().
+ *
+ * A batch operation is either a put, a remove with removeIfFound() semantics
+ * or an update. It only refers to the document, id or update given by the
+ * caller, which must be kept alive until applyBatch() has returned.
+ */
+
+#pragma once
+
+#include <persistence/spi/types.h>
+
+namespace storage {
+namespace spi {
+
+class BatchOperation {
+public:
+    enum Type {
+        PUT,
+        REMOVE,
+        UPDATE
+    };
+
+    static BatchOperation put(Timestamp ts, const DocumentSP& doc) {
+        return BatchOperation(PUT, ts, &doc, nullptr, nullptr);
+    }
+    static BatchOperation remove(Timestamp ts, const DocumentId& id) {
+        return BatchOperation(REMOVE, ts, nullptr, &id, nullptr);
+    }
+    static BatchOperation update(Timestamp ts, const DocumentUpdateSP& upd) {
+        return BatchOperation(UPDATE, ts, nullptr, nullptr, &upd);
+    }
+
+    Type getType() const { return _type; }
+    Timestamp getTimestamp() const { return _timestamp; }
+
+    /** Only valid for PUT operations. */
+    const DocumentSP& getDocument() const { return *_doc; }
+    /** Only valid for REMOVE operations. */
+    const DocumentId& getDocumentId() const { return *_id; }
+    /** Only valid for UPDATE operations. */
+    const DocumentUpdateSP& getUpdate() const { return *_update; }
+
+private:
+    BatchOperation(Type type, Timestamp ts, const DocumentSP* doc,
+                   const DocumentId* id, const DocumentUpdateSP* upd)
+        : _type(type),
+          _timestamp(ts),
+          _doc(doc),
+          _id(id),
+          _update(upd)
+    { }
+
+    Type _type;
+    Timestamp _timestamp;
+    const DocumentSP* _doc;
+    const DocumentId* _id;
+    const DocumentUpdateSP* _update;
+};
+
+} // spi
+} // storage
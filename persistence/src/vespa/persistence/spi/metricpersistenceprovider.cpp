@@ -47,7 +47,7 @@ Impl::ResultMetrics::ResultMetrics(const char* opName)
 Impl::MetricPersistenceProvider(PersistenceProvider& next)
     : metrics::MetricSet("spi", "", ""),
       _next(&next),
-      _functionMetrics(23)
+      _functionMetrics(24)
 {
     defineResultMetrics(0, "initialize");
     defineResultMetrics(1, "getPartitionStates");
@@ -72,6 +72,7 @@ Impl::MetricPersistenceProvider(PersistenceProvider& next)
     defineResultMetrics(20, "split");
     defineResultMetrics(21, "join");
     defineResultMetrics(22, "move");
+    defineResultMetrics(23, "applyBatch");
 }
 
 Impl::~MetricPersistenceProvider() { }
@@ -185,6 +186,15 @@ Impl::update(const Bucket& v1, Timestamp v2, const DocumentUpdateSP& v3, Context
     return r;
 }
 
+BatchResult
+Impl::applyBatch(const Bucket& v1, const std::vector<BatchOperation>& v2, Context& v3)
+{
+    PRE_PROCESS(23);
+    BatchResult r(_next->applyBatch(v1, v2, v3));
+    POST_PROCESS(23, r);
+    return r;
+}
+
 Result
 Impl::flush(const Bucket& v1, Context& v2)
 {
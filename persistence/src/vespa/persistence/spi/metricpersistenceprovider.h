@@ -43,6 +43,7 @@ public:
     RemoveResult removeIfFound(const Bucket&, Timestamp, const DocumentId&, Context&) override;
     Result removeEntry(const Bucket&, Timestamp, Context&) override;
     UpdateResult update(const Bucket&, Timestamp, const DocumentUpdateSP&, Context&) override;
+    BatchResult applyBatch(const Bucket&, const std::vector<BatchOperation>&, Context&) override;
     Result flush(const Bucket&, Context&) override;
     GetResult get(const Bucket&, const document::FieldSet&, const DocumentId&, Context&) const override;
     CreateIteratorResult createIterator(const Bucket&, const document::FieldSet&, const Selection&,
@@ -7,6 +7,33 @@ namespace spi {
 
 PersistenceProvider::~PersistenceProvider() { }
 
+BatchResult
+PersistenceProvider::applyBatch(const Bucket& bucket,
+                                const std::vector<BatchOperation>& ops,
+                                Context& context)
+{
+    BatchResult::ResultList results;
+    results.reserve(ops.size());
+    for (const BatchOperation& op : ops) {
+        switch (op.getType()) {
+        case BatchOperation::PUT:
+            results.push_back(std::make_unique<Result>(
+                    put(bucket, op.getTimestamp(), op.getDocument(), context)));
+            break;
+        case BatchOperation::REMOVE:
+            results.push_back(std::make_unique<RemoveResult>(
+                    removeIfFound(bucket, op.getTimestamp(),
+                                  op.getDocumentId(), context)));
+            break;
+        case BatchOperation::UPDATE:
+            results.push_back(std::make_unique<UpdateResult>(
+                    update(bucket, op.getTimestamp(), op.getUpdate(), context)));
+            break;
+        }
+    }
+    return BatchResult(std::move(results));
+}
+
 } // spi
 } // storage
 
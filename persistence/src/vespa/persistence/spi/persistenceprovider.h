@@ -1,6 +1,7 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #pragma once
 
+#include "batchoperation.h"
 #include "bucket.h"
 #include "bucketinfo.h"
 #include "context.h"
@@ -213,6 +214,22 @@ struct PersistenceProvider
                                 const DocumentUpdateSP& update,
                                 Context&) = 0;
 
+    /**
+     * Applies a sequence of feed operations to the given bucket, as if
+     * put(), removeIfFound() and update() were called for each of them in
+     * order. The service layer uses this to hand over all the feed operations
+     * it has queued for a bucket at once, which lets a provider amortize
+     * per-operation costs such as logging each operation to disk.
+     * <p/>
+     * The default implementation simply calls the single operation functions.
+     *
+     * @param ops The operations to apply, in order.
+     * @return One result per operation, see BatchResult.
+     */
+    virtual BatchResult applyBatch(const Bucket&,
+                                   const std::vector<BatchOperation>& ops,
+                                   Context&);
+
     /**
      * The service layer may choose to batch certain commands. This means that
      * the service layer will lock the bucket only once, then perform several
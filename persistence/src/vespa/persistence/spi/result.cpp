@@ -28,6 +28,8 @@ GetResult::GetResult(Document::UP doc, Timestamp timestamp)
       _doc(std::move(doc))
 { }
 
+BatchResult::~BatchResult() { }
+
 GetResult::~GetResult() { }
 BucketIdListResult::~BucketIdListResult() { }
 
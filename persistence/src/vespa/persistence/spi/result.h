@@ -146,6 +146,44 @@ private:
     bool _wasFound;
 };
 
+/**
+ * Result of applyBatch(). Unless the batch as a whole failed, it holds one
+ * result per operation in the batch, in the same order as the operations.
+ * Puts give a plain Result, removes a RemoveResult and updates an
+ * UpdateResult.
+ */
+class BatchResult : public Result
+{
+public:
+    using ResultList = std::vector<Result::UP>;
+
+    /**
+     * Constructor to use when none of the operations could be applied.
+     */
+    BatchResult(ErrorType error, const vespalib::string& errorMessage)
+        : Result(error, errorMessage),
+          _results()
+    { }
+
+    /**
+     * Constructor to use when all the operations have been attempted.
+     */
+    BatchResult(ResultList results)
+        : _results(std::move(results))
+    { }
+
+    BatchResult(const BatchResult &) = delete;
+    BatchResult(BatchResult &&rhs) = default;
+    BatchResult &operator=(BatchResult &&rhs) = default;
+
+    ~BatchResult();
+
+    const ResultList& getResults() const { return _results; }
+
+private:
+    ResultList _results;
+};
+
 class GetResult : public Result {
 public:
     /**
@@ -4,6 +4,7 @@
 
 #include "basictype.h"
 #include "collectiontype.h"
+#include "hnsw_index_params.h"
 #include "predicate_params.h"
 #include <vespa/searchcommon/common/growstrategy.h>
 #include <vespa/searchcommon/common/compaction_strategy.h>
@@ -28,6 +29,7 @@ public:
     bool huge()                           const { return _huge; }
     const PredicateParams &predicateParams() const { return _predicateParams; }
     vespalib::eval::ValueType tensorType() const { return _tensorType; }
+    const HnswIndexParams &hnswIndexParams() const { return _hnswIndexParams; }
 
     /**
      * Check if attribute posting list can consist of a bitvector in
@@ -49,6 +51,12 @@ public:
      */
     bool fastAccess() const { return _fastAccess; }
 
+    /**
+     * Check if multi-value integer attributes without fast search should
+     * keep their arrays compressed in memory.
+     */
+    bool compressMultiValues() const { return _compressMultiValues; }
+
     const GrowStrategy & getGrowStrategy() const { return _growStrategy; }
     const CompactionStrategy &getCompactionStrategy() const { return _compactionStrategy; }
     void setHuge(bool v)                         { _huge = v; }
@@ -57,6 +65,7 @@ public:
     void setTensorType(const vespalib::eval::ValueType &tensorType_in) {
         _tensorType = tensorType_in;
     }
+    void setHnswIndexParams(const HnswIndexParams &v) { _hnswIndexParams = v; }
 
     /**
      * Enable attribute posting list to consist of a bitvector in
@@ -84,6 +93,7 @@ public:
     }
 
     void setFastAccess(bool v) { _fastAccess = v; }
+    void setCompressMultiValues(bool v) { _compressMultiValues = v; }
     Config & setGrowStrategy(const GrowStrategy &gs) { _growStrategy = gs; return *this; }
     Config &setCompactionStrategy(const CompactionStrategy &compactionStrategy) { _compactionStrategy = compactionStrategy; return *this; }
     bool operator!=(const Config &b) const { return !(operator==(b)); }
@@ -99,11 +109,13 @@ public:
                _enableOnlyBitVector == b._enableOnlyBitVector &&
                _isFilter == b._isFilter &&
                _fastAccess == b._fastAccess &&
+               _compressMultiValues == b._compressMultiValues &&
                _growStrategy == b._growStrategy &&
                _compactionStrategy == b._compactionStrategy &&
                _predicateParams == b._predicateParams &&
             (_basicType.type() != BasicType::Type::TENSOR ||
-             _tensorType == b._tensorType);
+             (_tensorType == b._tensorType &&
+              _hnswIndexParams == b._hnswIndexParams));
     }
 
 private:
@@ -115,10 +127,12 @@ private:
     bool           _enableOnlyBitVector;
     bool           _isFilter;
     bool           _fastAccess;
+    bool           _compressMultiValues;
     GrowStrategy   _growStrategy;
     CompactionStrategy _compactionStrategy;
     PredicateParams    _predicateParams;
     vespalib::eval::ValueType _tensorType;
+    HnswIndexParams    _hnswIndexParams;
 };
 }  // namespace attribute
 }  // namespace search
@@ -0,0 +1,55 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstdint>
+
+namespace search {
+namespace attribute {
+
+/*
+ * Parameters for the approximate nearest neighbor (HNSW) index of
+ * dense tensor attributes.
+ */
+class HnswIndexParams
+{
+public:
+    enum class DistanceMetric { EUCLIDEAN, INNER_PRODUCT };
+private:
+    bool           _enabled;
+    uint32_t       _maxLinksPerNode;
+    uint32_t       _neighborsToExploreAtInsert;
+    DistanceMetric _distanceMetric;
+public:
+    HnswIndexParams()
+        : _enabled(false),
+          _maxLinksPerNode(16),
+          _neighborsToExploreAtInsert(200),
+          _distanceMetric(DistanceMetric::EUCLIDEAN)
+    {
+    }
+
+    HnswIndexParams(uint32_t maxLinksPerNode, uint32_t neighborsToExploreAtInsert, DistanceMetric distanceMetric)
+        : _enabled(true),
+          _maxLinksPerNode(maxLinksPerNode),
+          _neighborsToExploreAtInsert(neighborsToExploreAtInsert),
+          _distanceMetric(distanceMetric)
+    {
+    }
+
+    bool enabled() const { return _enabled; }
+    /** Max number of links per node on levels above 0. Level 0 allows twice as many. */
+    uint32_t maxLinksPerNode() const { return _maxLinksPerNode; }
+    /** Number of candidates to explore when linking in a new node. */
+    uint32_t neighborsToExploreAtInsert() const { return _neighborsToExploreAtInsert; }
+    DistanceMetric distanceMetric() const { return _distanceMetric; }
+    bool operator==(const HnswIndexParams &rhs) const {
+        return ((_enabled == rhs._enabled) &&
+                (_maxLinksPerNode == rhs._maxLinksPerNode) &&
+                (_neighborsToExploreAtInsert == rhs._neighborsToExploreAtInsert) &&
+                (_distanceMetric == rhs._distanceMetric));
+    }
+};
+
+}  // namespace attribute
+}  // namespace search
@@ -342,6 +342,7 @@ private:
 
     void requireThatAdapterHandlesAllFieldTypes();
     void requireThatAdapterHandlesMultipleDocuments();
+    void requireThatAdapterServesPrefetchedDocuments();
     void requireThatAdapterHandlesDocumentIdField();
     void requireThatDocsumRequestIsProcessed();
     void requireThatRewritersAreUsed();
@@ -572,6 +573,51 @@ Test::requireThatAdapterHandlesMultipleDocuments()
 }
 
 
+void
+Test::requireThatAdapterServesPrefetchedDocuments()
+{
+    Schema s;
+    s.addSummaryField(Schema::SummaryField("a", schema::DataType::INT32));
+
+    BuildContext bc(s);
+    bc._bld.startDocument("doc::0").
+        startSummaryField("a").
+        addInt(1000).
+        endField();
+    bc.endDocument(0);
+    bc._bld.startDocument("doc::1").
+        startSummaryField("a").
+        addInt(2000).endField();
+    bc.endDocument(1);
+
+    DocumentStoreAdapter dsa(bc._str, *bc._repo, getResultConfig(), "class1",
+                             bc.createFieldCacheRepo(getResultConfig())->getFieldCache("class1"),
+                             getMarkupFields());
+    dsa.prefetch({1, 0, 2});
+    search::CacheStats stats = bc._str.getCacheStats();
+    EXPECT_EQUAL(3u, stats.misses);
+    EXPECT_EQUAL(2u, stats.elements);
+    { // doc 1
+        GeneralResultPtr res = getResult(dsa, 1);
+        EXPECT_EQUAL(2000u, res->GetEntry("a")->_intval);
+    }
+    { // doc 0
+        GeneralResultPtr res = getResult(dsa, 0);
+        EXPECT_EQUAL(1000u, res->GetEntry("a")->_intval);
+    }
+    { // doc 2
+        DocsumStoreValue docsum = dsa.getMappedDocsum(2);
+        EXPECT_TRUE(docsum.pt() == NULL);
+    }
+    { // doc 0 (again), read from the cache filled by the prefetch
+        GeneralResultPtr res = getResult(dsa, 0);
+        EXPECT_EQUAL(1000u, res->GetEntry("a")->_intval);
+    }
+    EXPECT_EQUAL(1u, bc._str.getCacheStats().hits);
+    uint64_t flushToken = bc._str.initFlush(bc._serialNum - 1);
+    bc._str.flush(flushToken);
+}
+
 void
 Test::requireThatAdapterHandlesDocumentIdField()
 {
@@ -1296,6 +1342,7 @@ Test::Main()
     TEST_DO(requireThatSummaryAdapterHandlesPutAndRemove());
     TEST_DO(requireThatAdapterHandlesAllFieldTypes());
     TEST_DO(requireThatAdapterHandlesMultipleDocuments());
+    TEST_DO(requireThatAdapterServesPrefetchedDocuments());
     TEST_DO(requireThatAdapterHandlesDocumentIdField());
     TEST_DO(requireThatDocsumRequestIsProcessed());
     TEST_DO(requireThatRewritersAreUsed());
@@ -326,12 +326,13 @@ struct FixtureBase
         proton::test::runInMaster(_writeService, func);
     }
     void init() {
+                vespalib::ThreadStackExecutor executor(1, 1024 * 1024);
                 DocumentSubDbInitializer::SP task =
                     _subDb.createInitializer(*_snapshot->_cfg,
                                              Traits::configSerial(),
                                              ProtonConfig::Summary(),
-                                             ProtonConfig::Index());
-                vespalib::ThreadStackExecutor executor(1, 1024 * 1024);
+                                             ProtonConfig::Index(),
+                                             executor);
                 initializer::TaskRunner taskRunner(executor);
                 taskRunner.runTask(task);
         SessionManager::SP sessionMgr(new SessionManager(1));
@@ -31,6 +31,7 @@
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/vespalib/util/closuretask.h>
 #include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/stringfmt.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP("feedhandler_test");
@@ -182,6 +183,14 @@ struct MyDocumentMetaStore {
     }
 };
 
+typedef std::vector<vespalib::string> EventLog;
+
+void logEvent(EventLog *log, const vespalib::string &event) {
+    if (log != nullptr) {
+        log->push_back(event);
+    }
+}
+
 struct MyFeedView : public test::DummyFeedView {
     Rendezvous putRdz;
     bool usePutRdz;
@@ -195,6 +204,7 @@ struct MyFeedView : public test::DummyFeedView {
     int prune_removed_count;
     int update_count;
     SerialNum update_serial;
+    EventLog *log;
     MyFeedView(const DocumentTypeRepo::SP &dtr);
     ~MyFeedView();
     void resetPutLatch(uint32_t count) { putLatch.reset(new vespalib::CountDownLatch(count)); }
@@ -218,6 +228,7 @@ struct MyFeedView : public test::DummyFeedView {
         }
         ++put_count;
         put_serial = putOp.getSerialNum();
+        logEvent(log, vespalib::make_string("put(%" PRIu64 ")", putOp.getSerialNum()));
         metaStore.allocate(putOp.getDocument()->getId().getGlobalId());
         if (putLatch.get() != NULL) {
             putLatch->countDown();
@@ -230,10 +241,14 @@ struct MyFeedView : public test::DummyFeedView {
     virtual void handleUpdate(FeedToken *token, const UpdateOperation &op) override {
         ++update_count;
         update_serial = op.getSerialNum();
+        logEvent(log, vespalib::make_string("update(%" PRIu64 ")", op.getSerialNum()));
+        ackToken(token);
+    }
+    virtual void handleRemove(FeedToken *token, const RemoveOperation &op) override {
+        ++remove_count;
+        logEvent(log, vespalib::make_string("remove(%" PRIu64 ")", op.getSerialNum()));
         ackToken(token);
     }
-    virtual void handleRemove(FeedToken *token, const RemoveOperation &) override
-    { ++remove_count; ackToken(token); }
     virtual void handleMove(const MoveOperation &, IDestructorCallback::SP) override { ++move_count; }
     virtual void heartBeat(SerialNum) override { ++heartbeat_count; }
     virtual void handlePruneRemovedDocuments(
@@ -256,7 +271,8 @@ MyFeedView::MyFeedView(const DocumentTypeRepo::SP &dtr)
       move_count(0),
       prune_removed_count(0),
       update_count(0),
-      update_serial(0)
+      update_serial(0),
+      log(nullptr)
 {}
 MyFeedView::~MyFeedView() {}
 
@@ -409,9 +425,14 @@ struct MyTlsWriter : TlsWriter {
     int store_count;
     int erase_count;
     bool erase_return;
+    EventLog *log;
 
-    MyTlsWriter() : store_count(0), erase_count(0), erase_return(true) {}
-    virtual void storeOperation(const FeedOperation &) override { ++store_count; }
+    MyTlsWriter() : store_count(0), erase_count(0), erase_return(true), log(nullptr) {}
+    virtual void storeOperation(const FeedOperation &op) override {
+        ++store_count;
+        logEvent(log, vespalib::make_string("store(%" PRIu64 ")", op.getSerialNum()));
+    }
+    virtual void commitBatch() override { logEvent(log, "commit"); }
     virtual bool erase(SerialNum) override { ++erase_count; return erase_return; }
 
     virtual SerialNum
@@ -473,6 +494,11 @@ struct FeedHandlerFixture
     void syncMaster() {
         writeService.master().sync();
     }
+    void handleBatch(FeedHandler::FeedOperationBatch batch) {
+        FeedTokenContext commitToken;
+        handler.handleOperations(commitToken.token, std::move(batch));
+        EXPECT_TRUE(commitToken.await());
+    }
 };
 
 
@@ -704,6 +730,83 @@ TEST_F("require that remove is NOT rejected if resource limit is reached", FeedH
     EXPECT_EQUAL("", token.getResult()->getErrorMessage());
 }
 
+struct BatchFixture : public FeedHandlerFixture
+{
+    EventLog log;
+    std::vector<std::unique_ptr<FeedTokenContext>> tokens;
+    FeedHandler::FeedOperationBatch batch;
+    BatchFixture()
+        : FeedHandlerFixture(),
+          log(),
+          tokens(),
+          batch()
+    {
+        feedView.log = &log;
+        tls_writer.log = &log;
+        handler.setSerialNum(10);
+        handler.changeToNormalFeedState();
+    }
+    ~BatchFixture();
+    FeedToken &addToken(uint32_t type) {
+        tokens.push_back(std::make_unique<FeedTokenContext>(type));
+        return tokens.back()->token;
+    }
+    void addPut(const vespalib::string &docId, Timestamp timestamp) {
+        DocumentContext docCtx(docId, *schema.builder);
+        batch.emplace_back(addToken(DocumentProtocol::REPLY_PUTDOCUMENT),
+                           std::make_unique<PutOperation>(docCtx.bucketId, timestamp, docCtx.doc));
+    }
+    void addRemove(const vespalib::string &docId, Timestamp timestamp) {
+        DocumentContext docCtx(docId, *schema.builder);
+        batch.emplace_back(addToken(DocumentProtocol::REPLY_REMOVEDOCUMENT),
+                           std::make_unique<RemoveOperation>(docCtx.bucketId, timestamp, docCtx.doc->getId()));
+    }
+    void setNewLid(const vespalib::string &docId, uint32_t lid) {
+        GlobalId gid = DocumentId(docId).getGlobalId();
+        feedView.metaStore.insert(gid, MyDocumentMetaStore::Entry(lid, 0, Timestamp(0))).allocate(gid);
+    }
+    vespalib::string handleBatch() {
+        FeedHandlerFixture::handleBatch(std::move(batch));
+        for (const auto &token : tokens) {
+            EXPECT_TRUE(token->await());
+        }
+        vespalib::string result;
+        for (const auto &event : log) {
+            result += (result.empty() ? "" : " ") + event;
+        }
+        return result;
+    }
+};
+
+BatchFixture::~BatchFixture() {}
+
+TEST_F("require that batched operations are stored before they are applied", BatchFixture)
+{
+    f.addPut("id:test:searchdocument::foo", Timestamp(10));
+    f.addRemove("id:test:searchdocument::bar", Timestamp(11));
+    f.addPut("id:test:searchdocument::baz", Timestamp(12));
+    EXPECT_EQUAL("store(11) store(12) store(13) commit put(11) remove(12) put(13)", f.handleBatch());
+}
+
+TEST_F("require that batch is committed before operation on document with pending operation", BatchFixture)
+{
+    f.addPut("id:test:searchdocument::foo", Timestamp(10));
+    f.addPut("id:test:searchdocument::bar", Timestamp(11));
+    f.addRemove("id:test:searchdocument::foo", Timestamp(12));
+    EXPECT_EQUAL("store(11) store(12) commit put(11) put(12) store(13) commit remove(13)", f.handleBatch());
+}
+
+TEST_F("require that batch is committed before operation given new lid of pending operation", BatchFixture)
+{
+    f.setNewLid("id:test:searchdocument::foo", 5);
+    f.setNewLid("id:test:searchdocument::bar", 6);
+    f.setNewLid("id:test:searchdocument::baz", 5);
+    f.addPut("id:test:searchdocument::foo", Timestamp(10));
+    f.addPut("id:test:searchdocument::bar", Timestamp(11));
+    f.addPut("id:test:searchdocument::baz", Timestamp(12));
+    EXPECT_EQUAL("store(11) store(12) commit put(11) put(12) store(13) commit put(13)", f.handleBatch());
+}
+
 }  // namespace
 
 TEST_MAIN()
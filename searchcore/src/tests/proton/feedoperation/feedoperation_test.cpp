@@ -306,13 +306,17 @@ TEST_F("require that we can serialize and deserialize put operations", Fixture)
         op.setDbDocumentId({1, 2});
         op.setPrevDbDocumentId({3, 4});
         EXPECT_EQUAL(0u, op.getSerializedDocSize());
+        EXPECT_TRUE(op.getSerializedDocument().get() == nullptr);
         op.serialize(stream);
         EXPECT_EQUAL(expSerializedDocSize, op.getSerializedDocSize());
+        ASSERT_TRUE(op.getSerializedDocument().get() != nullptr);
+        EXPECT_EQUAL(expSerializedDocSize, op.getSerializedDocument()->size());
     }
     {
         PutOperation op;
         op.deserialize(stream, *f._repo);
         EXPECT_EQUAL(*doc, *op.getDocument());
+        EXPECT_TRUE(op.getSerializedDocument().get() == nullptr);
         TEST_DO(assertDocumentOperation(op, bucket, expSerializedDocSize));
     }
 }
@@ -84,7 +84,7 @@ public:
           _fileHeaderContext(),
           _threadingService(),
           _ops(_fileHeaderContext,
-               TuneFileIndexManager(), 0,
+               TuneFileIndexManager(), 0, 1, 1024 * 1024 * 1024,
                _threadingService)
     {}
     ~Test() {}
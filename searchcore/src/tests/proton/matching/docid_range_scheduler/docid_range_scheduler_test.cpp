@@ -2,6 +2,7 @@
 
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/searchcore/proton/matching/docid_range_scheduler.h>
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
@@ -305,4 +306,90 @@ TEST_MT_FF("require that the adaptive scheduler handles fewer documents than thr
 
 //-----------------------------------------------------------------------------
 
+TEST("require that the work stealing scheduler starts each thread in its own part of the docid space") {
+    WorkStealingDocidRangeScheduler scheduler(4, 1, 16);
+    EXPECT_EQUAL(scheduler.unassigned_size(), 15u);
+    EXPECT_EQUAL(scheduler.first_range(0).begin, 1u);
+    EXPECT_EQUAL(scheduler.first_range(1).begin, 5u);
+    EXPECT_EQUAL(scheduler.first_range(2).begin, 9u);
+    EXPECT_EQUAL(scheduler.first_range(3).begin, 13u);
+    TEST_DO(verify_range(scheduler.total_span(0), DocidRange(1,16)));
+    TEST_DO(verify_range(scheduler.total_span(3), DocidRange(1,16)));
+    EXPECT_TRUE(scheduler.make_idle_observer().is_always_zero());
+}
+
+TEST("require that the work stealing scheduler respects the minimal task size") {
+    WorkStealingDocidRangeScheduler scheduler(1, 10, 101);
+    TEST_DO(verify_range(scheduler.first_range(0), DocidRange(1,11)));
+    EXPECT_EQUAL(scheduler.total_size(0), 10u);
+    EXPECT_EQUAL(scheduler.unassigned_size(), 90u);
+}
+
+TEST("require that the work stealing scheduler steals the back half of the remaining work of another thread") {
+    WorkStealingDocidRangeScheduler scheduler(2, 1, 21);
+    DocidRange range = scheduler.first_range(0);
+    while (range.end <= 11) {
+        range = scheduler.next_range(0);
+    }
+    EXPECT_EQUAL(range.begin, 16u);
+    EXPECT_EQUAL(scheduler.unassigned_size(), 5u + (21 - range.end));
+    for (range = scheduler.first_range(1); !range.empty(); range = scheduler.next_range(1)) {
+        EXPECT_TRUE(range.end <= 16u || range.begin >= 16u);
+    }
+    EXPECT_EQUAL(scheduler.total_size(0) + scheduler.total_size(1), 20u);
+    EXPECT_EQUAL(scheduler.unassigned_size(), 0u);
+}
+
+TEST("require that the work stealing scheduler gives out all work when a single thread does everything") {
+    WorkStealingDocidRangeScheduler scheduler(4, 3, 1000);
+    size_t assigned = 0;
+    for (DocidRange range = scheduler.first_range(2); !range.empty(); range = scheduler.next_range(2)) {
+        assigned += range.size();
+    }
+    EXPECT_EQUAL(assigned, 999u);
+    EXPECT_EQUAL(scheduler.total_size(2), 999u);
+    EXPECT_EQUAL(scheduler.unassigned_size(), 0u);
+}
+
+TEST_MT_FF("require that the work stealing scheduler assigns all docids exactly once",
+           4, WorkStealingDocidRangeScheduler(num_threads, 1, 100000), std::vector<std::vector<DocidRange>>(num_threads))
+{
+    for (DocidRange range = f1.first_range(thread_id); !range.empty(); range = f1.next_range(thread_id)) {
+        f2[thread_id].push_back(range);
+    }
+    TEST_BARRIER();
+    if (thread_id == 0) {
+        std::vector<DocidRange> all;
+        size_t total_size = 0;
+        for (size_t i = 0; i < num_threads; ++i) {
+            all.insert(all.end(), f2[i].begin(), f2[i].end());
+            total_size += f1.total_size(i);
+        }
+        std::sort(all.begin(), all.end(), [](const DocidRange &a, const DocidRange &b){ return (a.begin < b.begin); });
+        uint32_t next = 1;
+        for (const auto &range: all) {
+            EXPECT_EQUAL(range.begin, next);
+            next = range.end;
+        }
+        EXPECT_EQUAL(next, 100000u);
+        EXPECT_EQUAL(total_size, 99999u);
+        EXPECT_EQUAL(f1.unassigned_size(), 0u);
+    }
+}
+
+TEST_MT_FF("require that the work stealing scheduler handles fewer documents than threads",
+           4, WorkStealingDocidRangeScheduler(num_threads, 1, 3), TimeBomb(60))
+{
+    for (DocidRange docid_range = f1.first_range(thread_id);
+         !docid_range.empty();
+         docid_range = f1.next_range(thread_id))
+    {
+        EXPECT_TRUE(docid_range.size() == 1);
+    }
+    TEST_BARRIER();
+    EXPECT_EQUAL(f1.total_size(0) + f1.total_size(1) + f1.total_size(2) + f1.total_size(3), 2u);
+}
+
+//-----------------------------------------------------------------------------
+
 TEST_MAIN() { TEST_RUN_ALL(); }
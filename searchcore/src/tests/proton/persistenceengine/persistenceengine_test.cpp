@@ -169,6 +169,7 @@ struct MyHandler : public IPersistenceHandler, IBucketFreezer {
     const Document *document;
     std::multiset<uint64_t> frozen;
     std::multiset<uint64_t> was_frozen;
+    uint32_t batchCount;
 
     MyHandler()
         : initialized(false),
@@ -188,7 +189,8 @@ struct MyHandler : public IPersistenceHandler, IBucketFreezer {
           _createBucketResult(),
           document(0),
           frozen(),
-          was_frozen()
+          was_frozen(),
+          batchCount(0)
     {
     }
 
@@ -228,6 +230,26 @@ struct MyHandler : public IPersistenceHandler, IBucketFreezer {
         handle(token, bucket, timestamp, id);
     }
 
+    virtual void handleBatch(FeedToken commitToken, const Bucket& bucket,
+                             const std::vector<storage::spi::BatchOperation>& ops,
+                             const std::vector<FeedToken>& tokens) override {
+        ++batchCount;
+        for (size_t i = 0; i < ops.size(); ++i) {
+            switch (ops[i].getType()) {
+            case storage::spi::BatchOperation::PUT:
+                handlePut(tokens[i], bucket, ops[i].getTimestamp(), ops[i].getDocument());
+                break;
+            case storage::spi::BatchOperation::REMOVE:
+                handleRemove(tokens[i], bucket, ops[i].getTimestamp(), ops[i].getDocumentId());
+                break;
+            case storage::spi::BatchOperation::UPDATE:
+                handleUpdate(tokens[i], bucket, ops[i].getTimestamp(), ops[i].getUpdate());
+                break;
+            }
+        }
+        commitToken.ack();
+    }
+
     virtual void handleListBuckets(IBucketIdListResultHandler &resultHandler) override {
         resultHandler.handle(BucketIdListResult(bucketList));
     }
@@ -583,6 +605,61 @@ TEST_F("require that remove is NOT rejected if resource limit is reached", Simpl
 }
 
 
+TEST_F("require that batches are split per handler", SimpleFixture)
+{
+    storage::spi::LoadType loadType(0, "default");
+    Context context(loadType, storage::spi::Priority(0),
+                    storage::spi::Trace::TraceLevel(0));
+    using storage::spi::BatchOperation;
+    f.hset.handler2.setExistingTimestamp(tstamp3);
+    std::vector<BatchOperation> ops;
+    ops.push_back(BatchOperation::put(tstamp1, doc1));
+    ops.push_back(BatchOperation::update(tstamp2, upd2));
+    ops.push_back(BatchOperation::remove(tstamp2, docId1));
+    ops.push_back(BatchOperation::put(tstamp3, doc3));
+    ops.push_back(BatchOperation::remove(tstamp3, docId3));
+    storage::spi::BatchResult br = f.engine.applyBatch(bucket1, ops, context);
+    EXPECT_FALSE(br.hasError());
+    ASSERT_EQUAL(5u, br.getResults().size());
+    EXPECT_EQUAL(1u, f.hset.handler1.batchCount);
+    EXPECT_EQUAL(1u, f.hset.handler2.batchCount);
+    assertHandler(bucket1, tstamp2, docId1, f.hset.handler1);
+    assertHandler(bucket1, tstamp2, docId2, f.hset.handler2);
+    EXPECT_EQUAL(Result(), *br.getResults()[0]);
+    EXPECT_EQUAL(tstamp3, dynamic_cast<const UpdateResult &>(*br.getResults()[1]).getExistingTimestamp());
+    EXPECT_FALSE(dynamic_cast<const RemoveResult &>(*br.getResults()[2]).wasFound());
+    EXPECT_EQUAL(Result(Result::PERMANENT_ERROR, "No handler for document type 'type3'"),
+                 *br.getResults()[3]);
+    EXPECT_FALSE(dynamic_cast<const RemoveResult &>(*br.getResults()[4]).wasFound());
+}
+
+
+TEST_F("require that batched puts and updates are rejected if resource limit is reached", SimpleFixture)
+{
+    f._writeFilter._acceptWriteOperation = false;
+    f._writeFilter._message = "Disk is full";
+
+    storage::spi::LoadType loadType(0, "default");
+    Context context(loadType, storage::spi::Priority(0),
+                    storage::spi::Trace::TraceLevel(0));
+    using storage::spi::BatchOperation;
+    std::vector<BatchOperation> ops;
+    ops.push_back(BatchOperation::put(tstamp1, doc1));
+    ops.push_back(BatchOperation::update(tstamp1, upd1));
+    ops.push_back(BatchOperation::remove(tstamp1, docId1));
+    storage::spi::BatchResult br = f.engine.applyBatch(bucket1, ops, context);
+    ASSERT_EQUAL(3u, br.getResults().size());
+    EXPECT_EQUAL(Result(Result::RESOURCE_EXHAUSTED,
+                        "Put operation rejected for document 'id:type1:type1::1': 'Disk is full'"),
+                 *br.getResults()[0]);
+    EXPECT_EQUAL(Result(Result::RESOURCE_EXHAUSTED,
+                        "Update operation rejected for document 'id:type1:type1::1': 'Disk is full'"),
+                 *br.getResults()[1]);
+    EXPECT_EQUAL(RemoveResult(false), *br.getResults()[2]);
+    EXPECT_EQUAL(1u, f.hset.handler1.batchCount);
+}
+
+
 TEST_F("require that listBuckets() is routed to handlers and merged", SimpleFixture)
 {
     f.hset.handler1.bucketList.push_back(bckId1);
@@ -191,7 +191,7 @@ AttributeInitializer::loadAttribute(const AttributeVectorSP &attr,
     assert(attr->hasLoadData());
     fastos::TimeStamp startTime = fastos::ClockSystem::now();
     EventLogger::loadAttributeStart(_documentSubDbName, attr->getName());
-    if (!attr->load()) {
+    if (!attr->load(_loadExecutor)) {
         LOG(warning, "Could not load attribute vector '%s' from disk. "
                 "Returning empty attribute vector",
                 attr->getBaseFileName().c_str());
@@ -243,7 +243,8 @@ AttributeInitializer::AttributeInitializer(const std::shared_ptr<AttributeDirect
       _documentSubDbName(documentSubDbName),
       _spec(spec),
       _currentSerialNum(currentSerialNum),
-      _factory(factory)
+      _factory(factory),
+      _loadExecutor(nullptr)
 {
 }
 
@@ -12,6 +12,8 @@ namespace search {
 namespace attribute { class AttributeHeader; }
 }
 
+namespace vespalib { class Executor; }
+
 namespace proton {
 
 class AttributeDirectory;
@@ -32,6 +34,7 @@ private:
     const AttributeSpec             _spec;
     const uint64_t                  _currentSerialNum;
     const IAttributeFactory        &_factory;
+    vespalib::Executor             *_loadExecutor;
 
     AttributeVectorSP tryLoadAttribute() const;
 
@@ -52,6 +55,12 @@ public:
                          const IAttributeFactory &factory);
     ~AttributeInitializer();
 
+    /**
+     * Sets an executor used to split the loading of a large attribute
+     * vector into parallel tasks. Without it, loading is single threaded.
+     */
+    void setLoadExecutor(vespalib::Executor *executor) { _loadExecutor = executor; }
+
     AttributeInitializerResult init() const;
     uint64_t getCurrentSerialNum() const { return _currentSerialNum; }
 };
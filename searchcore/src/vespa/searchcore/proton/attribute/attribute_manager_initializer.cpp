@@ -96,12 +96,14 @@ private:
     InitializerTask::SP _documentMetaStoreInitTask;
     DocumentMetaStore::SP _documentMetaStore;
     InitializedAttributesResult &_attributesResult;
+    vespalib::Executor *_loadExecutor;
 
 public:
     AttributeInitializerTasksBuilder(InitializerTask &attrMgrInitTask,
                                      InitializerTask::SP documentMetaStoreInitTask,
                                      DocumentMetaStore::SP documentMetaStore,
-                                     InitializedAttributesResult &attributesResult);
+                                     InitializedAttributesResult &attributesResult,
+                                     vespalib::Executor *loadExecutor);
     ~AttributeInitializerTasksBuilder();
     void add(AttributeInitializer::UP initializer) override;
 };
@@ -109,17 +111,20 @@ public:
 AttributeInitializerTasksBuilder::AttributeInitializerTasksBuilder(InitializerTask &attrMgrInitTask,
                                                                    InitializerTask::SP documentMetaStoreInitTask,
                                                                    DocumentMetaStore::SP documentMetaStore,
-                                                                   InitializedAttributesResult &attributesResult)
+                                                                   InitializedAttributesResult &attributesResult,
+                                                                   vespalib::Executor *loadExecutor)
     : _attrMgrInitTask(attrMgrInitTask),
       _documentMetaStoreInitTask(documentMetaStoreInitTask),
       _documentMetaStore(documentMetaStore),
-      _attributesResult(attributesResult)
+      _attributesResult(attributesResult),
+      _loadExecutor(loadExecutor)
 { }
 
 AttributeInitializerTasksBuilder::~AttributeInitializerTasksBuilder() {}
 
 void
 AttributeInitializerTasksBuilder::add(AttributeInitializer::UP initializer) {
+    initializer->setLoadExecutor(_loadExecutor);
     InitializerTask::SP attributeInitTask =
             std::make_shared<AttributeInitializerTask>(std::move(initializer),
                                                        _documentMetaStore,
@@ -147,6 +152,7 @@ AttributeManagerInitializer::AttributeManagerInitializer(SerialNum configSerialN
                                                          size_t attributeGrowNumDocs,
                                                          bool fastAccessAttributesOnly,
                                                          searchcorespi::index::IThreadService &master,
+                                                         vespalib::Executor *loadExecutor,
                                                          std::shared_ptr<AttributeManager::SP> attrMgrResult)
     : _configSerialNum(configSerialNum),
       _documentMetaStore(documentMetaStore),
@@ -156,11 +162,12 @@ AttributeManagerInitializer::AttributeManagerInitializer(SerialNum configSerialN
       _attributeGrowNumDocs(attributeGrowNumDocs),
       _fastAccessAttributesOnly(fastAccessAttributesOnly),
       _master(master),
+      _loadExecutor(loadExecutor),
       _attributesResult(),
       _attrMgrResult(attrMgrResult)
 {
     addDependency(documentMetaStoreInitTask);
-    AttributeInitializerTasksBuilder tasksBuilder(*this, documentMetaStoreInitTask, documentMetaStore, _attributesResult);
+    AttributeInitializerTasksBuilder tasksBuilder(*this, documentMetaStoreInitTask, documentMetaStore, _attributesResult, _loadExecutor);
     AttributeCollectionSpec::UP attrSpec = createAttributeSpec();
     _attrMgr = std::make_shared<AttributeManager>(*baseAttrMgr, *attrSpec, tasksBuilder);
 }
@@ -6,6 +6,7 @@
 #include <vespa/eval/tensor/tensor.h>
 #include <vespa/eval/tensor/serialization/typed_binary_format.h>
 #include <vespa/vespalib/objects/nbostream.h>
+#include <vespa/vespalib/stllike/hash_map.hpp>
 #include <vespa/document/fieldvalue/tensorfieldvalue.h>
 #include <vespa/log/log.h>
 LOG_SETUP(".proton.docsummary.documentstoreadapter");
@@ -159,6 +160,32 @@ DocumentStoreAdapter::convertFromSearchDoc(Document &doc, uint32_t docId)
     }
 }
 
+namespace {
+
+class PrefetchVisitor : public search::IDocumentVisitor
+{
+public:
+    PrefetchVisitor(vespalib::hash_map<uint32_t, Document::UP> & prefetched) : _prefetched(prefetched) { }
+    void visit(uint32_t lid, Document::UP doc) override {
+        if (doc) {
+            _prefetched[lid] = std::move(doc);
+        }
+    }
+    bool allowVisitCaching() const override { return false; }
+private:
+    vespalib::hash_map<uint32_t, Document::UP> & _prefetched;
+};
+
+}
+
+void
+DocumentStoreAdapter::prefetch(const std::vector<uint32_t> & docIds)
+{
+    _prefetched.clear();
+    PrefetchVisitor visitor(_prefetched);
+    _docStore.readBatch(docIds, _repo, visitor);
+}
+
 DocumentStoreAdapter::
 DocumentStoreAdapter(const search::IDocumentStore & docStore,
                      const DocumentTypeRepo &repo,
@@ -175,7 +202,8 @@ DocumentStoreAdapter(const search::IDocumentStore & docStore,
                                              c_str()))),
       _resultPacker(&_resultConfig),
       _fieldCache(fieldCache),
-      _markupFields(markupFields)
+      _markupFields(markupFields),
+      _prefetched()
 {
 }
 
@@ -190,7 +218,14 @@ DocumentStoreAdapter::getMappedDocsum(uint32_t docId)
             _resultClass->GetClassName(), getSummaryClassId());
         return DocsumStoreValue();
     }
-    Document::UP document = _docStore.read(docId, _repo);
+    Document::UP document;
+    auto found = _prefetched.find(docId);
+    if (found != _prefetched.end()) {
+        document = std::move(found->second);
+        _prefetched.erase(found);
+    } else {
+        document = _docStore.read(docId, _repo);
+    }
     if (document.get() == NULL) {
         LOG(debug,
             "Did not find summary document for docId %u. "
@@ -33,9 +33,13 @@ PutOperation::serialize(vespalib::nbostream &os) const
 {
     assertValidBucketId(_doc->getId());
     DocumentOperation::serialize(os);
-    size_t oldSize = os.size();
-    _doc->serialize(os);
-    _serializedDocSize = os.size() - oldSize;
+    if ( ! _serializedDoc) {
+        auto docStream = std::make_shared<vespalib::nbostream>();
+        _doc->serialize(*docStream);
+        _serializedDoc = std::move(docStream);
+    }
+    os.write(_serializedDoc->peek(), _serializedDoc->size());
+    _serializedDocSize = _serializedDoc->size();
 }
 
 
@@ -44,6 +48,7 @@ PutOperation::deserialize(vespalib::nbostream &is,
                           const DocumentTypeRepo &repo)
 {
     DocumentOperation::deserialize(is, repo);
+    _serializedDoc.reset();
     size_t oldSize = is.size();
     _doc.reset(new Document(repo, is));
     _serializedDocSize = oldSize - is.size();
@@ -8,7 +8,9 @@ namespace proton {
 class PutOperation : public DocumentOperation
 {
     using DocumentSP = std::shared_ptr<document::Document>;
+    using SerializedDocumentSP = std::shared_ptr<const vespalib::nbostream>;
     DocumentSP _doc;
+    mutable SerializedDocumentSP _serializedDoc; // Set by serialize()
 
 public:
     PutOperation();
@@ -17,6 +19,12 @@ public:
                  const DocumentSP &doc);
     virtual ~PutOperation();
     const DocumentSP &getDocument() const { return _doc; }
+    /**
+     * The document as serialized to the transaction log, or empty if the
+     * operation has not been serialized. The document store reuses these
+     * bytes instead of serializing the document a second time.
+     */
+    const SerializedDocumentSP &getSerializedDocument() const { return _serializedDoc; }
     void assertValid() const;
     virtual void serialize(vespalib::nbostream &os) const override;
     virtual void deserialize(vespalib::nbostream &is,
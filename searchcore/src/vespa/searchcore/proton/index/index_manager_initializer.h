@@ -19,6 +19,8 @@ class IndexManagerInitializer :  public initializer::InitializerTask
     const searchcorespi::index::WarmupConfig    _warmupCfg;
     size_t                                      _maxFlushed;
     size_t                                      _cacheSize;
+    uint32_t                                    _fusionThreads;
+    uint64_t                                    _fusionMemoryLimit;
     const search::index::Schema                 _schema;
     search::SerialNum                           _serialNum;
     searchcorespi::IIndexManager::Reconfigurer &_reconfigurer;
@@ -34,6 +36,8 @@ public:
                             const searchcorespi::index::WarmupConfig & warmupCfg,
                             size_t maxFlushed,
                             size_t cacheSize,
+                            uint32_t fusionThreads,
+                            uint64_t fusionMemoryLimit,
                             const search::index::Schema &schema,
                             search::SerialNum serialNum,
                             searchcorespi::IIndexManager::Reconfigurer & reconfigurer,
@@ -27,10 +27,14 @@ namespace proton {
 IndexManager::MaintainerOperations::MaintainerOperations(const FileHeaderContext &fileHeaderContext,
                                                          const TuneFileIndexManager &tuneFileIndexManager,
                                                          size_t cacheSize,
+                                                         uint32_t fusionThreads,
+                                                         uint64_t fusionMemoryLimit,
                                                          searchcorespi::index::
                                                          IThreadingService &
                                                          threadingService)
     : _cacheSize(cacheSize),
+      _fusionThreads(fusionThreads),
+      _fusionMemoryLimit(fusionMemoryLimit),
       _fileHeaderContext(fileHeaderContext),
       _tuneFileIndexing(tuneFileIndexManager._indexing),
       _tuneFileSearch(tuneFileIndexManager._search),
@@ -74,7 +78,8 @@ IndexManager::MaintainerOperations::runFusion(const Schema &schema,
     const bool dynamic_k_doc_pos_occ_format = false;
     return Fusion::merge(schema, outputDir, sources, selectorArray,
                          dynamic_k_doc_pos_occ_format,
-                         _tuneFileIndexing, fileHeaderContext);
+                         _tuneFileIndexing, fileHeaderContext,
+                         _fusionThreads, _fusionMemoryLimit);
 }
 
 
@@ -82,6 +87,8 @@ IndexManager::IndexManager(const vespalib::string &baseDir,
                            const WarmupConfig & warmup,
                            const size_t maxFlushed,
                            const size_t cacheSize,
+                           uint32_t fusionThreads,
+                           uint64_t fusionMemoryLimit,
                            const Schema &schema,
                            SerialNum serialNum,
                            Reconfigurer &reconfigurer,
@@ -91,7 +98,7 @@ IndexManager::IndexManager(const vespalib::string &baseDir,
                            const search::TuneFileAttributes &tuneFileAttributes,
                            const search::common::FileHeaderContext &fileHeaderContext) :
     _operations(fileHeaderContext, tuneFileIndexManager, cacheSize,
-                threadingService),
+                fusionThreads, fusionMemoryLimit, threadingService),
     _maintainer(IndexMaintainerConfig(baseDir,
                                       warmup,
                                       maxFlushed,
@@ -20,6 +20,8 @@ public:
     class MaintainerOperations : public searchcorespi::index::IIndexMaintainerOperations {
     private:
         const size_t _cacheSize;
+        const uint32_t _fusionThreads;
+        const uint64_t _fusionMemoryLimit;
         const search::common::FileHeaderContext &_fileHeaderContext;
         const search::TuneFileIndexing _tuneFileIndexing;
         const search::TuneFileSearch _tuneFileSearch;
@@ -29,6 +31,8 @@ public:
         MaintainerOperations(const search::common::FileHeaderContext &fileHeaderContext,
                              const search::TuneFileIndexManager &tuneFileIndexManager,
                              size_t cacheSize,
+                             uint32_t fusionThreads,
+                             uint64_t fusionMemoryLimit,
                              searchcorespi::index::IThreadingService &
                              threadingService);
 
@@ -57,6 +61,8 @@ public:
                  const searchcorespi::index::WarmupConfig & warmup,
                  size_t maxFlushed,
                  size_t cacheSize,
+                 uint32_t fusionThreads,
+                 uint64_t fusionMemoryLimit,
                  const Schema &schema,
                  SerialNum serialNum,
                  Reconfigurer &reconfigurer,
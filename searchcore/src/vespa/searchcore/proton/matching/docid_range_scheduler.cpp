@@ -160,4 +160,149 @@ AdaptiveDocidRangeScheduler::share_range(size_t thread_id, DocidRange todo)
 
 //-----------------------------------------------------------------------------
 
+WorkStealingDocidRangeScheduler::Worker::Worker()
+    : lock(),
+      todo(),
+      todo_size(0),
+      cost(0.0),
+      assigned(0),
+      last(),
+      last_time()
+{
+}
+
+WorkStealingDocidRangeScheduler::Worker::~Worker() {}
+
+void
+WorkStealingDocidRangeScheduler::update_cost(Worker &worker, Clock::time_point now)
+{
+    if (!worker.last.empty()) {
+        double elapsed = std::chrono::duration<double>(now - worker.last_time).count();
+        double sample = (elapsed / worker.last.size());
+        double old_cost = worker.cost.load(std::memory_order_relaxed);
+        double new_cost = (old_cost > 0.0) ? (0.5 * old_cost + 0.5 * sample) : sample;
+        worker.cost.store(new_cost, std::memory_order_relaxed);
+    }
+}
+
+uint32_t
+WorkStealingDocidRangeScheduler::chunk_size(const Worker &worker, size_t todo) const
+{
+    double cost = worker.cost.load(std::memory_order_relaxed);
+    size_t wanted = (cost > 0.0)
+                    ? static_cast<size_t>(std::min(_chunk_time / cost, double(todo)))
+                    : (todo / 16);
+    wanted = std::max(wanted, size_t(_min_task));
+    if ((wanted + _min_task) > todo) {
+        // avoid leaving a tail that is too small to be worth scheduling
+        return todo;
+    }
+    return wanted;
+}
+
+DocidRange
+WorkStealingDocidRangeScheduler::take_own(size_t thread_id)
+{
+    Worker &worker = _workers[thread_id];
+    Guard guard(worker.lock);
+    if (worker.todo.empty()) {
+        return DocidRange();
+    }
+    uint32_t size = chunk_size(worker, worker.todo.size());
+    DocidRange range(worker.todo.begin, worker.todo.begin + size);
+    worker.todo.begin = range.end;
+    worker.todo_size.store(worker.todo.size(), std::memory_order_relaxed);
+    return range;
+}
+
+bool
+WorkStealingDocidRangeScheduler::steal(size_t thread_id)
+{
+    Worker &thief = _workers[thread_id];
+    double my_cost = thief.cost.load(std::memory_order_relaxed);
+    for (;;) {
+        size_t victim_id = _workers.size();
+        double max_work = 0.0;
+        for (size_t i = 0; i < _workers.size(); ++i) {
+            size_t todo = _workers[i].todo_size.load(std::memory_order_relaxed);
+            if ((i == thread_id) || (todo == 0)) {
+                continue;
+            }
+            double cost = _workers[i].cost.load(std::memory_order_relaxed);
+            double work = todo * ((cost > 0.0) ? cost : ((my_cost > 0.0) ? my_cost : 1.0));
+            if (work > max_work) {
+                max_work = work;
+                victim_id = i;
+            }
+        }
+        if (victim_id == _workers.size()) {
+            return false;
+        }
+        DocidRange loot;
+        {
+            Worker &victim = _workers[victim_id];
+            Guard guard(victim.lock);
+            if (victim.todo.empty()) {
+                continue; // someone else got there first
+            }
+            if (victim.todo.size() >= (2 * _min_task)) {
+                uint32_t mid = victim.todo.begin + (victim.todo.size() / 2);
+                loot = DocidRange(mid, victim.todo.end);
+                victim.todo.end = mid;
+            } else {
+                loot = victim.todo;
+                victim.todo = DocidRange(victim.todo.end, victim.todo.end);
+            }
+            victim.todo_size.store(victim.todo.size(), std::memory_order_relaxed);
+        }
+        Guard guard(thief.lock);
+        thief.todo = loot;
+        thief.todo_size.store(loot.size(), std::memory_order_relaxed);
+        return true;
+    }
+}
+
+WorkStealingDocidRangeScheduler::WorkStealingDocidRangeScheduler(size_t num_threads, uint32_t min_task,
+                                                                 uint32_t docid_limit, double chunk_time)
+    : _splitter(DocidRange(1, docid_limit), num_threads),
+      _min_task(std::max(1u, min_task)),
+      _chunk_time(chunk_time),
+      _workers(num_threads)
+{
+    for (size_t i = 0; i < num_threads; ++i) {
+        _workers[i].todo = _splitter.get(i);
+        _workers[i].todo_size.store(_workers[i].todo.size(), std::memory_order_relaxed);
+    }
+}
+
+WorkStealingDocidRangeScheduler::~WorkStealingDocidRangeScheduler() {}
+
+DocidRange
+WorkStealingDocidRangeScheduler::next_range(size_t thread_id)
+{
+    Worker &worker = _workers[thread_id];
+    Clock::time_point now = Clock::now();
+    update_cost(worker, now);
+    DocidRange range = take_own(thread_id);
+    while (range.empty() && steal(thread_id)) {
+        range = take_own(thread_id);
+    }
+    worker.assigned += range.size();
+    worker.last = range;
+    worker.last_time = now;
+    return range;
+}
+
+size_t
+WorkStealingDocidRangeScheduler::unassigned_size() const
+{
+    size_t sum = 0;
+    for (const Worker &worker: _workers) {
+        sum += worker.todo_size.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+//-----------------------------------------------------------------------------
+
 }
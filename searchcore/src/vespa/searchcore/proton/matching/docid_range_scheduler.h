@@ -8,6 +8,7 @@
 #include <condition_variable>
 #include <atomic>
 #include <algorithm>
+#include <chrono>
 #include <vector>
 
 namespace proton {
@@ -205,5 +206,54 @@ public:
     DocidRange share_range(size_t, DocidRange todo) override;
 };
 
+/**
+ * A work-stealing scheduler. Each worker starts out owning an equal
+ * part of the docid space, which it consumes from the front in
+ * chunks. A worker running out of work steals the back half of the
+ * remaining work of the worker that is estimated to be furthest from
+ * being done. The cost of matching a single docid is measured per
+ * worker (time between requests divided by the size of the previous
+ * chunk). It is used to size chunks so that each takes roughly
+ * 'chunk_time' seconds, and to weight the amount of work left when
+ * selecting a victim to steal from.
+ **/
+class WorkStealingDocidRangeScheduler : public DocidRangeScheduler
+{
+private:
+    using Clock = std::chrono::steady_clock;
+    using Guard = std::lock_guard<std::mutex>;
+    struct alignas(64) Worker {
+        std::mutex          lock;
+        DocidRange          todo; // owner takes from front, thieves from back
+        std::atomic<size_t> todo_size;
+        std::atomic<double> cost; // seconds per docid, 0.0 means unknown
+        size_t              assigned;
+        DocidRange          last;
+        Clock::time_point   last_time;
+        Worker();
+        ~Worker();
+    };
+    DocidRangeSplitter  _splitter;
+    uint32_t            _min_task;
+    double              _chunk_time;
+    std::vector<Worker> _workers;
+
+    VESPA_DLL_LOCAL void update_cost(Worker &worker, Clock::time_point now);
+    VESPA_DLL_LOCAL uint32_t chunk_size(const Worker &worker, size_t todo) const;
+    VESPA_DLL_LOCAL DocidRange take_own(size_t thread_id);
+    VESPA_DLL_LOCAL bool steal(size_t thread_id);
+public:
+    WorkStealingDocidRangeScheduler(size_t num_threads, uint32_t min_task, uint32_t docid_limit,
+                                    double chunk_time = 0.001);
+    ~WorkStealingDocidRangeScheduler();
+    DocidRange first_range(size_t thread_id) override { return next_range(thread_id); }
+    DocidRange next_range(size_t thread_id) override;
+    DocidRange total_span(size_t) const override { return _splitter.full_range(); }
+    size_t total_size(size_t thread_id) const override { return _workers[thread_id].assigned; }
+    size_t unassigned_size() const override;
+    IdleObserver make_idle_observer() const override { return IdleObserver(); }
+    DocidRange share_range(size_t, DocidRange todo) override { return todo; }
+};
+
 } // namespace proton::matching
 } // namespace proton
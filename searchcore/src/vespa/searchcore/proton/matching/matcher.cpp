@@ -265,8 +265,10 @@ Matcher::match(const SearchRequest &request,
         MatchMaster master;
         uint32_t numSearchPartitions = NumSearchPartitions::lookup(rankProperties,
                                                                    _rankSetup->getNumSearchPartitions());
+        bool workStealing = WorkStealing::lookup(rankProperties, _rankSetup->getWorkStealing());
         ResultProcessor::Result::UP result = master.match(params, limitedThreadBundle, *mtf, rp,
-                                                          _distributionKey, numSearchPartitions);
+                                                          _distributionKey, numSearchPartitions,
+                                                          workStealing);
         my_stats = MatchMaster::getStats(std::move(master));
         size_t estimate = std::min(static_cast<size_t>(metaStore.getCommittedDocIdLimit()),
                                    mtf->match_limiter().getDocIdSpaceEstimate());
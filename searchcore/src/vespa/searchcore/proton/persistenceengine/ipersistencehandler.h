@@ -55,6 +55,17 @@ public:
                               storage::spi::Timestamp timestamp,
                               const document::DocumentId &id) = 0;
 
+    /**
+     * Handles a sequence of puts, removes and updates in order. Each
+     * operation acks its own token, in the same order as the operations,
+     * while the commit token is acked when all of them have been written to
+     * the transaction log.
+     */
+    virtual void handleBatch(FeedToken commitToken,
+                             const storage::spi::Bucket &bucket,
+                             const std::vector<storage::spi::BatchOperation> &ops,
+                             const std::vector<FeedToken> &tokens) = 0;
+
     virtual void handleListBuckets(IBucketIdListResultHandler &resultHandler) = 0;
 
     virtual void handleSetClusterState(const storage::spi::ClusterState &calc,
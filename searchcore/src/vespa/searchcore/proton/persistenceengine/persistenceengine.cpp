@@ -7,6 +7,7 @@
 #include <vespa/documentapi/messagebus/messages/feedreply.h>
 #include <vespa/documentapi/messagebus/messages/removedocumentreply.h>
 #include <vespa/documentapi/messagebus/messages/updatedocumentreply.h>
+#include <vespa/messagebus/emptyreply.h>
 #include <vespa/vespalib/stllike/hash_set.h>
 #include <vespa/fastos/thread.h>
 
@@ -446,6 +447,138 @@ PersistenceEngine::update(const Bucket& b, Timestamp t, const DocumentUpdate::SP
 }
 
 
+namespace {
+
+struct HandlerBatch {
+    std::vector<storage::spi::BatchOperation> ops;
+    std::vector<FeedToken> tokens;
+};
+
+}
+
+PersistenceEngine::BatchResult
+PersistenceEngine::applyBatch(const Bucket& b, const std::vector<BatchOperation>& ops, Context&)
+{
+    IResourceWriteFilter::State writeState;
+    bool acceptWrites = _writeFilter.acceptWriteOperation();
+    if (!acceptWrites) {
+        writeState = _writeFilter.getAcceptState();
+        acceptWrites = writeState.acceptWriteOperation();
+    }
+    std::shared_lock<std::shared_timed_mutex> rguard(_rwMutex);
+    LOG(spam, "applyBatch(%s, %zu operations)", b.toString().c_str(), ops.size());
+
+    // Operations are grouped per handler. Each operation gets its own latch,
+    // which counts down once for every handler it is given to.
+    BatchResult::ResultList results(ops.size());
+    std::vector<std::unique_ptr<TransportLatch>> latches(ops.size());
+    std::map<IPersistenceHandler *, HandlerBatch> batches;
+    std::vector<IPersistenceHandler::SP> handlers;
+    std::vector<HandlerSnapshot::UP> snapshots;
+    for (size_t i = 0; i < ops.size(); ++i) {
+        const BatchOperation &op = ops[i];
+        switch (op.getType()) {
+        case BatchOperation::PUT:
+        {
+            const Document &doc = *op.getDocument();
+            if (!acceptWrites) {
+                results[i] = std::make_unique<Result>(Result::RESOURCE_EXHAUSTED,
+                        make_string("Put operation rejected for document '%s': '%s'",
+                                    doc.getId().toString().c_str(), writeState.message().c_str()));
+                break;
+            }
+            if (!doc.getId().hasDocType()) {
+                results[i] = std::make_unique<Result>(Result::PERMANENT_ERROR,
+                        make_string("Old id scheme not supported in elastic mode (%s)",
+                                    doc.getId().toString().c_str()));
+                break;
+            }
+            DocTypeName docType(doc.getType());
+            IPersistenceHandler::SP handler = getHandler(docType);
+            if (handler.get() == NULL) {
+                results[i] = std::make_unique<Result>(Result::PERMANENT_ERROR,
+                        make_string("No handler for document type '%s'", docType.toString().c_str()));
+                break;
+            }
+            latches[i] = std::make_unique<TransportLatch>(1);
+            HandlerBatch &batch = batches[handler.get()];
+            batch.ops.push_back(op);
+            batch.tokens.emplace_back(*latches[i], mbus::Reply::UP(new documentapi::FeedReply(
+                                              documentapi::DocumentProtocol::REPLY_PUTDOCUMENT)));
+            handlers.push_back(std::move(handler));
+            break;
+        }
+        case BatchOperation::REMOVE:
+        {
+            HandlerSnapshot::UP snap = getHandlerSnapshot(op.getDocumentId());
+            if (!snap.get()) {
+                results[i] = std::make_unique<RemoveResult>(false);
+                break;
+            }
+            latches[i] = std::make_unique<TransportLatch>(snap->size());
+            for (; snap->handlers().valid(); snap->handlers().next()) {
+                HandlerBatch &batch = batches[snap->handlers().get()];
+                batch.ops.push_back(op);
+                batch.tokens.emplace_back(*latches[i], Reply::UP(new RemoveDocumentReply));
+            }
+            snapshots.push_back(std::move(snap));
+            break;
+        }
+        case BatchOperation::UPDATE:
+        {
+            const DocumentUpdate &upd = *op.getUpdate();
+            if (!acceptWrites) {
+                results[i] = std::make_unique<UpdateResult>(Result::RESOURCE_EXHAUSTED,
+                        make_string("Update operation rejected for document '%s': '%s'",
+                                    upd.getId().toString().c_str(), writeState.message().c_str()));
+                break;
+            }
+            DocTypeName docType(upd.getType());
+            IPersistenceHandler::SP handler = getHandler(docType);
+            if (handler.get() == NULL) {
+                results[i] = std::make_unique<UpdateResult>(Result::PERMANENT_ERROR,
+                        make_string("No handler for document type '%s'", docType.toString().c_str()));
+                break;
+            }
+            latches[i] = std::make_unique<TransportLatch>(1);
+            HandlerBatch &batch = batches[handler.get()];
+            batch.ops.push_back(op);
+            batch.tokens.emplace_back(*latches[i], mbus::Reply::UP(new documentapi::UpdateDocumentReply()));
+            handlers.push_back(std::move(handler));
+            break;
+        }
+        }
+    }
+
+    // The results are not returned before every handler has written its
+    // part of the batch to the transaction log.
+    TransportLatch commitLatch(batches.size());
+    for (auto &entry : batches) {
+        FeedToken commitToken(commitLatch, Reply::UP(new mbus::EmptyReply()));
+        entry.first->handleBatch(commitToken, b, entry.second.ops, entry.second.tokens);
+    }
+    commitLatch.await();
+    for (size_t i = 0; i < ops.size(); ++i) {
+        if (!latches[i]) {
+            continue;
+        }
+        latches[i]->await();
+        switch (ops[i].getType()) {
+        case BatchOperation::PUT:
+            results[i] = std::make_unique<Result>(latches[i]->getResult());
+            break;
+        case BatchOperation::REMOVE:
+            results[i] = std::make_unique<RemoveResult>(latches[i]->getRemoveResult());
+            break;
+        case BatchOperation::UPDATE:
+            results[i] = std::make_unique<UpdateResult>(latches[i]->getUpdateResult());
+            break;
+        }
+    }
+    return BatchResult(std::move(results));
+}
+
+
 PersistenceEngine::GetResult
 PersistenceEngine::get(const Bucket& b,
                        const document::FieldSet& fields,
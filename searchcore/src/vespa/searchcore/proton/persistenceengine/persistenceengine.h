@@ -18,6 +18,8 @@ class PersistenceEngine : public storage::spi::AbstractPersistenceProvider {
 private:
     typedef vespalib::Sequence<IPersistenceHandler *> PersistenceHandlerSequence;
     using DocumentUpdate = document::DocumentUpdate;
+    using BatchOperation = storage::spi::BatchOperation;
+    using BatchResult = storage::spi::BatchResult;
     using Bucket = storage::spi::Bucket;
     using BucketIdListResult = storage::spi::BucketIdListResult;
     using BucketInfo = storage::spi::BucketInfo;
@@ -116,6 +118,7 @@ public:
     virtual Result put(const Bucket&, Timestamp, const document::Document::SP&, Context&) override;
     virtual RemoveResult remove(const Bucket&, Timestamp, const document::DocumentId&, Context&) override;
     virtual UpdateResult update(const Bucket&, Timestamp, const document::DocumentUpdate::SP&, Context&) override;
+    virtual BatchResult applyBatch(const Bucket&, const std::vector<BatchOperation>&, Context&) override;
     virtual GetResult get(const Bucket&, const document::FieldSet&, const document::DocumentId&, Context&) const override;
     virtual CreateIteratorResult createIterator(const Bucket&, const document::FieldSet&, const Selection&,
                                                 IncludedVersions, Context&) override;
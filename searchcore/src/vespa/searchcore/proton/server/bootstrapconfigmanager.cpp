@@ -70,6 +70,9 @@ BootstrapConfigManager::update(const ConfigSnapshot & snapshot)
         tune._summary._write.setFromConfig<ProtonConfig::Summary::Write>(conf.summary.write.io);
         tune._summary._seqRead.setFromConfig<ProtonConfig::Summary::Read>(conf.summary.read.io);
         tune._summary._randRead.setFromConfig<ProtonConfig::Summary::Read, ProtonConfig::Summary::Read::Mmap>(conf.summary.read.io, conf.summary.read.mmap);
+        if (conf.summary.read.io == ProtonConfig::Summary::Read::ASYNC) {
+            tune._summary._randRead.setWantAsyncIO();
+        }
 
         newProtonConfig = ProtonConfigSP(protonConfig.release());
         newTuneFileDocumentDB = tuneFileDocumentDB;
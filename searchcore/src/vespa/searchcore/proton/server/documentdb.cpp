@@ -278,7 +278,7 @@ DocumentDB::initManagers()
     _initConfigSnapshot.reset();
     InitializerTask::SP rootTask =
         _subDBs.createInitializer(*configSnapshot, _initConfigSerialNum,
-                                  _protonSummaryCfg, _protonIndexCfg);
+                                  _protonSummaryCfg, _protonIndexCfg, *_initializeThreads);
     InitializeThreads initializeThreads = _initializeThreads;
     _initializeThreads.reset();
     std::shared_ptr<TaskRunner> taskRunner(std::make_shared<TaskRunner>(*initializeThreads));
@@ -170,7 +170,8 @@ initializer::InitializerTask::SP
 DocumentSubDBCollection::createInitializer(const DocumentDBConfig &configSnapshot,
                                            SerialNum configSerialNum,
                                            const ProtonConfig::Summary & protonSummaryCfg,
-                                           const ProtonConfig::Index & indexCfg)
+                                           const ProtonConfig::Index & indexCfg,
+                                           vespalib::Executor &initializeExecutor)
 {
     DocumentSubDbCollectionInitializer::SP task =
         std::make_shared<DocumentSubDbCollectionInitializer>();
@@ -179,7 +180,8 @@ DocumentSubDBCollection::createInitializer(const DocumentDBConfig &configSnapsho
             subTask(subDb->createInitializer(configSnapshot,
                                              configSerialNum,
                                              protonSummaryCfg,
-                                             indexCfg));
+                                             indexCfg,
+                                             initializeExecutor));
         task->add(subTask);
     }
     return task;
@@ -10,6 +10,7 @@
 
 namespace vespalib {
     class Clock;
+    class Executor;
     class ThreadExecutor;
     class ThreadStackExecutorBase;
 }
@@ -127,7 +128,8 @@ public:
     createInitializer(const DocumentDBConfig &configSnapshot,
                       SerialNum configSerialNum,
                       const vespa::config::search::core::ProtonConfig::Summary &protonSummaryCfg,
-                      const vespa::config::search::core::ProtonConfig::Index & indexCfg);
+                      const vespa::config::search::core::ProtonConfig::Index & indexCfg,
+                      vespalib::Executor &initializeExecutor);
 
     void
     initViews(const DocumentDBConfig &configSnapshot,
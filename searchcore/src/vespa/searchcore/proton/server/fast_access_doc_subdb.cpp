@@ -63,6 +63,7 @@ FastAccessDocSubDB::createAttributeManagerInitializer(const DocumentDBConfig &co
                                                       SerialNum configSerialNum,
                                                       InitializerTask::SP documentMetaStoreInitTask,
                                                       DocumentMetaStore::SP documentMetaStore,
+                                                      vespalib::Executor &initializeExecutor,
                                                       std::shared_ptr<AttributeManager::SP> attrMgrResult) const
 {
     IAttributeFactory::SP attrFactory = std::make_shared<AttributeFactory>();
@@ -83,6 +84,7 @@ FastAccessDocSubDB::createAttributeManagerInitializer(const DocumentDBConfig &co
                                                          _attributeGrowNumDocs,
                                                          _fastAccessAttributesOnly,
                                                          _writeService.master(),
+                                                         &initializeExecutor,
                                                          attrMgrResult);
 }
 
@@ -218,13 +220,16 @@ DocumentSubDbInitializer::UP
 FastAccessDocSubDB::createInitializer(const DocumentDBConfig &configSnapshot,
                                       SerialNum configSerialNum,
                                       const vespa::config::search::core::ProtonConfig::Summary &protonSummaryCfg,
-                                      const vespa::config::search::core::ProtonConfig::Index &indexCfg) const
+                                      const vespa::config::search::core::ProtonConfig::Index &indexCfg,
+                                      vespalib::Executor &initializeExecutor) const
 {
-    auto result = Parent::createInitializer(configSnapshot, configSerialNum, protonSummaryCfg, indexCfg);
+    auto result = Parent::createInitializer(configSnapshot, configSerialNum, protonSummaryCfg, indexCfg,
+                                            initializeExecutor);
     auto attrMgrInitTask = createAttributeManagerInitializer(configSnapshot,
                                                              configSerialNum,
                                                              result->getDocumentMetaStoreInitTask(),
                                                              result->result().documentMetaStore()->documentMetaStore(),
+                                                             initializeExecutor,
                                                              result->writableResult().writableAttributeManager());
     result->addDependency(attrMgrInitTask);
     return result;
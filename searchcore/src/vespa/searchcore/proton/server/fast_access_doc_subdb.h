@@ -75,6 +75,7 @@ private:
                                       SerialNum configSerialNum,
                                       std::shared_ptr<initializer::InitializerTask> documentMetaStoreInitTask,
                                       DocumentMetaStore::SP documentMetaStore,
+                                      vespalib::Executor &initializeExecutor,
                                       std::shared_ptr<AttributeManager::SP> attrMgrResult) const;
 
     void setupAttributeManager(AttributeManager::SP attrMgrResult);
@@ -106,7 +107,8 @@ public:
     createInitializer(const DocumentDBConfig &configSnapshot,
                       SerialNum configSerialNum,
                       const ProtonConfig::Summary &protonSummaryCfg,
-                      const ProtonConfig::Index &indexCfg) const override;
+                      const ProtonConfig::Index &indexCfg,
+                      vespalib::Executor &initializeExecutor) const override;
 
     void setup(const DocumentSubDbInitializerResult &initResult) override;
 
@@ -17,8 +17,10 @@
 #include <vespa/searchcore/proton/persistenceengine/transport_latch.h>
 #include <vespa/searchcorespi/index/ithreadingservice.h>
 #include <vespa/searchlib/common/idestructorcallback.h>
+#include <vespa/vespalib/stllike/hash_set.hpp>
 #include <vespa/vespalib/util/closuretask.h>
 #include <vespa/vespalib/util/exceptions.h>
+#include <algorithm>
 #include <unistd.h>
 
 #include <vespa/log/log.h>
@@ -78,11 +80,49 @@ ignoreOperation(const DocumentOperation &op)
 }
 
 
+const document::GlobalId *
+findGlobalId(const FeedOperation &op)
+{
+    switch (op.getType()) {
+    case FeedOperation::PUT:
+        return &static_cast<const PutOperation &>(op).getDocument()->getId().getGlobalId();
+    case FeedOperation::REMOVE:
+        return &static_cast<const RemoveOperation &>(op).getDocumentId().getGlobalId();
+    case FeedOperation::UPDATE_42:
+    case FeedOperation::UPDATE:
+        return &static_cast<const UpdateOperation &>(op).getUpdate()->getId().getGlobalId();
+    default:
+        return nullptr;
+    }
+}
+
+
 }  // namespace
 
 
 void FeedHandler::TlsMgrWriter::storeOperation(const FeedOperation &op) {
-    TlcProxy(*_tls_mgr.getSession(), _tlsDirectWriter).storeOperation(op);
+    if (!_batch) {
+        TlcProxy(*_tls_mgr.getSession(), _tlsDirectWriter).storeOperation(op);
+        return;
+    }
+    if (!TlcProxy::addOperation(*_batch, op)) {
+        // Packet is full, write what we have and continue in a new one.
+        _batch->close();
+        TlcProxy(*_tls_mgr.getSession(), _tlsDirectWriter).commit(*_batch);
+        _batch->clear();
+        TlcProxy::addOperation(*_batch, op);
+    }
+}
+void FeedHandler::TlsMgrWriter::startBatch() {
+    assert(!_batch);
+    _batch = std::make_unique<Packet>();
+}
+void FeedHandler::TlsMgrWriter::commitBatch() {
+    std::unique_ptr<Packet> batch(std::move(_batch));
+    if (batch && !batch->empty()) {
+        batch->close();
+        TlcProxy(*_tls_mgr.getSession(), _tlsDirectWriter).commit(*batch);
+    }
 }
 bool FeedHandler::TlsMgrWriter::erase(SerialNum oldest_to_keep) {
     return _tls_mgr.getSession()->erase(oldest_to_keep);
@@ -126,9 +166,94 @@ FeedHandler::doHandleOperation(FeedToken token, FeedOperation::UP op)
     _feedState->handleOperation(token, std::move(op));
 }
 
+void
+FeedHandler::doHandleOperations(FeedToken commitToken, FeedOperationBatch ops)
+{
+    assert(_writeService.master().isCurrentThread());
+    vespalib::LockGuard guard(_feedLock);
+    if (_feedState->getType() != FeedState::NORMAL) {
+        for (auto &entry : ops) {
+            _feedState->handleOperation(entry.first, std::move(entry.second));
+        }
+        commitToken.ack();
+        return;
+    }
+    // The operations stay owned by ops until their deferred feed view
+    // changes have been applied below.
+    _tlsWriter.startBatch();
+    _deferApply = true;
+    try {
+        for (auto &entry : ops) {
+            const document::GlobalId *gid = findGlobalId(*entry.second);
+            assert(gid != nullptr);
+            if (_pendingGids.find(*gid) != _pendingGids.end()) {
+                // Prepare must see the effect of the earlier operation.
+                commitPendingOperations();
+            }
+            performOperation(std::make_unique<FeedToken>(entry.first), *entry.second);
+            _pendingGids.insert(*gid);
+        }
+    } catch (...) {
+        _deferApply = false;
+        commitPendingOperations();
+        throw;
+    }
+    _deferApply = false;
+    commitPendingOperations();
+    commitToken.ack();
+}
+
+void
+FeedHandler::applyToFeedView(std::function<void()> apply)
+{
+    if (_deferApply) {
+        _pendingApplies.push_back(std::move(apply));
+    } else {
+        apply();
+    }
+}
+
+bool
+FeedHandler::reserveNewLid(const DocumentOperation &op)
+{
+    if (!_deferApply || !op.getValidDbdId() ||
+        (op.getValidPrevDbdId() && op.getSubDbId() == op.getPrevSubDbId())) {
+        return true;
+    }
+    // The lid is only peeked at by prepare, so operations prepared before
+    // the first one is applied are given the same lid.
+    const DbDocumentId newId(op.getDbDocumentId());
+    if (std::find(_pendingNewIds.begin(), _pendingNewIds.end(), newId) != _pendingNewIds.end()) {
+        return false;
+    }
+    _pendingNewIds.push_back(newId);
+    return true;
+}
+
+void
+FeedHandler::commitPendingOperations()
+{
+    _tlsWriter.commitBatch();
+    std::vector<std::function<void()>> applies;
+    applies.swap(_pendingApplies);
+    _pendingGids.clear();
+    _pendingNewIds.clear();
+    for (auto &apply : applies) {
+        apply();
+    }
+    if (_deferApply) {
+        _tlsWriter.startBatch();
+    }
+}
+
 void FeedHandler::performPut(FeedToken::UP token, PutOperation &op) {
     op.assertValid();
     _activeFeedView->preparePut(op);
+    if (!reserveNewLid(op)) {
+        commitPendingOperations();
+        _activeFeedView->preparePut(op);
+        reserveNewLid(op);
+    }
     if (ignoreOperation(op)) {
         LOG(debug, "performPut(): ignoreOperation: docId(%s), "
             "timestamp(%" PRIu64 "), prevTimestamp(%" PRIu64 ")",
@@ -159,7 +284,8 @@ void FeedHandler::performPut(FeedToken::UP token, PutOperation &op) {
                                  op.getPrevLid()));
         }
     }
-    _activeFeedView->handlePut(token.get(), op);
+    std::shared_ptr<FeedToken> sharedToken(std::move(token));
+    applyToFeedView([this, sharedToken, &op]() { _activeFeedView->handlePut(sharedToken.get(), op); });
 }
 
 
@@ -212,7 +338,8 @@ FeedHandler::performInternalUpdate(FeedToken::UP token, UpdateOperation &op)
         }
         setUpdateWasFound(token->getReply(), true);
     }
-    _activeFeedView->handleUpdate(token.get(), op);
+    std::shared_ptr<FeedToken> sharedToken(std::move(token));
+    applyToFeedView([this, sharedToken, &op]() { _activeFeedView->handleUpdate(sharedToken.get(), op); });
 }
 
 
@@ -222,37 +349,50 @@ FeedHandler::createNonExistingDocument(FeedToken::UP token, const UpdateOperatio
     Document::SP doc(new Document(op.getUpdate()->getType(), op.getUpdate()->getId()));
     doc->setRepo(*_activeFeedView->getDocumentTypeRepo());
     op.getUpdate()->applyTo(*doc);
-    PutOperation putOp(op.getBucketId(), op.getTimestamp(), doc);
-    _activeFeedView->preparePut(putOp);
-    storeOperation(putOp);
+    auto putOp = std::make_shared<PutOperation>(op.getBucketId(), op.getTimestamp(), doc);
+    _activeFeedView->preparePut(*putOp);
+    if (!reserveNewLid(*putOp)) {
+        commitPendingOperations();
+        _activeFeedView->preparePut(*putOp);
+        reserveNewLid(*putOp);
+    }
+    storeOperation(*putOp);
     if (token.get() != NULL) {
-        token->setResult(ResultUP(new UpdateResult(putOp.getTimestamp())), true);
+        token->setResult(ResultUP(new UpdateResult(putOp->getTimestamp())), true);
         if (token->shouldTrace(1)) {
-            const document::DocumentId &docId = putOp.getDocument()->getId();
+            const document::DocumentId &docId = putOp->getDocument()->getId();
             const document::GlobalId &gid = docId.getGlobalId();
             token->trace(1, make_string("Creating non-existing document '%s' for update (gid='%s',"
                                      " lid= %u,%u' prevlid='%u,%u').",
                                      docId.toString().c_str(),
                                      gid.toString().c_str(),
-                                     putOp.getSubDbId(),
-                                     putOp.getLid(),
-                                     putOp.getPrevSubDbId(),
-                                     putOp.getPrevLid()));
+                                     putOp->getSubDbId(),
+                                     putOp->getLid(),
+                                     putOp->getPrevSubDbId(),
+                                     putOp->getPrevLid()));
         }
         setUpdateWasFound(token->getReply(), true);
     }
-    TransportLatch latch(1);
-    FeedToken putToken(latch, mbus::Reply::UP(new FeedReply(DocumentProtocol::REPLY_PUTDOCUMENT)));
-    _activeFeedView->handlePut(&putToken, putOp);
-    latch.await();
-    if (token.get() != NULL) {
-        token->ack();
-    }
+    std::shared_ptr<FeedToken> sharedToken(std::move(token));
+    applyToFeedView([this, sharedToken, putOp]() {
+        TransportLatch latch(1);
+        FeedToken putToken(latch, mbus::Reply::UP(new FeedReply(DocumentProtocol::REPLY_PUTDOCUMENT)));
+        _activeFeedView->handlePut(&putToken, *putOp);
+        latch.await();
+        if (sharedToken) {
+            sharedToken->ack();
+        }
+    });
 }
 
 
 void FeedHandler::performRemove(FeedToken::UP token, RemoveOperation &op) {
     _activeFeedView->prepareRemove(op);
+    if (!reserveNewLid(op)) {
+        commitPendingOperations();
+        _activeFeedView->prepareRemove(op);
+        reserveNewLid(op);
+    }
     if (ignoreOperation(op)) {
         LOG(debug, "performRemove(): ignoreOperation: docId(%s), "
             "timestamp(%" PRIu64 "), prevTimestamp(%" PRIu64 ")",
@@ -289,7 +429,8 @@ void FeedHandler::performRemove(FeedToken::UP token, RemoveOperation &op) {
             }
             setRemoveWasFound(token->getReply(), documentWasFound);
         }
-        _activeFeedView->handleRemove(token.get(), op);
+        std::shared_ptr<FeedToken> sharedToken(std::move(token));
+        applyToFeedView([this, sharedToken, &op]() { _activeFeedView->handleRemove(sharedToken.get(), op); });
     } else if (op.hasDocType()) {
         assert(op.getDocType() == _docTypeName.getName());
         storeOperation(op);
@@ -304,7 +445,8 @@ void FeedHandler::performRemove(FeedToken::UP token, RemoveOperation &op) {
             }
             setRemoveWasFound(token->getReply(), false);
         }
-        _activeFeedView->handleRemove(token.get(), op);
+        std::shared_ptr<FeedToken> sharedToken(std::move(token));
+        applyToFeedView([this, sharedToken, &op]() { _activeFeedView->handleRemove(sharedToken.get(), op); });
     } else {
         if (token.get() != NULL) {
             token->setResult(ResultUP(new RemoveResult(false)), false);
@@ -512,7 +654,11 @@ FeedHandler::FeedHandler(IThreadingService &writeService,
       _metrics(metrics),
       _syncLock(),
       _syncedSerialNum(0),
-      _allowSync(false)
+      _allowSync(false),
+      _deferApply(false),
+      _pendingApplies(),
+      _pendingGids(),
+      _pendingNewIds()
 {
 }
 
@@ -684,34 +830,40 @@ FeedHandler::considerWriteOperationForRejection(FeedToken *token, const FeedOper
 void
 FeedHandler::performOperation(FeedToken::UP token, FeedOperation::UP op)
 {
-    if (considerWriteOperationForRejection(token.get(), *op)) {
+    performOperation(std::move(token), *op);
+}
+
+void
+FeedHandler::performOperation(FeedToken::UP token, FeedOperation &op)
+{
+    if (considerWriteOperationForRejection(token.get(), op)) {
         return;
     }
-    switch(op->getType()) {
+    switch(op.getType()) {
     case FeedOperation::PUT:
-        performPut(std::move(token), static_cast<PutOperation &>(*op));
+        performPut(std::move(token), static_cast<PutOperation &>(op));
         return;
     case FeedOperation::REMOVE:
-        performRemove(std::move(token), static_cast<RemoveOperation &>(*op));
+        performRemove(std::move(token), static_cast<RemoveOperation &>(op));
         return;
     case FeedOperation::UPDATE_42:
     case FeedOperation::UPDATE:
-        performUpdate(std::move(token), static_cast<UpdateOperation &>(*op));
+        performUpdate(std::move(token), static_cast<UpdateOperation &>(op));
         return;
     case FeedOperation::DELETE_BUCKET:
-        performDeleteBucket(std::move(token), static_cast<DeleteBucketOperation &>(*op));
+        performDeleteBucket(std::move(token), static_cast<DeleteBucketOperation &>(op));
         return;
     case FeedOperation::SPLIT_BUCKET:
-        performSplit(std::move(token), static_cast<SplitBucketOperation &>(*op));
+        performSplit(std::move(token), static_cast<SplitBucketOperation &>(op));
         return;
     case FeedOperation::JOIN_BUCKETS:
-        performJoin(std::move(token), static_cast<JoinBucketsOperation &>(*op));
+        performJoin(std::move(token), static_cast<JoinBucketsOperation &>(op));
         return;
     case FeedOperation::WIPE_HISTORY:
         performGarbageCollect(std::move(token));
         return;
     case FeedOperation::CREATE_BUCKET:
-        performCreateBucket(std::move(token), static_cast<CreateBucketOperation &>(*op));
+        performCreateBucket(std::move(token), static_cast<CreateBucketOperation &>(op));
         return;
     default:
         assert(!"Illegal operation type");
@@ -726,6 +878,14 @@ FeedHandler::handleOperation(FeedToken token, FeedOperation::UP op)
                                  &FeedHandler::doHandleOperation, token, std::move(op))));
 }
 
+void
+FeedHandler::handleOperations(FeedToken commitToken, FeedOperationBatch ops)
+{
+    _writeService.master().execute(
+            makeTask(makeClosure(this,
+                                 &FeedHandler::doHandleOperations, commitToken, std::move(ops))));
+}
+
 void
 FeedHandler::handleMove(MoveOperation &op, std::shared_ptr<search::IDestructorCallback> moveDoneCtx)
 {
@@ -10,8 +10,12 @@
 #include "tlswriter.h"
 #include "transactionlogmanager.h"
 #include <persistence/spi/types.h>
+#include <vespa/document/base/globalid.h>
+#include <vespa/searchcore/proton/common/dbdocumentid.h>
 #include <vespa/searchcore/proton/common/doctypename.h>
 #include <vespa/searchlib/transactionlog/translogclient.h>
+#include <vespa/vespalib/stllike/hash_set.h>
+#include <functional>
 
 namespace searchcorespi { namespace index { class IThreadingService; } }
 
@@ -20,6 +24,7 @@ class ConfigStore;
 class CreateBucketOperation;
 class DDBState;
 class DeleteBucketOperation;
+class DocumentOperation;
 class FeedConfigStore;
 class FeedState;
 class FeedToken;
@@ -53,6 +58,9 @@ class FeedHandler: private search::transactionlog::TransLogClient::Session::Call
                    public IOperationStorer,
                    public IGetSerialNum
 {
+public:
+    using FeedOperationBatch = std::vector<std::pair<FeedToken, std::unique_ptr<FeedOperation>>>;
+
 private:
     typedef search::transactionlog::Packet  Packet;
     typedef search::transactionlog::RPC     RPC;
@@ -66,13 +74,17 @@ private:
     class TlsMgrWriter : public TlsWriter {
         TransactionLogManager &_tls_mgr;
         search::transactionlog::Writer *_tlsDirectWriter;
+        std::unique_ptr<Packet> _batch;
     public:
         TlsMgrWriter(TransactionLogManager &tls_mgr,
                      search::transactionlog::Writer * tlsDirectWriter) :
             _tls_mgr(tls_mgr),
-            _tlsDirectWriter(tlsDirectWriter)
+            _tlsDirectWriter(tlsDirectWriter),
+            _batch()
         { }
         virtual void storeOperation(const FeedOperation &op) override;
+        virtual void startBatch() override;
+        virtual void commitBatch() override;
         virtual bool erase(SerialNum oldest_to_keep) override;
 
         virtual SerialNum
@@ -104,12 +116,37 @@ private:
     vespalib::Lock                         _syncLock;
     SerialNum                              _syncedSerialNum; 
     bool                                   _allowSync; // Sanity check
+    // While a batch is handled, operations are stored in the open transaction
+    // log packet and their feed view changes wait until it is committed.
+    bool                                   _deferApply;
+    std::vector<std::function<void()>>     _pendingApplies;
+    vespalib::hash_set<document::GlobalId, document::GlobalId::hash> _pendingGids;
+    std::vector<DbDocumentId>              _pendingNewIds;
 
     /**
      * Delayed handling of feed operations, in master write thread.
      * The current feed state is sampled here.
      */
     void doHandleOperation(FeedToken token, FeedOperationUP op);
+    void doHandleOperations(FeedToken commitToken, FeedOperationBatch ops);
+
+    /**
+     * Applies the feed view change of a stored operation, or defers it until
+     * the open batch has been committed to the transaction log.
+     */
+    void applyToFeedView(std::function<void()> apply);
+
+    /**
+     * Returns false if the prepared operation was given the same new lid as
+     * an operation in the open batch that has not been applied yet.
+     */
+    bool reserveNewLid(const DocumentOperation &op);
+
+    /**
+     * Commits the open batch to the transaction log, then applies the
+     * deferred feed view changes of its operations in order.
+     */
+    void commitPendingOperations();
 
     bool considerWriteOperationForRejection(FeedToken *token, const FeedOperation &op);
 
@@ -125,6 +162,7 @@ private:
 
     void performRemove(FeedTokenUP token, RemoveOperation &op);
 private:
+    void performOperation(FeedTokenUP token, FeedOperation &op);
     void performGarbageCollect(FeedTokenUP token);
 
     void
@@ -275,6 +313,13 @@ public:
     void performOperation(FeedTokenUP token, FeedOperationUP op);
     void handleOperation(FeedToken token, FeedOperationUP op);
 
+    /**
+     * Handles the given operations in order as one task in the master thread,
+     * and stores them together in the transaction log. The commit token is
+     * acked when all the operations have been stored.
+     */
+    void handleOperations(FeedToken commitToken, FeedOperationBatch ops);
+
     /**
      * Implements IDocumentMoveHandler
      */
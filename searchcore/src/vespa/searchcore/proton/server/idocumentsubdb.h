@@ -14,6 +14,8 @@ namespace search::index {
 
 namespace document { class DocumentId; }
 
+namespace vespalib { class Executor; }
+
 namespace searchcorespi {
     class IFlushTarget;
     class IIndexManager;
@@ -66,7 +68,8 @@ public:
 
     virtual std::unique_ptr<DocumentSubDbInitializer>
     createInitializer(const DocumentDBConfig &configSnapshot, SerialNum configSerialNum,
-                      const ProtonConfig::Summary &protonSummaryCfg, const ProtonConfig::Index &indexCfg) const = 0;
+                      const ProtonConfig::Summary &protonSummaryCfg, const ProtonConfig::Index &indexCfg,
+                      vespalib::Executor &initializeExecutor) const = 0;
 
     // Called by master thread
     virtual void setup(const DocumentSubDbInitializerResult &initResult) = 0;
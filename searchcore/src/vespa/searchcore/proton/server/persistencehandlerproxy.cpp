@@ -12,6 +12,7 @@
 #include <vespa/searchcore/proton/feedoperation/updateoperation.h>
 #include <vespa/persistence/spi/result.h>
 
+using storage::spi::BatchOperation;
 using storage::spi::Bucket;
 using storage::spi::Timestamp;
 
@@ -72,6 +73,34 @@ PersistenceHandlerProxy::handleRemove(FeedToken token,
     _feedHandler.handleOperation(token, std::move(op));
 }
 
+void
+PersistenceHandlerProxy::handleBatch(FeedToken commitToken,
+                                     const Bucket &bucket,
+                                     const std::vector<BatchOperation> &ops,
+                                     const std::vector<FeedToken> &tokens)
+{
+    document::BucketId bucketId(bucket.getBucketId().stripUnused());
+    FeedHandler::FeedOperationBatch batch;
+    batch.reserve(ops.size());
+    for (size_t i = 0; i < ops.size(); ++i) {
+        const BatchOperation &op = ops[i];
+        FeedOperation::UP feedOp;
+        switch (op.getType()) {
+        case BatchOperation::PUT:
+            feedOp.reset(new PutOperation(bucketId, op.getTimestamp(), op.getDocument()));
+            break;
+        case BatchOperation::REMOVE:
+            feedOp.reset(new RemoveOperation(bucketId, op.getTimestamp(), op.getDocumentId()));
+            break;
+        case BatchOperation::UPDATE:
+            feedOp.reset(new UpdateOperation(bucketId, op.getTimestamp(), op.getUpdate()));
+            break;
+        }
+        batch.emplace_back(tokens[i], std::move(feedOp));
+    }
+    _feedHandler.handleOperations(commitToken, std::move(batch));
+}
+
 void
 PersistenceHandlerProxy::handleListBuckets(IBucketIdListResultHandler &resultHandler)
 {
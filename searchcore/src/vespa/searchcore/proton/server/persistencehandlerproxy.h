@@ -42,6 +42,11 @@ public:
                               storage::spi::Timestamp timestamp,
                               const document::DocumentId &id) override;
 
+    virtual void handleBatch(FeedToken commitToken,
+                             const storage::spi::Bucket &bucket,
+                             const std::vector<storage::spi::BatchOperation> &ops,
+                             const std::vector<FeedToken> &tokens) override;
+
     virtual void handleListBuckets(IBucketIdListResultHandler &resultHandler) override;
 
     virtual void handleSetClusterState(const storage::spi::ClusterState &calc,
@@ -8,6 +8,8 @@ namespace proton {
 class PersistenceProviderProxy : public storage::spi::PersistenceProvider
 {
 private:
+    using BatchOperation = storage::spi::BatchOperation;
+    using BatchResult = storage::spi::BatchResult;
     using Bucket = storage::spi::Bucket;
     using BucketIdListResult = storage::spi::BucketIdListResult;
     using BucketInfoResult = storage::spi::BucketInfoResult;
@@ -87,6 +89,12 @@ public:
         return _pp.update(bucket, timestamp, docUpd, context);
     }
 
+    virtual BatchResult applyBatch(const Bucket &bucket,
+                                   const std::vector<BatchOperation> &ops,
+                                   Context& context) override {
+        return _pp.applyBatch(bucket, ops, context);
+    }
+
     virtual Result flush(const Bucket &bucket, Context& context) override {
         return _pp.flush(bucket, context);
     }
@@ -22,6 +22,7 @@
 #include <vespa/searchcommon/common/schemaconfigurer.h>
 #include <vespa/document/base/exceptions.h>
 #include <vespa/document/datatype/documenttype.h>
+#include <vespa/eval/eval/llvm/llvm_wrapper.h>
 #include <vespa/vespalib/io/fileutil.h>
 #include <vespa/vespalib/util/closuretask.h>
 #include <vespa/vespalib/util/host_name.h>
@@ -269,6 +270,12 @@ Proton::init(const BootstrapConfig::SP & configSnapshot)
         strategy.reset(new SimpleFlush());
         break;
     }
+    if (protonConfig.rankingexpression.compilecache.disk) {
+        vespalib::string compileCacheDir = protonConfig.basedir + "/compiled-expressions";
+        vespalib::mkdir(compileCacheDir, true);
+        vespalib::eval::LLVMWrapper::set_object_cache_dir(compileCacheDir,
+                                                          protonConfig.rankingexpression.compilecache.maxdisksize);
+    }
     vespalib::mkdir(protonConfig.basedir + "/documents", true);
     vespalib::chdir(protonConfig.basedir);
     _tls->start();
@@ -100,6 +100,8 @@ createIndexManagerInitializer(const DocumentDBConfig &configSnapshot,
          searchcorespi::index::WarmupConfig(indexCfg.warmup.time, indexCfg.warmup.unpack),
          indexCfg.maxflushed,
          indexCfg.cache.size,
+         indexCfg.fusion.threads,
+         indexCfg.fusion.memorylimit,
          *schema,
          configSerialNum,
          const_cast<SearchableDocSubDB &>(*this),
@@ -124,12 +126,14 @@ SearchableDocSubDB::
 createInitializer(const DocumentDBConfig &configSnapshot,
                   SerialNum configSerialNum,
                   const ProtonConfig::Summary &protonSummaryCfg,
-                  const ProtonConfig::Index &indexCfg) const
+                  const ProtonConfig::Index &indexCfg,
+                  vespalib::Executor &initializeExecutor) const
 {
     auto result = Parent::createInitializer(configSnapshot,
                                             configSerialNum,
                                             protonSummaryCfg,
-                                            indexCfg);
+                                            indexCfg,
+                                            initializeExecutor);
     auto indexTask = createIndexManagerInitializer(configSnapshot,
                                                    configSerialNum,
                                                    indexCfg,
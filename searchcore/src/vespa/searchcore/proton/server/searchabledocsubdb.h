@@ -118,7 +118,8 @@ public:
                       const vespa::config::search::core::
                       ProtonConfig::Summary &protonSummaryCfg,
                       const vespa::config::search::core::
-                      ProtonConfig::Index &indexCfg) const override;
+                      ProtonConfig::Index &indexCfg,
+                      vespalib::Executor &initializeExecutor) const override;
 
     void setup(const DocumentSubDbInitializerResult &initResult) override;
 
@@ -323,10 +323,12 @@ StoreOnlyDocSubDB::createInitializer(const DocumentDBConfig &configSnapshot,
                                      SerialNum configSerialNum,
                                      const ProtonConfig::Summary &
                                      protonSummaryCfg,
-                                     const ProtonConfig::Index &indexCfg) const
+                                     const ProtonConfig::Index &indexCfg,
+                                     vespalib::Executor &initializeExecutor) const
 {
     (void) configSerialNum;
     (void) indexCfg;
+    (void) initializeExecutor;
     auto result = std::make_unique<DocumentSubDbInitializer>
                   (const_cast<StoreOnlyDocSubDB &>(*this),
                    _writeService.master());
@@ -213,7 +213,8 @@ public:
     createInitializer(const DocumentDBConfig &configSnapshot,
                       SerialNum configSerialNum,
                       const ProtonConfig::Summary &protonSummaryCfg,
-                      const ProtonConfig::Index &indexCfg) const override;
+                      const ProtonConfig::Index &indexCfg,
+                      vespalib::Executor &initializeExecutor) const override;
 
     void setup(const DocumentSubDbInitializerResult &initResult) override;
     void initViews(const DocumentDBConfig &configSnapshot, const std::shared_ptr<matching::SessionManager> &sessionManager) override;
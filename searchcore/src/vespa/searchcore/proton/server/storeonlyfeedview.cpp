@@ -303,7 +303,11 @@ StoreOnlyFeedView::internalPut(FeedToken::UP token, const PutOperation &putOp)
         std::shared_ptr<PutDoneContext> onWriteDone =
             createPutDoneContext(token, putOp.getType(), _params._metrics,
                                  _gidToLidChangeHandler, gid, putOp.getLid(), serialNum, putOp.changedDbdId() && useDocumentMetaStore(serialNum));
-        putSummary(serialNum, putOp.getLid(), doc, onWriteDone);
+        if (putOp.getSerializedDocument()) {
+            putSummary(serialNum, putOp.getLid(), putOp.getSerializedDocument(), onWriteDone);
+        } else {
+            putSummary(serialNum, putOp.getLid(), doc, onWriteDone);
+        }
         putAttributes(serialNum, putOp.getLid(), *doc, immediateCommit, onWriteDone);
         putIndexedFields(serialNum, putOp.getLid(), doc, immediateCommit, onWriteDone);
     }
@@ -392,6 +396,21 @@ void StoreOnlyFeedView::putSummary(SerialNum serialNum, Lid lid, Document::SP do
             }));
 #pragma GCC diagnostic pop
 }
+
+void StoreOnlyFeedView::putSummary(SerialNum serialNum, Lid lid, SerializedDocSP doc, OnOperationDoneType onDone)
+{
+    _pendingLidTracker.produce(lid);
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winline" // Avoid spurious inlining warning from GCC related to lambda destructor.
+    summaryExecutor().execute(
+            makeLambdaTask([serialNum, doc = std::move(doc), onDone, lid, this] {
+                (void) onDone;
+                _summaryAdapter->put(serialNum, lid, *doc);
+                _pendingLidTracker.consume(lid);
+            }));
+#pragma GCC diagnostic pop
+}
+
 void StoreOnlyFeedView::removeSummary(SerialNum serialNum, Lid lid, OnWriteDoneType onDone) {
     _pendingLidTracker.produce(lid);
     summaryExecutor().execute(
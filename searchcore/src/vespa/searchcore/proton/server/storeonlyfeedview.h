@@ -64,6 +64,7 @@ public:
     using FutureDoc = std::future<Document::UP>;
     using PromisedDoc = std::promise<Document::UP>;
     using FutureStream = std::future<vespalib::nbostream>;
+    using SerializedDocSP = std::shared_ptr<const vespalib::nbostream>;
     using PromisedStream = std::promise<vespalib::nbostream>;
     using Lid = search::DocumentIdT;
 
@@ -158,6 +159,7 @@ private:
     }
     void putSummary(SerialNum serialNum,  Lid lid, FutureStream doc, OnOperationDoneType onDone);
     void putSummary(SerialNum serialNum,  Lid lid, Document::SP doc, OnOperationDoneType onDone);
+    void putSummary(SerialNum serialNum,  Lid lid, SerializedDocSP doc, OnOperationDoneType onDone);
     void removeSummary(SerialNum serialNum,  Lid lid, OnWriteDoneType onDone);
     void heartBeatSummary(SerialNum serialNum);
 
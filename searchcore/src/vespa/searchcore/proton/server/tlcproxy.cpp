@@ -11,32 +11,40 @@ using search::transactionlog::Packet;
 
 namespace proton {
 
-void TlcProxy::commit(search::SerialNum serialNum, search::transactionlog::Type type, const vespalib::nbostream &buf)
+void TlcProxy::commit(const Packet &packet)
 {
-    Packet::Entry entry(serialNum, type, vespalib::ConstBufferRef(buf.c_str(), buf.size()));
-    Packet packet;
-    packet.add(entry);
-    packet.close();
     if (_tlsDirectWriter != NULL) {
         _tlsDirectWriter->commit(_session.getDomain(), packet);
     } else {
         if (!_session.commit(vespalib::ConstBufferRef(packet.getHandle().c_str(), packet.getHandle().size()))) {
             throw vespalib::IllegalStateException(vespalib::make_string(
-                        "Failed to commit packet %" PRId64
-                        " to TLS (type = %d, size = %d).",
-                        entry.serial(), type, (uint32_t)buf.size()));
+                        "Failed to commit packet [%" PRIu64 ", %" PRIu64 "]"
+                        " to TLS (entries = %zu, size = %zu).",
+                        packet.range().from(), packet.range().to(),
+                        packet.size(), packet.sizeBytes()));
         }
     }
 }
 
-void
-TlcProxy::storeOperation(const FeedOperation &op)
+bool
+TlcProxy::addOperation(Packet &packet, const FeedOperation &op)
 {
     nbostream stream;
     op.serialize(stream);
-    LOG(debug, "storeOperation(): serialNum(%" PRIu64 "), type(%u), size(%zu)",
+    LOG(debug, "addOperation(): serialNum(%" PRIu64 "), type(%u), size(%zu)",
         op.getSerialNum(), (uint32_t)op.getType(), stream.size());
-    commit(op.getSerialNum(), (uint32_t)op.getType(), stream);
+    Packet::Entry entry(op.getSerialNum(), (uint32_t)op.getType(),
+                        vespalib::ConstBufferRef(stream.c_str(), stream.size()));
+    return packet.add(entry);
+}
+
+void
+TlcProxy::storeOperation(const FeedOperation &op)
+{
+    Packet packet;
+    addOperation(packet, op);
+    packet.close();
+    commit(packet);
 }
 
 }  // namespace proton
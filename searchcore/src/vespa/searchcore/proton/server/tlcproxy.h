@@ -16,7 +16,6 @@ class TlcProxy {
     search::transactionlog::TransLogClient::Session & _session;
     search::transactionlog::Writer                  * _tlsDirectWriter;
 
-    void commit( search::SerialNum serialNum, search::transactionlog::Type type, const vespalib::nbostream &buf);
 public:
     typedef std::unique_ptr<TlcProxy> UP;
 
@@ -24,6 +23,13 @@ public:
         : _session(session), _tlsDirectWriter(writer) {}
 
     void storeOperation(const FeedOperation &op);
+
+    /**
+     * Adds the operation as an entry in the given packet. Returns false,
+     * leaving the packet as is, if the packet is full.
+     */
+    static bool addOperation(search::transactionlog::Packet &packet, const FeedOperation &op);
+    void commit(const search::transactionlog::Packet &packet);
 };
 
 } // namespace proton
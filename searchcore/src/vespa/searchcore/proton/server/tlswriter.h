@@ -14,6 +14,14 @@ struct TlsWriter {
     virtual ~TlsWriter() {}
 
     virtual void storeOperation(const FeedOperation &op) = 0;
+
+    /**
+     * Makes the following calls to storeOperation() collect the operations,
+     * which are then written together by commitBatch(). Writers that do not
+     * support this write each operation when it is stored.
+     */
+    virtual void startBatch() { }
+    virtual void commitBatch() { }
     virtual bool erase(search::SerialNum oldest_to_keep) = 0;
 
     virtual search::SerialNum
@@ -50,7 +50,8 @@ struct DummyDocumentSubDb : public IDocumentSubDB
                       const vespa::config::search::core::ProtonConfig::
                       Summary &,
                       const vespa::config::search::core::
-                      ProtonConfig::Index &) const override {
+                      ProtonConfig::Index &,
+                      vespalib::Executor &) const override {
         return std::make_unique<DocumentSubDbInitializer>
             (const_cast<DummyDocumentSubDb &>(*this),
              _writeService->master());
@@ -4,12 +4,16 @@
 #include <vespa/searchlib/attribute/attributefactory.h>
 #include <vespa/searchlib/attribute/attributevector.hpp>
 #include <vespa/searchlib/attribute/integerbase.h>
+#include <vespa/searchlib/attribute/stringbase.h>
+#include <vespa/searchlib/attribute/enumstorebase.h>
 #include <vespa/searchlib/attribute/address_space_usage.h>
+#include <vespa/vespalib/util/stringfmt.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP("attribute_compaction_test");
 
 using search::IntegerAttribute;
+using search::StringAttribute;
 using search::AttributeVector;
 using search::attribute::Config;
 using search::attribute::BasicType;
@@ -117,6 +121,42 @@ void hammerAttribute(AttributePtr &v, DocIdRange range, uint32_t count)
     }
 }
 
+vespalib::string stringValue(uint32_t docId)
+{
+    return vespalib::make_string("value%u", docId);
+}
+
+/*
+ * Fills the attribute with unique values, and checks after each commit that
+ * the enum handle of a value is the same when looked up and when read from a
+ * document. Returns whether an enum store compaction spanned several commits.
+ */
+bool populateWithUniqueValues(StringAttribute &v, DocIdRange range)
+{
+    bool sawCompaction = false;
+    for (uint32_t docId = range.begin(); docId < range.end(); ++docId) {
+        if (v.hasMultiValue()) {
+            EXPECT_TRUE(v.append(docId, stringValue(docId), 1));
+        } else {
+            EXPECT_TRUE(v.update(docId, stringValue(docId)));
+        }
+        if ((docId % 1000) != 999) {
+            continue;
+        }
+        v.commit();
+        v.incGeneration();
+        sawCompaction |= v.getEnumStoreBase()->isCompacting();
+        for (uint32_t checkId = range.begin(); checkId <= docId; checkId += 97) {
+            AttributeVector::EnumHandle handle = 0;
+            EXPECT_TRUE(v.findEnum(stringValue(checkId).c_str(), handle));
+            EXPECT_EQUAL(handle, v.getEnum(checkId));
+        }
+    }
+    v.commit(true);
+    v.incGeneration();
+    return sawCompaction;
+}
+
 Config compactAddressSpaceAttributeConfig(bool enableAddressSpaceCompact)
 {
     Config cfg(BasicType::INT8, CollectionType::ARRAY);
@@ -190,4 +230,24 @@ TEST_F("Test that compaction of int8 array attribute limits address space usage"
     EXPECT_GREATER(65536u, afterSpace.dead());
 }
 
+TEST_F("Test that enum handles of lookups and documents match while enum store is compacted", Fixture({ BasicType::STRING, CollectionType::SINGLE }))
+{
+    DocIdRange range = f.addDocs(50000);
+    EXPECT_TRUE(populateWithUniqueValues(as<StringAttribute>(f._v), range));
+}
+
+TEST_F("Test that enum handles of lookups and documents match while fast search enum store is compacted",
+       Fixture({ BasicType::STRING, CollectionType::SINGLE, true, false }))
+{
+    DocIdRange range = f.addDocs(50000);
+    EXPECT_TRUE(populateWithUniqueValues(as<StringAttribute>(f._v), range));
+}
+
+TEST_F("Test that enum handles of lookups and documents match while array enum store is compacted",
+       Fixture({ BasicType::STRING, CollectionType::ARRAY }))
+{
+    DocIdRange range = f.addDocs(50000);
+    EXPECT_TRUE(populateWithUniqueValues(as<StringAttribute>(f._v), range));
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -62,6 +62,7 @@ private:
     void testHoldListAndGeneration();
     void testMemoryUsage();
     void requireThatAddressSpaceUsageIsReported();
+    void requireThatIncrementalCompactionMovesEntriesInSteps();
     void testBufferLimit();
 
     // helper methods
@@ -750,6 +751,71 @@ EnumStoreTest::requireThatAddressSpaceUsageIsReported()
     EXPECT_EQUAL(AddressSpace(48, 48, ADDRESS_LIMIT), store.getAddressSpaceUsage());
 }
 
+void
+EnumStoreTest::requireThatIncrementalCompactionMovesEntriesInSteps()
+{
+    const size_t ADDRESS_LIMIT = 34359738368; // NumericEnumStore::DataStoreType::RefType::offsetSize()
+    NumericEnumStore store(200, false);
+    std::vector<NumericEnumStore::Index> indices;
+    for (uint32_t i = 0; i < 5; ++i) {
+        indices.push_back(addEnum(store, (i + 1) * 10));
+    }
+    decRefCount(store, indices[1]);
+    EXPECT_EQUAL(AddressSpace(96, 32, ADDRESS_LIMIT), store.getAddressSpaceUsage());
+
+    EXPECT_TRUE(store.startCompaction(0));
+    EXPECT_TRUE(store.isCompacting());
+    EXPECT_EQUAL(AddressSpace(96, 32, ADDRESS_LIMIT), store.getAddressSpaceUsage());
+    EXPECT_EQUAL(store.getBuffer(1).remaining() - 64, store.getRemaining());
+
+    // Move 10 and 30, the freed 20 is not in the dictionary
+    EXPECT_FALSE(store.moveEntries(2));
+    EXPECT_EQUAL(AddressSpace(128, 64, ADDRESS_LIMIT), store.getAddressSpaceUsage());
+    EXPECT_EQUAL(store.getBuffer(1).remaining() - 32, store.getRemaining());
+    NumericEnumStore::Index idx = store.getCompactedIndex(indices[0]);
+    EXPECT_EQUAL(1u, idx.bufferId());
+    EXPECT_EQUAL(10u, store.getValue(idx));
+    EXPECT_EQUAL(store.getEnum(indices[0]), store.getEnum(idx));
+    // Lookups find the copies at once, old entries forward to them
+    EXPECT_TRUE(store.findIndex(10, idx));
+    EXPECT_EQUAL(store.getCompactedIndex(indices[0]).ref(), idx.ref());
+    EXPECT_EQUAL(1u, store.getRefCount(indices[0]));
+    EXPECT_EQUAL(1u, store.getCompactedIndex(indices[2]).bufferId());
+    EXPECT_EQUAL(indices[3].ref(), store.getCompactedIndex(indices[3]).ref());
+
+    // New values, ref count changes, and values freed before and after they are moved
+    NumericEnumStore::Index newIdx = addEnum(store, 60);
+    EXPECT_EQUAL(1u, newIdx.bufferId());
+    EXPECT_EQUAL(5u, store.getEnum(newIdx));
+    EXPECT_EQUAL(newIdx.ref(), store.getCompactedIndex(newIdx).ref());
+    store.incRefCount(indices[0]);
+    decRefCount(store, indices[2]);
+    decRefCount(store, indices[4]);
+    EXPECT_TRUE(store.moveEntries(10));
+    EXPECT_EQUAL(AddressSpace(160, 112, ADDRESS_LIMIT), store.getAddressSpaceUsage());
+    EXPECT_EQUAL(store.getBuffer(1).remaining(), store.getRemaining());
+    EXPECT_TRUE(store.findIndex(10, idx));
+    EXPECT_EQUAL(store.getCompactedIndex(indices[0]).ref(), idx.ref());
+    EXPECT_EQUAL(2u, store.getRefCount(idx));
+    EXPECT_TRUE(store.findIndex(40, idx));
+    EXPECT_EQUAL(store.getCompactedIndex(indices[3]).ref(), idx.ref());
+    EXPECT_EQUAL(1u, idx.bufferId());
+    EXPECT_EQUAL(3u, store.getEnum(idx));
+    EXPECT_FALSE(store.findIndex(30, idx));
+
+    store.finishCompaction();
+    EXPECT_FALSE(store.isCompacting());
+    // The copy of 30 was freed after it was moved
+    EXPECT_EQUAL(AddressSpace(64, 16, ADDRESS_LIMIT), store.getAddressSpaceUsage());
+    EXPECT_EQUAL(3u, store.getNumUniques());
+    EXPECT_EQUAL(5u, store.getLastEnum());
+    EXPECT_TRUE(store.findIndex(60, idx));
+    EXPECT_EQUAL(newIdx.ref(), idx.ref());
+    // Old entries on hold still forward to their copies
+    EXPECT_TRUE(store.findIndex(40, idx));
+    EXPECT_EQUAL(idx.ref(), store.getCompactedIndex(indices[3]).ref());
+}
+
 size_t
 digits(size_t num)
 {
@@ -871,6 +937,7 @@ EnumStoreTest::Main()
     testHoldListAndGeneration();
     testMemoryUsage();
     TEST_DO(requireThatAddressSpaceUsageIsReported());
+    TEST_DO(requireThatIncrementalCompactionMovesEntriesInSteps());
     if (_argc > 1) {
         testBufferLimit(); // large test with 8 GB buffer
     }
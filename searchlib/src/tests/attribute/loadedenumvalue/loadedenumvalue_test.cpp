@@ -0,0 +1,79 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/testkit/testapp.h>
+#include <vespa/searchlib/attribute/loadedenumvalue.h>
+#include <vespa/vespalib/util/array.hpp>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
+#include <random>
+
+using search::attribute::LoadedEnumAttribute;
+using search::attribute::LoadedEnumAttributeVector;
+using search::attribute::sortLoadedByEnum;
+
+namespace {
+
+LoadedEnumAttributeVector
+makeLoaded(size_t size)
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<uint32_t> enumDist(0, 100000);
+    LoadedEnumAttributeVector loaded;
+    for (size_t i = 0; i < size; ++i) {
+        loaded.push_back(LoadedEnumAttribute(enumDist(gen), (i * 7919) % size, i % 5));
+    }
+    return loaded;
+}
+
+void
+assertSameOrder(const LoadedEnumAttributeVector &exp, const LoadedEnumAttributeVector &act)
+{
+    ASSERT_EQUAL(exp.size(), act.size());
+    size_t mismatches = 0;
+    for (size_t i = 0; i < exp.size(); ++i) {
+        if (exp[i].getEnum() != act[i].getEnum() ||
+            exp[i].getDocId() != act[i].getDocId() ||
+            exp[i].getWeight() != act[i].getWeight()) {
+            ++mismatches;
+        }
+    }
+    EXPECT_EQUAL(0u, mismatches);
+}
+
+void
+assertParallelSort(size_t size, uint32_t numThreads)
+{
+    TEST_STATE(vespalib::make_string("size=%zu, numThreads=%u", size, numThreads).c_str());
+    LoadedEnumAttributeVector exp = makeLoaded(size);
+    LoadedEnumAttributeVector act = makeLoaded(size);
+    sortLoadedByEnum(exp);
+    vespalib::ThreadStackExecutor executor(numThreads, 128 * 1024);
+    sortLoadedByEnum(act, &executor);
+    assertSameOrder(exp, act);
+}
+
+}
+
+TEST("require that sort without executor orders on enum and docid")
+{
+    LoadedEnumAttributeVector loaded;
+    loaded.push_back(LoadedEnumAttribute(2, 1, 1));
+    loaded.push_back(LoadedEnumAttribute(1, 5, 1));
+    loaded.push_back(LoadedEnumAttribute(1, 3, 1));
+    sortLoadedByEnum(loaded, nullptr);
+    EXPECT_EQUAL(1u, loaded[0].getEnum());
+    EXPECT_EQUAL(3u, loaded[0].getDocId());
+    EXPECT_EQUAL(1u, loaded[1].getEnum());
+    EXPECT_EQUAL(5u, loaded[1].getDocId());
+    EXPECT_EQUAL(2u, loaded[2].getEnum());
+}
+
+TEST("require that parallel sort gives same order as single threaded sort")
+{
+    assertParallelSort(1000, 4);
+    assertParallelSort(2000000, 1);
+    assertParallelSort(3000000, 4);
+    assertParallelSort(7000001, 4);
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -8,11 +8,14 @@
 #include <vespa/vespalib/util/generationhandler.h>
 #include <vespa/vespalib/test/insertion_operators.h>
 #include <vespa/vespalib/stllike/hash_set.h>
+#include <limits>
 
 #include <vespa/log/log.h>
 LOG_SETUP("multivaluemapping_test");
 
 using search::datastore::ArrayStoreConfig;
+using search::multivalue::Value;
+using search::multivalue::WeightedValue;
 
 template <typename EntryT>
 void
@@ -66,26 +69,31 @@ protected:
     using MvMapping = search::attribute::MultiValueMapping<EntryT>;
     MvMapping _mvMapping;
     MyAttribute<MvMapping> _attr;
+    typename MvMapping::DecodeBuffer _buffer;
     using RefType = typename MvMapping::RefType;
     using generation_t = vespalib::GenerationHandler::generation_t;
 
 public:
     using ConstArrayRef = vespalib::ConstArrayRef<EntryT>;
-    Fixture(uint32_t maxSmallArraySize)
-        : _mvMapping(ArrayStoreConfig(maxSmallArraySize, ArrayStoreConfig::AllocSpec(0, RefType::offsetSize(), 8 * 1024))),
-          _attr(_mvMapping)
+    Fixture(uint32_t maxSmallArraySize, bool compressed = false)
+        : _mvMapping(ArrayStoreConfig(maxSmallArraySize, ArrayStoreConfig::AllocSpec(0, RefType::offsetSize(), 8 * 1024)),
+                     search::GrowStrategy(), compressed),
+          _attr(_mvMapping),
+          _buffer()
     {
     }
     Fixture(uint32_t maxSmallArraySize, size_t minClusters, size_t maxClusters, size_t numClustersForNewBuffer)
         : _mvMapping(ArrayStoreConfig(maxSmallArraySize, ArrayStoreConfig::AllocSpec(minClusters, maxClusters, numClustersForNewBuffer))),
-          _attr(_mvMapping)
+          _attr(_mvMapping),
+          _buffer()
     {
     }
     ~Fixture() { }
 
     void set(uint32_t docId, const std::vector<EntryT> &values) { _mvMapping.set(docId, values); }
     void replace(uint32_t docId, const std::vector<EntryT> &values) { _mvMapping.replace(docId, values); }
-    ConstArrayRef get(uint32_t docId) { return _mvMapping.get(docId); }
+    ConstArrayRef get(uint32_t docId) { return _mvMapping.get(docId, _buffer); }
+    ConstArrayRef get(uint32_t docId, typename MvMapping::DecodeBuffer &buffer) { return _mvMapping.get(docId, buffer); }
     void assertGet(uint32_t docId, const std::vector<EntryT> &exp)
     {
         ConstArrayRef act = get(docId);
@@ -134,6 +142,34 @@ public:
     }
 };
 
+template <typename EntryT>
+class CompressedFixture : public Fixture<EntryT>
+{
+public:
+    using ValueType = typename EntryT::ValueType;
+    using ValueWeights = std::vector<std::pair<int64_t, int32_t>>;
+    CompressedFixture(uint32_t maxSmallArraySize)
+        : Fixture<EntryT>(maxSmallArraySize, true)
+    {
+    }
+    bool isCompressed() const { return this->_mvMapping.isCompressed(); }
+    void set(uint32_t docId, const ValueWeights &values) {
+        std::vector<EntryT> entries;
+        for (const auto &value : values) {
+            entries.emplace_back(static_cast<ValueType>(value.first), value.second);
+        }
+        this->_mvMapping.set(docId, entries);
+    }
+    void assertGet(uint32_t docId, const ValueWeights &exp) {
+        typename Fixture<EntryT>::ConstArrayRef act = this->get(docId);
+        ValueWeights actValues;
+        for (const auto &entry : act) {
+            actValues.emplace_back(entry.value(), entry.weight());
+        }
+        EXPECT_EQUAL(exp, actValues);
+    }
+};
+
 class IntFixture : public Fixture<int>
 {
     search::Rand48 _rnd;
@@ -324,4 +360,65 @@ TEST_F("Test that compaction works", IntFixture(3, 64, 512, 129))
     EXPECT_LESS(bufferCountAfter, bufferCountBefore);
 }
 
+TEST_F("Test that compressed arrays keep order and values", CompressedFixture<Value<int64_t>>(3))
+{
+    EXPECT_TRUE(f.isCompressed());
+    f.addDocs(10);
+    f.set(1, {});
+    f.set(2, {{4, 1}, {-7, 1}});
+    f.set(3, {{std::numeric_limits<int64_t>::max(), 1}, {std::numeric_limits<int64_t>::min(), 1}, {0, 1}});
+    f.set(4, {{10, 1}, {14, 1}, {17, 1}, {16, 1}, {1000000000000, 1}});
+    TEST_DO(f.assertGet(1, {}));
+    TEST_DO(f.assertGet(2, {{4, 1}, {-7, 1}}));
+    TEST_DO(f.assertGet(3, {{std::numeric_limits<int64_t>::max(), 1}, {std::numeric_limits<int64_t>::min(), 1}, {0, 1}}));
+    TEST_DO(f.assertGet(4, {{10, 1}, {14, 1}, {17, 1}, {16, 1}, {1000000000000, 1}}));
+    EXPECT_EQUAL(10u, f.getTotalValueCnt());
+    f.set(4, {{10, 1}});
+    EXPECT_EQUAL(6u, f.getTotalValueCnt());
+    TEST_DO(f.assertGet(4, {{10, 1}}));
+}
+
+TEST_F("Test that compressed weighted sets keep weights sorted on value", CompressedFixture<WeightedValue<int8_t>>(3))
+{
+    f.addDocs(10);
+    f.set(2, {{127, -3}, {-128, 1000000}, {5, 0}, {-1, std::numeric_limits<int32_t>::min()}});
+    TEST_DO(f.assertGet(2, {{-128, 1000000}, {-1, std::numeric_limits<int32_t>::min()}, {5, 0}, {127, -3}}));
+    EXPECT_EQUAL(4u, f.getTotalValueCnt());
+    f.clearDocs(2, 3);
+    TEST_DO(f.assertGet(2, {}));
+    EXPECT_EQUAL(0u, f.getTotalValueCnt());
+}
+
+TEST_F("Test that decoded arrays are owned by the reader's buffer", CompressedFixture<Value<int32_t>>(3))
+{
+    f.addDocs(3);
+    f.set(1, {{5, 1}, {7, 1}});
+    f.set(2, {{9, 1}});
+    std::vector<Value<int32_t>> buffer1;
+    std::vector<Value<int32_t>> buffer2;
+    auto values1 = f.get(1, buffer1);
+    auto values2 = f.get(2, buffer2);
+    TEST_DO(assertArray({Value<int32_t>(5), Value<int32_t>(7)}, values1));
+    TEST_DO(assertArray({Value<int32_t>(9)}, values2));
+}
+
+TEST_F("Test that compressed arrays survive compaction", CompressedFixture<WeightedValue<int32_t>>(3))
+{
+    f.addDocs(100);
+    for (uint32_t docId = 0; docId < 100; ++docId) {
+        f.set(docId, {{int32_t(docId * 1000), int32_t(docId)}, {int32_t(docId), 1}});
+    }
+    for (uint32_t docId = 0; docId < 100; docId += 2) {
+        f.set(docId, {});
+    }
+    f.compactWorst();
+    for (uint32_t docId = 0; docId < 100; ++docId) {
+        if ((docId % 2) == 0) {
+            TEST_DO(f.assertGet(docId, {}));
+        } else {
+            TEST_DO(f.assertGet(docId, {{int32_t(docId), 1}, {int32_t(docId * 1000), int32_t(docId)}}));
+        }
+    }
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
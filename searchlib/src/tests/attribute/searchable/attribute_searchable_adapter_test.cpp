@@ -25,6 +25,10 @@
 #include <vespa/searchlib/queryeval/field_spec.h>
 #include <vespa/searchlib/queryeval/searchiterator.h>
 #include <vespa/searchlib/queryeval/wand/parallel_weak_and_search.h>
+#include <vespa/searchlib/tensor/dense_tensor_attribute.h>
+#include <vespa/eval/tensor/tensor.h>
+#include <vespa/eval/tensor/tensor_factory.h>
+#include <algorithm>
 #include <memory>
 
 using search::AttributeEnumGuard;
@@ -62,6 +66,7 @@ using search::queryeval::MinMaxPostingInfo;
 using search::queryeval::ParallelWeakAndSearch;
 using search::queryeval::PostingInfo;
 using search::queryeval::SearchIterator;
+using search::tensor::DenseTensorAttribute;
 using std::vector;
 using vespalib::string;
 using namespace search::attribute;
@@ -714,6 +719,64 @@ TEST("require that strict diversity gives enough diversity and hits while doing
     EXPECT_EQUAL(23u, diversity_docid_range(manager, "[;;10;other;3;2;strict]", true).second);
 }
 
+MyAttributeManager make_nearest_neighbor_setup() {
+    Config cfg(BasicType::TENSOR, CollectionType::SINGLE);
+    cfg.setTensorType(vespalib::eval::ValueType::from_spec("tensor(x[2])"));
+    cfg.setHnswIndexParams(HnswIndexParams(4, 20, HnswIndexParams::DistanceMetric::EUCLIDEAN));
+    AttributeVector::SP attr = AttributeFactory::createAttribute(field, cfg);
+    auto &tensor_attr = dynamic_cast<DenseTensorAttribute &>(*attr);
+    add_docs(&tensor_attr, num_docs);
+    for (uint32_t docid = 1; docid <= 100; ++docid) {
+        auto tensor = vespalib::tensor::TensorFactory::createDense({ {{{"x", 0}}, double(docid)},
+                                                                     {{{"x", 1}}, 0.0} });
+        tensor_attr.setTensor(docid, *tensor);
+        tensor_attr.commit();
+    }
+    return MyAttributeManager(attr);
+}
+
+TEST("require that nearest neighbor terms find the top k hits in the hnsw index") {
+    MyAttributeManager manager = make_nearest_neighbor_setup();
+    SimpleStringTerm node("[50.4,0];3;20", field, 0, Weight(1));
+    for (bool strict: std::vector<bool>({true, false})) {
+        TEST_STATE(strict ? "strict" : "non-strict");
+        Result result = do_search(manager, node, strict);
+        EXPECT_FALSE(result.est_empty);
+        EXPECT_EQUAL(3u, result.est_hits);
+        ASSERT_EQUAL(3u, result.hits.size());
+        EXPECT_EQUAL(49u, result.hits[0].docid);
+        EXPECT_EQUAL(50u, result.hits[1].docid);
+        EXPECT_EQUAL(51u, result.hits[2].docid);
+        EXPECT_APPROX(1.0 / 2.4, result.hits[0].raw_score, 1e-9);
+        EXPECT_APPROX(1.0 / 1.4, result.hits[1].raw_score, 1e-9);
+        EXPECT_APPROX(1.0 / 1.6, result.hits[2].raw_score, 1e-9);
+
+        AttributeGuard::UP guard = manager.getAttribute(field);
+        const auto &tensor_attr = dynamic_cast<const DenseTensorAttribute &>(*guard->get());
+        const auto &index = *tensor_attr.nearestNeighborIndex();
+        std::vector<double> query = { 50.4, 0.0 };
+        auto expected = index.findTopK(3, vespalib::ConstArrayRef<double>(query.data(), query.size()), 23);
+        ASSERT_EQUAL(3u, expected.size());
+        for (const auto &neighbor : expected) {
+            auto hit = std::find_if(result.hits.begin(), result.hits.end(),
+                                    [&](const Result::Hit &h) { return h.docid == neighbor.docId; });
+            ASSERT_TRUE(hit != result.hits.end());
+            EXPECT_EQUAL(index.getDistanceFunction().toRawScore(neighbor.distance), hit->raw_score);
+        }
+    }
+}
+
+TEST("require that malformed nearest neighbor terms give empty results") {
+    MyAttributeManager manager = make_nearest_neighbor_setup();
+    for (const char *term : { "[50.4,0]", "[50.4];3", "[50.4,0,1];3", "50.4,0;3", "[50.4,0];0", "[50.4,0];3;x" }) {
+        TEST_STATE(term);
+        SimpleStringTerm node(term, field, 0, Weight(1));
+        Result result = do_search(manager, node, true);
+        EXPECT_TRUE(result.est_empty);
+        EXPECT_EQUAL(0u, result.hits.size());
+    }
+}
+
 }  // namespace
 
 TEST_MAIN() { TEST_RUN_ALL(); }
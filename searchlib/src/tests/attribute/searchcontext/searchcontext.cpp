@@ -203,6 +203,12 @@ private:
     void fillForSemiNibbleSearchIteratorTest(IntegerAttribute * ia);
     void testSearchIterator();
 
+    // test block scanning strict iterator over single value numeric attributes
+    template <typename VectorType, typename ValueType>
+    void testBlockScanSearchIterator(const vespalib::string & name, BasicType::Type type,
+                                     const std::vector<ValueType> & values, const vespalib::string & term);
+    void testBlockScanSearchIterator();
+
 
     // test search iterator unpacking
     void fillForSearchIteratorUnpackingTest(IntegerAttribute * ia, bool extra);
@@ -896,6 +902,114 @@ SearchContextTest::testSearchIterator()
 
 
 
+template <typename VectorType, typename ValueType>
+void
+SearchContextTest::testBlockScanSearchIterator(const vespalib::string & name, BasicType::Type type,
+                                               const std::vector<ValueType> & values, const vespalib::string & term)
+{
+    // 2 full blocks and a partial word at the end
+    const uint32_t numDocs = 2100;
+    Config cfg(type, CollectionType::SINGLE);
+    AttributePtr ptr = AttributeFactory::createAttribute(name, cfg);
+    VectorType & vec = dynamic_cast<VectorType &>(*ptr);
+    addDocs(*ptr, numDocs);
+    for (uint32_t docId = 1; docId <= numDocs; ++docId) {
+        vec.update(docId, values[(docId * 7) % values.size()]);
+    }
+    ptr->commit(true);
+    const uint32_t docIdLimit = ptr->getCommittedDocIdLimit();
+
+    TermFieldMatchData dummy;
+    SearchContextPtr sc = getSearch(vec, term);
+    sc->fetchPostings(true);
+    std::vector<uint32_t> expected;
+    for (uint32_t docId = 1; docId < docIdLimit; ++docId) {
+        if (sc->cmp(docId)) {
+            expected.push_back(docId);
+        }
+    }
+    EXPECT_TRUE(expected.size() > 0u);
+    EXPECT_TRUE(expected.size() < numDocs);
+    {
+        SearchBasePtr sb = sc->createIterator(&dummy, true);
+        sb->initRange(1, docIdLimit);
+        std::vector<uint32_t> actual;
+        for (sb->seek(1); ! sb->isAtEnd(); sb->seek(sb->getDocId() + 1)) {
+            actual.push_back(sb->getDocId());
+        }
+        EXPECT_TRUE(expected == actual);
+    }
+    {
+        // a block matched for the first range must not be used for the second
+        const uint32_t end = 300;
+        SearchBasePtr sb = sc->createIterator(&dummy, true);
+        sb->initRange(1, docIdLimit);
+        sb->seek(1);
+        sb->initRange(1, end);
+        std::vector<uint32_t> actual;
+        for (sb->seek(1); ! sb->isAtEnd(); sb->seek(sb->getDocId() + 1)) {
+            actual.push_back(sb->getDocId());
+        }
+        std::vector<uint32_t> expectedInRange(expected.begin(),
+                                              std::lower_bound(expected.begin(), expected.end(), end));
+        EXPECT_TRUE(expectedInRange == actual);
+        EXPECT_EQUAL(search::endDocId, sb->getDocId());
+    }
+    {
+        SearchBasePtr sb = sc->createIterator(&dummy, true);
+        sb->initRange(1, docIdLimit);
+        sb->seek(1000);
+        BitVector::UP hits = sb->get_hits(1);
+        for (uint32_t docId = 1; docId < docIdLimit; ++docId) {
+            bool hit = (docId >= 1000) && std::binary_search(expected.begin(), expected.end(), docId);
+            EXPECT_EQUAL(hit, hits->testBit(docId));
+        }
+    }
+    {
+        SearchBasePtr sb = sc->createIterator(&dummy, true);
+        sb->initRange(1, docIdLimit);
+        BitVector::UP result = BitVector::create(docIdLimit);
+        result->setInterval(1, docIdLimit);
+        result->clearBit(expected[0]);
+        sb->and_hits_into(*result, 1);
+        EXPECT_EQUAL(expected.size() - 1, result->countTrueBits());
+        for (size_t i = 1; i < expected.size(); ++i) {
+            EXPECT_TRUE(result->testBit(expected[i]));
+        }
+    }
+    {
+        SearchBasePtr sb = sc->createIterator(&dummy, true);
+        sb->initRange(1, docIdLimit);
+        BitVector::UP result = BitVector::create(docIdLimit);
+        size_t extra = 0;
+        for (uint32_t docId = 3; docId < docIdLimit; docId += 3) {
+            result->setBit(docId);
+            if ( ! std::binary_search(expected.begin(), expected.end(), docId)) {
+                ++extra;
+            }
+        }
+        sb->or_hits_into(*result, 1);
+        EXPECT_EQUAL(expected.size() + extra, result->countTrueBits());
+        for (uint32_t docId : expected) {
+            EXPECT_TRUE(result->testBit(docId));
+        }
+    }
+}
+
+void
+SearchContextTest::testBlockScanSearchIterator()
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    TEST_DO((testBlockScanSearchIterator<IntegerAttribute, int64_t>("s-int8", BasicType::INT8, {-5, 3, 10, 11, 20, 100}, "[3;11]")));
+    TEST_DO((testBlockScanSearchIterator<IntegerAttribute, int64_t>("s-int16", BasicType::INT16, {-5, 3, 10, 11, 20, 1000}, "[3;11]")));
+    TEST_DO((testBlockScanSearchIterator<IntegerAttribute, int64_t>("s-int32", BasicType::INT32, {-5, 3, 10, 11, 20, 100000}, "[3;11]")));
+    TEST_DO((testBlockScanSearchIterator<IntegerAttribute, int64_t>("s-int64", BasicType::INT64, {-5, 3, 10, 11, 20, 10000000000}, "10")));
+    TEST_DO((testBlockScanSearchIterator<FloatingPointAttribute, double>("s-float", BasicType::FLOAT, {-5.5, 3.0, 10.5, nan, 11.0, 20.0}, "[3;11]")));
+    TEST_DO((testBlockScanSearchIterator<FloatingPointAttribute, double>("s-double", BasicType::DOUBLE, {-5.5, 3.0, 10.5, nan, 11.0, 20.0}, "[3;11]")));
+}
+
+
+
 //-----------------------------------------------------------------------------
 // Test search iterator unpacking
 //-----------------------------------------------------------------------------
@@ -1904,6 +2018,7 @@ SearchContextTest::Main()
 
     testSearch();
     testSearchIterator();
+    TEST_DO(testBlockScanSearchIterator());
     testRangeSearch();
     testRangeSearchLimited();
     testCaseInsensitiveSearch();
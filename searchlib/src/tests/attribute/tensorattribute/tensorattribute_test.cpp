@@ -47,6 +47,7 @@ struct Fixture
     using BasicType = search::attribute::BasicType;
     using CollectionType = search::attribute::CollectionType;
     using Config = search::attribute::Config;
+    using HnswIndexParams = search::attribute::HnswIndexParams;
 
     Config _cfg;
     vespalib::string _name;
@@ -58,7 +59,8 @@ struct Fixture
     bool _useDenseTensorAttribute;
 
     Fixture(const vespalib::string &typeSpec,
-            bool useDenseTensorAttribute = false)
+            bool useDenseTensorAttribute = false,
+            bool useNearestNeighborIndex = false)
         : _cfg(BasicType::TENSOR, CollectionType::SINGLE),
           _name("test"),
           _typeSpec(typeSpec),
@@ -69,6 +71,9 @@ struct Fixture
           _useDenseTensorAttribute(useDenseTensorAttribute)
     {
         _cfg.setTensorType(ValueType::from_spec(typeSpec));
+        if (useNearestNeighborIndex) {
+            _cfg.setHnswIndexParams(HnswIndexParams(4, 20, HnswIndexParams::DistanceMetric::EUCLIDEAN));
+        }
         if (_cfg.tensorType().is_dense()) {
             _denseTensors = true;
         }
@@ -241,6 +246,8 @@ struct Fixture
     void testCompaction();
     void testTensorTypeFileHeaderTag();
     void testEmptyTensor();
+    void testNearestNeighborIndex();
+    void assertNearestNeighbors(const std::vector<uint32_t> &expDocIds, double x);
 };
 
 
@@ -370,6 +377,39 @@ Fixture::testEmptyTensor()
     }
 }
 
+void
+Fixture::assertNearestNeighbors(const std::vector<uint32_t> &expDocIds, double x)
+{
+    AttributeGuard guard(_attr);
+    const auto &denseAttr = dynamic_cast<const DenseTensorAttribute &>(*_tensorAttr);
+    ASSERT_TRUE(denseAttr.nearestNeighborIndex() != nullptr);
+    std::vector<double> query = { x, 0, 0, 0, 0, 0 };
+    std::vector<uint32_t> actDocIds;
+    for (const auto &hit : denseAttr.nearestNeighborIndex()->findTopK(expDocIds.size(),
+                                                                      vespalib::ConstArrayRef<double>(query.data(), query.size()),
+                                                                      10)) {
+        actDocIds.push_back(hit.docId);
+    }
+    EXPECT_TRUE(expDocIds == actDocIds);
+}
+
+void
+Fixture::testNearestNeighborIndex()
+{
+    for (uint32_t docId = 1; docId < 6; ++docId) {
+        setTensor(docId, *createDenseTensor({ {{{"x", 0}, {"y", 0}}, double(docId)},
+                                              {{{"x", 1}, {"y", 2}}, 0} }));
+    }
+    TEST_DO(assertNearestNeighbors({3, 4}, 3.4));
+    TEST_DO(clearTensor(3));
+    TEST_DO(assertNearestNeighbors({4, 2}, 3.4));
+    setTensor(4, *createDenseTensor({ {{{"x", 0}, {"y", 0}}, 10},
+                                      {{{"x", 1}, {"y", 2}}, 0} }));
+    TEST_DO(assertNearestNeighbors({5, 2}, 3.8));
+    TEST_DO(save());
+    TEST_DO(load());
+    TEST_DO(assertNearestNeighbors({5, 2, 1, 4}, 3.8));
+}
 
 TEST_F("Test empty sparse tensor attribute", Fixture("tensor()"))
 {
@@ -403,6 +443,12 @@ TEST("Test dense tensors with dense tensor attribute")
     testAll([]() { return std::make_shared<Fixture>(denseSpec, true); });
 }
 
+TEST("Test dense tensors with dense tensor attribute and nearest neighbor index")
+{
+    testAll([]() { return std::make_shared<Fixture>(denseSpec, true, true); });
+    TEST_DO(Fixture(denseSpec, true, true).testNearestNeighborIndex());
+}
+
 TEST("Test dense tensors with generic tensor attribute with unbound x and y dims")
 {
     testAll([]() { return std::make_shared<Fixture>(denseAbstractSpec_xy); });
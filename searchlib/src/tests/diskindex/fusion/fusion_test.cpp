@@ -17,6 +17,9 @@
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/searchlib/util/filekit.h>
 #include <vespa/searchlib/common/sequencedtaskexecutor.h>
+#include <vespa/searchlib/queryeval/posting_info.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <limits>
 
 namespace search {
 
@@ -43,6 +46,7 @@ private:
     const Schema & getSchema() const { return _schema; }
 
     void requireThatFusionIsWorking(const vespalib::string &prefix, bool directio, bool readmmap);
+    void requireThatBlockMaxWeightsSurviveFusion();
 public:
     Test();
     int Main() override;
@@ -235,6 +239,59 @@ validateDiskIndex(DiskIndex &dw,
 }
 
 
+int32_t
+blockMaxTestWeight(uint32_t docId)
+{
+    return static_cast<int32_t>((docId * 37) % 1000) - 200;
+}
+
+
+void
+validateBlockMaxWeights(DiskIndex &dw, uint32_t numDocs)
+{
+    typedef DiskIndex::LookupResult LR;
+    typedef index::PostingListHandle PH;
+    typedef search::queryeval::SearchIterator SB;
+
+    uint32_t id(dw.getSchema().getIndexFieldId("f3"));
+    LR::UP lr(dw.lookup(id, "w"));
+    ASSERT_TRUE(lr.get() != NULL);
+    PH::UP wh(dw.readPostingList(*lr));
+    ASSERT_TRUE(wh.get() != NULL);
+    TermFieldMatchData f3;
+    TermFieldMatchDataArray a;
+    a.add(&f3);
+    SB::UP sbap(wh->createIterator(lr->counts, a));
+    const auto *info = dynamic_cast<const queryeval::BlockMaxWeightInfo *>(sbap.get());
+    ASSERT_TRUE(info != NULL);
+    EXPECT_TRUE(info->hasBlockMaxWeights());
+    sbap->initFullRange();
+    uint32_t numBlocks = 0;
+    uint32_t blockBegin = 1;
+    for (uint32_t docId = 1; docId < numDocs; ++docId) {
+        ASSERT_TRUE(sbap->seek(docId));
+        sbap->unpack(docId);
+        FieldPositionsIterator itr(f3.getIterator());
+        ASSERT_TRUE(itr.valid());
+        EXPECT_EQUAL(blockMaxTestWeight(docId), itr.getElementWeight());
+        uint32_t blockLastDocId = info->getBlockLastDocId();
+        ASSERT_TRUE(docId <= blockLastDocId && blockLastDocId < numDocs);
+        if (docId == blockBegin) {
+            // The stored max must be exact for every block, including the last
+            int32_t maxWeight = std::numeric_limits<int32_t>::min();
+            for (uint32_t i = docId; i <= blockLastDocId; ++i) {
+                maxWeight = std::max(maxWeight, blockMaxTestWeight(i));
+            }
+            EXPECT_EQUAL(maxWeight, info->getBlockMaxWeight());
+            blockBegin = blockLastDocId + 1;
+            ++numBlocks;
+        }
+    }
+    EXPECT_EQUAL(numDocs, blockBegin);
+    EXPECT_GREATER(numBlocks, 1u);
+}
+
+
 void
 Test::requireThatFusionIsWorking(const vespalib::string &prefix,
                                  bool directio,
@@ -427,6 +484,45 @@ Test::requireThatFusionIsWorking(const vespalib::string &prefix,
             break;
         TEST_DO(validateDiskIndex(dw6, true, true));
     } while (0);
+    do {
+        std::vector<vespalib::string> sources;
+        SelectorArray selector(numDocs, 0);
+        sources.push_back(prefix + "dump3");
+        if (!EXPECT_TRUE(Fusion::merge(schema,
+                                       prefix + "dump7",
+                                       sources, selector,
+                                       dynamicKPosOcc,
+                                       tuneFileIndexing,
+                                       fileHeaderContext,
+                                       4)))
+            return;
+    } while (0);
+    do {
+        DiskIndex dw7(prefix + "dump7");
+        if (!EXPECT_TRUE(dw7.setup(tuneFileSearch)))
+            break;
+        TEST_DO(validateDiskIndex(dw7, true, true));
+    } while (0);
+    do {
+        std::vector<vespalib::string> sources;
+        SelectorArray selector(numDocs, 0);
+        sources.push_back(prefix + "dump3");
+        // Too little memory for more than one field at a time
+        if (!EXPECT_TRUE(Fusion::merge(schema,
+                                       prefix + "dump8",
+                                       sources, selector,
+                                       dynamicKPosOcc,
+                                       tuneFileIndexing,
+                                       fileHeaderContext,
+                                       4, 1)))
+            return;
+    } while (0);
+    do {
+        DiskIndex dw8(prefix + "dump8");
+        if (!EXPECT_TRUE(dw8.setup(tuneFileSearch)))
+            break;
+        TEST_DO(validateDiskIndex(dw8, true, true));
+    } while (0);
     do {
         std::vector<vespalib::string> sources;
         SelectorArray selector(numDocs, 0);
@@ -447,6 +543,52 @@ Test::requireThatFusionIsWorking(const vespalib::string &prefix,
     } while (0);
 }
 
+void
+Test::requireThatBlockMaxWeightsSurviveFusion()
+{
+    // Enough documents to get L1 skip info for the posting list of "w"
+    uint32_t numDocs = 2000;
+    Schema schema;
+    schema.addIndexField(Schema::IndexField("f3", DataType::STRING, CollectionType::WEIGHTEDSET));
+    Dictionary d(schema);
+    DocBuilder b(schema);
+    SequencedTaskExecutor invertThreads(2);
+    SequencedTaskExecutor pushThreads(2);
+    DocumentInverter inv(schema, invertThreads, pushThreads);
+    for (uint32_t docId = 1; docId < numDocs; ++docId) {
+        b.startDocument(vespalib::make_string("doc::%u", docId)).
+            startIndexField("f3").
+            startElement(blockMaxTestWeight(docId)).addStr("w").endElement().
+            endField();
+        Document::UP doc = b.endDocument();
+        inv.invertDocument(docId, *doc);
+        invertThreads.sync();
+        myPushDocument(inv, d);
+        pushThreads.sync();
+    }
+
+    TuneFileIndexing tuneFileIndexing;
+    TuneFileSearch tuneFileSearch;
+    DummyFileHeaderContext fileHeaderContext;
+    IndexBuilder ib(schema);
+    ib.setPrefix("bdump1");
+    ib.open(numDocs, d.getNumUniqueWords(), tuneFileIndexing, fileHeaderContext);
+    d.dump(ib);
+    ib.close();
+
+    std::vector<vespalib::string> sources;
+    sources.push_back("bdump1");
+    SelectorArray selector(numDocs, 0);
+    ASSERT_TRUE(Fusion::merge(schema, "bdump2", sources, selector, false,
+                              tuneFileIndexing, fileHeaderContext));
+    for (const char *dir : { "bdump1", "bdump2" }) {
+        DiskIndex dw(dir);
+        if (!EXPECT_TRUE(dw.setup(tuneFileSearch)))
+            continue;
+        TEST_DO(validateBlockMaxWeights(dw, numDocs));
+    }
+}
+
 Test::Test()
     : _schema()
 {
@@ -469,6 +611,7 @@ Test::Main()
     TEST_DO(requireThatFusionIsWorking("d", true, false));
     TEST_DO(requireThatFusionIsWorking("m", false, true));
     TEST_DO(requireThatFusionIsWorking("dm", true, true));
+    TEST_DO(requireThatBlockMaxWeightsSurviveFusion());
 
     TEST_DONE();
 }
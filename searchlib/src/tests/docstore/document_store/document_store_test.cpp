@@ -2,7 +2,15 @@
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/searchlib/docstore/documentstore.h>
 #include <vespa/searchlib/docstore/cachestats.h>
+#include <vespa/searchlib/docstore/ibucketizer.h>
 #include <vespa/document/repo/documenttyperepo.h>
+#include <vespa/document/datatype/documenttype.h>
+#include <vespa/document/fieldvalue/document.h>
+#include <vespa/vespalib/data/databuffer.h>
+#include <vespa/vespalib/test/insertion_operators.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <algorithm>
+#include <map>
 
 using namespace search;
 using CompressionConfig = vespalib::compression::CompressionConfig;
@@ -61,4 +69,88 @@ TEST_FFF("require that cached docstore lookups are counted",
     EXPECT_EQUAL(1u, f3.getCacheStats().misses);
 }
 
+struct MemoryDataStore : NullDataStore {
+    std::map<uint32_t, vespalib::string> _blobs;
+    mutable std::vector<LidVector> _batches;
+    MemoryDataStore() : NullDataStore(), _blobs(), _batches() {}
+    ssize_t read(uint32_t lid, vespalib::DataBuffer & buffer) const override {
+        auto found = _blobs.find(lid);
+        if (found == _blobs.end()) {
+            return 0;
+        }
+        buffer.writeBytes(found->second.c_str(), found->second.size());
+        return found->second.size();
+    }
+    void read(const LidVector & lids, IBufferVisitor & visitor) const override {
+        _batches.push_back(lids);
+        for (uint32_t lid : lids) {
+            auto found = _blobs.find(lid);
+            if (found != _blobs.end()) {
+                visitor.visit(lid, vespalib::ConstBufferRef(found->second.c_str(), found->second.size()));
+            } else {
+                visitor.visit(lid, vespalib::ConstBufferRef());
+            }
+        }
+    }
+    void write(uint64_t, uint32_t lid, const void * buffer, size_t len) override {
+        _blobs[lid] = vespalib::string(static_cast<const char *>(buffer), len);
+    }
+};
+
+struct LidCollector : IDocumentVisitor {
+    std::vector<uint32_t> _lids;
+    void visit(uint32_t lid, document::Document::UP doc) override {
+        EXPECT_EQUAL(vespalib::make_string("doc:test:%u", lid), doc->getId().toString());
+        _lids.push_back(lid);
+    }
+    bool allowVisitCaching() const override { return false; }
+};
+
+struct BatchFixture {
+    MemoryDataStore backing;
+    DocumentStore store;
+    BatchFixture(size_t maxCacheBytes)
+        : backing(),
+          store(DocumentStore::Config(CompressionConfig::NONE, maxCacheBytes, 0), backing)
+    {
+        for (uint32_t lid : {1u, 2u, 3u}) {
+            document::Document doc(*document::DataType::DOCUMENT,
+                                   document::DocumentId(vespalib::make_string("doc:test:%u", lid)));
+            store.write(lid, lid, doc);
+        }
+    }
+    std::vector<uint32_t> readBatch(const IDocumentStore::LidVector & lids) {
+        LidCollector collector;
+        store.readBatch(lids, repo, collector);
+        std::sort(collector._lids.begin(), collector._lids.end());
+        return collector._lids;
+    }
+};
+
+TEST_F("require that uncached batch reads go to the data store together", BatchFixture(0))
+{
+    EXPECT_EQUAL(std::vector<uint32_t>({1, 2, 3}), f.readBatch({1, 2, 3, 4}));
+    ASSERT_EQUAL(1u, f.backing._batches.size());
+    EXPECT_EQUAL(IDocumentStore::LidVector({1, 2, 3, 4}), f.backing._batches[0]);
+    EXPECT_EQUAL(4u, f.store.getCacheStats().misses);
+}
+
+TEST_F("require that batch reads use and populate the cache", BatchFixture(100000))
+{
+    f.store.read(1, repo);
+    EXPECT_EQUAL(std::vector<uint32_t>({1, 2, 3}), f.readBatch({1, 2, 3, 4}));
+    ASSERT_EQUAL(1u, f.backing._batches.size());
+    EXPECT_EQUAL(IDocumentStore::LidVector({2, 3, 4}), f.backing._batches[0]);
+    CacheStats stats = f.store.getCacheStats();
+    EXPECT_EQUAL(1u, stats.hits);
+    EXPECT_EQUAL(4u, stats.misses);
+    EXPECT_EQUAL(3u, stats.elements);
+
+    EXPECT_EQUAL(std::vector<uint32_t>({2, 3}), f.readBatch({2, 3}));
+    EXPECT_EQUAL(1u, f.backing._batches.size());
+    EXPECT_EQUAL(3u, f.store.getCacheStats().hits);
+    ASSERT_TRUE(f.store.read(2, repo));
+    EXPECT_EQUAL(4u, f.store.getCacheStats().hits);
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -1,6 +1,7 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/searchlib/docstore/visitcache.h>
+#include <vespa/searchlib/docstore/frequencysketch.h>
 
 using namespace search;
 using namespace search::docstore;
@@ -67,4 +68,28 @@ TEST("require that BlobSet can be built") {
     verifyAB(b);
 }
 
+TEST("require that FrequencySketch estimates access counts") {
+    FrequencySketch sketch(1000);
+    for (size_t i(0); i < 5; i++) {
+        sketch.add(7);
+    }
+    sketch.add(9);
+    EXPECT_EQUAL(5u, sketch.estimate(7));
+    EXPECT_EQUAL(1u, sketch.estimate(9));
+    EXPECT_EQUAL(0u, sketch.estimate(11));
+}
+
+TEST("require that FrequencySketch counters saturate and are halved after sample period") {
+    FrequencySketch sketch(64);
+    EXPECT_EQUAL(640u, sketch.getSamplePeriod());
+    for (size_t i(0); i < 100; i++) {
+        sketch.add(7);
+    }
+    EXPECT_EQUAL(15u, sketch.estimate(7));
+    for (size_t i(100); i < sketch.getSamplePeriod(); i++) {
+        sketch.add(1000 + i);
+    }
+    EXPECT_EQUAL(7u, sketch.estimate(7));
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -4,17 +4,22 @@
 #include <vespa/document/repo/configbuilder.h>
 #include <vespa/document/repo/documenttyperepo.h>
 #include <vespa/document/datatype/documenttype.h>
+#include <vespa/searchlib/docstore/batchpread.h>
 #include <vespa/searchlib/docstore/chunkformats.h>
 #include <vespa/searchlib/docstore/logdocumentstore.h>
+#include <vespa/searchlib/docstore/randreaders.h>
 #include <vespa/searchlib/docstore/storebybucket.h>
 #include <vespa/searchlib/docstore/visitcache.h>
 #include <vespa/searchlib/index/dummyfileheadercontext.h>
 #include <vespa/searchlib/test/directory_handler.h>
+#include <vespa/vespalib/data/databuffer.h>
 #include <vespa/vespalib/stllike/asciistream.h>
 #include <vespa/vespalib/test/insertion_operators.h>
 #include <vespa/vespalib/util/exceptions.h>
 #include <vespa/vespalib/util/threadstackexecutor.h>
 #include <iomanip>
+#include <fcntl.h>
+#include <unistd.h>
 
 using document::BucketId;
 using namespace search::docstore;
@@ -397,6 +402,136 @@ TEST("test visit cache does not cache empty ones and is able to access some back
     EXPECT_EQUAL(1u, visitCache.read({1,3}).getBlobSet().getPositions().size());
 }
 
+TEST("test that overlapping sets in different visit cache shards are invalidated") {
+    const char * A7 = "aAaAaAa";
+    VisitStore store;
+    IDataStore & datastore = store.getStore();
+    for (uint32_t lid(1); lid <= 4; lid++) {
+        datastore.write(lid, lid, A7, 7);
+    }
+
+    VisitCache visitCache(datastore, 100000, CompressionConfig::Type::LZ4, 4);
+    EXPECT_EQUAL(4u, visitCache.getNumShards());
+    EXPECT_EQUAL(2u, visitCache.read({1,2}).getBlobSet().getPositions().size());
+    EXPECT_EQUAL(1u, visitCache.getCacheStats().elements);
+    EXPECT_EQUAL(2u, visitCache.read({2,3}).getBlobSet().getPositions().size());
+    EXPECT_EQUAL(1u, visitCache.getCacheStats().elements);
+    EXPECT_EQUAL(1u, visitCache.getShardCacheStats()[2].elements);
+    EXPECT_EQUAL(1u, visitCache.read({4}).getBlobSet().getPositions().size());
+    EXPECT_EQUAL(2u, visitCache.getCacheStats().elements);
+    visitCache.remove(3);
+    EXPECT_EQUAL(1u, visitCache.getCacheStats().elements);
+    EXPECT_EQUAL(0u, visitCache.getShardCacheStats()[2].elements);
+    EXPECT_EQUAL(1u, visitCache.getShardCacheStats()[0].elements);
+
+    CacheStats sum;
+    for (const CacheStats & shardStats : visitCache.getShardCacheStats()) {
+        sum += shardStats;
+    }
+    EXPECT_EQUAL(visitCache.getCacheStats().misses, sum.misses);
+    EXPECT_EQUAL(visitCache.getCacheStats().memory_used, sum.memory_used);
+}
+
+TEST("test that visit cache admission keeps frequently read sets during scans") {
+    const char * A7 = "aAaAaAa";
+    VisitStore store;
+    IDataStore & datastore = store.getStore();
+    for (uint32_t lid(1); lid <= 8; lid++) {
+        datastore.write(lid, lid, A7, 7);
+    }
+    size_t setSize(0);
+    {
+        VisitCache probe(datastore, 100000, CompressionConfig::Type::LZ4, 1);
+        probe.read({1});
+        setSize = probe.getCacheStats().memory_used;
+    }
+
+    VisitCache visitCache(datastore, setSize * 2, CompressionConfig::Type::LZ4, 1);
+    for (size_t i(0); i < 3; i++) {
+        visitCache.read({1});
+        visitCache.read({2});
+    }
+    for (uint32_t lid(3); lid <= 8; lid++) {
+        EXPECT_EQUAL(1u, visitCache.read({lid}).getBlobSet().getPositions().size());
+    }
+    CacheStats stats = visitCache.getCacheStats();
+    EXPECT_EQUAL(4u, stats.hits);
+    EXPECT_EQUAL(8u, stats.misses);
+    EXPECT_EQUAL(2u, stats.elements);
+    EXPECT_EQUAL(0u, stats.evictions);
+
+    visitCache.read({1});
+    visitCache.read({2});
+    EXPECT_EQUAL(6u, visitCache.getCacheStats().hits);
+
+    for (size_t i(0); i < 5; i++) {
+        visitCache.read({3});
+    }
+    stats = visitCache.getCacheStats();
+    EXPECT_EQUAL(2u, stats.elements);
+    EXPECT_EQUAL(1u, stats.evictions);
+}
+
+void
+verifyBatchRead(BatchPRead::Mode mode) {
+    vespalib::string fileName("batchpread.dat");
+    std::vector<char> content(100000);
+    for (size_t i(0); i < content.size(); i++) {
+        content[i] = i % 251;
+    }
+    {
+        FastOS_File file(fileName.c_str());
+        ASSERT_TRUE(file.OpenWriteOnlyTruncate());
+        ASSERT_EQUAL(ssize_t(content.size()), file.Write2(&content[0], content.size()));
+    }
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    ASSERT_TRUE(fd >= 0);
+    std::vector<std::vector<char>> buffers;
+    std::vector<BatchPRead::Read> reads;
+    for (size_t i(0); i < 101; i++) {
+        buffers.emplace_back(777);
+    }
+    for (size_t i(0); i + 1 < buffers.size(); i++) {
+        reads.emplace_back(&buffers[i][0], buffers[i].size(), (i * 7919) % (content.size() - 777));
+    }
+    reads.emplace_back(&buffers.back()[0], buffers.back().size(), content.size() - 100);
+    BatchPRead::read(fd, reads, mode);
+    for (size_t i(0); i + 1 < reads.size(); i++) {
+        EXPECT_EQUAL(777, reads[i]._result);
+        EXPECT_EQUAL(0, memcmp(&content[reads[i]._offset], reads[i]._buffer, reads[i]._size));
+    }
+    EXPECT_EQUAL(100, reads.back()._result);
+    ::close(fd);
+    FastOS_File::Delete(fileName.c_str());
+}
+
+TEST("test that batched preads return the same as the file content") {
+    TEST_DO(verifyBatchRead(BatchPRead::Mode::THREADS));
+    TEST_DO(verifyBatchRead(BatchPRead::Mode::AUTO));
+}
+
+TEST("test that AsyncRandRead reads a batch of requests") {
+    vespalib::string fileName("asyncrandread.dat");
+    {
+        FastOS_File file(fileName.c_str());
+        ASSERT_TRUE(file.OpenWriteOnlyTruncate());
+        ASSERT_EQUAL(10, file.Write2("0123456789", 10));
+    }
+    AsyncRandRead reader(fileName);
+    EXPECT_EQUAL(10, reader.getSize());
+    vespalib::DataBuffer a, b;
+    std::vector<FileRandRead::Request> requests;
+    requests.emplace_back(2, 3, a);
+    requests.emplace_back(7, 3, b);
+    reader.readBatch(requests);
+    EXPECT_EQUAL("234", vespalib::string(a.getData(), a.getDataLen()));
+    EXPECT_EQUAL("789", vespalib::string(b.getData(), b.getDataLen()));
+    vespalib::DataBuffer c;
+    reader.read(4, c, 2);
+    EXPECT_EQUAL("45", vespalib::string(c.getData(), c.getDataLen()));
+    FastOS_File::Delete(fileName.c_str());
+}
+
 using vespalib::string;
 using document::DataType;
 using document::Document;
@@ -9,6 +9,7 @@ LOG_SETUP("hitcollector_test");
 #include <vespa/searchlib/fef/fef.h>
 #include <vespa/searchlib/queryeval/hitcollector.h>
 #include <vespa/searchlib/queryeval/scores.h>
+#include <vespa/vespalib/test/insertion_operators.h>
 
 using namespace search;
 using namespace search::fef;
@@ -251,6 +252,46 @@ TEST_F("require that scores for 2nd phase candidates can be retrieved", Descendi
     EXPECT_EQUAL(96, scores[4]);
 }
 
+TEST_F("require that hits are reranked after scores for 2nd phase candidates are retrieved", AscendingScoreFixture)
+{
+    f.addHits();
+    ASSERT_EQUAL(5u, f.hc.getSortedHeapScores().size());
+    EXPECT_EQUAL(3u, f.reRank(3));
+
+    std::vector<RankedHit> expRh;
+    for (uint32_t i = 10; i < 20; ++i) {  // 10 last are the best
+        expRh.push_back(RankedHit(i, f.calculateScore(i)));
+        if (i >= 17) { // hits from heap (3 last)
+            expRh.back()._rankValue = i + 200; // after reranking
+        }
+    }
+
+    std::unique_ptr<ResultSet> rs = f.hc.getResultSet();
+    TEST_DO(checkResult(*rs.get(), expRh));
+    TEST_DO(checkResult(*rs.get(), f.expBv.get()));
+}
+
+TEST_F("require that hits are ordered when scores for 2nd phase candidates are retrieved without reranking", Fixture)
+{
+    // the 5 best hits are spread out, so the candidates must be moved to the front
+    for (uint32_t i = 0; i < 10; ++i) {
+        f.hc.addHit(i, (i % 2 == 0) ? 100 + i : i);
+    }
+    std::vector<feature_t> scores = f.hc.getSortedHeapScores();
+    ASSERT_EQUAL(5u, scores.size());
+    EXPECT_EQUAL(108, scores[0]);
+    EXPECT_EQUAL(0u, f.reRank(0));
+
+    std::vector<RankedHit> expRh;
+    for (uint32_t i = 0; i < 10; ++i) {
+        expRh.push_back(RankedHit(i, (i % 2 == 0) ? 100 + i : i));
+    }
+
+    std::unique_ptr<ResultSet> rs = f.hc.getResultSet();
+    TEST_DO(checkResult(*rs.get(), expRh));
+    TEST_DO(checkResult(*rs.get(), nullptr));
+}
+
 TEST("require that score ranges can be read and set.") {
     std::pair<Scores, Scores> ranges =
         std::make_pair(Scores(1.0, 2.0), Scores(3.0, 4.0));
@@ -531,4 +572,83 @@ TEST("require that hits can be added out of order only after passing array limit
     TEST_DO(checkResult(*rs.get(), nullptr));
 }
 
+TEST("require that the best hits are kept when many hits have the same score") {
+    const uint32_t numDocs = 3000;
+    HitCollector hc(numDocs, 100, 20);
+    std::vector<HitCollector::Hit> hits;
+    for (uint32_t i = 0; i < numDocs; ++i) {
+        feature_t score = (i * 7919) % 50;
+        hc.addHit(i, score);
+        hits.emplace_back(i, score);
+    }
+    // best score first, lowest doc id first among equal scores
+    std::sort(hits.begin(), hits.end(), [](const HitCollector::Hit &lhs, const HitCollector::Hit &rhs)
+              { return (lhs.second > rhs.second) || ((lhs.second == rhs.second) && (lhs.first < rhs.first)); });
+    std::vector<feature_t> scores = hc.getSortedHeapScores();
+    ASSERT_EQUAL(20u, scores.size());
+    for (uint32_t i = 0; i < 20; ++i) {
+        EXPECT_EQUAL(hits[i].second, scores[i]);
+    }
+    BasicScorer scorer(1000);
+    EXPECT_EQUAL(20u, hc.reRank(scorer));
+    for (uint32_t i = 0; i < 20; ++i) {
+        hits[i].second = scorer.score(hits[i].first);
+    }
+    hits.resize(100);
+    std::sort(hits.begin(), hits.end());
+    std::vector<RankedHit> expRh;
+    for (const auto &hit : hits) {
+        expRh.push_back(RankedHit());
+        expRh.back()._docId = hit.first;
+        expRh.back()._rankValue = hit.second;
+    }
+    std::unique_ptr<ResultSet> rs = hc.getResultSet();
+    TEST_DO(checkResult(*rs.get(), expRh));
+}
+
+struct DocIdRecorder : public HitCollector::DocumentScorer
+{
+    std::vector<uint32_t> _docIds;
+    virtual feature_t score(uint32_t docId) override {
+        _docIds.push_back(docId);
+        return docId;
+    }
+};
+
+TEST("require that hits with NaN scores are ordered last") {
+    const uint32_t numDocs = 3000;
+    HitCollector hc(numDocs, 100, 20);
+    std::vector<uint32_t> realScoreDocIds;
+    for (uint32_t i = 0; i < numDocs; ++i) {
+        if ((i % 300) == 150) {
+            hc.addHit(i, i);
+            realScoreDocIds.push_back(i);
+        } else {
+            hc.addHit(i, std::numeric_limits<feature_t>::quiet_NaN());
+        }
+    }
+    ASSERT_EQUAL(10u, realScoreDocIds.size());
+    // the hits with real scores, then the NaN hits with the lowest doc ids
+    std::vector<uint32_t> expReRanked(realScoreDocIds);
+    for (uint32_t i = 0; i < 10; ++i) {
+        expReRanked.push_back(i);
+    }
+    std::sort(expReRanked.begin(), expReRanked.end());
+    DocIdRecorder scorer;
+    EXPECT_EQUAL(20u, hc.reRank(scorer));
+    EXPECT_EQUAL(expReRanked, scorer._docIds);
+
+    std::unique_ptr<ResultSet> rs = hc.getResultSet();
+    ASSERT_EQUAL(100u, rs->getArrayUsed());
+    std::vector<uint32_t> expHits(realScoreDocIds);
+    for (uint32_t i = 0; i < 90; ++i) {
+        expHits.push_back(i);
+    }
+    std::sort(expHits.begin(), expHits.end());
+    const RankedHit *rh = rs->getArray();
+    for (uint32_t i = 0; i < expHits.size(); ++i) {
+        EXPECT_EQUAL(expHits[i], rh[i]._docId);
+    }
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -300,6 +300,32 @@ TEST_F("requireThatMixOfAddAndRemoveWorks", Fixture)
 }
 
 
+TEST_F("require that documents inverted in separate shards are merged on push", Fixture)
+{
+    FieldInverter shard1(f._schema, 0);
+    f._inverters[0]->invertField(10, makeDoc10(f._b)->getValue("f0"));
+    shard1.remove("c", 9);
+    shard1.remove("a", 11);
+    shard1.invertField(11, makeDoc11(f._b)->getValue("f0"));
+    f._inverters[0]->invertField(12, makeDoc12(f._b)->getValue("f0"));
+    shard1.invertField(13, makeDoc13(f._b)->getValue("f0"));
+    std::vector<FieldInverter *> shards({f._inverters[0].get(), &shard1});
+    f._inserter.setFieldId(0);
+    FieldInverter::pushDocuments(shards, f._inserter);
+    EXPECT_EQUAL("f=0,w=a,a=10,r=11,a=11,"
+                 "w=b,a=10,a=11,"
+                 "w=c,r=9,a=10,"
+                 "w=d,a=10,"
+                 "w=doc12,a=12,"
+                 "w=doc13,a=13,"
+                 "w=e,a=11,"
+                 "w=f,a=11,"
+                 "w=h,a=12,"
+                 "w=i,a=13",
+                 f._inserter.toStr());
+}
+
+
 TEST_F("require that empty document can be inverted", Fixture)
 {
     f.invertDocument(15, *makeDoc15(f._b));
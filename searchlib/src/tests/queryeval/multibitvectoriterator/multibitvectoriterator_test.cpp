@@ -27,6 +27,7 @@ public:
     void testOr();
     void testAndWith();
     void testEndGuard();
+    void testSparse();
     template<typename T>
     void testThatOptimizePreservesUnpack();
     template <typename T>
@@ -503,6 +504,51 @@ Test::testEndGuard()
     EXPECT_FALSE(m.seek(_bvs[0]->size()+987));
 }
 
+void
+Test::testSparse()
+{
+    const uint32_t docIdLimit = 100000;
+    std::vector<BitVector::UP> bvs;
+    for (uint32_t i(0); i < 3; i++) {
+        bvs.push_back(BitVector::create(docIdLimit));
+        BitVector & bv(*bvs.back());
+        for (uint32_t docId(i + 1); docId < docIdLimit; docId += 997 + 2*i) {
+            bv.setBit(docId);
+        }
+        // Common hits after long gaps, the last one in the last word.
+        bv.setBit(70001);
+        bv.setBit(docIdLimit - 1);
+        bv.invalidateCachedCount();
+    }
+    TermFieldMatchData tfmd;
+    TermFieldMatchDataArray tfmda;
+    tfmda.add(&tfmd);
+    for (bool isAnd : {true, false}) {
+        MultiSearch::Children children;
+        for (const auto & bv : bvs) {
+            children.push_back(BitVectorIterator::create(bv.get(), tfmda, true).release());
+        }
+        SearchIterator::UP s(isAnd ? AndSearch::create(children, true) : OrSearch::create(children, true));
+        s = MultiBitVectorIteratorBase::optimize(std::move(s));
+        EXPECT_TRUE(dynamic_cast<const MultiBitVectorIteratorBase *>(s.get()) != nullptr);
+        H expected;
+        for (uint32_t docId(1); docId < docIdLimit; docId++) {
+            size_t numSet(0);
+            for (const auto & bv : bvs) {
+                numSet += bv->testBit(docId) ? 1 : 0;
+            }
+            if (isAnd ? (numSet == bvs.size()) : (numSet > 0)) {
+                expected.push_back(docId);
+            }
+        }
+        H hits = seek(*s, docIdLimit);
+        ASSERT_EQUAL(expected.size(), hits.size());
+        for (size_t i(0); i < hits.size(); i++) {
+            EXPECT_EQUAL(expected[i], hits[i]);
+        }
+    }
+}
+
 int
 Test::Main()
 {
@@ -514,6 +560,8 @@ Test::Main()
     TEST_FLUSH();
     testEndGuard();
     TEST_FLUSH();
+    testSparse();
+    TEST_FLUSH();
     testAndNot();
     TEST_FLUSH();
     testAnd();
@@ -407,6 +407,92 @@ TEST_F("require that dot product score is calculated", SearchFixture)
 }
 
 
+/**
+ * Search over a fake result exposing max weights for fixed size blocks
+ * of documents, counting the number of unpacked documents.
+ **/
+class BlockMaxSearch : public SearchIterator, public BlockMaxWeightInfo
+{
+private:
+    FakeResult                   _result;
+    size_t                       _blockSize;
+    bool                         _blockMax;
+    size_t                       _offset;
+    search::fef::TermFieldMatchData &_tfmd;
+    size_t                       &_unpacks;
+
+    size_t blockEnd() const { return std::min(((_offset / _blockSize) + 1) * _blockSize, _result.inspect().size()); }
+
+public:
+    BlockMaxSearch(const FakeResult &result, size_t blockSize, bool blockMax,
+                   search::fef::TermFieldMatchData &tfmd, size_t &unpacks)
+        : _result(result), _blockSize(blockSize), _blockMax(blockMax), _offset(0), _tfmd(tfmd), _unpacks(unpacks)
+    {}
+    void doSeek(uint32_t docid) override {
+        while (_offset < _result.inspect().size() && _result.inspect()[_offset].docId < docid) {
+            ++_offset;
+        }
+        if (_offset < _result.inspect().size()) {
+            setDocId(_result.inspect()[_offset].docId);
+        } else {
+            setAtEnd();
+        }
+    }
+    void doUnpack(uint32_t docid) override {
+        ++_unpacks;
+        _tfmd.reset(docid);
+        search::fef::TermFieldMatchDataPosition pos;
+        pos.setElementWeight(_result.inspect()[_offset].elements[0].weight);
+        _tfmd.appendPosition(pos);
+    }
+    bool hasBlockMaxWeights() const override { return _blockMax; }
+    int32_t getBlockMaxWeight() const override {
+        int32_t maxWeight = std::numeric_limits<int32_t>::min();
+        for (size_t i = (_offset / _blockSize) * _blockSize; i < blockEnd(); ++i) {
+            maxWeight = std::max(maxWeight, _result.inspect()[i].elements[0].weight);
+        }
+        return maxWeight;
+    }
+    uint32_t getBlockLastDocId() const override { return _result.inspect()[blockEnd() - 1].docId; }
+};
+
+struct BlockMaxFixture
+{
+    WandSpecWithRealHeap spec;
+    MatchDataLayout      layout;
+    std::vector<TermFieldHandle> handles;
+    size_t               unpacks;
+    FakeResult           result;
+    BlockMaxFixture(bool blockMax) : spec(2, 1), layout(), handles(), unpacks(0), result() {
+        FakeResult a;
+        FakeResult b;
+        for (uint32_t docid = 1; docid <= 1000; ++docid) {
+            a.doc(docid).weight((docid == 10 || docid == 500) ? 100 : 1).pos(0);
+            if ((docid % 2) == 0) {
+                b.doc(docid).weight((docid == 10 || docid == 900) ? 100 : 1).pos(0);
+            }
+        }
+        handles.push_back(layout.allocTermField(0));
+        handles.push_back(layout.allocTermField(0));
+        MatchData::UP md = layout.createMatchData();
+        wand::Terms terms;
+        terms.push_back(wand::Term(new BlockMaxSearch(a, 16, blockMax, *md->resolveTermField(handles[0]), unpacks),
+                                   1, 1000, md->resolveTermField(handles[0])));
+        terms.push_back(wand::Term(new BlockMaxSearch(b, 16, blockMax, *md->resolveTermField(handles[1]), unpacks),
+                                   1, 500, md->resolveTermField(handles[1])));
+        SearchIterator::UP search(ParallelWeakAndSearch::create(terms, spec.matchParams,
+                                                                RankParams(spec.rootMatchData, std::move(md)), true));
+        result = doSearch(*search, spec.rootMatchData);
+    }
+};
+
+TEST_FF("require that blocks that cannot beat the threshold are skipped", BlockMaxFixture(false), BlockMaxFixture(true))
+{
+    EXPECT_EQUAL(f1.result, f2.result);
+    EXPECT_LESS(f2.unpacks * 10, f1.unpacks);
+}
+
+
 struct BlueprintFixtureBase
 {
     WandBlueprintSpec spec;
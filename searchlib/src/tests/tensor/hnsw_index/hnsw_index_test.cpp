@@ -0,0 +1,298 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/log/log.h>
+LOG_SETUP("hnsw_index_test");
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/searchlib/tensor/distance_function.h>
+#include <vespa/searchlib/tensor/doc_vector_access.h>
+#include <vespa/searchlib/tensor/hnsw_index.h>
+#include <vespa/vespalib/util/generationhandler.h>
+#include <algorithm>
+#include <random>
+#include <set>
+
+using search::attribute::HnswIndexParams;
+using search::tensor::DistanceFunction;
+using search::tensor::DocVectorAccess;
+using search::tensor::HnswIndex;
+using search::tensor::InnerProductDistance;
+using search::tensor::SquaredEuclideanDistance;
+using vespalib::GenerationHandler;
+using vespalib::GenerationHolder;
+
+using Vector = std::vector<double>;
+using DocIdVector = std::vector<uint32_t>;
+
+namespace std {
+
+std::ostream &
+operator<<(std::ostream &os, const DocIdVector &docIds)
+{
+    os << "[";
+    for (size_t i = 0; i < docIds.size(); ++i) {
+        os << ((i > 0) ? "," : "") << docIds[i];
+    }
+    return os << "]";
+}
+
+}
+
+class MyDocVectorAccess : public DocVectorAccess {
+    std::vector<Vector> _vectors;
+public:
+    MyDocVectorAccess() : _vectors() {}
+    MyDocVectorAccess &set(uint32_t docId, const Vector &vector) {
+        if (docId >= _vectors.size()) {
+            _vectors.resize(docId + 1);
+        }
+        _vectors[docId] = vector;
+        return *this;
+    }
+    void clear(uint32_t docId) { _vectors[docId].clear(); }
+    vespalib::ConstArrayRef<double> getVector(uint32_t docId) const override {
+        if (docId >= _vectors.size()) {
+            return vespalib::ConstArrayRef<double>();
+        }
+        return vespalib::ConstArrayRef<double>(_vectors[docId].data(), _vectors[docId].size());
+    }
+};
+
+struct Fixture {
+    MyDocVectorAccess vectors;
+    std::unique_ptr<DistanceFunction> distance;
+    GenerationHandler genHandler;
+    GenerationHolder genHolder;
+    HnswIndex index;
+
+    Fixture(uint32_t maxLinksPerNode = 4,
+            HnswIndexParams::DistanceMetric metric = HnswIndexParams::DistanceMetric::EUCLIDEAN)
+        : vectors(),
+          distance(DistanceFunction::create(metric)),
+          genHandler(),
+          genHolder(),
+          index(vectors, *distance, genHolder, HnswIndexParams(maxLinksPerNode, 50, metric))
+    {
+    }
+    ~Fixture() {
+        genHolder.clearHoldLists();
+    }
+    void commit() {
+        index.transferHoldLists(genHandler.getCurrentGeneration());
+        genHolder.transferHoldLists(genHandler.getCurrentGeneration());
+        genHandler.incGeneration();
+        genHandler.updateFirstUsedGeneration();
+        index.trimHoldLists(genHandler.getFirstUsedGeneration());
+        genHolder.trimHoldLists(genHandler.getFirstUsedGeneration());
+    }
+    void add(uint32_t docId, const Vector &vector) {
+        vectors.set(docId, vector);
+        index.addDocument(docId);
+        commit();
+    }
+    void remove(uint32_t docId) {
+        index.removeDocument(docId);
+        vectors.clear(docId);
+        commit();
+    }
+    DocIdVector findTopK(uint32_t k, const Vector &vector, uint32_t exploreK = 0) {
+        DocIdVector result;
+        for (const auto &hit : index.findTopK(k, vespalib::ConstArrayRef<double>(vector.data(), vector.size()), exploreK)) {
+            result.push_back(hit.docId);
+        }
+        return result;
+    }
+    void assertLinksExist() {
+        for (uint32_t docId = 1; docId < 100; ++docId) {
+            for (uint32_t level = 0; level < index.getLevels(docId); ++level) {
+                for (uint32_t link : index.getLinksCopy(docId, level)) {
+                    EXPECT_NOT_EQUAL(docId, link);
+                }
+            }
+        }
+    }
+    void assertLinksAreSymmetric(uint32_t docIdLimit) {
+        for (uint32_t docId = 1; docId < docIdLimit; ++docId) {
+            for (uint32_t level = 0; level < index.getLevels(docId); ++level) {
+                for (uint32_t link : index.getLinksCopy(docId, level)) {
+                    EXPECT_GREATER(index.getLevels(link), level);
+                    auto reverse = index.getLinksCopy(link, level);
+                    EXPECT_TRUE(std::find(reverse.begin(), reverse.end(), docId) != reverse.end());
+                }
+            }
+        }
+    }
+};
+
+TEST("require that squared euclidean distance is calculated")
+{
+    SquaredEuclideanDistance distance;
+    Vector a = {1, 2, 3, 4, 5};
+    Vector b = {2, 2, 1, 4, 8};
+    EXPECT_EQUAL(14.0, distance.calc(vespalib::ConstArrayRef<double>(a.data(), a.size()),
+                                     vespalib::ConstArrayRef<double>(b.data(), b.size())));
+    EXPECT_EQUAL(0.5, distance.toRawScore(1.0));
+}
+
+TEST("require that inner product distance is negated dot product")
+{
+    InnerProductDistance distance;
+    Vector a = {1, 2, 3};
+    Vector b = {4, 5, 6};
+    EXPECT_EQUAL(-32.0, distance.calc(vespalib::ConstArrayRef<double>(a.data(), a.size()),
+                                      vespalib::ConstArrayRef<double>(b.data(), b.size())));
+    EXPECT_EQUAL(32.0, distance.toRawScore(-32.0));
+}
+
+TEST_F("require that empty index finds nothing", Fixture)
+{
+    EXPECT_EQUAL(DocIdVector(), f.findTopK(3, {1, 1}));
+}
+
+TEST_F("require that nearest documents are found in small index", Fixture)
+{
+    f.add(1, {0, 0});
+    f.add(2, {10, 0});
+    f.add(3, {0, 10});
+    f.add(4, {10, 10});
+    f.add(5, {5, 5});
+    EXPECT_EQUAL(DocIdVector({5}), f.findTopK(1, {6, 6}));
+    EXPECT_EQUAL(DocIdVector({4, 5}), f.findTopK(2, {9, 9}, 10));
+    EXPECT_EQUAL(DocIdVector({1, 5, 2, 3, 4}), f.findTopK(10, {1, 0}, 10));
+}
+
+TEST_F("require that removed documents are not found", Fixture)
+{
+    for (uint32_t docId = 1; docId < 50; ++docId) {
+        f.add(docId, {double(docId), 0});
+    }
+    f.remove(20);
+    f.remove(21);
+    EXPECT_EQUAL(DocIdVector({19, 22, 18}), f.findTopK(3, {20.4, 0}, 10));
+    EXPECT_EQUAL(0u, f.index.getLevels(20));
+    for (uint32_t docId = 1; docId < 50; ++docId) {
+        for (uint32_t level = 0; level < f.index.getLevels(docId); ++level) {
+            auto links = f.index.getLinksCopy(docId, level);
+            EXPECT_TRUE(std::find(links.begin(), links.end(), 20u) == links.end());
+            EXPECT_TRUE(std::find(links.begin(), links.end(), 21u) == links.end());
+        }
+    }
+}
+
+TEST_F("require that entry node is replaced when removed", Fixture)
+{
+    for (uint32_t docId = 1; docId < 50; ++docId) {
+        f.add(docId, {double(docId), double(docId % 7)});
+    }
+    for (uint32_t i = 0; i < 45; ++i) {
+        uint32_t entry = f.index.getEntryDocId();
+        f.remove(entry);
+        EXPECT_NOT_EQUAL(entry, f.index.getEntryDocId());
+        EXPECT_EQUAL(f.index.getLevels(f.index.getEntryDocId()), f.index.getEntryLevel() + 1);
+    }
+    EXPECT_EQUAL(4u, f.findTopK(10, {0, 0}, 10).size());
+    f.assertLinksExist();
+}
+
+TEST_F("require that links stay symmetric when documents are added and removed", Fixture)
+{
+    std::mt19937 rnd(17);
+    std::uniform_real_distribution<double> dist(-10.0, 10.0);
+    std::set<uint32_t> present;
+    for (uint32_t round = 0; round < 500; ++round) {
+        uint32_t docId = 1 + rnd() % 100;
+        if (present.count(docId) != 0) {
+            f.remove(docId);
+            present.erase(docId);
+        } else {
+            f.add(docId, {dist(rnd), dist(rnd)});
+            present.insert(docId);
+        }
+    }
+    TEST_DO(f.assertLinksAreSymmetric(101));
+    for (uint32_t docId = 1; docId <= 100; ++docId) {
+        EXPECT_EQUAL(present.count(docId) != 0, f.index.getLevels(docId) > 0);
+    }
+}
+
+TEST_F("require that prepared documents can be completed as a batch", Fixture(16))
+{
+    for (uint32_t docId = 1; docId < 200; ++docId) {
+        f.vectors.set(docId, {double(docId % 20), double(docId / 20)});
+    }
+    std::vector<HnswIndex::PreparedAddDoc> batch;
+    for (uint32_t docId = 1; docId < 200; ++docId) {
+        batch.push_back(f.index.prepareAddDocument(docId, f.index.drawLevel()));
+    }
+    for (const auto &prepared : batch) {
+        f.index.completeAddDocument(prepared);
+    }
+    f.commit();
+    TEST_DO(f.assertLinksAreSymmetric(200));
+    EXPECT_EQUAL(DocIdVector({67}), f.findTopK(1, {7.1, 3.1}, 10));
+    EXPECT_EQUAL(10u, f.findTopK(10, {0, 0}, 20).size());
+}
+
+TEST_F("require that document can be re-added with new vector", Fixture)
+{
+    for (uint32_t docId = 1; docId < 20; ++docId) {
+        f.add(docId, {double(docId), 0});
+    }
+    f.remove(3);
+    f.add(3, {100, 0});
+    EXPECT_EQUAL(DocIdVector({3, 19}), f.findTopK(2, {99, 0}, 10));
+    EXPECT_EQUAL(DocIdVector({2, 4}), f.findTopK(2, {2.9, 0}, 10));
+}
+
+TEST_F("require that inner product metric finds largest dot products",
+       Fixture(4, HnswIndexParams::DistanceMetric::INNER_PRODUCT))
+{
+    f.add(1, {1, 0});
+    f.add(2, {0, 1});
+    f.add(3, {3, 3});
+    f.add(4, {-5, 0});
+    EXPECT_EQUAL(DocIdVector({3, 1}), f.findTopK(2, {1, 0.1}, 10));
+    EXPECT_EQUAL(DocIdVector({4}), f.findTopK(1, {-1, 0}, 10));
+}
+
+TEST_F("require that recall is good compared to brute force search", Fixture(16))
+{
+    constexpr uint32_t numDocs = 2000;
+    constexpr uint32_t numDims = 8;
+    constexpr uint32_t k = 10;
+    std::mt19937 rnd(42);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<Vector> docs(numDocs + 1);
+    for (uint32_t docId = 1; docId <= numDocs; ++docId) {
+        for (uint32_t dim = 0; dim < numDims; ++dim) {
+            docs[docId].push_back(dist(rnd));
+        }
+        f.vectors.set(docId, docs[docId]);
+        f.index.addDocument(docId);
+    }
+    f.commit();
+    size_t found = 0;
+    constexpr uint32_t numQueries = 50;
+    for (uint32_t query = 0; query < numQueries; ++query) {
+        Vector q;
+        for (uint32_t dim = 0; dim < numDims; ++dim) {
+            q.push_back(dist(rnd));
+        }
+        std::vector<std::pair<double, uint32_t>> exact;
+        for (uint32_t docId = 1; docId <= numDocs; ++docId) {
+            exact.emplace_back(f.distance->calc(vespalib::ConstArrayRef<double>(q.data(), q.size()),
+                                                vespalib::ConstArrayRef<double>(docs[docId].data(), numDims)), docId);
+        }
+        std::partial_sort(exact.begin(), exact.begin() + k, exact.end());
+        std::set<uint32_t> expected;
+        for (uint32_t i = 0; i < k; ++i) {
+            expected.insert(exact[i].second);
+        }
+        for (uint32_t docId : f.findTopK(k, q, 100)) {
+            found += expected.count(docId);
+        }
+    }
+    double recall = double(found) / (numQueries * k);
+    LOG(info, "recall@%u = %f", k, recall);
+    EXPECT_GREATER_EQUAL(recall, 0.95);
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -17,6 +17,7 @@
 #include <vespa/searchlib/queryeval/emptysearch.h>
 #include <vespa/searchlib/queryeval/intermediate_blueprints.h>
 #include <vespa/searchlib/queryeval/leaf_blueprints.h>
+#include <vespa/searchlib/queryeval/nearest_neighbor_blueprint.h>
 #include <vespa/searchlib/queryeval/orlikesearch.h>
 #include <vespa/searchlib/queryeval/dot_product_blueprint.h>
 #include <vespa/searchlib/queryeval/wand/parallel_weak_and_blueprint.h>
@@ -25,6 +26,7 @@
 #include <vespa/searchlib/queryeval/weighted_set_term_search.h>
 #include <vespa/searchlib/queryeval/weighted_set_term_blueprint.h>
 #include <vespa/searchlib/queryeval/get_weight_from_node.h>
+#include <vespa/searchlib/tensor/dense_tensor_attribute.h>
 
 
 #include <vespa/vespalib/util/regexp.h>
@@ -58,6 +60,7 @@ using search::queryeval::DotProductBlueprint;
 using search::queryeval::FieldSpec;
 using search::queryeval::FieldSpecBaseList;
 using search::queryeval::IRequestContext;
+using search::queryeval::NearestNeighborBlueprint;
 using search::queryeval::NoUnpack;
 using search::queryeval::OrLikeSearch;
 using search::queryeval::OrSearch;
@@ -66,6 +69,7 @@ using search::queryeval::PredicateBlueprint;
 using search::queryeval::SearchIterator;
 using search::queryeval::Searchable;
 using search::queryeval::WeightedSetTermBlueprint;
+using search::tensor::DenseTensorAttribute;
 using vespalib::geo::ZCurve;
 using vespalib::string;
 
@@ -440,6 +444,67 @@ bool check_valid_diversity_attr(const IAttributeVector *attr) {
 
 //-----------------------------------------------------------------------------
 
+/**
+ * Parses the term of a nearest neighbor search in a dense tensor
+ * attribute: the query vector as "[x0,x1,...]", then ";targetNumHits"
+ * and optionally ";exploreAdditionalHits".
+ **/
+bool
+parseNearestNeighborTerm(const vespalib::string &term, std::vector<double> &queryVector,
+                         uint32_t &targetNumHits, uint32_t &exploreAdditionalHits)
+{
+    const char *p = term.c_str();
+    if (*p++ != '[') {
+        return false;
+    }
+    while (*p != ']') {
+        char *end = nullptr;
+        double value = strtod(p, &end);
+        if (end == p) {
+            return false;
+        }
+        queryVector.push_back(value);
+        p = end;
+        if (*p == ',') {
+            ++p;
+        } else if (*p != ']') {
+            return false;
+        }
+    }
+    ++p;
+    if (*p++ != ';') {
+        return false;
+    }
+    char *end = nullptr;
+    targetNumHits = strtoul(p, &end, 10);
+    if ((end == p) || (targetNumHits == 0)) {
+        return false;
+    }
+    p = end;
+    exploreAdditionalHits = 0;
+    if (*p == ';') {
+        ++p;
+        exploreAdditionalHits = strtoul(p, &end, 10);
+        if (end == p) {
+            return false;
+        }
+        p = end;
+    }
+    return (*p == '\0');
+}
+
+size_t
+numCells(const vespalib::eval::ValueType &tensorType)
+{
+    size_t cells = 1;
+    for (const auto &dim : tensorType.dimensions()) {
+        cells *= dim.size;
+    }
+    return cells;
+}
+
+//-----------------------------------------------------------------------------
+
 
 /**
  * Determines the correct Blueprint to use.
@@ -489,6 +554,26 @@ public:
         }
     }
 
+    void visitNearestNeighbor(StringTerm &n, const DenseTensorAttribute &attr) {
+        std::vector<double> queryVector;
+        uint32_t targetNumHits = 0;
+        uint32_t exploreAdditionalHits = 0;
+        if (attr.nearestNeighborIndex() == nullptr) {
+            LOG(warning, "Trying to apply a nearest neighbor search to dense tensor attribute '%s' "
+                "without a nearest neighbor index.", attr.getName().c_str());
+            setResult(std::make_unique<queryeval::EmptyBlueprint>(_field));
+        } else if (!parseNearestNeighborTerm(n.getTerm(), queryVector, targetNumHits, exploreAdditionalHits) ||
+                   (queryVector.size() != numCells(attr.getConfig().tensorType())))
+        {
+            LOG(warning, "Malformed nearest neighbor term '%s' for dense tensor attribute '%s'.",
+                n.getTerm().c_str(), attr.getName().c_str());
+            setResult(std::make_unique<queryeval::EmptyBlueprint>(_field));
+        } else {
+            setResult(std::make_unique<NearestNeighborBlueprint>(_field, attr, std::move(queryVector),
+                                                                 targetNumHits, exploreAdditionalHits));
+        }
+    }
+
     void visit(NumberTerm & n) override { visitTerm(n, true); }
     void visit(LocationTerm &n) override { visitLocation(n); }
     void visit(PrefixTerm & n) override { visitTerm(n); }
@@ -511,7 +596,14 @@ public:
         }
     }
 
-    void visit(StringTerm & n) override { visitTerm(n, true); }
+    void visit(StringTerm & n) override {
+        const DenseTensorAttribute *tensorAttr = dynamic_cast<const DenseTensorAttribute *>(&_attr);
+        if (tensorAttr != nullptr) {
+            visitNearestNeighbor(n, *tensorAttr);
+        } else {
+            visitTerm(n, true);
+        }
+    }
     void visit(SubstringTerm & n) override {
         search::query::SimpleRegExpTerm re(vespalib::Regexp::make_from_substring(n.getTerm()),
                                            n.getView(), n.getId(), n.getWeight());
@@ -148,6 +148,50 @@ public:
     { }
 };
 
+/**
+ * This class acts as a strict iterator over a single value attribute
+ * vector that does not use posting lists, like AttributeIteratorStrict
+ * and FilterAttributeIteratorStrict.  Instead of comparing one document
+ * at a time, it lets the search context match a block of documents into
+ * bit vector words using vector instructions, and then walks the set
+ * bits.  The same words are used directly when the hits are wanted as a
+ * bit vector.
+ *
+ * @param SC the specialized search context type associated with this iterator.
+ *           It must be able to match whole words with matchWords.
+ * @param Parent AttributeIteratorT<SC> or FilterAttributeIteratorT<SC>
+ */
+template <typename SC, typename Parent>
+class AttributeBlockScanIteratorStrict : public Parent
+{
+private:
+    static constexpr uint32_t BLOCK_WORDS = 16;
+
+    using Parent::_searchContext;
+    using Trinary=vespalib::Trinary;
+
+    uint32_t _blockBegin;
+    uint32_t _blockEnd;
+    uint64_t _words[BLOCK_WORDS];
+
+    uint32_t matchBlock(uint32_t begin, uint32_t end, uint64_t * words) const;
+    template <typename Func>
+    void scanWords(uint32_t begin, uint32_t end, Func func) const;
+    void initRange(uint32_t begin, uint32_t end) override;
+    void doSeek(uint32_t docId) override;
+    void and_hits_into(BitVector & result, uint32_t begin_id) override;
+    void or_hits_into(BitVector & result, uint32_t begin_id) override;
+    std::unique_ptr<BitVector> get_hits(uint32_t begin_id) override;
+    Trinary is_strict() const override { return Trinary::True; }
+public:
+    AttributeBlockScanIteratorStrict(const SC &searchContext, fef::TermFieldMatchData * matchData)
+        : Parent(searchContext, matchData),
+          _blockBegin(0),
+          _blockEnd(0),
+          _words()
+    { }
+};
+
 /**
  * This class acts as an iterator over documents that are results for
  * the subquery represented by the search context object associated
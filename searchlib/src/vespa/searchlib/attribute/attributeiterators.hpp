@@ -10,6 +10,7 @@
 #include <vespa/searchlib/query/queryterm.h>
 #include <vespa/searchlib/common/bitvector.h>
 #include <vespa/vespalib/objects/visit.h>
+#include <vespa/vespalib/util/optimized.h>
 
 namespace search {
 
@@ -380,6 +381,129 @@ FilterAttributeIteratorStrict<SC>::doSeek(uint32_t docId)
     setAtEnd();
 }
 
+template <typename SC, typename Parent>
+uint32_t
+AttributeBlockScanIteratorStrict<SC, Parent>::matchBlock(uint32_t begin, uint32_t end, uint64_t * words) const
+{
+    // begin is always at the start of a word
+    uint32_t fullWords = (end - begin) >> 6;
+    _searchContext.matchWords(begin, fullWords, words);
+    uint32_t tailBegin = begin + (fullWords << 6);
+    if (tailBegin == end) {
+        return fullWords;
+    }
+    uint64_t tail(0);
+    for (uint32_t docId(tailBegin); docId < end; ++docId) {
+        if (_searchContext.cmp(docId)) {
+            tail |= uint64_t(1) << (docId - tailBegin);
+        }
+    }
+    words[fullWords] = tail;
+    return fullWords + 1;
+}
+
+template <typename SC, typename Parent>
+template <typename Func>
+void
+AttributeBlockScanIteratorStrict<SC, Parent>::scanWords(uint32_t begin, uint32_t end, Func func) const
+{
+    uint64_t words[BLOCK_WORDS];
+    for (uint32_t blockBegin(begin & ~63u); blockBegin < end; blockBegin += BLOCK_WORDS * 64) {
+        uint32_t blockEnd = std::min(end, blockBegin + BLOCK_WORDS * 64);
+        uint32_t numWords = matchBlock(blockBegin, blockEnd, words);
+        for (uint32_t i(0); i < numWords; ++i) {
+            uint32_t wordBegin = blockBegin + (i << 6);
+            uint64_t valid(~uint64_t(0));
+            if (wordBegin < begin) {
+                valid &= ~uint64_t(0) << (begin - wordBegin);
+            }
+            if (end - wordBegin < 64) {
+                valid &= (uint64_t(1) << (end - wordBegin)) - 1;
+            }
+            func(wordBegin, words[i] & valid, valid);
+        }
+    }
+}
+
+template <typename SC, typename Parent>
+void
+AttributeBlockScanIteratorStrict<SC, Parent>::initRange(uint32_t begin, uint32_t end)
+{
+    Parent::initRange(begin, end);
+    // the matched block was limited by the previous end
+    _blockBegin = 0;
+    _blockEnd = 0;
+}
+
+template <typename SC, typename Parent>
+void
+AttributeBlockScanIteratorStrict<SC, Parent>::doSeek(uint32_t docId)
+{
+    const uint32_t endId = this->getEndId();
+    while (docId < endId) {
+        if ((docId < _blockBegin) || (docId >= _blockEnd)) {
+            _blockBegin = docId & ~63u;
+            _blockEnd = std::min(endId, _blockBegin + BLOCK_WORDS * 64);
+            matchBlock(_blockBegin, _blockEnd, _words);
+        }
+        uint32_t wordIdx = (docId - _blockBegin) >> 6;
+        uint32_t numWords = (_blockEnd - _blockBegin + 63) >> 6;
+        uint64_t word = _words[wordIdx] & (~uint64_t(0) << (docId & 63));
+        while ((word == 0) && (++wordIdx < numWords)) {
+            word = _words[wordIdx];
+        }
+        if (word != 0) {
+            this->setDocId(_blockBegin + (wordIdx << 6) + vespalib::Optimized::lsbIdx(word));
+            return;
+        }
+        docId = _blockEnd;
+    }
+    this->setAtEnd();
+}
+
+template <typename SC, typename Parent>
+void
+AttributeBlockScanIteratorStrict<SC, Parent>::and_hits_into(BitVector & result, uint32_t begin_id)
+{
+    uint64_t * words = static_cast<uint64_t *>(result.getStart());
+    uint32_t begin = std::max(begin_id, result.getStartIndex());
+    uint32_t end = std::min(this->getEndId(), result.size());
+    scanWords(begin, end, [words](uint32_t wordBegin, uint64_t hits, uint64_t valid) {
+                  words[wordBegin >> 6] &= (hits | ~valid);
+              });
+    if (std::max(begin, end) < result.size()) {
+        result.clearInterval(std::max(begin, end), result.size());
+    }
+    result.invalidateCachedCount();
+}
+
+template <typename SC, typename Parent>
+void
+AttributeBlockScanIteratorStrict<SC, Parent>::or_hits_into(BitVector & result, uint32_t begin_id)
+{
+    uint64_t * words = static_cast<uint64_t *>(result.getStart());
+    uint32_t begin = std::max(begin_id, result.getStartIndex());
+    uint32_t end = std::min(this->getEndId(), result.size());
+    scanWords(begin, end, [words](uint32_t wordBegin, uint64_t hits, uint64_t) {
+                  words[wordBegin >> 6] |= hits;
+              });
+    result.invalidateCachedCount();
+}
+
+template <typename SC, typename Parent>
+BitVector::UP
+AttributeBlockScanIteratorStrict<SC, Parent>::get_hits(uint32_t begin_id)
+{
+    BitVector::UP result = BitVector::create(begin_id, this->getEndId());
+    uint64_t * words = static_cast<uint64_t *>(result->getStart());
+    scanWords(std::max(begin_id, this->getDocId()), this->getEndId(),
+              [words](uint32_t wordBegin, uint64_t hits, uint64_t) {
+                  words[wordBegin >> 6] |= hits;
+              });
+    result->invalidateCachedCount();
+    return result;
+}
+
 template <typename SC>
 void
 AttributeIteratorT<SC>::or_hits_into(BitVector & result, uint32_t begin_id) {
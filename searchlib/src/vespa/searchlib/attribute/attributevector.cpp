@@ -178,7 +178,8 @@ AttributeVector::AttributeVector(const vespalib::stringref &baseFileName, const
       _hasEnum(false),
       _hasSortedEnum(false),
       _loaded(false),
-      _enableEnumeratedSave(false)
+      _enableEnumeratedSave(false),
+      _loadExecutor(nullptr)
 { }
 
 
@@ -529,7 +530,14 @@ AttributeVector::isEnumeratedSaveFormat() const
 
 bool
 AttributeVector::load() {
+    return load(nullptr);
+}
+
+bool
+AttributeVector::load(vespalib::Executor *executor) {
+    _loadExecutor = executor;
     bool loaded = onLoad();
+    _loadExecutor = nullptr;
     if (loaded) {
         commit();
     }
@@ -35,6 +35,7 @@ namespace document {
 }
 
 namespace vespalib {
+    class Executor;
     class GenericHeader;
 }
 
@@ -392,6 +393,9 @@ protected:
     virtual AddressSpace getEnumStoreAddressSpaceUsage() const;
     virtual AddressSpace getMultiValueAddressSpaceUsage() const;
 
+    /** Returns the executor given to load(), if any, during load. */
+    vespalib::Executor *getLoadExecutor() const { return _loadExecutor; }
+
 public:
     DECLARE_IDENTIFIABLE_ABSTRACT(AttributeVector);
     bool isLoaded() const { return _loaded; }
@@ -456,6 +460,12 @@ public:
 
     bool isEnumeratedSaveFormat() const;
     bool load();
+    /**
+     * Loads this attribute vector, using the given executor to split
+     * expensive steps of loading a large attribute into parallel tasks.
+     * The executor may be shared with other loading attributes.
+     */
+    bool load(vespalib::Executor *executor);
     void commit(bool forceStatUpdate = false);
     void commit(uint64_t firstSyncToken, uint64_t lastSyncToken);
     void setCreateSerialNum(uint64_t createSerialNum);
@@ -609,6 +619,7 @@ private:
     bool                   _hasSortedEnum;
     bool                   _loaded;
     bool                   _enableEnumeratedSave;
+    vespalib::Executor    *_loadExecutor;
     fastos::TimeStamp      _nextStatUpdateTime;
 
 ////// Locking strategy interface. only available from the Guards.
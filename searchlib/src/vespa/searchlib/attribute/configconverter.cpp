@@ -69,6 +69,7 @@ ConfigConverter::convert(const AttributesConfig::Attribute & cfg)
     retval.setEnableOnlyBitVector(cfg.enableonlybitvector);
     retval.setIsFilter(cfg.enableonlybitvector);
     retval.setFastAccess(cfg.fastaccess);
+    retval.setCompressMultiValues(cfg.compressmultivalues);
     predicateParams.setArity(cfg.arity);
     predicateParams.setBounds(cfg.lowerbound, cfg.upperbound);
     predicateParams.setDensePostingListThreshold(cfg.densepostinglistthreshold);
@@ -79,6 +80,14 @@ ConfigConverter::convert(const AttributesConfig::Attribute & cfg)
         } else {
             retval.setTensorType(ValueType::tensor_type({}));
         }
+        if (cfg.hnsw.enabled) {
+            auto distanceMetric = (cfg.hnsw.distancemetric == AttributesConfig::Attribute::Hnsw::INNERPRODUCT)
+                                  ? HnswIndexParams::DistanceMetric::INNER_PRODUCT
+                                  : HnswIndexParams::DistanceMetric::EUCLIDEAN;
+            retval.setHnswIndexParams(HnswIndexParams(cfg.hnsw.maxlinkspernode,
+                                                      cfg.hnsw.neighborstoexploreatinsert,
+                                                      distanceMetric));
+        }
     }
     return retval;
 }
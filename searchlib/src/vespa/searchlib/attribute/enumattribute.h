@@ -51,6 +51,11 @@ protected:
     typedef EnumStoreBase::Index                     EnumIndex;
 
     EnumStore _enumStore;
+    DocId     _compactLidLow; // first document not yet remapped by an ongoing compaction
+
+    // Entries moved and documents remapped per commit when compacting the enum store incrementally.
+    static constexpr uint32_t COMPACT_ENTRIES_PER_COMMIT = 10000;
+    static constexpr uint32_t COMPACT_DOCS_PER_COMMIT = 100000;
 
     EnumStore &       getEnumStore()       { return _enumStore; }
     const EnumStore & getEnumStore() const { return _enumStore; }
@@ -69,11 +74,22 @@ protected:
 
     /*
      * Iterate through the change vector and find new unique values.
-     * Perform compaction if necessary and insert the new unique values into the EnumStore.
+     * Start or continue compaction if necessary and insert the new unique values into the EnumStore.
      */
     void insertNewUniqueValues(EnumStoreBase::IndexVector & newIndexes);
+    /*
+     * Move a bounded number of entries of an ongoing enum store compaction. When all
+     * entries are moved, remap the enum indexes of a bounded number of documents, and
+     * finish the compaction when all documents are remapped. Returns true if so.
+     */
+    bool compactEnumStore(uint32_t maxEntries, uint32_t maxDocs);
+    void finishEnumStoreCompaction();
     virtual void considerAttributeChange(const Change & c, UniqueSet & newUniques) = 0;
-    virtual void reEnumerate() = 0;
+    /*
+     * Remap the enum indexes of the documents in the given range to the
+     * copies of entries moved by compaction.
+     */
+    virtual void reEnumerate(DocId lidLow, DocId lidLimit) = 0;
     bool hasEnum2Value() const override { return true; }
     AddressSpace getEnumStoreAddressSpaceUsage() const override;
 
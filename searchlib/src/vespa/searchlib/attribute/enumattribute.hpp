@@ -4,6 +4,8 @@
 
 #include <vespa/searchlib/attribute/enumattribute.h>
 #include <vespa/searchlib/attribute/enumstore.hpp>
+#include <algorithm>
+#include <limits>
 
 namespace search {
 
@@ -12,7 +14,8 @@ EnumAttribute<B>::
 EnumAttribute(const vespalib::string &baseFileName,
               const AttributeVector::Config &cfg)
     : B(baseFileName, cfg),
-      _enumStore(0, cfg.fastSearch())
+      _enumStore(0, cfg.fastSearch()),
+      _compactLidLow(0)
 {
     this->setEnum(true);
 }
@@ -98,13 +101,15 @@ EnumAttribute<B>::insertNewUniqueValues(EnumStoreBase::IndexVector & newIndexes)
         extraBytesNeeded += _enumStore.getEntrySize(data.raw());
     }
 
+    bool movesEntries = _enumStore.hasEntriesToMove();
     do {
-        // perform compaction on EnumStore if necessary
+        // start compaction of EnumStore if necessary
         if (extraBytesNeeded > this->_enumStore.getRemaining() ||
             this->_enumStore.getPendingCompact()) {
+            finishEnumStoreCompaction();
             this->removeAllOldGenerations();
             this->_enumStore.clearPendingCompact();
-            if (!this->_enumStore.performCompaction(extraBytesNeeded)) {
+            if (!this->_enumStore.startCompaction(extraBytesNeeded)) {
                 // fallback to resize strategy
                 this->_enumStore.fallbackResize(extraBytesNeeded);
                 if (extraBytesNeeded > this->_enumStore.getRemaining()) {
@@ -113,19 +118,21 @@ EnumAttribute<B>::insertNewUniqueValues(EnumStoreBase::IndexVector & newIndexes)
                 }
                 break;  // fallback resize performed instead of compaction.
             }
-
-            // update underlying structure with new EnumIndex values.
-            reEnumerate();
-            // Clear scratch enumeration
-            for (auto & data : this->_changes) {
-                data._enumScratchPad = ChangeBase::UNSET_ENUM;
-            }
-
-            // clear mapping from old enum value to new index
-            _enumStore.clearIndexMap();
+            _compactLidLow = 0;
+            movesEntries = true;
         }
     } while (0);
 
+    if (_enumStore.isCompacting()) {
+        compactEnumStore(COMPACT_ENTRIES_PER_COMMIT, COMPACT_DOCS_PER_COMMIT);
+    }
+    if (movesEntries) {
+        // Clear scratch enumeration, it may refer to moved entries
+        for (auto & data : this->_changes) {
+            data._enumScratchPad = ChangeBase::UNSET_ENUM;
+        }
+    }
+
     // insert new unique values in EnumStore
     for (const auto & data : newUniques) {
         EnumIndex idx;
@@ -135,6 +142,40 @@ EnumAttribute<B>::insertNewUniqueValues(EnumStoreBase::IndexVector & newIndexes)
 }
 
 
+template <typename B>
+bool
+EnumAttribute<B>::compactEnumStore(uint32_t maxEntries, uint32_t maxDocs)
+{
+    if (!_enumStore.moveEntries(maxEntries)) {
+        return false;
+    }
+    // Moved entries forward to their copies until the old buffers are freed,
+    // so documents still referring to old entries are remapped a slice at a
+    // time without holding the enum modifier.
+    DocId numDocs = this->getNumDocs();
+    DocId lidLow = std::min(_compactLidLow, numDocs);
+    DocId lidLimit = lidLow + std::min(maxDocs, numDocs - lidLow);
+    reEnumerate(lidLow, lidLimit);
+    _compactLidLow = lidLimit;
+    if (lidLimit < numDocs) {
+        return false;
+    }
+    _enumStore.finishCompaction();
+    return true;
+}
+
+
+template <typename B>
+void
+EnumAttribute<B>::finishEnumStoreCompaction()
+{
+    if (_enumStore.isCompacting()) {
+        compactEnumStore(std::numeric_limits<uint32_t>::max(), std::numeric_limits<uint32_t>::max());
+        assert(!_enumStore.isCompacting());
+    }
+}
+
+
 template <typename B>
 AddressSpace
 EnumAttribute<B>::getEnumStoreAddressSpaceUsage() const
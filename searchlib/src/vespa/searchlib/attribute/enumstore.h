@@ -172,6 +172,8 @@ public:
     void freeUnusedEnums(const IndexVector &toRemove) override;
     void reset(Builder &builder);
     bool performCompaction(uint64_t bytesNeeded) override;
+    bool startCompaction(uint64_t bytesNeeded) override;
+    bool moveEntries(uint32_t maxEntries) override;
     void printCurrentContent(vespalib::asciistream &os) const;
 
 private:
@@ -184,6 +186,12 @@ private:
     template <typename Dictionary>
     void performCompaction(Dictionary &dict);
 
+    template <typename Dictionary>
+    void collectEntriesToMove(const Dictionary &dict);
+
+    template <typename Dictionary>
+    bool moveEntries(Dictionary &dict, uint32_t maxEntries);
+
     template <typename Dictionary>
     void printCurrentContent(vespalib::asciistream &os, const Dictionary &dict) const;
 };
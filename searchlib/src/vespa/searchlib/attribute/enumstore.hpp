@@ -20,6 +20,7 @@ namespace search {
 template <typename EntryType>
 void EnumStoreT<EntryType>::freeUnusedEnum(Index idx, IndexSet & unused)
 {
+    idx = this->getCompactedIndex(idx);
     Entry e = getEntry(idx);
     if (e.getRefCount() == 0) {
         Type value = e.getValue();
@@ -473,6 +474,95 @@ EnumStoreT<EntryType>::performCompaction(uint64_t bytesNeeded)
 }
 
 
+template <typename EntryType>
+template <typename Dictionary>
+void
+EnumStoreT<EntryType>::collectEntriesToMove(const Dictionary &dict)
+{
+    typedef typename Dictionary::ConstIterator DictionaryConstIterator;
+    this->_entriesToMove.reserve(dict.size());
+    for (DictionaryConstIterator iter = dict.begin(); iter.valid(); ++iter) {
+        Index idx = iter.getKey();
+        this->_entriesToMove.push_back(idx);
+        this->_bytesToMove += this->getEntrySize(getValue(idx));
+    }
+    this->_nextEntryToMove = 0;
+    this->_bytesMoved = 0;
+}
+
+
+template <typename EntryType>
+bool
+EnumStoreT<EntryType>::startCompaction(uint64_t bytesNeeded)
+{
+    if ( ! this->preCompact(bytesNeeded) ) {
+        return false;
+    }
+    if (_enumDict->hasData())
+        collectEntriesToMove(static_cast<EnumStoreDict<EnumPostingTree> *>
+                             (_enumDict)->getDictionary());
+    else
+        collectEntriesToMove(static_cast<EnumStoreDict<EnumTree> *>
+                             (_enumDict)->getDictionary());
+    return true;
+}
+
+
+template <typename EntryType>
+template <typename Dictionary>
+bool
+EnumStoreT<EntryType>::moveEntries(Dictionary &dict, uint32_t maxEntries)
+{
+    typedef typename Dictionary::Iterator DictionaryIterator;
+    uint32_t activeBufferIdx = _store.getActiveBufferId(TYPE_ID);
+    datastore::BufferState & activeBuf = _store.getBufferState(activeBufferIdx);
+    ComparatorType cmp(*this);
+    DictionaryIterator iter(btree::BTreeNode::Ref(), dict.getAllocator());
+    IndexVector &entriesToMove = this->_entriesToMove;
+    uint32_t moved = 0;
+    for (; moved < maxEntries && this->_nextEntryToMove < entriesToMove.size(); ++this->_nextEntryToMove) {
+        Index oldIdx = entriesToMove[this->_nextEntryToMove];
+        Entry e = this->getEntry(oldIdx);
+        Type value = e.getValue();
+        uint32_t entrySize = this->getEntrySize(value);
+        this->_bytesToMove -= entrySize;
+        iter.lower_bound(dict.getRoot(), oldIdx, cmp);
+        if (!iter.valid() || iter.getKey() != oldIdx) {
+            continue; // freed after compaction was started
+        }
+        uint64_t offset = activeBuf.size();
+        assert(activeBuf.remaining() >= entrySize);
+        char * dst = _store.template getBufferEntry<char>(activeBufferIdx, offset);
+        this->insertEntry(dst, e.getEnum(), e.getRefCount(), value);
+        activeBuf.pushed_back(entrySize);
+        Index newIdx(offset, activeBufferIdx);
+        assert(e.getEnum() < this->_indexMap.size());
+
+        // forward old entry and update tree with new index
+        std::atomic_thread_fence(std::memory_order_release);
+        this->_indexMap[e.getEnum()] = newIdx;
+        iter.writeKey(newIdx);
+        this->_bytesMoved += entrySize;
+        ++moved;
+    }
+    return this->_nextEntryToMove == entriesToMove.size();
+}
+
+
+template <typename EntryType>
+bool
+EnumStoreT<EntryType>::moveEntries(uint32_t maxEntries)
+{
+    assert(this->isCompacting());
+    if (_enumDict->hasData())
+        return moveEntries(static_cast<EnumStoreDict<EnumPostingTree> *>
+                           (_enumDict)->getDictionary(), maxEntries);
+    else
+        return moveEntries(static_cast<EnumStoreDict<EnumTree> *>
+                           (_enumDict)->getDictionary(), maxEntries);
+}
+
+
 template <typename EntryType>
 template <typename Dictionary>
 void
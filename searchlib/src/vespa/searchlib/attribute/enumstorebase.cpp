@@ -65,6 +65,10 @@ EnumStoreBase::EnumStoreBase(uint64_t initBufferSize,
       _nextEnum(0),
       _indexMap(),
       _toHoldBuffers(),
+      _entriesToMove(),
+      _nextEntryToMove(0),
+      _bytesToMove(0),
+      _bytesMoved(0),
       _disabledReEnumerate(false)
 {
     if (hasPostings)
@@ -91,6 +95,11 @@ EnumStoreBase::reset(uint64_t initBufferSize)
     _type.setSizeNeededAndDead(initBufferSize, 0);
     _store.initActiveBuffers();
     clearIndexMap();
+    _toHoldBuffers.clear();
+    IndexVector().swap(_entriesToMove);
+    _nextEntryToMove = 0;
+    _bytesToMove = 0;
+    _bytesMoved = 0;
     _enumDict->onReset();
     _nextEnum = 0;
 }
@@ -128,8 +137,17 @@ EnumStoreBase::getAddressSpaceUsage() const
 {
     const datastore::BufferState &activeState =
             _store.getBufferState(_store.getActiveBufferId(TYPE_ID));
-    return AddressSpace(activeState.size(), activeState.getDeadElems(),
-                        DataStoreType::RefType::offsetSize());
+    size_t used = activeState.size();
+    size_t dead = activeState.getDeadElems();
+    // The old buffers are in use until an incremental compaction is finished,
+    // with the entries already moved counted as dead.
+    for (uint32_t bufferId : _toHoldBuffers) {
+        const datastore::BufferState &state = _store.getBufferState(bufferId);
+        used += state.size();
+        dead += state.getDeadElems();
+    }
+    dead += _bytesMoved;
+    return AddressSpace(used, dead, DataStoreType::RefType::offsetSize());
 }
 
 void
@@ -158,14 +176,19 @@ EnumStoreBase::trimHoldLists(generation_t firstUsed)
 bool
 EnumStoreBase::preCompact(uint64_t bytesNeeded)
 {
+    assert(!isCompacting());
     if (getBufferIndex(datastore::BufferState::FREE) == Index::numBuffers()) {
         return false;
     }
     uint32_t activeBufId = _store.getActiveBufferId(TYPE_ID);
     datastore::BufferState & activeBuf = _store.getBufferState(activeBufId);
     _type.setSizeNeededAndDead(bytesNeeded, activeBuf.getDeadElems());
+    // Readers only look at the index map for entries in compacting buffers.
+    // Those of the previous compaction are freed, so the map can be reset
+    // before marking the active buffer as compacting.
+    IndexVector(_nextEnum, Index()).swap(_indexMap);
+    std::atomic_thread_fence(std::memory_order_release);
     _toHoldBuffers = _store.startCompact(TYPE_ID);
-    _indexMap.resize(_nextEnum);
     return true;
 }
 
@@ -201,9 +224,26 @@ void
 EnumStoreBase::postCompact(uint32_t newEnum)
 {
     _store.finishCompact(_toHoldBuffers);
+    _toHoldBuffers.clear();
     _nextEnum = newEnum;
 }
 
+
+void
+EnumStoreBase::finishCompaction()
+{
+    assert(isCompacting());
+    assert(_nextEntryToMove == _entriesToMove.size());
+    _store.finishCompact(_toHoldBuffers);
+    _toHoldBuffers.clear();
+    IndexVector().swap(_entriesToMove);
+    _nextEntryToMove = 0;
+    _bytesToMove = 0;
+    _bytesMoved = 0;
+    // The index map is kept, old entries forward through it until the
+    // buffers on hold are freed.
+}
+
 void
 EnumStoreBase::failNewSize(uint64_t minNewSize, uint64_t maxSize)
 {
@@ -234,6 +234,10 @@ protected:
     uint32_t              _nextEnum;
     IndexVector           _indexMap;
     std::vector<uint32_t> _toHoldBuffers; // used during compaction
+    IndexVector           _entriesToMove; // used during incremental compaction
+    size_t                _nextEntryToMove;
+    uint64_t              _bytesToMove;   // size of the entries not yet moved
+    uint64_t              _bytesMoved;    // size of the old entries already moved
     // set before backgound flush, cleared during background flush
     mutable std::atomic<bool> _disabledReEnumerate;
 
@@ -268,10 +272,10 @@ public:
         return _store.getBufferState(_store.getActiveBufferId(TYPE_ID)).size();
     }
     void getEnumValue(const EnumHandle * v, uint32_t *e, uint32_t sz) const;
-    uint32_t getRefCount(Index idx) const { return getEntryBase(idx).getRefCount(); }
+    uint32_t getRefCount(Index idx) const { return getEntryBase(getCompactedIndex(idx)).getRefCount(); }
     uint32_t getEnum(Index idx)     const { return getEntryBase(idx).getEnum(); }
-    void incRefCount(Index idx)           { getEntryBase(idx).incRefCount(); }
-    void decRefCount(Index idx)           { getEntryBase(idx).decRefCount(); }
+    void incRefCount(Index idx)           { getEntryBase(getCompactedIndex(idx)).incRefCount(); }
+    void decRefCount(Index idx)           { getEntryBase(getCompactedIndex(idx)).decRefCount(); }
     
     // Only use when reading from enumerated attribute save files
     void fixupRefCount(Index idx, uint32_t refCount) {
@@ -285,8 +289,14 @@ public:
     uint32_t getLastEnum()          const { return _nextEnum ? _nextEnum - 1 : _nextEnum; }
     uint32_t getNumUniques() const { return _enumDict->getNumUniques(); }
 
+    /**
+     * Returns the number of bytes left in the active buffer. During an
+     * incremental compaction the space needed by the entries not yet moved
+     * is not counted as remaining.
+     */
     uint32_t getRemaining() const {
-        return _store.getBufferState(_store.getActiveBufferId(TYPE_ID)).remaining();
+        uint64_t remaining = _store.getBufferState(_store.getActiveBufferId(TYPE_ID)).remaining();
+        return (remaining > _bytesToMove) ? (remaining - _bytesToMove) : 0;
     }
     MemoryUsage getMemoryUsage() const;
     MemoryUsage getTreeMemoryUsage() const { return _enumDict->getTreeMemoryUsage(); }
@@ -295,6 +305,27 @@ public:
 
     bool getCurrentIndex(Index oldIdx, Index & newIdx) const;
 
+    /**
+     * Returns the index of the live copy of the entry at the given index.
+     * An entry moved by a compaction forwards to its copy until the old
+     * buffer is freed, so documents not yet remapped and readers holding
+     * old indexes see the same handle as the dictionary. Safe for readers.
+     */
+    Index getCompactedIndex(Index idx) const {
+        if (!idx.valid()) {
+            return idx;
+        }
+        const datastore::BufferState &state = getBuffer(idx.bufferId());
+        if (!state.getCompacting() && state.getState() != datastore::BufferState::HOLD) {
+            return idx;
+        }
+        uint32_t enumValue = getEnum(idx);
+        if (enumValue < _indexMap.size() && _indexMap[enumValue].valid()) {
+            return _indexMap[enumValue];
+        }
+        return idx;
+    }
+
     void transferHoldLists(generation_t generation);
     void trimHoldLists(generation_t firstUsed);
 
@@ -345,6 +376,24 @@ public:
 
     virtual bool performCompaction(uint64_t bytesNeeded) = 0;
 
+    /**
+     * Incremental compaction. The active buffer is switched at start, while
+     * the entries are moved over a number of later calls to moveEntries().
+     * A moved entry is live at once: the dictionary key is switched to the
+     * copy, and the old entry forwards to it (see getCompactedIndex()). Users
+     * remap their own indexes at their own pace and then call
+     * finishCompaction(), which puts the old buffers on hold.
+     */
+    virtual bool startCompaction(uint64_t bytesNeeded) = 0;
+    /**
+     * Moves up to the given number of entries to the active buffer.
+     * Returns true when all entries have been moved.
+     */
+    virtual bool moveEntries(uint32_t maxEntries) = 0;
+    bool hasEntriesToMove() const { return _nextEntryToMove < _entriesToMove.size(); }
+    bool isCompacting() const { return !_toHoldBuffers.empty(); }
+    void finishCompaction();
+
     EnumStoreDictBase &getEnumStoreDict() { return *_enumDict; }
     const EnumStoreDictBase &getEnumStoreDict() const { return *_enumDict; }
     EnumPostingTree &getPostingDictionary() { return _enumDict->getPostingDictionary(); }
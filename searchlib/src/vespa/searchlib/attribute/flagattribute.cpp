@@ -65,9 +65,9 @@ FlagAttributeT<B>::getSearch(QueryTermSimple::UP qTerm,
 template <typename B>
 void FlagAttributeT<B>::clearOldValues(DocId doc)
 {
-    const typename B::WType * values(NULL);
-    for (uint32_t i(0), m(this->get(doc, values)); i < m; i++) {
-        BitVector * bv = _bitVectors[getOffset(values[i].value())];
+    std::vector<typename B::WType> buffer;
+    for (const auto & value : this->_mvMapping.get(doc, buffer)) {
+        BitVector * bv = _bitVectors[getOffset(value.value())];
         if (bv != NULL) {
             bv->clearBit(doc);
         }
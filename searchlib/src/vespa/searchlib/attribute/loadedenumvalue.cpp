@@ -2,21 +2,118 @@
 
 #include "loadedenumvalue.h"
 #include <vespa/searchlib/common/sort.h>
+#include <vespa/vespalib/util/array.hpp>
+#include <vespa/vespalib/util/executor.h>
+#include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/sync.h>
+#include <algorithm>
+#include <atomic>
 
 namespace search {
 namespace attribute {
 
+namespace {
+
+const size_t MIN_CHUNK_SIZE = 1000000;
+const size_t MAX_CHUNKS = 16;
+
 void
-sortLoadedByEnum(LoadedEnumAttributeVector &loaded)
+radixSort(LoadedEnumAttribute *data, size_t size)
 {
     ShiftBasedRadixSorter<LoadedEnumAttribute,
         LoadedEnumAttribute::EnumRadix,
         LoadedEnumAttribute::EnumCompare, 56>::
         radix_sort(LoadedEnumAttribute::EnumRadix(),
                    LoadedEnumAttribute::EnumCompare(),
-                   &loaded[0], loaded.size(), 16);
+                   data, size, 16);
+}
+
+/**
+ * Runs work(i) for i in [0, numItems), spread over tasks on the
+ * executor and the calling thread. Items not picked up by an executor
+ * thread (e.g. if the executor is busy or rejects the task) are run by
+ * the calling thread.
+ */
+template <typename Work>
+void
+runParallel(vespalib::Executor &executor, size_t numItems, Work work)
+{
+    struct State {
+        std::atomic<size_t> next;
+        vespalib::CountDownLatch done;
+        Work work;
+        State(size_t numItems_in, Work work_in)
+            : next(0), done(numItems_in), work(std::move(work_in))
+        { }
+        void run(size_t numItems_in) {
+            for (size_t i = next++; i < numItems_in; i = next++) {
+                work(i);
+                done.countDown();
+            }
+        }
+    };
+    auto state = std::make_shared<State>(numItems, std::move(work));
+    for (size_t i = 1; i < numItems; ++i) {
+        // A rejected task is returned and dropped, leaving its items to the others.
+        executor.execute(vespalib::makeLambdaTask([state, numItems]() { state->run(numItems); }));
+    }
+    state->run(numItems);
+    state->done.await();
+}
+
+}
+
+void
+sortLoadedByEnum(LoadedEnumAttributeVector &loaded)
+{
+    radixSort(&loaded[0], loaded.size());
+}
+
+void
+sortLoadedByEnum(LoadedEnumAttributeVector &loaded, vespalib::Executor *executor)
+{
+    size_t size = loaded.size();
+    size_t numChunks = std::min(MAX_CHUNKS, size / MIN_CHUNK_SIZE);
+    if (executor == nullptr || numChunks < 2) {
+        sortLoadedByEnum(loaded);
+        return;
+    }
+    std::vector<size_t> bounds;
+    for (size_t i = 0; i <= numChunks; ++i) {
+        bounds.push_back(size * i / numChunks);
+    }
+    LoadedEnumAttribute *src = &loaded[0];
+    runParallel(*executor, numChunks, [src, &bounds](size_t i) {
+        radixSort(src + bounds[i], bounds[i + 1] - bounds[i]);
+    });
+    LoadedEnumAttributeVector tmp;
+    tmp.resize(size);
+    LoadedEnumAttribute *dst = &tmp[0];
+    while (bounds.size() > 2) {
+        size_t numMerges = (bounds.size() - 1) / 2;
+        runParallel(*executor, numMerges, [src, dst, &bounds](size_t i) {
+            size_t lo = bounds[2 * i];
+            size_t mid = bounds[2 * i + 1];
+            size_t hi = bounds[2 * i + 2];
+            std::merge(src + lo, src + mid, src + mid, src + hi, dst + lo,
+                       LoadedEnumAttribute::EnumCompare());
+        });
+        std::vector<size_t> merged;
+        for (size_t i = 0; i < bounds.size(); i += 2) {
+            merged.push_back(bounds[i]);
+        }
+        if ((bounds.size() - 1) % 2 != 0) {
+            // Odd chunk count, last chunk is carried over unchanged.
+            std::copy(src + bounds[bounds.size() - 2], src + size, dst + bounds[bounds.size() - 2]);
+            merged.push_back(size);
+        }
+        bounds.swap(merged);
+        std::swap(src, dst);
+    }
+    if (src != &loaded[0]) {
+        loaded.swap(tmp);
+    }
 }
 
 } // namespace attribute
 } // namespace search
-
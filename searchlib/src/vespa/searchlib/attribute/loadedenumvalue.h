@@ -5,6 +5,8 @@
 #include <vespa/vespalib/util/array.h>
 #include <vespa/searchlib/attribute/enumstorebase.h>
 
+namespace vespalib { class Executor; }
+
 namespace search
 {
 
@@ -143,6 +145,16 @@ public:
 void
 sortLoadedByEnum(LoadedEnumAttributeVector &loaded);
 
+/**
+ * Sorts loaded values on enum and docid. Large vectors are split into
+ * chunks that are sorted and then merged pairwise by tasks on the
+ * given executor. The calling thread also takes part in the work, so
+ * this is safe to call from a task running on the same executor. A
+ * null executor gives the single threaded sort.
+ */
+void
+sortLoadedByEnum(LoadedEnumAttributeVector &loaded, vespalib::Executor *executor);
+
 } // namespace attribute
 
 } // namespace search
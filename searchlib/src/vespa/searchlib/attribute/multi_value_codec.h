@@ -0,0 +1,129 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "multivalue.h"
+#include <vespa/vespalib/util/arrayref.h>
+#include <algorithm>
+#include <cstdlib>
+#include <type_traits>
+#include <vector>
+
+namespace search {
+namespace attribute {
+
+namespace multivaluecodec {
+
+inline void
+encodeVarint(uint64_t v, std::vector<uint8_t> &buf)
+{
+    while (v >= 0x80) {
+        buf.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    buf.push_back(static_cast<uint8_t>(v));
+}
+
+inline uint64_t
+decodeVarint(const uint8_t *&p)
+{
+    uint64_t v = *p & 0x7f;
+    for (uint32_t shift = 7; (*p++ & 0x80) != 0; shift += 7) {
+        v |= uint64_t(*p & 0x7f) << shift;
+    }
+    return v;
+}
+
+inline uint64_t zigzagEncode(int64_t v) { return (uint64_t(v) << 1) ^ uint64_t(v >> 63); }
+inline int64_t zigzagDecode(uint64_t v) { return int64_t(v >> 1) ^ -int64_t(v & 1); }
+
+}
+
+/**
+ * Encodes arrays of multi-values as bytes for the compressed variant of
+ * the multi value mapping. Only integer values are supported, other
+ * entry types use this fallback that tells so.
+ */
+template <typename EntryT, typename = void>
+class MultiValueCodec
+{
+public:
+    static constexpr bool supported = false;
+    static void encode(vespalib::ConstArrayRef<EntryT>, std::vector<uint8_t> &) { abort(); }
+    static uint32_t decodeSize(vespalib::ConstArrayRef<uint8_t>) { abort(); }
+    static void decode(vespalib::ConstArrayRef<uint8_t>, std::vector<EntryT> &) { abort(); }
+};
+
+/**
+ * Byte format: the number of values followed by each value as the zigzag
+ * encoded difference to the previous value, all as varints. Weighted values
+ * have the zigzag encoded weight as a varint after each value.
+ *
+ * Weighted values are used for weighted sets, where the order carries no
+ * meaning. They are sorted on value before encoding so that the differences
+ * between ids in the same set stay small.
+ */
+template <typename EntryT>
+class MultiValueCodec<EntryT, std::enable_if_t<std::is_integral<typename EntryT::ValueType>::value>>
+{
+    using ValueType = typename EntryT::ValueType;
+    static constexpr bool hasWeight = EntryT::_hasWeight;
+
+    static void encodeSorted(vespalib::ConstArrayRef<EntryT> values, std::vector<uint8_t> &buf) {
+        using namespace multivaluecodec;
+        encodeVarint(values.size(), buf);
+        uint64_t prev = 0;
+        for (const EntryT &entry : values) {
+            uint64_t v = static_cast<uint64_t>(static_cast<int64_t>(entry.value()));
+            encodeVarint(zigzagEncode(static_cast<int64_t>(v - prev)), buf);
+            prev = v;
+            if (hasWeight) {
+                encodeVarint(zigzagEncode(entry.weight()), buf);
+            }
+        }
+    }
+public:
+    static constexpr bool supported = true;
+
+    static void encode(vespalib::ConstArrayRef<EntryT> values, std::vector<uint8_t> &buf) {
+        buf.clear();
+        if (values.size() == 0) {
+            return;
+        }
+        if (hasWeight && !std::is_sorted(values.cbegin(), values.cend())) {
+            std::vector<EntryT> sorted(values.cbegin(), values.cend());
+            std::sort(sorted.begin(), sorted.end());
+            encodeSorted(sorted, buf);
+        } else {
+            encodeSorted(values, buf);
+        }
+    }
+
+    static uint32_t decodeSize(vespalib::ConstArrayRef<uint8_t> bytes) {
+        if (bytes.size() == 0) {
+            return 0;
+        }
+        const uint8_t *p = &bytes[0];
+        return multivaluecodec::decodeVarint(p);
+    }
+
+    static void decode(vespalib::ConstArrayRef<uint8_t> bytes, std::vector<EntryT> &values) {
+        using namespace multivaluecodec;
+        values.clear();
+        if (bytes.size() == 0) {
+            return;
+        }
+        const uint8_t *p = &bytes[0];
+        uint32_t numValues = decodeVarint(p);
+        values.reserve(numValues);
+        uint64_t prev = 0;
+        for (uint32_t i = 0; i < numValues; ++i) {
+            prev += static_cast<uint64_t>(zigzagDecode(decodeVarint(p)));
+            int32_t weight = hasWeight ? static_cast<int32_t>(zigzagDecode(decodeVarint(p))) : 1;
+            values.emplace_back(static_cast<ValueType>(static_cast<int64_t>(prev)), weight);
+        }
+    }
+};
+
+} // namespace search::attribute
+} // namespace search
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "multi_value_mapping_base.h"
+#include "multi_value_codec.h"
 #include <vespa/searchlib/datastore/array_store.h>
 #include <vespa/searchlib/common/address_space.h>
 
@@ -11,6 +12,12 @@ namespace attribute {
 
 /**
  * Class for mapping from from document id to an array of values.
+ *
+ * A compressed mapping stores arrays delta and varint encoded in a byte
+ * array store. Readers then pass a decode buffer they own to get() or
+ * getDataForIdx(), and the returned array is valid until that buffer is
+ * reused. Uncompressed mappings return arrays in the store and leave the
+ * buffer untouched.
  */
 template <typename EntryT, typename RefT = datastore::EntryRefT<19> >
 class MultiValueMapping : public MultiValueMappingBase
@@ -20,30 +27,57 @@ public:
     using RefType = RefT;
 private:
     using ArrayStore = datastore::ArrayStore<EntryT, RefT>;
+    using CompressedArrayStore = datastore::ArrayStore<uint8_t, RefT>;
+    using Codec = MultiValueCodec<EntryT>;
     using generation_t = vespalib::GenerationHandler::generation_t;
     using ConstArrayRef = vespalib::ConstArrayRef<EntryT>;
 
-    ArrayStore _store;
+    // Only one of the stores is allocated, depending on compression.
+    std::unique_ptr<ArrayStore> _store;
+    std::unique_ptr<CompressedArrayStore> _compressedStore;
+    std::vector<uint8_t> _encodeBuffer;
+
+    ConstArrayRef decode(EntryRef idx, std::vector<EntryT> &buffer) const;
 public:
+    using DecodeBuffer = std::vector<EntryT>;
+    static constexpr bool supportsCompression = Codec::supported;
+
     MultiValueMapping(const MultiValueMapping &) = delete;
     MultiValueMapping & operator = (const MultiValueMapping &) = delete;
+    /**
+     * storeCfg describes the compressed byte array store when compressed
+     * is true, which requires supportsCompression.
+     */
     MultiValueMapping(const datastore::ArrayStoreConfig &storeCfg,
-                      const GrowStrategy &gs = GrowStrategy());
+                      const GrowStrategy &gs = GrowStrategy(),
+                      bool compressed = false);
     virtual ~MultiValueMapping();
-    ConstArrayRef get(uint32_t docId) const { return _store.get(_indices[docId]); }
-    ConstArrayRef getDataForIdx(EntryRef idx) const { return _store.get(idx); }
+
+    // Only valid for uncompressed mappings.
+    ConstArrayRef get(uint32_t docId) const { return _store->get(_indices[docId]); }
+    ConstArrayRef getDataForIdx(EntryRef idx) const { return _store->get(idx); }
+
+    ConstArrayRef get(uint32_t docId, DecodeBuffer &buffer) const { return getDataForIdx(_indices[docId], buffer); }
+    ConstArrayRef getDataForIdx(EntryRef idx, DecodeBuffer &buffer) const {
+        if (__builtin_expect(!_compressedStore, true)) {
+            return _store->get(idx);
+        }
+        return decode(idx, buffer);
+    }
     void set(uint32_t docId, ConstArrayRef values);
 
+    bool isCompressed() const { return bool(_compressedStore); }
+
     // replace is generally unsafe and should only be used when
     // compacting enum store (replacing old enum index with updated enum index)
     void replace(uint32_t docId, ConstArrayRef values);
 
-    // Pass on hold list management to underlying store
-    void transferHoldLists(generation_t generation) { _store.transferHoldLists(generation); }
-    void trimHoldLists(generation_t firstUsed) { _store.trimHoldLists(firstUsed); }
-    void prepareLoadFromMultiValue() { _store.setInitializing(true); }
+    // Pass on hold list management to underlying stores
+    void transferHoldLists(generation_t generation);
+    void trimHoldLists(generation_t firstUsed);
+    void prepareLoadFromMultiValue();
 
-    void doneLoadFromMultiValue() { _store.setInitializing(false); }
+    void doneLoadFromMultiValue();
 
     virtual void compactWorst(bool compactMemory, bool compactAddressSpace) override;
 
@@ -54,6 +88,10 @@ public:
                                                                   size_t hugePageSize,
                                                                   size_t smallPageSize,
                                                                   size_t minNumArraysForNewBuffer);
+    static datastore::ArrayStoreConfig optimizedCompressedConfigForHugePage(size_t maxSmallArraySize,
+                                                                            size_t hugePageSize,
+                                                                            size_t smallPageSize,
+                                                                            size_t minNumArraysForNewBuffer);
 };
 
 } // namespace search::attribute
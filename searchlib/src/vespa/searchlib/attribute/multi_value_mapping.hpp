@@ -10,10 +10,19 @@ namespace search {
 namespace attribute {
 
 template <typename EntryT, typename RefT>
-MultiValueMapping<EntryT,RefT>::MultiValueMapping(const datastore::ArrayStoreConfig &storeCfg, const GrowStrategy &gs)
-    : MultiValueMappingBase(gs, _store.getGenerationHolder()),
-      _store(storeCfg)
+MultiValueMapping<EntryT,RefT>::MultiValueMapping(const datastore::ArrayStoreConfig &storeCfg, const GrowStrategy &gs,
+                                                  bool compressed)
+    : MultiValueMappingBase(gs),
+      _store(),
+      _compressedStore(),
+      _encodeBuffer()
 {
+    if (compressed) {
+        assert(Codec::supported);
+        _compressedStore = std::make_unique<CompressedArrayStore>(storeCfg);
+    } else {
+        _store = std::make_unique<ArrayStore>(storeCfg);
+    }
 }
 
 template <typename EntryT, typename RefT>
@@ -21,23 +30,40 @@ MultiValueMapping<EntryT,RefT>::~MultiValueMapping()
 {
 }
 
+template <typename EntryT, typename RefT>
+typename MultiValueMapping<EntryT,RefT>::ConstArrayRef
+MultiValueMapping<EntryT,RefT>::decode(EntryRef idx, std::vector<EntryT> &buffer) const
+{
+    Codec::decode(_compressedStore->get(idx), buffer);
+    return buffer;
+}
+
 template <typename EntryT, typename RefT>
 void
 MultiValueMapping<EntryT,RefT>::set(uint32_t docId, ConstArrayRef values)
 {
     _indices.ensure_size(docId + 1);
     EntryRef oldRef(_indices[docId]);
-    ConstArrayRef oldValues = _store.get(oldRef);
-    _indices[docId] = _store.add(values);
+    if (_compressedStore) {
+        Codec::encode(values, _encodeBuffer);
+        size_t oldSize = Codec::decodeSize(_compressedStore->get(oldRef));
+        _indices[docId] = _compressedStore->add(_encodeBuffer);
+        updateValueCount(oldSize, values.size());
+        _compressedStore->remove(oldRef);
+        return;
+    }
+    ConstArrayRef oldValues = _store->get(oldRef);
+    _indices[docId] = _store->add(values);
     updateValueCount(oldValues.size(), values.size());
-    _store.remove(oldRef);
+    _store->remove(oldRef);
 }
 
 template <typename EntryT, typename RefT>
 void
 MultiValueMapping<EntryT,RefT>::replace(uint32_t docId, ConstArrayRef values)
 {
-    ConstArrayRef oldValues = _store.get(_indices[docId]);
+    assert(!_compressedStore);
+    ConstArrayRef oldValues = _store->get(_indices[docId]);
     assert(oldValues.size() == values.size());
     EntryT *dst = const_cast<EntryT *>(&oldValues[0]);
     for (auto &src : values) {
@@ -50,7 +76,9 @@ template <typename EntryT, typename RefT>
 void
 MultiValueMapping<EntryT,RefT>::compactWorst(bool compactMemory, bool compactAddressSpace)
 {
-    datastore::ICompactionContext::UP compactionContext(_store.compactWorst(compactMemory, compactAddressSpace));
+    datastore::ICompactionContext::UP compactionContext(_compressedStore
+                                                        ? _compressedStore->compactWorst(compactMemory, compactAddressSpace)
+                                                        : _store->compactWorst(compactMemory, compactAddressSpace));
     if (compactionContext) {
         compactionContext->compact(vespalib::ArrayRef<EntryRef>(&_indices[0],
                                                                 _indices.size()));
@@ -61,13 +89,59 @@ template <typename EntryT, typename RefT>
 MemoryUsage
 MultiValueMapping<EntryT,RefT>::getArrayStoreMemoryUsage() const
 {
-    return _store.getMemoryUsage();
+    return _compressedStore ? _compressedStore->getMemoryUsage() : _store->getMemoryUsage();
 }
 
 template <typename EntryT, typename RefT>
 AddressSpace
 MultiValueMapping<EntryT, RefT>::getAddressSpaceUsage() const {
-    return _store.addressSpaceUsage();
+    return _compressedStore ? _compressedStore->addressSpaceUsage() : _store->addressSpaceUsage();
+}
+
+template <typename EntryT, typename RefT>
+void
+MultiValueMapping<EntryT,RefT>::transferHoldLists(generation_t generation)
+{
+    _genHolder.transferHoldLists(generation);
+    if (_compressedStore) {
+        _compressedStore->transferHoldLists(generation);
+    } else {
+        _store->transferHoldLists(generation);
+    }
+}
+
+template <typename EntryT, typename RefT>
+void
+MultiValueMapping<EntryT,RefT>::trimHoldLists(generation_t firstUsed)
+{
+    _genHolder.trimHoldLists(firstUsed);
+    if (_compressedStore) {
+        _compressedStore->trimHoldLists(firstUsed);
+    } else {
+        _store->trimHoldLists(firstUsed);
+    }
+}
+
+template <typename EntryT, typename RefT>
+void
+MultiValueMapping<EntryT,RefT>::prepareLoadFromMultiValue()
+{
+    if (_compressedStore) {
+        _compressedStore->setInitializing(true);
+    } else {
+        _store->setInitializing(true);
+    }
+}
+
+template <typename EntryT, typename RefT>
+void
+MultiValueMapping<EntryT,RefT>::doneLoadFromMultiValue()
+{
+    if (_compressedStore) {
+        _compressedStore->setInitializing(false);
+    } else {
+        _store->setInitializing(false);
+    }
 }
 
 template <typename EntryT, typename RefT>
@@ -80,5 +154,15 @@ MultiValueMapping<EntryT, RefT>::optimizedConfigForHugePage(size_t maxSmallArray
     return ArrayStore::optimizedConfigForHugePage(maxSmallArraySize, hugePageSize, smallPageSize, minNumArraysForNewBuffer);
 }
 
+template <typename EntryT, typename RefT>
+datastore::ArrayStoreConfig
+MultiValueMapping<EntryT, RefT>::optimizedCompressedConfigForHugePage(size_t maxSmallArraySize,
+                                                                       size_t hugePageSize,
+                                                                       size_t smallPageSize,
+                                                                       size_t minNumArraysForNewBuffer)
+{
+    return CompressedArrayStore::optimizedConfigForHugePage(maxSmallArraySize, hugePageSize, smallPageSize, minNumArraysForNewBuffer);
+}
+
 } // namespace search::attribute
 } // namespace search
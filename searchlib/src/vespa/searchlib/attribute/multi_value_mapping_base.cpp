@@ -14,9 +14,9 @@ constexpr size_t DEAD_CLUSTERS_SLACK = 0x10000u;
 
 }
 
-MultiValueMappingBase::MultiValueMappingBase(const GrowStrategy &gs,
-                                               vespalib::GenerationHolder &genHolder)
-    : _indices(gs, genHolder),
+MultiValueMappingBase::MultiValueMappingBase(const GrowStrategy &gs)
+    : _genHolder(),
+      _indices(gs, _genHolder),
       _totalValues(0u),
       _cachedArrayStoreMemoryUsage(),
       _cachedArrayStoreAddressSpaceUsage(0, 0, (1ull << 32))
@@ -25,6 +25,7 @@ MultiValueMappingBase::MultiValueMappingBase(const GrowStrategy &gs,
 
 MultiValueMappingBase::~MultiValueMappingBase()
 {
+    _genHolder.clearHoldLists();
 }
 
 MultiValueMappingBase::RefCopyVector
@@ -71,6 +72,7 @@ MultiValueMappingBase::getMemoryUsage() const
 {
     MemoryUsage retval = getArrayStoreMemoryUsage();
     retval.merge(_indices.getMemoryUsage());
+    retval.mergeGenerationHeldBytes(_genHolder.getHeldBytes());
     return retval;
 }
 
@@ -81,6 +83,7 @@ MultiValueMappingBase::updateStat()
     MemoryUsage retval = getArrayStoreMemoryUsage();
     _cachedArrayStoreMemoryUsage = retval;
     retval.merge(_indices.getMemoryUsage());
+    retval.mergeGenerationHeldBytes(_genHolder.getHeldBytes());
     return retval;
 }
 
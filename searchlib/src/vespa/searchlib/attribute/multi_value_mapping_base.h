@@ -24,12 +24,13 @@ public:
     using RefVector = RcuVectorBase<EntryRef>;
 
 protected:
+    vespalib::GenerationHolder _genHolder; // for the index vector, the stores have their own
     RefVector _indices;
     size_t    _totalValues;
     MemoryUsage _cachedArrayStoreMemoryUsage;
     AddressSpace _cachedArrayStoreAddressSpaceUsage;
 
-    MultiValueMappingBase(const GrowStrategy &gs, vespalib::GenerationHolder &genHolder);
+    MultiValueMappingBase(const GrowStrategy &gs);
     virtual ~MultiValueMappingBase();
 
     void updateValueCount(size_t oldValues, size_t newValues) {
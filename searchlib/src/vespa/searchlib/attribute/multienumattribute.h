@@ -47,7 +47,7 @@ protected:
 
     // from EnumAttribute
     void considerAttributeChange(const Change & c, UniqueSet & newUniques) override; // same for both string and numeric
-    void reEnumerate() override; // same for both string and numeric
+    void reEnumerate(DocId lidLow, DocId lidLimit) override; // same for both string and numeric
 
     virtual void applyValueChanges(const DocIndices & docIndices, EnumStoreBase::IndexVector & unused);
 
@@ -80,14 +80,14 @@ public:
         if (indices.size() == 0) {
             return std::numeric_limits<uint32_t>::max();
         } else {
-            return indices[0].value().ref();
+            return this->_enumStore.getCompactedIndex(indices[0].value()).ref();
         }
     }
     uint32_t get(DocId doc, EnumHandle * e, uint32_t sz) const override {
         WeightedIndexArrayRef indices(this->_mvMapping.get(doc));
         uint32_t valueCount = indices.size();
         for (uint32_t i = 0, m = std::min(sz, valueCount); i < m; ++i) {
-            e[i] = indices[i].value().ref();
+            e[i] = this->_enumStore.getCompactedIndex(indices[i].value()).ref();
         }
         return valueCount;
     }
@@ -95,7 +95,7 @@ public:
         WeightedIndexArrayRef indices(this->_mvMapping.get(doc));
         uint32_t valueCount = indices.size();
         for (uint32_t i = 0, m = std::min(sz, valueCount); i < m; ++i) {
-            e[i] = WeightedEnum(indices[i].value().ref(), indices[i].weight());
+            e[i] = WeightedEnum(this->_enumStore.getCompactedIndex(indices[i].value()).ref(), indices[i].weight());
         }
         return valueCount;
     }
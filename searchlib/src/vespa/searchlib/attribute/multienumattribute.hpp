@@ -41,23 +41,26 @@ MultiValueEnumAttribute<B, M>::considerAttributeChange(const Change & c, UniqueS
 
 template <typename B, typename M>
 void
-MultiValueEnumAttribute<B, M>::reEnumerate()
+MultiValueEnumAttribute<B, M>::reEnumerate(DocId lidLow, DocId lidLimit)
 {
     // update MultiValueMapping with new EnumIndex values.
-    EnumModifier enumGuard(this->getEnumModifier());
-    for (DocId doc = 0; doc < this->getNumDocs(); ++doc) {
+    WeightedIndexVector indices;
+    for (DocId doc = lidLow; doc < lidLimit; ++doc) {
         vespalib::ConstArrayRef<WeightedIndex> indicesRef(this->_mvMapping.get(doc));
-        WeightedIndexVector indices(indicesRef.cbegin(), indicesRef.cend());
-
+        indices.assign(indicesRef.cbegin(), indicesRef.cend());
+        bool changed = false;
         for (uint32_t i = 0; i < indices.size(); ++i) {
             EnumIndex oldIndex = indices[i].value();
-            EnumIndex newIndex;
-            this->_enumStore.getCurrentIndex(oldIndex, newIndex);
-            indices[i] = WeightedIndex(newIndex, indices[i].weight());
+            EnumIndex newIndex = this->_enumStore.getCompactedIndex(oldIndex);
+            if (newIndex != oldIndex) {
+                indices[i] = WeightedIndex(newIndex, indices[i].weight());
+                changed = true;
+            }
+        }
+        if (changed) {
+            std::atomic_thread_fence(std::memory_order_release);
+            this->_mvMapping.replace(doc, indices);
         }
-
-        std::atomic_thread_fence(std::memory_order_release);
-        this->_mvMapping.replace(doc, indices);
     }
 }
 
@@ -196,6 +199,7 @@ template <typename B, typename M>
 std::unique_ptr<AttributeSaver>
 MultiValueEnumAttribute<B, M>::onInitSave()
 {
+    this->finishEnumStoreCompaction();
     {
         EnumModifier enumGuard(this->getEnumModifier());
         this->_enumStore.reEnumerate();
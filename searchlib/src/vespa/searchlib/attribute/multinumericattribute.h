@@ -6,6 +6,7 @@
 #include "floatbase.h"
 #include "multivalueattribute.h"
 #include <limits>
+#include <stdexcept>
 
 namespace search {
 
@@ -35,6 +36,7 @@ private:
     typedef typename MultiValueAttribute<B, M>::ValueType         MValueType; // = B::BaseType
     typedef typename MultiValueAttribute<B, M>::MultiValueType    MultiValueType; // = B::BaseType
     using MultiValueArrayRef = typename MultiValueAttribute<B, M>::MultiValueArrayRef;
+    using DecodeBuffer = typename MultiValueAttribute<B, M>::DecodeBuffer;
 
     bool extractChangeData(const Change & c, MValueType & data) override {
         data = static_cast<MValueType>(c._data.get());
@@ -61,6 +63,9 @@ protected:
 
 public:
     virtual uint32_t getRawValues(DocId doc, const WType * & values) const final override {
+        if (this->_mvMapping.isCompressed()) {
+            throw std::runtime_error(this->getNativeClassName() + "::getRawValues() not supported for compressed multi-values.");
+        }
         return get(doc, values);
     }
     /*
@@ -70,6 +75,7 @@ public:
     {
     private:
         const MultiValueNumericAttribute<B, M> & _toBeSearched;
+        mutable DecodeBuffer _buffer;
 
         bool onCmp(DocId docId, int32_t & weight) const override {
             return cmp(docId, weight);
@@ -87,7 +93,7 @@ public:
         Int64Range getAsIntegerTerm() const override;
 
         bool cmp(DocId doc, int32_t & weight) const {
-            MultiValueArrayRef values(_toBeSearched._mvMapping.get(doc));
+            MultiValueArrayRef values(_toBeSearched._mvMapping.get(doc, _buffer));
             for (const MultiValueType &mv : values) {
                 if (this->match(mv.value())) {
                     weight = mv.weight();
@@ -98,7 +104,7 @@ public:
         }
 
         bool cmp(DocId doc) const {
-            MultiValueArrayRef values(_toBeSearched._mvMapping.get(doc));
+            MultiValueArrayRef values(_toBeSearched._mvMapping.get(doc, _buffer));
             for (const MultiValueType &mv : values) {
                 if (this->match(mv.value())) {
                     return true;
@@ -118,6 +124,7 @@ public:
     {
     private:
         const MultiValueNumericAttribute<B, M> & _toBeSearched;
+        mutable DecodeBuffer _buffer;
 
         bool onCmp(DocId docId, int32_t & weight) const override {
             return cmp(docId, weight);
@@ -134,7 +141,7 @@ public:
         ArraySearchContext(std::unique_ptr<QueryTermSimple> qTerm, const NumericAttribute & toBeSearched);
         bool cmp(DocId doc, int32_t & weight) const {
             uint32_t hitCount = 0;
-            MultiValueArrayRef values(_toBeSearched._mvMapping.get(doc));
+            MultiValueArrayRef values(_toBeSearched._mvMapping.get(doc, _buffer));
             for (const MultiValueType &mv : values) {
                 if (this->match(mv.value())) {
                     hitCount++;
@@ -146,7 +153,7 @@ public:
         }
 
         bool cmp(DocId doc) const {
-            MultiValueArrayRef values(_toBeSearched._mvMapping.get(doc));
+            MultiValueArrayRef values(_toBeSearched._mvMapping.get(doc, _buffer));
             for (const MultiValueType &mv : values) {
                 if (this->match(mv.value())) {
                     return true;
@@ -183,15 +190,18 @@ public:
     // new read api
     //-------------------------------------------------------------------------
     T get(DocId doc) const override {
-        MultiValueArrayRef values(this->_mvMapping.get(doc));
+        DecodeBuffer buffer;
+        MultiValueArrayRef values(this->_mvMapping.get(doc, buffer));
         return ((values.size() > 0) ? values[0].value() : T());
     }
     largeint_t getInt(DocId doc) const override {
-        MultiValueArrayRef values(this->_mvMapping.get(doc));
+        DecodeBuffer buffer;
+        MultiValueArrayRef values(this->_mvMapping.get(doc, buffer));
         return static_cast<largeint_t>((values.size() > 0) ? values[0].value() : T());
     }
     double getFloat(DocId doc) const override {
-        MultiValueArrayRef values(this->_mvMapping.get(doc));
+        DecodeBuffer buffer;
+        MultiValueArrayRef values(this->_mvMapping.get(doc, buffer));
         return static_cast<double>((values.size() > 0) ? values[0].value() : T());
     }
     EnumHandle getEnum(DocId doc) const override {
@@ -209,7 +219,8 @@ public:
     }
     template <typename BufferType>
     uint32_t getHelper(DocId doc, BufferType * buffer, uint32_t sz) const {
-        MultiValueArrayRef handle(this->_mvMapping.get(doc));
+        DecodeBuffer decodeBuffer;
+        MultiValueArrayRef handle(this->_mvMapping.get(doc, decodeBuffer));
         uint32_t ret = handle.size();
         for(size_t i(0), m(std::min(sz, ret)); i < m; i++) {
             buffer[i] = static_cast<BufferType>(handle[i].value());
@@ -224,7 +235,8 @@ public:
     }
     template <typename E>
     uint32_t getEnumHelper(DocId doc, E * e, uint32_t sz) const {
-        MultiValueArrayRef values(this->_mvMapping.get(doc));
+        DecodeBuffer buffer;
+        MultiValueArrayRef values(this->_mvMapping.get(doc, buffer));
         uint32_t available = values.size();
         uint32_t num2Read = std::min(available, sz);
         for (uint32_t i = 0; i < num2Read; ++i) {
@@ -243,7 +255,8 @@ public:
     }
     template <typename WeightedType, typename ValueType>
     uint32_t getWeightedHelper(DocId doc, WeightedType * buffer, uint32_t sz) const {
-        MultiValueArrayRef handle(this->_mvMapping.get(doc));
+        DecodeBuffer decodeBuffer;
+        MultiValueArrayRef handle(this->_mvMapping.get(doc, decodeBuffer));
         uint32_t ret = handle.size();
         for(size_t i(0), m(std::min(sz, ret)); i < m; i++) {
             buffer[i] = WeightedType(static_cast<ValueType>(handle[i].value()),
@@ -44,7 +44,8 @@ uint32_t MultiValueNumericAttribute<B, M>::getValueCount(DocId doc) const
     if (doc >= B::getNumDocs()) {
         return 0;
     }
-    MultiValueArrayRef values(this->_mvMapping.get(doc));
+    DecodeBuffer buffer;
+    MultiValueArrayRef values(this->_mvMapping.get(doc, buffer));
     return values.size();
 }
 
@@ -199,7 +200,8 @@ template <typename B, typename M>
 MultiValueNumericAttribute<B, M>::SetSearchContext::SetSearchContext(QueryTermSimple::UP qTerm, const NumericAttribute & toBeSearched) :
     NumericAttribute::Range<T>(*qTerm),
     AttributeVector::SearchContext(toBeSearched),
-    _toBeSearched(static_cast<const MultiValueNumericAttribute<B, M> &>(toBeSearched))
+    _toBeSearched(static_cast<const MultiValueNumericAttribute<B, M> &>(toBeSearched)),
+    _buffer()
 { }
 
 template <typename B, typename M>
@@ -233,7 +235,8 @@ template <typename B, typename M>
 MultiValueNumericAttribute<B, M>::ArraySearchContext::ArraySearchContext(QueryTermSimple::UP qTerm, const NumericAttribute & toBeSearched) :
     NumericAttribute::Range<T>(*qTerm),
     AttributeVector::SearchContext(toBeSearched),
-    _toBeSearched(static_cast<const MultiValueNumericAttribute<B, M> &>(toBeSearched))
+    _toBeSearched(static_cast<const MultiValueNumericAttribute<B, M> &>(toBeSearched)),
+    _buffer()
 { }
 
 template <typename B, typename M>
@@ -66,9 +66,10 @@ onSave(IAttributeSaveTarget &saveTarget)
     WeightWriter<MultiValueType::_hasWeight> weightWriter(saveTarget);
     DatWriter datWriter(saveTarget);
 
+    typename MultiValueMapping::DecodeBuffer buffer;
     for (uint32_t docId = 0; docId < _frozenIndices.size(); ++docId) {
         datastore::EntryRef idx = _frozenIndices[docId];
-        vespalib::ConstArrayRef<MultiValueType> values(_mvMapping.getDataForIdx(idx));
+        vespalib::ConstArrayRef<MultiValueType> values(_mvMapping.getDataForIdx(idx, buffer));
         countWriter.writeCount(values.size());
         weightWriter.writeWeights(values);
         datWriter.writeValues(values);
@@ -84,7 +84,7 @@ MultiValueNumericEnumAttribute<B, M>::onLoadEnumerated(ReaderBase &attrReader)
         if (numDocs > 0) {
             this->onAddDoc(numDocs - 1);
         }
-        attribute::sortLoadedByEnum(loaded);
+        attribute::sortLoadedByEnum(loaded, this->getLoadExecutor());
         this->fillPostingsFixupEnum(loaded);
     } else {
         this->fixupEnumRefCounts(enumHist);
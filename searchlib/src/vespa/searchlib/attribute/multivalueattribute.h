@@ -27,6 +27,7 @@ protected:
     typedef typename MultiValueType::ValueType            ValueType;
     typedef std::vector<MultiValueType>                   ValueVector;
     using MultiValueArrayRef = vespalib::ConstArrayRef<MultiValueType>;
+    using DecodeBuffer = typename MultiValueMapping::DecodeBuffer;
     typedef typename ValueVector::iterator                ValueVectorIterator;
     typedef std::vector<std::pair<DocId, ValueVector> >   DocumentValues;
 
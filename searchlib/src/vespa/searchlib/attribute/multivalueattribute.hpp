@@ -11,6 +11,23 @@ namespace multivalueattribute {
 constexpr size_t HUGE_MEMORY_PAGE_SIZE = 2 * 1024 * 1024;
 constexpr size_t SMALL_MEMORY_PAGE_SIZE = 4 * 1024;
 
+template <typename MultiValueMapping>
+bool
+useCompression(const attribute::Config &cfg)
+{
+    return MultiValueMapping::supportsCompression && cfg.compressMultiValues();
+}
+
+template <typename MultiValueMapping>
+datastore::ArrayStoreConfig
+storeConfig(bool compressed)
+{
+    if (compressed) {
+        return MultiValueMapping::optimizedCompressedConfigForHugePage(1023, HUGE_MEMORY_PAGE_SIZE, SMALL_MEMORY_PAGE_SIZE, 8 * 1024);
+    }
+    return MultiValueMapping::optimizedConfigForHugePage(1023, HUGE_MEMORY_PAGE_SIZE, SMALL_MEMORY_PAGE_SIZE, 8 * 1024);
+}
+
 }
 
 template <typename B, typename M>
@@ -18,10 +35,9 @@ MultiValueAttribute<B, M>::
 MultiValueAttribute(const vespalib::string &baseFileName,
                     const AttributeVector::Config &cfg)
     : B(baseFileName, cfg),
-      _mvMapping(MultiValueMapping::optimizedConfigForHugePage(1023,
-                                                               multivalueattribute::HUGE_MEMORY_PAGE_SIZE,
-                                                               multivalueattribute::SMALL_MEMORY_PAGE_SIZE,
-                                                               8 * 1024), cfg.getGrowStrategy())
+      _mvMapping(multivalueattribute::storeConfig<MultiValueMapping>(multivalueattribute::useCompression<MultiValueMapping>(cfg)),
+                 cfg.getGrowStrategy(),
+                 multivalueattribute::useCompression<MultiValueMapping>(cfg))
 {
 }
 
@@ -33,7 +49,8 @@ MultiValueAttribute<B, M>::~MultiValueAttribute()
 template <typename B, typename M>
 int32_t MultiValueAttribute<B, M>::getWeight(DocId doc, uint32_t idx) const
 {
-    MultiValueArrayRef values(this->_mvMapping.get(doc));
+    DecodeBuffer buffer;
+    MultiValueArrayRef values(this->_mvMapping.get(doc, buffer));
     return ((idx < values.size()) ? values[idx].weight() : 1);
 }
 
@@ -43,10 +60,11 @@ void
 MultiValueAttribute<B, M>::applyAttributeChanges(DocumentValues & docValues)
 {
     // compute new values for each document with changes
+    DecodeBuffer buffer;
     for (ChangeVectorIterator current(this->_changes.begin()), end(this->_changes.end()); (current != end); ) {
         DocId doc = current->_doc;
 
-        MultiValueArrayRef oldValues(_mvMapping.get(doc));
+        MultiValueArrayRef oldValues(_mvMapping.get(doc, buffer));
         ValueVector newValues(oldValues.cbegin(), oldValues.cend());
 
         // find last clear doc
@@ -169,7 +187,8 @@ MultiValueAttribute<B, M>::getValueCount(DocId doc) const
     if (doc >= this->getNumDocs()) {
         return 0;
     }
-    MultiValueArrayRef values(this->_mvMapping.get(doc));
+    DecodeBuffer buffer;
+    MultiValueArrayRef values(this->_mvMapping.get(doc, buffer));
     return values.size();
 }
 
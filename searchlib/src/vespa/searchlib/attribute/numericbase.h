@@ -40,6 +40,9 @@ protected:
         Equal(const QueryTermSimple &queryTerm, bool avoidUndefinedInRange);
         bool isValid() const { return _valid; }
         bool match(T v) const { return v == _value; }
+        // match(v) is the same as lowerLimit() <= v && v <= upperLimit()
+        T lowerLimit() const { return _value; }
+        T upperLimit() const { return _value; }
         Int64Range getRange() const {
             return Int64Range(static_cast<int64_t>(_value));
         }
@@ -62,6 +65,8 @@ protected:
         }
         bool isValid() const { return _valid; }
         bool match(T v) const { return (_low <= v) && (v <= _high); }
+        T lowerLimit() const { return _low; }
+        T upperLimit() const { return _high; }
         int getRangeLimit() const { return _limit; }
         size_t getMaxPerGroup() const { return _max_per_group; }
 
@@ -126,7 +126,7 @@ PostingListAttributeBase<P>::updatePostings(PostingMap &changePost,
     for (typename PostingMap::iterator
              it(changePost.begin()), mt(changePost.end()); it != mt; it++) {
         PostingChange<P> &change(it->second);
-        EnumIndex idx(it->first.getEnumIdx());
+        EnumIndex idx(_esb.getCompactedIndex(it->first.getEnumIdx()));
         typename EnumPostingTree::Iterator dictItr =
             _dict.lowerBound(idx, cmp);
         assert(dictItr.valid() && dictItr.getKey() == idx);
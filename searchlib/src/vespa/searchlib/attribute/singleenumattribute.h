@@ -28,13 +28,14 @@ public:
     using EnumIndexCopyVector = vespalib::Array<EnumIndex>;
 
     EnumStoreBase::Index getEnumIndex(DocId docId) const { return _enumIndices[docId]; }
-    EnumHandle getE(DocId doc) const { return _enumIndices[doc].ref(); }
+    EnumHandle getE(DocId doc) const { return _enumStoreBase.getCompactedIndex(_enumIndices[doc]).ref(); }
 protected:
-    SingleValueEnumAttributeBase(const attribute::Config & c, GenerationHolder &genHolder);
+    SingleValueEnumAttributeBase(const attribute::Config & c, GenerationHolder &genHolder, const EnumStoreBase &enumStore);
     ~SingleValueEnumAttributeBase();
     AttributeVector::DocId addDoc(bool & incGeneration);
 
     EnumIndexVector _enumIndices;
+    const EnumStoreBase &_enumStoreBase;
 
     EnumIndexCopyVector getIndicesCopy(uint32_t size) const;
 };
@@ -65,7 +66,7 @@ private:
 protected:
     // from EnumAttribute
     void considerAttributeChange(const Change & c, UniqueSet & newUniques) override;
-    void reEnumerate() override;
+    void reEnumerate(DocId lidLow, DocId lidLimit) override;
 
     // implemented by single value numeric enum attribute.
     virtual void considerUpdateAttributeChange(const Change & c) { (void) c; }
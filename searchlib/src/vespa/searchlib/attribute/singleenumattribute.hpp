@@ -15,7 +15,7 @@ SingleValueEnumAttribute<B>::
 SingleValueEnumAttribute(const vespalib::string &baseFileName,
                          const AttributeVector::Config &cfg)
     : B(baseFileName, cfg),
-      SingleValueEnumAttributeBase(cfg, getGenerationHolder())
+      SingleValueEnumAttributeBase(cfg, getGenerationHolder(), this->getEnumStore())
 {
 }
 
@@ -135,16 +135,16 @@ SingleValueEnumAttribute<B>::considerAttributeChange(const Change & c, UniqueSet
 
 template <typename B>
 void
-SingleValueEnumAttribute<B>::reEnumerate()
+SingleValueEnumAttribute<B>::reEnumerate(DocId lidLow, DocId lidLimit)
 {
-    EnumModifier enumGuard(this->getEnumModifier());
-    for (uint32_t i = 0; i < _enumIndices.size(); ++i) {
-        EnumIndex oldIdx = _enumIndices[i];
+    for (DocId lid = lidLow; lid < lidLimit; ++lid) {
+        EnumIndex oldIdx = _enumIndices[lid];
         if (oldIdx.valid()) {
-            EnumIndex newIdx;
-            this->_enumStore.getCurrentIndex(oldIdx, newIdx);
-            std::atomic_thread_fence(std::memory_order_release);
-            _enumIndices[i] = newIdx;
+            EnumIndex newIdx = this->_enumStore.getCompactedIndex(oldIdx);
+            if (newIdx != oldIdx) {
+                std::atomic_thread_fence(std::memory_order_release);
+                _enumIndices[lid] = newIdx;
+            }
         }
     }
 }
@@ -302,6 +302,7 @@ template <typename B>
 std::unique_ptr<AttributeSaver>
 SingleValueEnumAttribute<B>::onInitSave()
 {
+    this->finishEnumStoreCompaction();
     {
         EnumModifier enumGuard(this->getEnumModifier());
         this->_enumStore.reEnumerate();
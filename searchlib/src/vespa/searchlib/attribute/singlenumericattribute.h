@@ -5,6 +5,7 @@
 #include "integerbase.h"
 #include "floatbase.h"
 #include <vespa/searchlib/common/rcuvector.h>
+#include <vespa/vespalib/hwaccelrated/iaccelrated.h>
 #include <limits>
 
 namespace search {
@@ -40,6 +41,7 @@ private:
     {
     private:
         const T * _data;
+        vespalib::hwaccelrated::IAccelrated::UP _accel;
 
         bool onCmp(DocId docId, int32_t & weight) const override {
             return cmp(docId, weight);
@@ -64,6 +66,14 @@ private:
             return this->match(v);
         }
 
+        /**
+         * Matches the 64 * numWords documents starting at docId into
+         * bit vector words, as cmp does for single documents.
+         */
+        void matchWords(DocId docId, size_t numWords, uint64_t * words) const {
+            _accel->rangeMatchWords(_data + docId, this->lowerLimit(), this->upperLimit(), numWords, words);
+        }
+
         Int64Range getAsIntegerTerm() const override;
 
         std::unique_ptr<queryeval::SearchIterator>
@@ -210,7 +210,8 @@ SingleValueNumericAttribute<B>::SingleSearchContext<M>::SingleSearchContext(Quer
                                                                             const NumericAttribute & toBeSearched) :
     M(*qTerm, true),
     AttributeVector::SearchContext(toBeSearched),
-    _data(&static_cast<const SingleValueNumericAttribute<B> &>(toBeSearched)._data[0])
+    _data(&static_cast<const SingleValueNumericAttribute<B> &>(toBeSearched)._data[0]),
+    _accel(vespalib::hwaccelrated::IAccelrated::getAccelrator())
 { }
 
 
@@ -230,16 +231,17 @@ createFilterIterator(fef::TermFieldMatchData * matchData, bool strict)
     if (!valid()) {
         return queryeval::SearchIterator::UP(new queryeval::EmptySearch());
     }
+    using SC = SingleSearchContext<M>;
     if (getIsFilter()) {
         return queryeval::SearchIterator::UP
                 (strict
-                 ? new FilterAttributeIteratorStrict<SingleSearchContext<M> >(*this, matchData)
-                 : new FilterAttributeIteratorT<SingleSearchContext<M> >(*this, matchData));
+                 ? new AttributeBlockScanIteratorStrict<SC, FilterAttributeIteratorT<SC> >(*this, matchData)
+                 : new FilterAttributeIteratorT<SC>(*this, matchData));
     }
     return queryeval::SearchIterator::UP
             (strict
-             ? new AttributeIteratorStrict<SingleSearchContext<M> >(*this, matchData)
-             : new AttributeIteratorT<SingleSearchContext<M> >(*this, matchData));
+             ? new AttributeBlockScanIteratorStrict<SC, AttributeIteratorT<SC> >(*this, matchData)
+             : new AttributeIteratorT<SC>(*this, matchData));
 }
 }
 
@@ -373,9 +373,12 @@ readFeatures(search::index::DocIdAndFeatures &features)
                                         K_VALUE_POSOCC_ELEMENTID,
                                         EC);
             if (fieldParams._hasElementWeights) {
-                UC64_SKIPEXPGOLOMB_SMALL_NS(o,
-                                            K_VALUE_POSOCC_ELEMENTWEIGHT,
-                                            EC);
+                // Element weights are exposed for block max weights
+                UC64_DECODEEXPGOLOMB_SMALL_NS(o,
+                                              K_VALUE_POSOCC_ELEMENTWEIGHT,
+                                              EC);
+                features._elements.emplace_back();
+                features._elements.back().setWeight(this->convertToSigned(val64));
             }
             if (__builtin_expect(oCompr >= valE, false)) {
                 while (rawFeatures < oCompr) {
@@ -882,9 +885,12 @@ readFeatures(search::index::DocIdAndFeatures &features)
                                         K_VALUE_POSOCC_ELEMENTID,
                                         EC);
             if (fieldParams._hasElementWeights) {
-                UC64_SKIPEXPGOLOMB_SMALL_NS(o,
-                                            K_VALUE_POSOCC_ELEMENTWEIGHT,
-                                            EC);
+                // Element weights are exposed for block max weights
+                UC64_DECODEEXPGOLOMB_SMALL_NS(o,
+                                              K_VALUE_POSOCC_ELEMENTWEIGHT,
+                                              EC);
+                features._elements.emplace_back();
+                features._elements.back().setWeight(this->convertToSigned(val64));
             }
             if (__builtin_expect(oCompr >= valE, false)) {
                 while (rawFeatures < oCompr) {
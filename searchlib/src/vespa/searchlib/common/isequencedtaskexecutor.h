@@ -25,6 +25,11 @@ public:
      */
     virtual uint32_t getExecutorId(uint64_t componentId) = 0;
 
+    /**
+     * Number of internal executors, i.e. how many tasks that can run in parallel.
+     */
+    virtual uint32_t getNumExecutors() const = 0;
+
     uint32_t getExecutorId(vespalib::stringref componentId) {
         vespalib::hash<vespalib::stringref> hashfun;
         return getExecutorId(hashfun(componentId));
@@ -34,6 +34,8 @@ public:
 
     virtual uint32_t getExecutorId(uint64_t componentId) override;
 
+    virtual uint32_t getNumExecutors() const override { return _executors.size(); }
+
     virtual void executeTask(uint32_t executorId, vespalib::Executor::Task::UP task) override;
 
     virtual void sync() override;
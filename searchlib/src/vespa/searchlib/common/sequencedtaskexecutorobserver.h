@@ -27,6 +27,7 @@ public:
 
     virtual ~SequencedTaskExecutorObserver() override;
     virtual uint32_t getExecutorId(uint64_t componentId) override;
+    virtual uint32_t getNumExecutors() const override { return _executor.getNumExecutors(); }
     virtual void executeTask(uint32_t executorId,
                              vespalib::Executor::Task::UP task) override;
     virtual void sync() override;
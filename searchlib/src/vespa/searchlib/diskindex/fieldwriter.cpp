@@ -63,6 +63,11 @@ FieldWriter::earlyOpen(const vespalib::string &prefix,
         countParams.set("minChunkDocs", minChunkDocs);
         params.set("minChunkDocs", minChunkDocs);
     }
+    // Weighted set fields get max element weight per skip block, used
+    // by parallel weak and to skip blocks that cannot beat its threshold.
+    if (schema.getIndexField(indexId).getCollectionType() == Schema::CollectionType::WEIGHTEDSET) {
+        params.set("blockMaxWeights", true);
+    }
 
     _dictFile.reset(new PageDict4FileSeqWrite);
     _dictFile->setParams(countParams);
@@ -9,6 +9,13 @@
 #include <vespa/vespalib/io/fileutil.h>
 #include <vespa/searchlib/common/documentsummary.h>
 #include <vespa/vespalib/util/error.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
+#include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/data/fileheader.h>
+#include <vespa/fastos/file.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <sstream>
 
 #include <vespa/log/log.h>
@@ -25,6 +32,7 @@ using search::index::Schema;
 using search::index::SchemaUtil;
 using search::index::schema::DataType;
 using vespalib::getLastErrorString;
+using vespalib::makeLambdaTask;
 
 
 namespace search {
@@ -43,7 +51,6 @@ Fusion::Fusion(bool dynamicKPosIndexFormat,
     : _schema(NULL),
       _oldIndexes(),
       _docIdLimit(0u),
-      _numWordIds(0u),
       _dynamicKPosIndexFormat(dynamicKPosIndexFormat),
       _outDir("merged"),
       _tuneFileIndexing(tuneFileIndexing),
@@ -53,7 +60,6 @@ Fusion::Fusion(bool dynamicKPosIndexFormat,
 
 Fusion::~Fusion()
 {
-    ReleaseMappingTables();
 }
 
 
@@ -103,9 +109,8 @@ Fusion::openInputWordReaders(const SchemaUtil::IndexIterator &index,
     for (auto &i : getOldIndexes()) {
         OldIndex &oi = *i;
         auto reader(std::make_unique<DictionaryWordReader>());
-        const vespalib::string &tmpindexpath = oi.getTmpPath();
         const vespalib::string &oldindexpath = oi.getPath();
-        vespalib::string wordMapName = tmpindexpath + "/old2new.dat";
+        vespalib::string wordMapName = getFieldTmpPath(oi, index.getName()) + "/old2new.dat";
         vespalib::string fieldDir(oldindexpath + "/" + index.getName());
         vespalib::string dictName(fieldDir + "/dictionary");
         const Schema &oldSchema = oi.getSchema();
@@ -131,7 +136,9 @@ Fusion::openInputWordReaders(const SchemaUtil::IndexIterator &index,
 
 
 bool
-Fusion::renumberFieldWordIds(const SchemaUtil::IndexIterator &index)
+Fusion::renumberFieldWordIds(const SchemaUtil::IndexIterator &index,
+                             WordNumMappingList &list,
+                             uint64_t &numWordIds)
 {
     vespalib::string indexName = index.getName();
     LOG(debug, "Renumber word IDs for field %s", indexName.c_str());
@@ -146,7 +153,7 @@ Fusion::renumberFieldWordIds(const SchemaUtil::IndexIterator &index)
 
     heap.merge(out, 4);
     assert(heap.empty());
-    _numWordIds = out.getWordNum();
+    numWordIds = out.getWordNum();
 
     // Close files
     for (auto &i : readers) {
@@ -155,7 +162,7 @@ Fusion::renumberFieldWordIds(const SchemaUtil::IndexIterator &index)
 
     // Now read mapping files back into an array
     // XXX: avoid this, and instead make the array here
-    if (!ReadMappingFiles(&index))
+    if (!ReadMappingFiles(index, list))
         return false;
 
     LOG(debug, "Finished renumbering words IDs for field %s",
@@ -165,17 +172,86 @@ Fusion::renumberFieldWordIds(const SchemaUtil::IndexIterator &index)
 }
 
 
+uint64_t
+Fusion::estimateFieldMemory(const SchemaUtil::IndexIterator &index)
+{
+    // The word number mapping from each old index is kept in memory while
+    // the field is merged, one 64-bit word number per word in its dictionary.
+    uint64_t memory = 0;
+    for (auto &i : getOldIndexes()) {
+        OldIndex &oi = *i;
+        if (!index.hasOldFields(oi.getSchema(), false)) {
+            continue;
+        }
+        vespalib::string name = oi.getPath() + "/" + index.getName() + "/dictionary.ssdat";
+        FastOS_File file;
+        if (!file.OpenReadOnly(name.c_str())) {
+            continue;
+        }
+        vespalib::FileHeader header;
+        try {
+            header.readFile(file);
+        } catch (const vespalib::IllegalHeaderException &e) {
+            LOG(warning, "Cannot read header of '%s': %s", name.c_str(), e.getMessage().c_str());
+            continue;
+        }
+        if (header.hasTag("numWordIds")) {
+            memory += (header.getTag("numWordIds").asInteger() + 2) * sizeof(uint64_t);
+        }
+    }
+    return memory;
+}
+
+
 bool
-Fusion::mergeFields()
+Fusion::mergeFields(uint32_t numThreads, uint64_t memoryLimit)
 {
-   typedef SchemaUtil::IndexIterator IndexIterator;
+    typedef SchemaUtil::IndexIterator IndexIterator;
 
     const Schema &schema = getSchema();
-    for (IndexIterator index(schema); index.isValid(); ++index) {
-        if (!mergeField(index.getIndex()))
-            return false;
+    makeTmpDirs();
+    bool failed = false;
+    if (numThreads <= 1) {
+        for (IndexIterator index(schema); index.isValid() && !failed; ++index) {
+            failed = !mergeField(index.getIndex());
+        }
+    } else {
+        std::atomic<bool> fieldFailed(false);
+        std::mutex memoryLock;
+        std::condition_variable memoryCond;
+        uint64_t usedMemory = 0;
+        vespalib::ThreadStackExecutor executor(numThreads, 128 * 1024);
+        for (IndexIterator index(schema); index.isValid(); ++index) {
+            uint64_t fieldMemory = estimateFieldMemory(index);
+            {
+                std::unique_lock<std::mutex> guard(memoryLock);
+                memoryCond.wait(guard, [&]() {
+                    return (usedMemory == 0) || (fieldMemory <= memoryLimit - usedMemory);
+                });
+                usedMemory += fieldMemory;
+            }
+            executor.execute(makeLambdaTask([this, id = index.getIndex(), fieldMemory, &fieldFailed,
+                                             &memoryLock, &memoryCond, &usedMemory]() {
+                if (!fieldFailed.load(std::memory_order_relaxed) && !mergeField(id)) {
+                    fieldFailed.store(true, std::memory_order_relaxed);
+                }
+                {
+                    std::lock_guard<std::mutex> guard(memoryLock);
+                    usedMemory -= fieldMemory;
+                }
+                memoryCond.notify_all();
+            }));
+        }
+        executor.sync();
+        executor.shutdown();
+        failed = fieldFailed.load(std::memory_order_relaxed);
     }
-    return true;
+    if (failed) {
+        // the word number mappings are rebuilt when fusion is retried
+        CleanTmpDirs();
+        return false;
+    }
+    return CleanTmpDirs();
 }
 
 
@@ -201,16 +277,20 @@ Fusion::mergeField(uint32_t id)
     LOG(debug, "mergeField for field %s dir %s",
         indexName.c_str(), indexDir.c_str());
 
-    makeTmpDirs();
+    for (auto &i : getOldIndexes()) {
+        vespalib::mkdir(getFieldTmpPath(*i, indexName), false);
+    }
 
-    if (!renumberFieldWordIds(index)) {
+    WordNumMappingList list(_oldIndexes.size());
+    uint64_t numWordIds = 0;
+    if (!renumberFieldWordIds(index, list, numWordIds)) {
         LOG(error, "Could not renumber field word ids for field %s dir %s",
             indexName.c_str(), indexDir.c_str());
         return false;
     }
 
     // Tokamak
-    bool res = mergeFieldPostings(index);
+    bool res = mergeFieldPostings(index, list, numWordIds);
     if (!res) {
         LOG(error, "Could not merge field postings for field %s dir %s",
             indexName.c_str(), indexDir.c_str());
@@ -219,9 +299,6 @@ Fusion::mergeField(uint32_t id)
     if (!FileKit::createStamp(indexDir +  "/.mergeocc_done"))
         return false;
 
-    if (!CleanTmpDirs())
-        return false;
-
     LOG(debug, "Finished mergeField for field %s dir %s",
         indexName.c_str(), indexDir.c_str());
 
@@ -285,18 +362,19 @@ Fusion::selectCookedOrRawFeatures(Reader &reader, Writer &writer)
 
 bool
 Fusion::openInputFieldReaders(const SchemaUtil::IndexIterator &index,
+                              const WordNumMappingList &list,
                               std::vector<std::unique_ptr<FieldReader> > &
                               readers)
 {
     vespalib::string indexName = index.getName();
-    for (auto &i : _oldIndexes) {
-        OldIndex &oi = *i;
+    for (uint32_t i = 0; i < _oldIndexes.size(); ++i) {
+        OldIndex &oi = *_oldIndexes[i];
         const Schema &oldSchema = oi.getSchema();
         if (!index.hasOldFields(oldSchema, false)) {
             continue; // drop data
         }
         auto reader = FieldReader::allocFieldReader(index, oldSchema);
-        reader->setup(oi.getWordNumMapping(),
+        reader->setup(list[i],
                       oi.getDocIdMapping());
         if (!reader->open(oi.getPath() + "/" +
                           indexName + "/",
@@ -352,15 +430,17 @@ Fusion::setupMergeHeap(const std::vector<std::unique_ptr<FieldReader> > &
 
 
 bool
-Fusion::mergeFieldPostings(const SchemaUtil::IndexIterator &index)
+Fusion::mergeFieldPostings(const SchemaUtil::IndexIterator &index,
+                           const WordNumMappingList &list,
+                           uint64_t numWordIds)
 {
     std::vector<std::unique_ptr<FieldReader>> readers;
     PostingPriorityQueue<FieldReader> heap;
     /* OUTPUT */
-    FieldWriter fieldWriter(_docIdLimit, _numWordIds);
+    FieldWriter fieldWriter(_docIdLimit, numWordIds);
     vespalib::string indexName = index.getName();
 
-    if (!openInputFieldReaders(index, readers))
+    if (!openInputFieldReaders(index, list, readers))
         return false;
     if (!openFieldWriter(index, fieldWriter))
         return false;
@@ -384,15 +464,14 @@ Fusion::mergeFieldPostings(const SchemaUtil::IndexIterator &index)
 
 
 bool
-Fusion::ReadMappingFiles(const SchemaUtil::IndexIterator *index)
+Fusion::ReadMappingFiles(const SchemaUtil::IndexIterator &index,
+                         WordNumMappingList &list)
 {
-    ReleaseMappingTables();
-
     size_t numberOfOldIndexes = _oldIndexes.size();
     for (uint32_t i = 0; i < numberOfOldIndexes; i++)
     {
         OldIndex &oi = *_oldIndexes[i];
-        WordNumMapping &wordNumMapping = oi.getWordNumMapping();
+        WordNumMapping &wordNumMapping = list[i];
         std::vector<uint32_t> oldIndexes;
         const Schema &oldSchema = oi.getSchema();
         if (!SchemaUtil::getIndexIds(oldSchema,
@@ -403,12 +482,12 @@ Fusion::ReadMappingFiles(const SchemaUtil::IndexIterator *index)
             wordNumMapping.noMappingFile();
             continue;
         }
-        if (index && !index->hasOldFields(oldSchema, false)) {
+        if (!index.hasOldFields(oldSchema, false)) {
             continue; // drop data
         }
 
         // Open word mapping file
-        vespalib::string old2newname = oi.getTmpPath() + "/old2new.dat";
+        vespalib::string old2newname = getFieldTmpPath(oi, index.getName()) + "/old2new.dat";
         wordNumMapping.readMappingFile(old2newname, _tuneFileIndexing._read);
     }
 
@@ -416,16 +495,10 @@ Fusion::ReadMappingFiles(const SchemaUtil::IndexIterator *index)
 }
 
 
-bool
-Fusion::ReleaseMappingTables()
+vespalib::string
+Fusion::getFieldTmpPath(const OldIndex &oi, const vespalib::string &indexName) const
 {
-    size_t numberOfOldIndexes = _oldIndexes.size();
-    for (uint32_t i = 0; i < numberOfOldIndexes; i++)
-    {
-        OldIndex &oi = *_oldIndexes[i];
-        oi.getWordNumMapping().clear();
-    }
-    return true;
+    return oi.getTmpPath() + "/" + indexName;
 }
 
 
@@ -516,7 +589,9 @@ Fusion::merge(const Schema &schema,
               const SelectorArray &selector,
               bool dynamicKPosOccFormat,
               const TuneFileIndexing &tuneFileIndexing,
-              const FileHeaderContext &fileHeaderContext)
+              const FileHeaderContext &fileHeaderContext,
+              uint32_t numThreads,
+              uint64_t memoryLimit)
 {
     assert(sources.size() <= 255);
     uint32_t docIdLimit = selector.size();
@@ -585,7 +660,7 @@ Fusion::merge(const Schema &schema,
                            idx);
     }
     fusion->setDocIdLimit(trimmedDocIdLimit);
-    if (!fusion->mergeFields())
+    if (!fusion->mergeFields(numThreads, memoryLimit))
         return false;
     return true;
 }
@@ -6,6 +6,7 @@
 #include "wordnummapper.h"
 
 #include <vespa/searchlib/index/schemautil.h>
+#include <limits>
 #include <vector>
 #include <string>
 
@@ -37,7 +38,6 @@ public:
     typedef diskindex::DocIdMapping DocIdMapping;
 private:
     vespalib::string _path;
-    WordNumMapping _wordNumMapping;
     DocIdMapping _docIdMapping;
     vespalib::string _tmpPath;
     index::Schema::SP _schema;
@@ -45,7 +45,6 @@ private:
 public:
     FusionInputIndex()
         : _path(),
-          _wordNumMapping(),
           _docIdMapping(),
           _tmpPath(),
           _schema()
@@ -81,18 +80,6 @@ public:
         return _tmpPath;
     }
 
-    const WordNumMapping &
-    getWordNumMapping() const
-    {
-        return _wordNumMapping;
-    }
-
-    WordNumMapping &
-    getWordNumMapping()
-    {
-        return _wordNumMapping;
-    }
-
     const DocIdMapping &
     getDocIdMapping() const
     {
@@ -122,6 +109,9 @@ class Fusion
 public:
     typedef search::index::Schema Schema;
     typedef search::index::SchemaUtil SchemaUtil;
+    typedef FusionInputIndex OldIndex;
+    // Word number mappings for one field, one entry per old index
+    typedef std::vector<WordNumMapping> WordNumMappingList;
 
 private:
     Fusion(const Fusion &);
@@ -137,9 +127,17 @@ public:
 
     void SetOldIndexList(const std::vector<vespalib::string> &oldIndexList);
 
-    bool mergeFields();
+    /**
+     * Merge all index fields. Fields are independent of each other
+     * and are merged concurrently when more than one thread is given,
+     * as long as their estimated memory use stays within the limit.
+     */
+    bool mergeFields(uint32_t numThreads = 1,
+                     uint64_t memoryLimit = std::numeric_limits<uint64_t>::max());
+    uint64_t estimateFieldMemory(const SchemaUtil::IndexIterator &index);
     bool mergeField(uint32_t id);
     bool openInputFieldReaders(const SchemaUtil::IndexIterator &index,
+                               const WordNumMappingList &list,
                                std::vector<std::unique_ptr<FieldReader> > &
                                readers);
     bool openFieldWriter(const SchemaUtil::IndexIterator &index,
@@ -148,13 +146,17 @@ public:
                         readers,
                         FieldWriter &writer,
                         PostingPriorityQueue<FieldReader> &heap);
-    bool mergeFieldPostings(const SchemaUtil::IndexIterator &index);
+    bool mergeFieldPostings(const SchemaUtil::IndexIterator &index,
+                            const WordNumMappingList &list,
+                            uint64_t numWordIds);
     bool openInputWordReaders(const SchemaUtil::IndexIterator &index,
                               std::vector<
                                  std::unique_ptr<DictionaryWordReader> > &
                               readers,
                               PostingPriorityQueue<DictionaryWordReader> &heap);
-    bool renumberFieldWordIds(const SchemaUtil::IndexIterator &index);
+    bool renumberFieldWordIds(const SchemaUtil::IndexIterator &index,
+                              WordNumMappingList &list,
+                              uint64_t &numWordIds);
 
     void
     setSchema(const Schema *schema);
@@ -177,8 +179,10 @@ public:
     selectCookedOrRawFeatures(Reader &reader, Writer &writer);
 
 protected:
-    bool ReadMappingFiles(const SchemaUtil::IndexIterator *index);
-    bool ReleaseMappingTables();
+    bool ReadMappingFiles(const SchemaUtil::IndexIterator &index,
+                          WordNumMappingList &list);
+    vespalib::string getFieldTmpPath(const OldIndex &oi,
+                                     const vespalib::string &indexName) const;
 
     static unsigned int noGen()
     {
@@ -187,8 +191,6 @@ protected:
 
 protected:
 
-    typedef FusionInputIndex OldIndex;
-
     const Schema *_schema;  // External ownership
     std::vector<std::shared_ptr<OldIndex> > _oldIndexes;
     typedef std::vector<std::shared_ptr<OldIndex> >::iterator
@@ -197,7 +199,6 @@ protected:
     // OUTPUT:
 
     uint32_t _docIdLimit;
-    uint64_t _numWordIds;
 
     // Index format parameters.
     bool _dynamicKPosIndexFormat;
@@ -226,12 +227,6 @@ public:
         _docIdLimit = docIdLimit;
     }
 
-    void
-    setNumWordIds(uint64_t numWordIds)
-    {
-        _numWordIds = numWordIds;
-    }
-
     std::vector<std::shared_ptr<OldIndex> > &
     getOldIndexes()
     {
@@ -254,7 +249,9 @@ public:
           const SelectorArray &docIdSelector,
           bool dynamicKPosOccFormat,
           const TuneFileIndexing &tuneFileIndexing,
-          const search::common::FileHeaderContext &fileHeaderContext);
+          const search::common::FileHeaderContext &fileHeaderContext,
+          uint32_t numThreads = 1,
+          uint64_t memoryLimit = std::numeric_limits<uint64_t>::max());
 };
 
 } // namespace diskindex
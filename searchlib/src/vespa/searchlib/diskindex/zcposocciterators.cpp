@@ -29,8 +29,9 @@ Zc4PosOccIterator<bigEndian>::
 Zc4PosOccIterator(Position start, uint64_t bitLength, uint32_t docIdLimit,
                   uint32_t minChunkDocs, const PostingListCounts &counts,
                   const PosOccFieldsParams *fieldsParams,
-                  const TermFieldMatchDataArray &matchData)
-    : ZcPostingIterator<bigEndian>(minChunkDocs, false, counts, matchData, start, docIdLimit),
+                  const TermFieldMatchDataArray &matchData,
+                  bool blockMaxWeights)
+    : ZcPostingIterator<bigEndian>(minChunkDocs, false, counts, matchData, start, docIdLimit, blockMaxWeights),
       _decodeContextReal(start.getOccurences(), start.getBitOffset(), bitLength, fieldsParams)
 {
     assert(!matchData.valid() || (fieldsParams->getNumFields() == matchData.size()));
@@ -56,8 +57,9 @@ ZcPosOccIterator<bigEndian>::
 ZcPosOccIterator(Position start, uint64_t bitLength, uint32_t docIdLimit,
                  uint32_t minChunkDocs, const PostingListCounts &counts,
                  const PosOccFieldsParams *fieldsParams,
-                 const TermFieldMatchDataArray &matchData)
-    : ZcPostingIterator<bigEndian>(minChunkDocs, true, counts, matchData, start, docIdLimit),
+                 const TermFieldMatchDataArray &matchData,
+                 bool blockMaxWeights)
+    : ZcPostingIterator<bigEndian>(minChunkDocs, true, counts, matchData, start, docIdLimit, blockMaxWeights),
       _decodeContextReal(start.getOccurences(), start.getBitOffset(), bitLength, fieldsParams)
 {
     assert(!matchData.valid() || (fieldsParams->getNumFields() == matchData.size()));
@@ -38,7 +38,8 @@ public:
     Zc4PosOccIterator(Position start, uint64_t bitLength, uint32_t docIdLimit,
                       uint32_t minChunkDocs, const index::PostingListCounts &counts,
                       const bitcompression::PosOccFieldsParams *fieldsParams,
-                      const search::fef::TermFieldMatchDataArray &matchData);
+                      const search::fef::TermFieldMatchDataArray &matchData,
+                      bool blockMaxWeights = false);
 };
 
 
@@ -71,7 +72,8 @@ public:
     ZcPosOccIterator(Position start, uint64_t bitLength, uint32_t docidLimit,
                      uint32_t minChunkDocs, const index::PostingListCounts &counts,
                      const bitcompression::PosOccFieldsParams *fieldsParams,
-                     const search::fef::TermFieldMatchDataArray &matchData);
+                     const search::fef::TermFieldMatchDataArray &matchData,
+                     bool blockMaxWeights = false);
 };
 
 
@@ -40,6 +40,7 @@ ZcPosOccRandRead::ZcPosOccRandRead()
       _minChunkDocs(1 << 30),
       _minSkipDocs(64),
       _docIdLimit(10000000),
+      _blockMaxWeights(false),
       _numWords(0),
       _fileBitSize(0),
       _headerBitSize(0),
@@ -100,7 +101,8 @@ createIterator(const PostingListCounts &counts,
     if (numDocs < _minSkipDocs) {
         return new ZcRareWordPosOccIterator<true>(start, handle._bitLength, _docIdLimit, &_fieldsParams, matchData);
     } else {
-        return new ZcPosOccIterator<true>(start, handle._bitLength, _docIdLimit, _minChunkDocs, counts, &_fieldsParams, matchData);
+        return new ZcPosOccIterator<true>(start, handle._bitLength, _docIdLimit, _minChunkDocs, counts, &_fieldsParams, matchData,
+                                          _blockMaxWeights);
     }
 }
 
@@ -231,6 +233,8 @@ ZcPosOccRandRead::readHeader()
     _minChunkDocs = header.getTag("minChunkDocs").asInteger();
     _docIdLimit = header.getTag("docIdLimit").asInteger();
     _minSkipDocs = header.getTag("minSkipDocs").asInteger();
+    _blockMaxWeights = header.hasTag("blockMaxWeights") &&
+                       header.getTag("blockMaxWeights").asInteger() != 0;
     // Read feature decoding specific subheader
     d.readHeader(header, "features.");
     // Align on 64-bit unit
@@ -305,7 +309,8 @@ createIterator(const PostingListCounts &counts,
     if (numDocs < _minSkipDocs) {
         return new Zc4RareWordPosOccIterator<true>(start, handle._bitLength, _docIdLimit, &_fieldsParams, matchData);
     } else {
-        return new Zc4PosOccIterator<true>(start, handle._bitLength, _docIdLimit, _minChunkDocs, counts, &_fieldsParams, matchData);
+        return new Zc4PosOccIterator<true>(start, handle._bitLength, _docIdLimit, _minChunkDocs, counts, &_fieldsParams, matchData,
+                                           _blockMaxWeights);
     }
 }
 
@@ -342,6 +347,8 @@ Zc4PosOccRandRead::readHeader()
     _minChunkDocs = header.getTag("minChunkDocs").asInteger();
     _docIdLimit = header.getTag("docIdLimit").asInteger();
     _minSkipDocs = header.getTag("minSkipDocs").asInteger();
+    _blockMaxWeights = header.hasTag("blockMaxWeights") &&
+                       header.getTag("blockMaxWeights").asInteger() != 0;
     // Read feature decoding specific subheader
     d.readHeader(header, "features.");
     // Align on 64-bit unit
@@ -20,6 +20,7 @@ protected:
     uint32_t _minChunkDocs; // # of documents needed for chunking
     uint32_t _minSkipDocs;  // # of documents needed for skipping
     uint32_t _docIdLimit;   // Limit for document ids (docId < docIdLimit)
+    bool _blockMaxWeights;  // L1 skip info has max element weight per block
 
     uint64_t _numWords;     // Number of words in file
     uint64_t _fileBitSize;
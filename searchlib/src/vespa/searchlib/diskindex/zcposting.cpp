@@ -8,6 +8,7 @@
 #include <vespa/searchlib/common/fileheadercontext.h>
 #include <vespa/vespalib/objects/nbostream.h>
 #include <vespa/vespalib/data/fileheader.h>
+#include <limits>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".diskindex.zcposting");
@@ -46,6 +47,7 @@ Zc4PostingSeqRead(PostingListCountFileSeqRead *countFile)
       _minChunkDocs(1 << 30),
       _minSkipDocs(64),
       _docIdLimit(10000000),
+      _blockMaxWeights(false),
       _zcDocIds(),
       _l1Skip(),
       _l2Skip(),
@@ -162,6 +164,9 @@ readCommonWordDocIdAndFeatures(DocIdAndFeatures &features)
             assert(_l2SkipDocId >= docId);
         }
         _l1SkipDocId += _l1Skip.decode() + 1;
+        if (_blockMaxWeights) {
+            _l1Skip.decode();   // Max element weight in block
+        }
         assert(_l1SkipDocId <= _lastDocId);
         assert(_l1SkipDocId <= _l4SkipDocId);
         assert(_l1SkipDocId <= _l3SkipDocId);
@@ -405,10 +410,14 @@ Zc4PostingSeqRead::readWordStartWithSkip()
         _decodeContext->readBytes(_l4Skip._valI, l4SkipSize);
     _l4Skip._valE = _l4Skip._valI + l4SkipSize;
 
-    if (l1SkipSize > 0)
+    if (l1SkipSize > 0) {
         _l1SkipDocId = _l1Skip.decode() + 1 + _prevDocId;
-    else
+        if (_blockMaxWeights) {
+            _l1Skip.decode();   // Max element weight in block
+        }
+    } else {
         _l1SkipDocId = _lastDocId;
+    }
     if (l2SkipSize > 0)
         _l2SkipDocId = _l2Skip.decode() + 1 + _prevDocId;
     else
@@ -574,6 +583,7 @@ Zc4PostingSeqRead::getParams(PostingListParams &params)
         params.set("minChunkDocs", _minChunkDocs);
     }
     params.set("minSkipDocs", _minSkipDocs);
+    params.set("blockMaxWeights", _blockMaxWeights);
 }
 
 
@@ -616,6 +626,8 @@ Zc4PostingSeqRead::readHeader()
     _minChunkDocs = header.getTag("minChunkDocs").asInteger();
     _docIdLimit = header.getTag("docIdLimit").asInteger();
     _minSkipDocs = header.getTag("minSkipDocs").asInteger();
+    _blockMaxWeights = header.hasTag("blockMaxWeights") &&
+                       header.getTag("blockMaxWeights").asInteger() != 0;
     assert(header.getTag("endian").asString() == "big");
     // Read feature decoding specific subheader
     d.readHeader(header, "features.");
@@ -671,7 +683,9 @@ Zc4PostingSeqWrite(PostingListCountFileSeqWrite *countFile)
       _minChunkDocs(1 << 30),
       _minSkipDocs(64),
       _docIdLimit(10000000),
+      _blockMaxWeights(false),
       _docIds(),
+      _docMaxWeights(),
       _encodeFeatures(NULL),
       _featureOffset(0),
       _featureWriteContext(sizeof(uint64_t)),
@@ -715,6 +729,13 @@ writeDocIdAndFeatures(const DocIdAndFeatures &features)
     assert(static_cast<uint32_t>(featureSize) == featureSize);
     _docIds.push_back(std::make_pair(features._docId,
                                      static_cast<uint32_t>(featureSize)));
+    if (_blockMaxWeights) {
+        int32_t maxWeight = features._elements.empty() ? 1 : std::numeric_limits<int32_t>::min();
+        for (const auto &element : features._elements) {
+            maxWeight = std::max(maxWeight, element.getWeight());
+        }
+        _docMaxWeights.push_back(maxWeight);
+    }
     _featureOffset = writeOffset;
 }
 
@@ -747,7 +768,7 @@ Zc4PostingSeqWrite::checkPointWrite(nbostream &out)
     out << _numWords;
     _writeContext.checkPointWrite(out);
     _featureWriteContext.checkPointWrite(out);
-    out.saveVector(_docIds) << _writePos << _counts;
+    out.saveVector(_docIds).saveVector(_docMaxWeights) << _writePos << _counts;
     _file.Sync();
 }
 
@@ -759,7 +780,7 @@ Zc4PostingSeqWrite::checkPointRead(nbostream &in)
     _writeContext.checkPointRead(in);
     _featureWriteContext.checkPointRead(in);
     _featureOffset = _encodeFeatures->getWriteOffset();
-    in.restoreVector(_docIds) >> _writePos >> _counts;
+    in.restoreVector(_docIds).restoreVector(_docMaxWeights) >> _writePos >> _counts;
 }
 
 
@@ -812,6 +833,8 @@ Zc4PostingSeqWrite::readHeader(const vespalib::string &name)
     _minChunkDocs = header.getTag("minChunkDocs").asInteger();
     _docIdLimit = header.getTag("docIdLimit").asInteger();
     _minSkipDocs = header.getTag("minSkipDocs").asInteger();
+    _blockMaxWeights = header.hasTag("blockMaxWeights") &&
+                       header.getTag("blockMaxWeights").asInteger() != 0;
     assert(header.getTag("endian").asString() == "big");
     // Read feature decoding specific subheader using helper decode context
     f.readHeader(header, "features.");
@@ -843,6 +866,7 @@ Zc4PostingSeqWrite::makeHeader(const FileHeaderContext &fileHeaderContext)
     header.putTag(Tag("minChunkDocs", _minChunkDocs));
     header.putTag(Tag("docIdLimit", _docIdLimit));
     header.putTag(Tag("minSkipDocs", _minSkipDocs));
+    header.putTag(Tag("blockMaxWeights", _blockMaxWeights ? 1 : 0));
     header.putTag(Tag("endian", "big"));
     header.putTag(Tag("desc", "Posting list file"));
 
@@ -971,6 +995,7 @@ setParams(const PostingListParams &params)
     params.get("docIdLimit", _docIdLimit);
     params.get("minChunkDocs", _minChunkDocs);
     params.get("minSkipDocs", _minSkipDocs);
+    params.get("blockMaxWeights", _blockMaxWeights);
 }
 
 
@@ -994,6 +1019,7 @@ getParams(PostingListParams &params)
         params.set("minChunkDocs", _minChunkDocs);
     }
     params.set("minSkipDocs", _minSkipDocs);
+    params.set("blockMaxWeights", _blockMaxWeights);
 }
 
 
@@ -1053,6 +1079,7 @@ Zc4PostingSeqWrite::calcSkipInfo()
     unsigned int l3SkipCnt = 0;
     unsigned int l4SkipCnt = 0;
     uint64_t featurePos = 0;
+    int32_t l1BlockMaxWeight = std::numeric_limits<int32_t>::min();
 
     std::vector<DocIdAndFeatureSize>::const_iterator dit = _docIds.begin();
     std::vector<DocIdAndFeatureSize>::const_iterator dite = _docIds.end();
@@ -1072,6 +1099,11 @@ Zc4PostingSeqWrite::calcSkipInfo()
             assert(static_cast<int32_t>(docIdDelta) > 0);
             _l1Skip.encode(docIdDelta - 1);
             lastL1SkipDocId = lastDocId;
+            if (_blockMaxWeights) {
+                // L1 max element weight in block
+                _l1Skip.encode(EncodeContext::convertToUnsigned(l1BlockMaxWeight));
+                l1BlockMaxWeight = std::numeric_limits<int32_t>::min();
+            }
             // L1 docid pos
             uint64_t docIdPos = _zcDocIds.size();
             _l1Skip.encode(docIdPos - lastL1SkipDocIdPos - 1);
@@ -1157,11 +1189,18 @@ Zc4PostingSeqWrite::calcSkipInfo()
         featurePos += dit->second;
         _zcDocIds.encode(docId - lastDocId - 1);
         lastDocId = docId;
+        if (_blockMaxWeights) {
+            l1BlockMaxWeight = std::max(l1BlockMaxWeight, _docMaxWeights[dit - _docIds.begin()]);
+        }
         ++l1SkipCnt;
     }
     // Extra partial entries for skip tables to simplify iterator during search
-    if (_l1Skip.size() > 0)
+    if (_l1Skip.size() > 0) {
         _l1Skip.encode(lastDocId - lastL1SkipDocId - 1);
+        if (_blockMaxWeights) {
+            _l1Skip.encode(EncodeContext::convertToUnsigned(l1BlockMaxWeight));
+        }
+    }
     if (_l2Skip.size() > 0)
         _l2Skip.encode(lastDocId - lastL2SkipDocId - 1);
     if (_l3Skip.size() > 0)
@@ -1315,6 +1354,7 @@ void
 Zc4PostingSeqWrite::resetWord()
 {
     _docIds.clear();
+    _docMaxWeights.clear();
     _encodeFeatures->setupWrite(_featureWriteContext);
     _featureOffset = 0;
 }
@@ -39,6 +39,7 @@ protected:
     uint32_t _minChunkDocs; // # of documents needed for chunking
     uint32_t _minSkipDocs;  // # of documents needed for skipping
     uint32_t _docIdLimit;   // Limit for document ids (docId < docIdLimit)
+    bool _blockMaxWeights;  // L1 skip info has max element weight per block
 
     ZcBuf _zcDocIds;    // Document id deltas
     ZcBuf _l1Skip;      // L1 skip info
@@ -147,9 +148,11 @@ protected:
     uint32_t _minChunkDocs; // # of documents needed for chunking
     uint32_t _minSkipDocs;  // # of documents needed for skipping
     uint32_t _docIdLimit;   // Limit for document ids (docId < docIdLimit)
+    bool _blockMaxWeights;  // Store max element weight per L1 skip block ?
     // Unpacked document ids for word and feature sizes
     typedef std::pair<uint32_t, uint32_t> DocIdAndFeatureSize;
     std::vector<DocIdAndFeatureSize> _docIds;
+    std::vector<int32_t> _docMaxWeights; // Max element weight per document
 
     // Buffer up features in memory
     EncodeContext *_encodeFeatures;
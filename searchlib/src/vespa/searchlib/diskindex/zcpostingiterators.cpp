@@ -204,11 +204,14 @@ ZcRareWordPostingIterator<bigEndian>::readWordStart(uint32_t docIdLimit)
     clearUnpacked();
 }
 
-ZcPostingIteratorBase::ZcPostingIteratorBase(const TermFieldMatchDataArray &matchData, Position start, uint32_t docIdLimit)
+ZcPostingIteratorBase::ZcPostingIteratorBase(const TermFieldMatchDataArray &matchData, Position start, uint32_t docIdLimit,
+                                             bool blockMaxWeights)
     : ZcIteratorBase(matchData, start, docIdLimit),
       _valI(NULL),
       _valIBase(NULL),
       _featureSeekPos(0),
+      _blockMaxWeights(blockMaxWeights),
+      _blockMaxWeight(std::numeric_limits<int32_t>::max()),
       _l1(),
       _l2(),
       _l3(),
@@ -226,8 +229,9 @@ ZcPostingIterator(uint32_t minChunkDocs,
                   bool dynamicK,
                   const PostingListCounts &counts,
                   const search::fef::TermFieldMatchDataArray &matchData,
-                  Position start, uint32_t docIdLimit)
-    : ZcPostingIteratorBase(matchData, start, docIdLimit),
+                  Position start, uint32_t docIdLimit,
+                  bool blockMaxWeights)
+    : ZcPostingIteratorBase(matchData, start, docIdLimit, blockMaxWeights),
       _decodeContext(NULL),
       _minChunkDocs(minChunkDocs),
       _docIdK(0),
@@ -313,6 +317,11 @@ ZcPostingIterator<bigEndian>::readWordStart(uint32_t docIdLimit)
     _valIBase = _valI = bcompr;
     bcompr += docIdsSize;
     _l1.setup(prevDocId, _chunk._lastDocId, bcompr, l1SkipSize);
+    if (l1SkipSize != 0) {
+        decodeBlockMaxWeight();
+    } else {
+        _blockMaxWeight = std::numeric_limits<int32_t>::max();
+    }
     _l2.setup(prevDocId, _chunk._lastDocId, bcompr, l2SkipSize);
     _l3.setup(prevDocId, _chunk._lastDocId, bcompr, l3SkipSize);
     _l4.setup(prevDocId, _chunk._lastDocId, bcompr, l4SkipSize);
@@ -387,6 +396,7 @@ ZcPostingIteratorBase::doL4SkipSeek(uint32_t docId)
     _l3._valI = _l4._l3Pos;
     nextDocId(lastL4SkipDocId);
     _l1.nextDocId();
+    decodeBlockMaxWeight();
     _l2.nextDocId();
     _l3.nextDocId();
 #if DEBUG_ZCPOSTING_PRINTF
@@ -435,6 +445,7 @@ ZcPostingIteratorBase::doL3SkipSeek(uint32_t docId)
     _l2._valI = _l3._l2Pos;
     nextDocId(lastL3SkipDocId);
     _l1.nextDocId();
+    decodeBlockMaxWeight();
     _l2.nextDocId();
 #if DEBUG_ZCPOSTING_PRINTF
     printf("L3Seek, docId %d docIdPos %d"
@@ -478,6 +489,7 @@ ZcPostingIteratorBase::doL2SkipSeek(uint32_t docId)
     _l1._valI = _l2._l1Pos;
     nextDocId(lastL2SkipDocId);
     _l1.nextDocId();
+    decodeBlockMaxWeight();
 #if DEBUG_ZCPOSTING_PRINTF
     printf("L2Seek, docId %d docIdPos %d L1SkipPos %d, nextDocId %d\n",
            lastL2SkipDocId,
@@ -503,6 +515,7 @@ ZcPostingIteratorBase::doL1SkipSeek(uint32_t docId)
         lastL1SkipDocId = _l1._skipDocId;
         _l1.decodeSkipEntry();
         _l1.nextDocId();
+        decodeBlockMaxWeight();
 #if DEBUG_ZCPOSTING_PRINTF
         printf("L1Decode docId %d, docIdPos %d, L1SkipPos %d, nextDocId %d\n",
                lastL1SkipDocId,
@@ -5,6 +5,7 @@
 #include <vespa/searchlib/index/postinglistfile.h>
 #include <vespa/searchlib/bitcompression/compression.h>
 #include <vespa/searchlib/queryeval/iterators.h>
+#include <vespa/searchlib/queryeval/posting_info.h>
 #include <vespa/fastos/dynamiclibrary.h>
 
 namespace search {
@@ -103,12 +104,15 @@ public:
 };
 
 
-class ZcPostingIteratorBase : public ZcIteratorBase
+class ZcPostingIteratorBase : public ZcIteratorBase,
+                              public queryeval::BlockMaxWeightInfo
 {
 protected:
     const uint8_t *_valI;     // docid deltas
     const uint8_t *_valIBase; // start of docid deltas
     uint64_t _featureSeekPos;
+    bool _blockMaxWeights;    // L1 skip info has max element weight per block
+    int32_t _blockMaxWeight;  // Max element weight in current L1 skip block
 
     // Helper class for L1 skip info
     class L1Skip
@@ -248,6 +252,13 @@ protected:
         ZCDECODE(_valI, docId +=);
         setDocId(docId);
     }
+    void decodeBlockMaxWeight() {
+        if (_blockMaxWeights) {
+            uint32_t weight;
+            ZCDECODE(_l1._valI, weight =);
+            _blockMaxWeight = bitcompression::DecodeContext64Base::convertToSigned(weight);
+        }
+    }
     virtual void featureSeek(uint64_t offset) = 0;
     VESPA_DLL_LOCAL void doChunkSkipSeek(uint32_t docId);
     VESPA_DLL_LOCAL void doL4SkipSeek(uint32_t docId);
@@ -256,7 +267,12 @@ protected:
     VESPA_DLL_LOCAL void doL1SkipSeek(uint32_t docId);
     void doSeek(uint32_t docId) override;
 public:
-    ZcPostingIteratorBase(const fef::TermFieldMatchDataArray &matchData, Position start, uint32_t docIdLimit);
+    ZcPostingIteratorBase(const fef::TermFieldMatchDataArray &matchData, Position start, uint32_t docIdLimit,
+                          bool blockMaxWeights);
+
+    bool hasBlockMaxWeights() const override { return _blockMaxWeights; }
+    int32_t getBlockMaxWeight() const override { return _blockMaxWeight; }
+    uint32_t getBlockLastDocId() const override { return _l1._skipDocId; }
 };
 
 template <bool bigEndian>
@@ -286,7 +302,8 @@ public:
                       bool dynamicK,
                       const PostingListCounts &counts,
                       const search::fef::TermFieldMatchDataArray &matchData,
-                      Position start, uint32_t docIdLimit);
+                      Position start, uint32_t docIdLimit,
+                      bool blockMaxWeights = false);
 
 
     void doUnpack(uint32_t docId) override;
@@ -0,0 +1,318 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "batchpread.h"
+#include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
+#include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/sync.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cinttypes>
+#include <cstring>
+#include <memory>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define SEARCHLIB_HAVE_IO_URING 1
+#endif
+
+#include <vespa/log/log.h>
+LOG_SETUP(".search.docstore.batchpread");
+
+using vespalib::IoException;
+using vespalib::make_string;
+
+namespace search {
+
+namespace {
+
+constexpr size_t NUM_THREADS = 16;
+
+void
+throwReadError(int error, const BatchPRead::Read & read) {
+    throw IoException(make_string("Failed reading %zu bytes at offset %" PRIu64 ". Reason given by OS = '%s'",
+                                  read._size, read._offset, strerror(error)),
+                      IoException::getErrorType(error), VESPA_STRLOC);
+}
+
+/**
+ * Completes a read synchronously, picking up after what has already been read.
+ * Returns the error from the OS, or 0 when done.
+ */
+int
+completeRead(int fd, BatchPRead::Read & read) {
+    size_t done = read._result;
+    while (done < read._size) {
+        ssize_t got = ::pread(fd, static_cast<char *>(read._buffer) + done, read._size - done, read._offset + done);
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno;
+        }
+        if (got == 0) {
+            break;
+        }
+        done += got;
+    }
+    read._result = done;
+    return 0;
+}
+
+void
+completeReadOrThrow(int fd, BatchPRead::Read & read) {
+    int error = completeRead(fd, read);
+    if (error != 0) {
+        throwReadError(error, read);
+    }
+}
+
+void
+readWithThreads(int fd, std::vector<BatchPRead::Read> & reads) {
+    static vespalib::ThreadStackExecutor executor(NUM_THREADS, 64*1024);
+    size_t numTasks = std::min(reads.size(), NUM_THREADS);
+    vespalib::CountDownLatch latch(numTasks);
+    std::vector<std::pair<int, size_t>> failures(numTasks, std::make_pair(0, size_t(0)));
+    for (size_t task(0); task < numTasks; task++) {
+        auto readSome = vespalib::makeLambdaTask([fd, task, numTasks, &reads, &failures, &latch]() {
+            for (size_t i(task); (i < reads.size()) && (failures[task].first == 0); i += numTasks) {
+                failures[task] = std::make_pair(completeRead(fd, reads[i]), i);
+            }
+            latch.countDown();
+        });
+        auto rejected = executor.execute(std::move(readSome));
+        if (rejected) {
+            rejected->run();
+        }
+    }
+    latch.await();
+    for (const auto & failure : failures) {
+        if (failure.first != 0) {
+            throwReadError(failure.first, reads[failure.second]);
+        }
+    }
+}
+
+#ifdef SEARCHLIB_HAVE_IO_URING
+
+/**
+ * A minimal io_uring submission/completion ring, used from one thread only.
+ */
+class IoUring {
+public:
+    static std::unique_ptr<IoUring> create(uint32_t entries);
+    ~IoUring();
+    void read(int fd, std::vector<BatchPRead::Read> & reads);
+private:
+    IoUring(int ringFd, const io_uring_params & params);
+    bool mapRings();
+
+    int            _ringFd;
+    io_uring_params _params;
+    void         * _sqRing;
+    size_t         _sqRingSize;
+    void         * _cqRing;
+    size_t         _cqRingSize;
+    io_uring_sqe * _sqes;
+    size_t         _sqesSize;
+    unsigned     * _sqHead;
+    unsigned     * _sqTail;
+    unsigned     * _sqMask;
+    unsigned     * _sqArray;
+    unsigned     * _cqHead;
+    unsigned     * _cqTail;
+    unsigned     * _cqMask;
+    io_uring_cqe * _cqes;
+};
+
+template <typename T>
+T *
+offsetPtr(void * base, uint32_t offset) {
+    return reinterpret_cast<T *>(static_cast<char *>(base) + offset);
+}
+
+std::unique_ptr<IoUring>
+IoUring::create(uint32_t entries) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int ringFd = syscall(__NR_io_uring_setup, entries, &params);
+    if (ringFd < 0) {
+        LOG(debug, "io_uring_setup failed: %s", strerror(errno));
+        return std::unique_ptr<IoUring>();
+    }
+    std::unique_ptr<IoUring> ring(new IoUring(ringFd, params));
+    if ( ! ring->mapRings()) {
+        LOG(debug, "mapping io_uring failed: %s", strerror(errno));
+        return std::unique_ptr<IoUring>();
+    }
+    return ring;
+}
+
+IoUring::IoUring(int ringFd, const io_uring_params & params)
+    : _ringFd(ringFd),
+      _params(params),
+      _sqRing(MAP_FAILED),
+      _sqRingSize(params.sq_off.array + params.sq_entries * sizeof(unsigned)),
+      _cqRing(MAP_FAILED),
+      _cqRingSize(params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe)),
+      _sqes(static_cast<io_uring_sqe *>(MAP_FAILED)),
+      _sqesSize(params.sq_entries * sizeof(io_uring_sqe)),
+      _sqHead(nullptr),
+      _sqTail(nullptr),
+      _sqMask(nullptr),
+      _sqArray(nullptr),
+      _cqHead(nullptr),
+      _cqTail(nullptr),
+      _cqMask(nullptr),
+      _cqes(nullptr)
+{ }
+
+bool
+IoUring::mapRings() {
+    _sqRing = mmap(nullptr, _sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ringFd, IORING_OFF_SQ_RING);
+    _cqRing = mmap(nullptr, _cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ringFd, IORING_OFF_CQ_RING);
+    _sqes = static_cast<io_uring_sqe *>(mmap(nullptr, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                             _ringFd, IORING_OFF_SQES));
+    if ((_sqRing == MAP_FAILED) || (_cqRing == MAP_FAILED) || (_sqes == MAP_FAILED)) {
+        return false;
+    }
+    _sqHead = offsetPtr<unsigned>(_sqRing, _params.sq_off.head);
+    _sqTail = offsetPtr<unsigned>(_sqRing, _params.sq_off.tail);
+    _sqMask = offsetPtr<unsigned>(_sqRing, _params.sq_off.ring_mask);
+    _sqArray = offsetPtr<unsigned>(_sqRing, _params.sq_off.array);
+    _cqHead = offsetPtr<unsigned>(_cqRing, _params.cq_off.head);
+    _cqTail = offsetPtr<unsigned>(_cqRing, _params.cq_off.tail);
+    _cqMask = offsetPtr<unsigned>(_cqRing, _params.cq_off.ring_mask);
+    _cqes = offsetPtr<io_uring_cqe>(_cqRing, _params.cq_off.cqes);
+    return true;
+}
+
+IoUring::~IoUring() {
+    if (_sqes != MAP_FAILED) {
+        munmap(_sqes, _sqesSize);
+    }
+    if (_cqRing != MAP_FAILED) {
+        munmap(_cqRing, _cqRingSize);
+    }
+    if (_sqRing != MAP_FAILED) {
+        munmap(_sqRing, _sqRingSize);
+    }
+    close(_ringFd);
+}
+
+void
+IoUring::read(int fd, std::vector<BatchPRead::Read> & reads) {
+    std::vector<iovec> iovecs;
+    iovecs.reserve(reads.size());
+    for (const BatchPRead::Read & read : reads) {
+        iovecs.push_back(iovec{read._buffer, read._size});
+    }
+    size_t submitted(0);
+    size_t completed(0);
+    while (completed < reads.size()) {
+        unsigned sqTail = *_sqTail;
+        unsigned sqHead = __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+        while ((submitted < reads.size()) &&
+               (sqTail - sqHead < _params.sq_entries) &&
+               (submitted - completed < _params.cq_entries))
+        {
+            unsigned index = sqTail & *_sqMask;
+            io_uring_sqe & sqe = _sqes[index];
+            memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_READV;
+            sqe.fd = fd;
+            sqe.off = reads[submitted]._offset;
+            sqe.addr = reinterpret_cast<uint64_t>(&iovecs[submitted]);
+            sqe.len = 1;
+            sqe.user_data = submitted;
+            _sqArray[index] = index;
+            sqTail++;
+            submitted++;
+        }
+        __atomic_store_n(_sqTail, sqTail, __ATOMIC_RELEASE);
+        unsigned toSubmit = sqTail - __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+        int ret = syscall(__NR_io_uring_enter, _ringFd, toSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if ((ret < 0) && (errno != EINTR) && (errno != EAGAIN) && (errno != EBUSY)) {
+            // Already submitted reads may still write to the buffers, so we can not just give up on them.
+            LOG_ABORT("io_uring_enter failed while reads were in flight");
+        }
+        unsigned cqHead = *_cqHead;
+        unsigned cqTail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+        for (; cqHead != cqTail; cqHead++) {
+            const io_uring_cqe & cqe = _cqes[cqHead & *_cqMask];
+            reads[cqe.user_data]._result = cqe.res;
+            completed++;
+        }
+        __atomic_store_n(_cqHead, cqHead, __ATOMIC_RELEASE);
+    }
+}
+
+std::atomic<bool> ioUringUnavailable(false);
+thread_local std::unique_ptr<IoUring> threadRing;
+
+IoUring *
+getThreadRing() {
+    if ( ! threadRing && ! ioUringUnavailable.load(std::memory_order_relaxed)) {
+        threadRing = IoUring::create(64);
+        if ( ! threadRing) {
+            LOG(info, "io_uring is not available, batched reads will use a thread pool");
+            ioUringUnavailable.store(true, std::memory_order_relaxed);
+        }
+    }
+    return threadRing.get();
+}
+
+#endif
+
+}
+
+bool
+BatchPRead::hasIoUring() {
+#ifdef SEARCHLIB_HAVE_IO_URING
+    return getThreadRing() != nullptr;
+#else
+    return false;
+#endif
+}
+
+void
+BatchPRead::read(int fd, std::vector<Read> & reads, Mode mode) {
+    for (Read & read : reads) {
+        read._result = 0;
+    }
+    if (reads.size() == 1) {
+        completeReadOrThrow(fd, reads[0]);
+        return;
+    }
+#ifdef SEARCHLIB_HAVE_IO_URING
+    IoUring * ring = (mode == Mode::AUTO) ? getThreadRing() : nullptr;
+    if (ring != nullptr) {
+        ring->read(fd, reads);
+        for (Read & read : reads) {
+            if (read._result < 0) {
+                int error = -read._result;
+                if (error != EINTR && error != EAGAIN) {
+                    throwReadError(error, read);
+                }
+                read._result = 0;
+            }
+            // Short reads and interrupted ones are finished synchronously.
+            if (size_t(read._result) < read._size) {
+                completeReadOrThrow(fd, read);
+            }
+        }
+        return;
+    }
+#else
+    (void) mode;
+#endif
+    readWithThreads(fd, reads);
+}
+
+}
@@ -0,0 +1,41 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+
+namespace search {
+
+/**
+ * Performs a batch of positional reads from a file descriptor and waits for all of them.
+ * The reads are submitted together through io_uring when the kernel supports it.
+ * Otherwise they are spread over a small shared pool of threads doing plain pread.
+ * Either way the device gets the whole batch at once instead of one read at a time.
+ **/
+class BatchPRead {
+public:
+    struct Read {
+        Read(void * buffer, size_t size, uint64_t offset) : _buffer(buffer), _size(size), _offset(offset), _result(0) { }
+        void     * _buffer;
+        size_t     _size;
+        uint64_t   _offset;
+        ssize_t    _result;
+    };
+    enum class Mode { AUTO, THREADS };
+
+    /**
+     * Reads all, blocking until done.
+     * A read that hits end of file is short and has its _result set accordingly.
+     * @throws vespalib::IoException if any of the reads fail.
+     */
+    static void read(int fd, std::vector<Read> & reads, Mode mode = Mode::AUTO);
+    /**
+     * Tells if io_uring can be used from this thread.
+     */
+    static bool hasIoUring();
+};
+
+}
@@ -12,19 +12,22 @@ struct CacheStats {
     size_t misses;
     size_t elements;
     size_t memory_used;
+    size_t evictions;
 
     CacheStats()
         : hits(0),
           misses(0),
           elements(0),
-          memory_used(0)
+          memory_used(0),
+          evictions(0)
     { }
 
-    CacheStats(size_t hit, size_t miss, size_t elem, size_t mem)
+    CacheStats(size_t hit, size_t miss, size_t elem, size_t mem, size_t evict = 0)
         : hits(hit),
           misses(miss),
           elements(elem),
-          memory_used(mem)
+          memory_used(mem),
+          evictions(evict)
     { }
 
     CacheStats &
@@ -34,6 +37,7 @@ struct CacheStats {
         misses += rhs.misses;
         elements += rhs.elements;
         memory_used += rhs.memory_used;
+        evictions += rhs.evictions;
         return *this;
     }
 };
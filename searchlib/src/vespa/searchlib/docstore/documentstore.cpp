@@ -189,6 +189,42 @@ public:
 using VisitCache = docstore::VisitCache;
 using docstore::Value;
 
+namespace {
+
+/**
+ * Inserts the documents read by a batch in the cache, like a miss in a single read does,
+ * before handing them to the visitor.
+ */
+class CachingVisitorAdapter : public IBufferVisitor
+{
+public:
+    CachingVisitorAdapter(Cache & cache, const CompressionConfig & compression,
+                          const DocumentTypeRepo & repo, IDocumentVisitor & visitor) :
+        _cache(cache),
+        _compression(compression),
+        _adapter(repo, visitor)
+    { }
+    void visit(uint32_t lid, vespalib::ConstBufferRef buf) override;
+private:
+    Cache & _cache;
+    const CompressionConfig & _compression;
+    DocumentVisitorAdapter _adapter;
+};
+
+void
+CachingVisitorAdapter::visit(uint32_t lid, vespalib::ConstBufferRef buf) {
+    if (buf.size() > 0) {
+        vespalib::DataBuffer copy(buf.size());
+        copy.writeBytes(buf.c_str(), buf.size());
+        Value value;
+        value.set(std::move(copy), buf.size(), _compression);
+        _cache.populate(lid, value);
+    }
+    _adapter.visit(lid, buf);
+}
+
+}
+
 DocumentStore::DocumentStore(const Config & config, IDataStore & store)
     : IDocumentStore(),
       _config(config),
@@ -224,6 +260,34 @@ DocumentStore::visit(const LidVector & lids, const DocumentTypeRepo &repo, IDocu
     }
 }
 
+void
+DocumentStore::readBatch(const LidVector & lids, const DocumentTypeRepo &repo, IDocumentVisitor & visitor) const
+{
+    if ( ! useCache()) {
+        _uncached_lookups.fetch_add(lids.size());
+        _store->visit(lids, repo, visitor);
+        return;
+    }
+    // Cached documents are served from the cache, the rest are read together from the backing store
+    // and inserted in the cache.
+    LidVector missing;
+    for (DocumentIdT lid : lids) {
+        if (_cache->hasKey(lid)) {
+            Value value = _cache->read(lid);
+            if ( ! value.empty() ) {
+                visitor.visit(lid, value.deserializeDocument(repo));
+            }
+        } else {
+            missing.push_back(lid);
+        }
+    }
+    if ( ! missing.empty()) {
+        _uncached_lookups.fetch_add(missing.size());
+        CachingVisitorAdapter adapter(*_cache, _store->getCompression(), repo, visitor);
+        _backingStore.read(missing, adapter);
+    }
+}
+
 document::Document::UP
 DocumentStore::read(DocumentIdT lid, const DocumentTypeRepo &repo) const
 {
@@ -500,7 +564,7 @@ DocumentStore::getFileChunkStats() const
 CacheStats DocumentStore::getCacheStats() const {
     CacheStats visitStats = _visitCache->getCacheStats();
     CacheStats singleStats(_cache->getHit(), _cache->getMiss() + _uncached_lookups,
-                           _cache->size(), _cache->sizeBytes());
+                           _cache->size(), _cache->sizeBytes(), _cache->getEvict());
     singleStats += visitStats;
     return singleStats;
 }
@@ -266,6 +266,9 @@ FileChunk::enableRead()
             LOG(debug, "enableRead(): MMapRandReadDynamic: file='%s'", _dataFileName.c_str());
             _file.reset(new MMapRandReadDynamic(_dataFileName, mmapFlags, fadviseOptions));
         }
+    } else if (_tune._randRead.getWantAsyncIO()) {
+        LOG(debug, "enableRead(): AsyncRandRead: file='%s'", _dataFileName.c_str());
+        _file.reset(new AsyncRandRead(_dataFileName));
     } else {
         LOG(debug, "enableRead(): NormalRandRead: file='%s'", _dataFileName.c_str());
         _file.reset(new NormalRandRead(_dataFileName));
@@ -364,32 +367,49 @@ void
 FileChunk::read(LidInfoWithLidV::const_iterator begin, size_t count, IBufferVisitor & visitor) const
 {
     if (count == 0) { return; }
+    std::vector<ChunkLids> chunks;
     uint32_t prevChunk = begin->getChunkId();
     uint32_t start(0);
     for (size_t i(0); i < count; i++) {
         const LidInfoWithLid & li = *(begin + i);
         if (li.getChunkId() != prevChunk) {
-            ChunkInfo ci = _chunkInfo[prevChunk];
-            read(begin + start, i - start, ci, visitor);
+            chunks.emplace_back(begin + start, i - start, _chunkInfo[prevChunk]);
             prevChunk = li.getChunkId();
             start = i;
         }
     }
-    ChunkInfo ci = _chunkInfo[prevChunk];
-    read(begin + start, count - start, ci, visitor);
+    chunks.emplace_back(begin + start, count - start, _chunkInfo[prevChunk]);
+    read(chunks, visitor);
 }
 
 void
-FileChunk::read(LidInfoWithLidV::const_iterator begin, size_t count, ChunkInfo ci, IBufferVisitor & visitor) const
+FileChunk::read(const std::vector<ChunkLids> & chunks, IBufferVisitor & visitor) const
 {
-    vespalib::DataBuffer whole(0ul, ALIGNMENT);
-    FileRandRead::FSP keepAlive = _file->read(ci.getOffset(), whole, ci.getSize());
-    Chunk chunk(begin->getChunkId(), whole.getData(), whole.getDataLen(), _skipCrcOnRead);
-    for (size_t i(0); i < count; i++) {
-        const LidInfoWithLid & li = *(begin + i);
-        vespalib::ConstBufferRef buf = chunk.getLid(li.getLid());
-        if (buf.size() != 0) {
-            visitor.visit(li.getLid(), buf);
+    // Bounds the memory held by one batch, as each chunk needs its own buffer.
+    constexpr size_t MAX_CHUNKS_PER_BATCH = 64;
+    for (size_t batchStart(0); batchStart < chunks.size(); batchStart += MAX_CHUNKS_PER_BATCH) {
+        size_t batchEnd = std::min(chunks.size(), batchStart + MAX_CHUNKS_PER_BATCH);
+        std::vector<std::unique_ptr<vespalib::DataBuffer>> buffers;
+        std::vector<FileRandRead::Request> requests;
+        buffers.reserve(batchEnd - batchStart);
+        requests.reserve(batchEnd - batchStart);
+        for (size_t i(batchStart); i < batchEnd; i++) {
+            const ChunkInfo & ci = chunks[i]._info;
+            buffers.push_back(std::make_unique<vespalib::DataBuffer>(0ul, ALIGNMENT));
+            requests.emplace_back(ci.getOffset(), ci.getSize(), *buffers.back());
+        }
+        _file->readBatch(requests);
+        for (size_t i(batchStart); i < batchEnd; i++) {
+            const ChunkLids & lids = chunks[i];
+            const vespalib::DataBuffer & whole = *buffers[i - batchStart];
+            Chunk chunk(lids._begin->getChunkId(), whole.getData(), whole.getDataLen(), _skipCrcOnRead);
+            for (size_t j(0); j < lids._count; j++) {
+                const LidInfoWithLid & li = *(lids._begin + j);
+                vespalib::ConstBufferRef buf = chunk.getLid(li.getLid());
+                if (buf.size() != 0) {
+                    visitor.visit(li.getLid(), buf);
+                }
+            }
         }
     }
 }
@@ -233,7 +233,21 @@ protected:
 
     void setNumUniqueBuckets(size_t numUniqueBuckets) { _numUniqueBuckets = numUniqueBuckets; }
     ssize_t read(uint32_t lid, SubChunkId chunkId, const ChunkInfo & chunkInfo, vespalib::DataBuffer & buffer) const;
-    void read(LidInfoWithLidV::const_iterator begin, size_t count, ChunkInfo ci, IBufferVisitor & visitor) const;
+    /**
+     * The lids that live in one chunk, as a range of a sorted LidInfoWithLidV.
+     */
+    struct ChunkLids {
+        ChunkLids(LidInfoWithLidV::const_iterator begin, size_t count, ChunkInfo info)
+            : _begin(begin), _count(count), _info(info)
+        { }
+        LidInfoWithLidV::const_iterator _begin;
+        size_t                          _count;
+        ChunkInfo                       _info;
+    };
+    /**
+     * Reads the chunks in batches so that their reads can be issued together.
+     */
+    void read(const std::vector<ChunkLids> & chunks, IBufferVisitor & visitor) const;
     static uint32_t readDocIdLimit(vespalib::GenericHeader &header);
     static void writeDocIdLimit(vespalib::GenericHeader &header, uint32_t docIdLimit);
 
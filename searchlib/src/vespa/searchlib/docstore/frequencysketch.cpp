@@ -0,0 +1,81 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "frequencysketch.h"
+#include <algorithm>
+
+namespace search::docstore {
+
+namespace {
+
+size_t
+roundUp2inN(size_t n) {
+    size_t v(1);
+    while (v < n) {
+        v <<= 1;
+    }
+    return v;
+}
+
+uint64_t
+mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdul;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ul;
+    h ^= h >> 33;
+    return h;
+}
+
+}
+
+FrequencySketch::FrequencySketch(size_t expectedEntries)
+    : _counters(),
+      _mask(roundUp2inN(std::max(expectedEntries, size_t(64))) - 1),
+      _samplePeriod(10 * (_mask + 1)),
+      _additions(0)
+{
+    _counters.resize(NUM_ROWS * (_mask + 1), 0);
+}
+
+FrequencySketch::~FrequencySketch() { }
+
+size_t
+FrequencySketch::index(uint64_t hash, size_t row) const {
+    // Double hashing gives independent enough positions for each row.
+    uint64_t h = hash + row * ((hash >> 32) | 1);
+    return row * (_mask + 1) + (h & _mask);
+}
+
+void
+FrequencySketch::add(uint64_t hash) {
+    hash = mix(hash);
+    for (size_t row(0); row < NUM_ROWS; row++) {
+        uint8_t & counter = _counters[index(hash, row)];
+        if (counter < MAX_COUNT) {
+            counter++;
+        }
+    }
+    if (++_additions >= _samplePeriod) {
+        age();
+    }
+}
+
+uint32_t
+FrequencySketch::estimate(uint64_t hash) const {
+    hash = mix(hash);
+    uint8_t minCount(MAX_COUNT);
+    for (size_t row(0); row < NUM_ROWS; row++) {
+        minCount = std::min(minCount, _counters[index(hash, row)]);
+    }
+    return minCount;
+}
+
+void
+FrequencySketch::age() {
+    for (uint8_t & counter : _counters) {
+        counter >>= 1;
+    }
+    _additions /= 2;
+}
+
+}
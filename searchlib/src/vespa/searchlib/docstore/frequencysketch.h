@@ -0,0 +1,36 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace search::docstore {
+
+/**
+ * Approximate access frequency of keys, used for cache admission.
+ * This is a count-min sketch with small saturating counters. All counters are
+ * halved after a sample period so that old popularity fades away.
+ * It is not thread safe.
+ **/
+class FrequencySketch {
+public:
+    FrequencySketch(size_t expectedEntries);
+    ~FrequencySketch();
+    void add(uint64_t hash);
+    uint32_t estimate(uint64_t hash) const;
+    size_t getSamplePeriod() const { return _samplePeriod; }
+private:
+    static constexpr size_t NUM_ROWS = 4;
+    static constexpr uint8_t MAX_COUNT = 15;
+    size_t index(uint64_t hash, size_t row) const;
+    void age();
+
+    std::vector<uint8_t> _counters;
+    size_t               _mask;
+    size_t               _samplePeriod;
+    size_t               _additions;
+};
+
+}
@@ -76,6 +76,11 @@ public:
      **/
     virtual document::Document::UP read(DocumentIdT lid, const document::DocumentTypeRepo &repo) const = 0;
     virtual void visit(const LidVector & lidVector, const document::DocumentTypeRepo &repo, IDocumentVisitor & visitor) const;
+    /**
+     * Read the documents for all the given lids, letting the store fetch them together.
+     * The visitor is called for the documents found, in no particular order.
+     **/
+    virtual void readBatch(const LidVector & lids, const document::DocumentTypeRepo &repo, IDocumentVisitor & visitor) const;
 
     /**
      * Serialize and store a document.
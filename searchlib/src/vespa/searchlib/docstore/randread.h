@@ -5,6 +5,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 class FastOS_FileInterface;
 
@@ -16,8 +17,30 @@ class FileRandRead
 {
 public:
     typedef std::shared_ptr<FastOS_FileInterface> FSP;
+    /**
+     * One read in a batch. The buffer is filled as by a single read, and keepAlive
+     * must be held as long as the buffer is used.
+     */
+    struct Request {
+        Request(size_t offset, size_t size, vespalib::DataBuffer & buffer)
+            : _offset(offset), _size(size), _buffer(&buffer), _keepAlive()
+        { }
+        size_t                 _offset;
+        size_t                 _size;
+        vespalib::DataBuffer * _buffer;
+        FSP                    _keepAlive;
+    };
     virtual ~FileRandRead() { }
     virtual FSP read(size_t offset, vespalib::DataBuffer & buffer, size_t sz) = 0;
+    /**
+     * Performs all the reads, giving the implementation a chance to issue them together.
+     * Default is to do them one by one.
+     */
+    virtual void readBatch(std::vector<Request> & requests) {
+        for (Request & request : requests) {
+            request._keepAlive = read(request._offset, *request._buffer, request._size);
+        }
+    }
     virtual int64_t getSize() = 0;
 };
 
@@ -2,8 +2,14 @@
 
 #include "randreaders.h"
 #include "summaryexceptions.h"
+#include "batchpread.h"
 #include <vespa/vespalib/data/databuffer.h>
+#include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/fastos/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".search.docstore.randreaders");
@@ -84,6 +90,21 @@ MMapRandRead::read(size_t offset, vespalib::DataBuffer & buffer, size_t sz)
     return FSP();
 }
 
+void
+MMapRandRead::readBatch(std::vector<Request> & requests)
+{
+    // Let the kernel fault in all the pages concurrently before we touch them one by one.
+    const size_t pageSize = getpagesize();
+    for (const Request & request : requests) {
+        const char *data = static_cast<const char *>(_file->MemoryMapPtr(request._offset));
+        if ((data != nullptr) && (request._size > 0)) {
+            size_t unaligned = reinterpret_cast<size_t>(data) & (pageSize - 1);
+            madvise(const_cast<char *>(data - unaligned), request._size + unaligned, MADV_WILLNEED);
+        }
+    }
+    FileRandRead::readBatch(requests);
+}
+
 int64_t
 MMapRandRead::getSize() {
     return _file->GetSize();
@@ -167,4 +188,63 @@ NormalRandRead::getSize()
     return _file->GetSize();
 }
 
+AsyncRandRead::AsyncRandRead(const vespalib::string & fileName)
+    : _fileName(fileName),
+      _fd(::open(fileName.c_str(), O_RDONLY | O_CLOEXEC))
+{
+    if (_fd < 0) {
+        throw vespalib::IoException(vespalib::make_string("Failed opening data file : Failing file = '%s'. Reason given by OS = '%s'",
+                                                          fileName.c_str(), strerror(errno)),
+                                    vespalib::IoException::getErrorType(errno), VESPA_STRLOC);
+    }
+}
+
+AsyncRandRead::~AsyncRandRead()
+{
+    ::close(_fd);
+}
+
+FileRandRead::FSP
+AsyncRandRead::read(size_t offset, vespalib::DataBuffer & buffer, size_t sz)
+{
+    std::vector<Request> requests;
+    requests.emplace_back(offset, sz, buffer);
+    readBatch(requests);
+    return FSP();
+}
+
+void
+AsyncRandRead::readBatch(std::vector<Request> & requests)
+{
+    std::vector<BatchPRead::Read> reads;
+    reads.reserve(requests.size());
+    for (Request & request : requests) {
+        request._buffer->clear();
+        request._buffer->ensureFree(request._size);
+        reads.emplace_back(request._buffer->getFree(), request._size, request._offset);
+    }
+    BatchPRead::read(_fd, reads);
+    for (size_t i(0); i < requests.size(); i++) {
+        if (size_t(reads[i]._result) != requests[i]._size) {
+            throw vespalib::IoException(vespalib::make_string("Short read of %zu bytes at offset %zu from '%s', got %zd",
+                                                              requests[i]._size, requests[i]._offset,
+                                                              _fileName.c_str(), reads[i]._result),
+                                        vespalib::IoException::CORRUPT_DATA, VESPA_STRLOC);
+        }
+        requests[i]._buffer->moveFreeToData(requests[i]._size);
+    }
+}
+
+int64_t
+AsyncRandRead::getSize()
+{
+    struct stat st;
+    if (fstat(_fd, &st) != 0) {
+        throw vespalib::IoException(vespalib::make_string("Failed to stat '%s'. Reason given by OS = '%s'",
+                                                          _fileName.c_str(), strerror(errno)),
+                                    vespalib::IoException::getErrorType(errno), VESPA_STRLOC);
+    }
+    return st.st_size;
+}
+
 }
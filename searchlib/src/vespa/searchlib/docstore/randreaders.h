@@ -28,6 +28,7 @@ class MMapRandRead : public FileRandRead
 public:
     MMapRandRead(const vespalib::string & fileName, int mmapFlags, int fadviseOptions);
     FSP read(size_t offset, vespalib::DataBuffer & buffer, size_t sz) override;
+    void readBatch(std::vector<Request> & requests) override;
     int64_t getSize() override;
     const void * getMapping();
 private:
@@ -50,6 +51,23 @@ private:
     vespalib::Lock                            _lock;
 };
 
+/**
+ * Reads with pread on a plain file descriptor. A batch of reads is issued to the
+ * device together, see BatchPRead.
+ */
+class AsyncRandRead : public FileRandRead
+{
+public:
+    AsyncRandRead(const vespalib::string & fileName);
+    ~AsyncRandRead();
+    FSP read(size_t offset, vespalib::DataBuffer & buffer, size_t sz) override;
+    void readBatch(std::vector<Request> & requests) override;
+    int64_t getSize() override;
+private:
+    vespalib::string _fileName;
+    int              _fd;
+};
+
 class NormalRandRead : public FileRandRead
 {
 public:
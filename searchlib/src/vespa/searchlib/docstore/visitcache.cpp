@@ -145,12 +145,37 @@ VisitCache::BackingStore::read(const KeySet &key, CompressedBlobSet &blobs) cons
     return ! blobs.empty();
 }
 
-VisitCache::VisitCache(IDataStore &store, size_t cacheSize, const CompressionConfig &compression) :
+namespace {
+
+/**
+ * Rough average size of a cached set, used for sizing the frequency sketch.
+ */
+constexpr size_t ESTIMATED_SET_SIZE = 1024;
+
+uint64_t
+fingerprint(const KeySet & keys) {
+    uint64_t h(keys.getKeys().size());
+    for (uint32_t key : keys.getKeys()) {
+        h = h * 0x9e3779b97f4a7c15ul + key;
+    }
+    return h;
+}
+
+}
+
+VisitCache::VisitCache(IDataStore &store, size_t cacheSize, const CompressionConfig &compression, size_t numShards) :
     _store(store, compression),
-    _cache(std::make_unique<Cache>(_store, cacheSize))
+    _shards()
 {
+    numShards = std::max(numShards, size_t(1));
+    _shards.reserve(numShards);
+    for (size_t i(0); i < numShards; i++) {
+        _shards.push_back(std::make_unique<Cache>(_store, cacheSize / numShards));
+    }
 }
 
+VisitCache::~VisitCache() { }
+
 VisitCache::Cache::IdSet
 VisitCache::Cache::findSetsContaining(const LockGuard &, const KeySet & keys) const {
     IdSet found;
@@ -163,55 +188,85 @@ VisitCache::Cache::findSetsContaining(const LockGuard &, const KeySet & keys) co
     return found;
 }
 
-CompressedBlobSet
-VisitCache::Cache::readSet(const KeySet & key)
+bool
+VisitCache::Cache::recordAccess(const KeySet & key)
 {
-    if (!key.empty()) {
-        {
-            auto cacheGuard = getGuard();
-            if (!hasKey(cacheGuard, key)) {
-                locateAndInvalidateOtherSubsets(cacheGuard, key);
-            }
-        }
-        return read(key);
-    }
-    return CompressedBlobSet();
+    auto cacheGuard = getGuard();
+    _sketch.add(fingerprint(key));
+    return hasKey(cacheGuard, key);
 }
 
 void
-VisitCache::Cache::locateAndInvalidateOtherSubsets(const LockGuard & cacheGuard, const KeySet & keys)
+VisitCache::Cache::locateAndInvalidateOtherSubsets(const KeySet & keys)
 {
     // Due to the implementation of insert where the global lock is released and the fact
     // that 2 overlapping keysets kan have different keys and use different ValueLock
     // We do have a theoretical issue.
     // The reason it is theoretical is that for all practical purpose this inconsitency
     // is prevented by the storage layer above alloing only one visit/mutating operation to a single bucket.
-    // So for that reason we will just merge this one to get testing started. 
-    // The final fix will come in 2 days.
+    auto cacheGuard = getGuard();
     IdSet otherSubSets = findSetsContaining(cacheGuard, keys);
     for (uint64_t keyId : otherSubSets) {
         invalidate(cacheGuard, _id2KeySet[keyId]);
     }
 }
 
+bool
+VisitCache::Cache::admit(const K & candidate, const K & victim) {
+    return _sketch.estimate(fingerprint(candidate)) > _sketch.estimate(fingerprint(victim));
+}
+
+CacheStats
+VisitCache::Cache::getStats() const {
+    return CacheStats(getHit(), getMiss(), size(), sizeBytes(), getEvict());
+}
+
 CompressedBlobSet
 VisitCache::read(const IDocumentStore::LidVector & lids) const {
     KeySet key(lids);
-    return _cache->readSet(lids);
+    if (key.empty()) {
+        return CompressedBlobSet();
+    }
+    Cache & shard = getShard(key);
+    if ( ! shard.recordAccess(key)) {
+        for (const auto & cache : _shards) {
+            cache->locateAndInvalidateOtherSubsets(key);
+        }
+    }
+    return shard.read(key);
 }
 
 void
 VisitCache::remove(uint32_t key) {
-    _cache->removeKey(key);
+    for (const auto & cache : _shards) {
+        cache->removeKey(key);
+    }
 }
 
 CacheStats
 VisitCache::getCacheStats() const {
-    return CacheStats(_cache->getHit(), _cache->getMiss(), _cache->size(), _cache->sizeBytes());
+    CacheStats stats;
+    for (const auto & cache : _shards) {
+        stats += cache->getStats();
+    }
+    return stats;
+}
+
+std::vector<CacheStats>
+VisitCache::getShardCacheStats() const {
+    std::vector<CacheStats> stats;
+    stats.reserve(_shards.size());
+    for (const auto & cache : _shards) {
+        stats.push_back(cache->getStats());
+    }
+    return stats;
 }
 
 VisitCache::Cache::Cache(BackingStore & b, size_t maxBytes) :
-    Parent(b, maxBytes)
+    Parent(b, maxBytes),
+    _lid2Id(),
+    _id2KeySet(),
+    _sketch(maxBytes / ESTIMATED_SET_SIZE)
 { }
 
 VisitCache::Cache::~Cache() { }
@@ -4,6 +4,7 @@
 
 #include "idocumentstore.h"
 #include "cachestats.h"
+#include "frequencysketch.h"
 #include <vespa/vespalib/stllike/cache.h>
 #include <vespa/vespalib/stllike/hash_set.h>
 #include <vespa/vespalib/stllike/hash_map.h>
@@ -93,17 +94,26 @@ private:
  * Caches a set of objects as a set.
  * The objects are compressed together as a set.
  * The whole set is invalidated when one object of its objects are removed.
+ * The cache is split in shards by the first key of the set, each with its own lock,
+ * so concurrent readers of different sets do not contend.
+ * When a shard is full a new set is only admitted if it is accessed more
+ * frequently than the set it would evict, so that one off visits do not push out hot sets.
  **/
 class VisitCache {
 public:
     using CompressionConfig = vespalib::compression::CompressionConfig;
-    VisitCache(IDataStore &store, size_t cacheSize, const CompressionConfig &compression);
+    static constexpr size_t DEFAULT_NUM_SHARDS = 16;
+    VisitCache(IDataStore &store, size_t cacheSize, const CompressionConfig &compression,
+               size_t numShards = DEFAULT_NUM_SHARDS);
+    ~VisitCache();
 
     CompressedBlobSet read(const IDocumentStore::LidVector & keys) const;
     void remove(uint32_t key);
     void invalidate(uint32_t key) { remove(key); }
 
     CacheStats getCacheStats() const;
+    std::vector<CacheStats> getShardCacheStats() const;
+    size_t getNumShards() const { return _shards.size(); }
 private:
     /**
      * This implments the interface the cache uses when it has a cache miss.
@@ -138,28 +148,37 @@ private:
      * it will correctly invalidate the cached sets when objects are removed/updated.
      * It will also detect the addition of new objects to any of the sets upon first
      * usage of the set and then invalidate and perform fresh visit of the backing store.
+     * Sets may overlap sets held by other shards, so invalidation must be done on all shards.
      */
     class Cache : public vespalib::cache<CacheParams> {
     public:
         Cache(BackingStore & b, size_t maxBytes);
         ~Cache();
-        CompressedBlobSet readSet(const KeySet & keys);
+        /**
+         * Counts the access for admission control and tells if the set is cached.
+         */
+        bool recordAccess(const KeySet & keys);
+        void locateAndInvalidateOtherSubsets(const KeySet & keys);
         void removeKey(uint32_t key);
+        CacheStats getStats() const;
     private:
-        void locateAndInvalidateOtherSubsets(const vespalib::LockGuard & cacheGuard, const KeySet & keys);
         using IdSet = vespalib::hash_set<uint64_t>;
         using Parent = vespalib::cache<CacheParams>;
         using LidUniqueKeySetId = vespalib::hash_map<uint32_t, uint64_t>;
         using IdKeySetMap = vespalib::hash_map<uint64_t, KeySet>;
         IdSet findSetsContaining(const vespalib::LockGuard &, const KeySet & keys) const;
+        bool admit(const K & candidate, const K & victim) override;
         void onInsert(const K & key) override;
         void onRemove(const K & key) override;
         LidUniqueKeySetId _lid2Id;
         IdKeySetMap       _id2KeySet;
+        FrequencySketch   _sketch;
     };
 
-    BackingStore            _store;
-    std::unique_ptr<Cache>  _cache;
+    Cache & getShard(const KeySet & keys) const { return *_shards[keys.hash() % _shards.size()]; }
+
+    BackingStore                         _store;
+    std::vector<std::unique_ptr<Cache>>  _shards;
 };
 
 }
@@ -233,11 +233,14 @@ WriteableFileChunk::read(LidInfoWithLidV::const_iterator begin, size_t count, IB
                 }
             }
         }
+        std::vector<ChunkLids> chunks;
+        chunks.reserve(chunksOnFile.size());
         for (auto & it : chunksOnFile) {
             LidInfoWithLidV::const_iterator first = find_first(begin, it.first);
             LidInfoWithLidV::const_iterator last = seek_past(first, begin + count, it.first);
-            FileChunk::read(first, last - first, it.second, visitor);
+            chunks.emplace_back(first, last - first, it.second);
         }
+        FileChunk::read(chunks, visitor);
     } else {
         FileChunk::read(begin, count, visitor);
     }
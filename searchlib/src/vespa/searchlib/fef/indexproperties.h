@@ -133,6 +133,18 @@ namespace matching {
         static uint32_t lookup(const Properties &props);
         static uint32_t lookup(const Properties &props, uint32_t defaultValue);
     };
+
+    /**
+     * Property for enabling the work-stealing docid range scheduler.
+     * When enabled, idle search threads steal work from the busiest
+     * thread instead of waiting for work to be shared with them.
+     **/
+    struct WorkStealing {
+        static const vespalib::string NAME;
+        static const bool DEFAULT_VALUE;
+        static bool lookup(const Properties &props);
+        static bool lookup(const Properties &props, bool defaultValue);
+    };
 }
 
 namespace softtimeout {
@@ -36,6 +36,7 @@ private:
     uint32_t                 _numThreads;
     uint32_t                 _minHitsPerThread;
     uint32_t                 _numSearchPartitions;
+    bool                     _workStealing;
     uint32_t                 _heapSize;
     uint32_t                 _arraySize;
     uint32_t                 _estimatePoint;
@@ -158,6 +159,10 @@ public:
 
     uint32_t getNumSearchPartitions() const { return _numSearchPartitions; }
 
+    void setWorkStealing(bool workStealing) { _workStealing = workStealing; }
+
+    bool getWorkStealing() const { return _workStealing; }
+
     /**
      * Sets the heap size to be used in the hit collector.
      *
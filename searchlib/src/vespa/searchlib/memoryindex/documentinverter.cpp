@@ -9,6 +9,7 @@
 #include <vespa/document/annotation/alternatespanlist.h>
 #include <vespa/searchlib/util/url.h>
 #include <stdexcept>
+#include <algorithm>
 #include <vespa/vespalib/text/utf8.h>
 #include <vespa/vespalib/text/lowercase.h>
 #include <vespa/searchlib/common/sort.h>
@@ -45,15 +46,62 @@ using vespalib::make_string;
 using search::util::URL;
 
 
+namespace {
+
+uint32_t
+countTextFields(const Schema &schema)
+{
+    index::DocTypeBuilder::SchemaIndexFields schemaIndexFields;
+    schemaIndexFields.setup(schema);
+    return schemaIndexFields._textFields.size();
+}
+
+size_t
+estimateBytes(const FieldValue &fv)
+{
+    const vespalib::Identifiable::RuntimeClass &cInfo(fv.getClass());
+    if (cInfo.id() == StringFieldValue::classId) {
+        return static_cast<const StringFieldValue &>(fv).getValue().size();
+    }
+    size_t bytes = 0;
+    if (cInfo.id() == ArrayFieldValue::classId) {
+        const ArrayFieldValue &arr = static_cast<const ArrayFieldValue &>(fv);
+        for (uint32_t i = 0; i < arr.size(); ++i) {
+            bytes += estimateBytes(arr[i]);
+        }
+    } else if (cInfo.id() == WeightedSetFieldValue::classId) {
+        for (const auto &el : static_cast<const WeightedSetFieldValue &>(fv)) {
+            bytes += estimateBytes(*el.first);
+        }
+    }
+    return bytes;
+}
+
+}
+
+
 DocumentInverter::DocumentInverter(const Schema &schema,
                                    ISequencedTaskExecutor &invertThreads,
                                    ISequencedTaskExecutor &pushThreads)
+    : DocumentInverter(schema, invertThreads, pushThreads,
+                       calcNumShards(countTextFields(schema), invertThreads.getNumExecutors()))
+{
+}
+
+
+DocumentInverter::DocumentInverter(const Schema &schema,
+                                   ISequencedTaskExecutor &invertThreads,
+                                   ISequencedTaskExecutor &pushThreads,
+                                   uint32_t numShards)
     : _schema(schema),
       _indexedFieldPaths(),
       _dataType(nullptr),
       _schemaIndexFields(),
       _inverters(),
       _urlInverters(),
+      _extraShards(),
+      _numShards(std::max(numShards, 1u)),
+      _pendingBytes(0),
       _invertThreads(invertThreads),
       _pushThreads(pushThreads)
 {
@@ -63,6 +111,12 @@ DocumentInverter::DocumentInverter(const Schema &schema,
          ++fieldId) {
         _inverters.push_back(std::make_unique<FieldInverter>(_schema, fieldId));
     }
+    _extraShards.resize(_inverters.size());
+    for (uint32_t fieldId : _schemaIndexFields._textFields) {
+        for (uint32_t shard = 1; shard < _numShards; ++shard) {
+            _extraShards[fieldId].push_back(std::make_unique<FieldInverter>(_schema, fieldId));
+        }
+    }
     for (auto &urlField : _schemaIndexFields._uriFields) {
         Schema::CollectionType collectionType =
             _schema.getIndexField(urlField._all).getCollectionType();
@@ -80,6 +134,16 @@ DocumentInverter::DocumentInverter(const Schema &schema,
 }
 
 
+uint32_t
+DocumentInverter::calcNumShards(uint32_t numTextFields, uint32_t numInvertThreads)
+{
+    if (numTextFields == 0) {
+        return 1u;
+    }
+    return std::max(numInvertThreads / numTextFields, 1u);
+}
+
+
 DocumentInverter::~DocumentInverter()
 {
     _invertThreads.sync();
@@ -137,8 +201,12 @@ DocumentInverter::invertDocument(uint32_t docId, const Document &doc)
             // FieldValue::UP fv = doc.getNestedFieldValue(fieldPath.begin(), fieldPath.end());
             fv = doc.getValue(*fieldPath);
         }
-        FieldInverter *inverter = _inverters[fieldId].get();
-        _invertThreads.execute(fieldId,
+        if (fv) {
+            _pendingBytes += estimateBytes(*fv);
+        }
+        uint32_t shard = docId % _numShards;
+        FieldInverter *inverter = getShard(fieldId, shard);
+        _invertThreads.execute(getShardComponentId(fieldId, shard),
                                [inverter, docId, fv(std::move(fv))]()
                                { inverter->invertField(docId, fv); });
     }
@@ -152,6 +220,9 @@ DocumentInverter::invertDocument(uint32_t docId, const Document &doc)
             // FieldValue::UP fv = doc.getNestedFieldValue(fieldPath.begin(), fieldPath.end());
             fv = doc.getValue(*fieldPath);
         }
+        if (fv) {
+            _pendingBytes += estimateBytes(*fv);
+        }
         UrlFieldInverter *inverter = _urlInverters[urlId].get();
         _invertThreads.execute(fieldId,
                                [inverter, docId, fv(std::move(fv))]()
@@ -165,8 +236,9 @@ void
 DocumentInverter::removeDocument(uint32_t docId)
 {
     for (uint32_t fieldId : _schemaIndexFields._textFields) {
-        FieldInverter *inverter = _inverters[fieldId].get();
-        _invertThreads.execute(fieldId,
+        uint32_t shard = docId % _numShards;
+        FieldInverter *inverter = getShard(fieldId, shard);
+        _invertThreads.execute(getShardComponentId(fieldId, shard),
                                [inverter, docId]()
                                { inverter->removeDocument(docId); });
     }
@@ -193,16 +265,31 @@ DocumentInverter::pushDocuments(Dictionary &dict,
         MemoryFieldIndex &fieldIndex(**indexFieldIterator);
         DocumentRemover &remover(fieldIndex.getDocumentRemover());
         OrderedDocumentInserter &inserter(fieldIndex.getInserter());
-        _pushThreads.execute(fieldId,
-                             [inverter(inverter.get()), &remover, &inserter,
-                              &fieldIndex, onWriteDone]()
-                             { inverter->applyRemoves(remover);
-                                 inverter->pushDocuments(inserter);
-                                 fieldIndex.commit(); });
+        if (_extraShards[fieldId].empty()) {
+            _pushThreads.execute(fieldId,
+                                 [inverter(inverter.get()), &remover, &inserter,
+                                  &fieldIndex, onWriteDone]()
+                                 { inverter->applyRemoves(remover);
+                                     inverter->pushDocuments(inserter);
+                                     fieldIndex.commit(); });
+        } else {
+            std::vector<FieldInverter *> shards;
+            for (uint32_t shard = 0; shard < _numShards; ++shard) {
+                shards.push_back(getShard(fieldId, shard));
+            }
+            _pushThreads.execute(fieldId,
+                                 [shards(std::move(shards)), &remover, &inserter,
+                                  &fieldIndex, onWriteDone]()
+                                 { for (FieldInverter *shard : shards) {
+                                         shard->applyRemoves(remover);
+                                     }
+                                     FieldInverter::pushDocuments(shards, inserter);
+                                     fieldIndex.commit(); });
+        }
         ++indexFieldIterator;
         ++fieldId;
     }
+    _pendingBytes = 0;
 }
 
 }
-
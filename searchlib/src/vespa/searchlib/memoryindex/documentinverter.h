@@ -60,9 +60,22 @@ private:
 
     std::vector<std::unique_ptr<FieldInverter>> _inverters;
     std::vector<std::unique_ptr<UrlFieldInverter>> _urlInverters;
+    // Extra inverters for text fields, splitting the documents of a
+    // field on docId.  Shard 0 is the inverter in _inverters.
+    std::vector<std::vector<std::unique_ptr<FieldInverter>>> _extraShards;
+    uint32_t                _numShards;
+    size_t                  _pendingBytes;
     ISequencedTaskExecutor &_invertThreads;
     ISequencedTaskExecutor &_pushThreads;
 
+    FieldInverter *getShard(uint32_t fieldId, uint32_t shard) const {
+        return (shard == 0) ? _inverters[fieldId].get() : _extraShards[fieldId][shard - 1].get();
+    }
+
+    uint64_t getShardComponentId(uint32_t fieldId, uint32_t shard) const {
+        return fieldId + static_cast<uint64_t>(shard) * _inverters.size();
+    }
+
     /**
      * Obtain the schema used by this index.
      *
@@ -84,6 +97,22 @@ public:
                      ISequencedTaskExecutor &invertThreads,
                      ISequencedTaskExecutor &pushThreads);
 
+    /**
+     * Create a new memory index based on the given schema, splitting
+     * the inversion of each text field across numShards inverters.
+     */
+    DocumentInverter(const index::Schema &schema,
+                     ISequencedTaskExecutor &invertThreads,
+                     ISequencedTaskExecutor &pushThreads,
+                     uint32_t numShards);
+
+    /**
+     * Number of shards to use per text field to keep all invert
+     * threads busy.
+     */
+    static uint32_t
+    calcNumShards(uint32_t numTextFields, uint32_t numInvertThreads);
+
     ~DocumentInverter();
 
     /**
@@ -120,6 +149,13 @@ public:
     getInverters() const { return _inverters; }
 
     uint32_t getNumFields() const { return _inverters.size(); }
+
+    uint32_t getNumShards() const { return _numShards; }
+
+    /**
+     * Approximate size of the field values inverted since the last push.
+     */
+    size_t getPendingBytes() const { return _pendingBytes; }
 };
 
 } // namespace memoryindex
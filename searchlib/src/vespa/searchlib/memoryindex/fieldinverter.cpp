@@ -5,6 +5,7 @@
 #include <vespa/document/datatype/urldatatype.h>
 #include <vespa/searchlib/util/url.h>
 #include <stdexcept>
+#include <algorithm>
 #include <vespa/vespalib/text/utf8.h>
 #include <vespa/vespalib/text/lowercase.h>
 #include <vespa/searchlib/common/sort.h>
@@ -487,12 +488,11 @@ FieldInverter::applyRemoves(DocumentRemover &remover)
 
 
 void
-FieldInverter::pushDocuments(IOrderedDocumentInserter &inserter)
+FieldInverter::sortPositions()
 {
     trimAbortedDocs();
 
     if (_positions.empty()) {
-        reset();
         return;             // All documents with words aborted
     }
 
@@ -501,51 +501,34 @@ FieldInverter::pushDocuments(IOrderedDocumentInserter &inserter)
     // Sort for terms.
     ShiftBasedRadixSorter<PosInfo, FullRadix, std::less<PosInfo>, 56, true>::
         radix_sort(FullRadix(), std::less<PosInfo>(), &_positions[0], _positions.size(), 16);
+}
 
+
+size_t
+FieldInverter::pushWordDocument(size_t idx, IOrderedDocumentInserter &inserter)
+{
     constexpr uint32_t NO_ELEMENT_ID = std::numeric_limits<uint32_t>::max();
     constexpr uint32_t NO_WORD_POS = std::numeric_limits<uint32_t>::max();
-    uint32_t lastWordNum = 0;
-    uint32_t lastElemId = 0;
-    uint32_t lastWordPos = 0;
-    uint32_t numWordIds = _wordRefs.size() - 1;
-    uint32_t lastDocId = 0;
-    vespalib::stringref word;
-    bool emptyFeatures = true;
-
-    inserter.rewind();
-
-    for (auto &i : _positions) {
-        assert(i._wordNum <= numWordIds);
-        (void) numWordIds;
-        if (lastWordNum != i._wordNum || lastDocId != i._docId) {
-            if (!emptyFeatures) {
-                inserter.add(lastDocId, _features);
-                emptyFeatures = true;
-            }
-            if (lastWordNum != i._wordNum) {
-                lastWordNum = i._wordNum;
-                word = getWordFromNum(lastWordNum);
-                inserter.setNextWord(word);
-            }
-            lastDocId = i._docId;
-            if (i.removed()) {
-                inserter.remove(lastDocId);
-                continue;
-            }
-        }
-        if (emptyFeatures) {
-            if (!i.removed()) {
-                emptyFeatures = false;
-                _features.clear(lastDocId);
-                lastElemId = NO_ELEMENT_ID;
-                lastWordPos = NO_WORD_POS;
-            } else {
-                continue; // ignore dup remove
-            }
-        } else {
-            // removes must come before non-removes
-            assert(!i.removed());
-        }
+    const uint32_t wordNum = _positions[idx]._wordNum;
+    const uint32_t docId = _positions[idx]._docId;
+    const size_t end = _positions.size();
+    assert(wordNum < _wordRefs.size());
+    if (_positions[idx].removed()) {
+        inserter.remove(docId);
+        // ignore dup removes
+        for (++idx; idx < end && _positions[idx]._wordNum == wordNum &&
+                 _positions[idx]._docId == docId && _positions[idx].removed(); ++idx) { }
+    }
+    if (idx == end || _positions[idx]._wordNum != wordNum || _positions[idx]._docId != docId) {
+        return idx;
+    }
+    _features.clear(docId);
+    uint32_t lastElemId = NO_ELEMENT_ID;
+    uint32_t lastWordPos = NO_WORD_POS;
+    for (; idx < end && _positions[idx]._wordNum == wordNum && _positions[idx]._docId == docId; ++idx) {
+        const PosInfo &i = _positions[idx];
+        // removes must come before non-removes
+        assert(!i.removed());
         const ElemInfo &elem = _elems[i._elemRef];
         if (i._wordPos != lastWordPos || i._elemId != lastElemId) {
             _features.addNextOcc(i._elemId, i._wordPos,
@@ -556,15 +539,90 @@ FieldInverter::pushDocuments(IOrderedDocumentInserter &inserter)
             // silently ignore duplicate annotations
         }
     }
+    inserter.add(docId, _features);
+    return idx;
+}
+
 
-    if (!emptyFeatures) {
-        inserter.add(lastDocId, _features);
+void
+FieldInverter::pushDocuments(IOrderedDocumentInserter &inserter)
+{
+    sortPositions();
+    if (_positions.empty()) {
+        reset();
+        return;
+    }
+
+    uint32_t lastWordNum = 0;
+    inserter.rewind();
+    for (size_t idx(0); idx < _positions.size(); ) {
+        if (lastWordNum != _positions[idx]._wordNum) {
+            lastWordNum = _positions[idx]._wordNum;
+            inserter.setNextWord(getWordFromNum(lastWordNum));
+        }
+        idx = pushWordDocument(idx, inserter);
     }
     inserter.flush();
     reset();
 }
 
 
+void
+FieldInverter::pushDocuments(const std::vector<FieldInverter *> &shards,
+                             IOrderedDocumentInserter &inserter)
+{
+    /*
+     * Each shard owns a disjoint set of documents and has its own word
+     * numbering, so the shards are merged on (word, docId) here. The
+     * positions for a given (word, docId) are all in the same shard.
+     */
+    struct Cursor {
+        FieldInverter *_shard;
+        size_t         _idx;
+        const char    *_word;
+        uint32_t       _docId;
+        void update() {
+            const PosInfo &pos = _shard->_positions[_idx];
+            _word = _shard->getWordFromNum(pos._wordNum);
+            _docId = pos._docId;
+        }
+        bool operator<(const Cursor &rhs) const {
+            int cmpres = strcmp(_word, rhs._word);
+            return (cmpres < 0) || ((cmpres == 0) && (_docId < rhs._docId));
+        }
+    };
+    std::vector<Cursor> cursors;
+    for (FieldInverter *shard : shards) {
+        shard->sortPositions();
+        if (!shard->_positions.empty()) {
+            cursors.push_back(Cursor{shard, 0, nullptr, 0});
+            cursors.back().update();
+        }
+    }
+    if (!cursors.empty()) {
+        const char *lastWord = nullptr;
+        inserter.rewind();
+        while (!cursors.empty()) {
+            auto best = std::min_element(cursors.begin(), cursors.end());
+            if (lastWord == nullptr || strcmp(lastWord, best->_word) != 0) {
+                lastWord = best->_word;
+                inserter.setNextWord(lastWord);
+            }
+            best->_idx = best->_shard->pushWordDocument(best->_idx, inserter);
+            if (best->_idx < best->_shard->_positions.size()) {
+                best->update();
+            } else {
+                cursors.erase(best);
+            }
+        }
+        inserter.flush();
+    }
+    for (FieldInverter *shard : shards) {
+        shard->reset();
+    }
+}
+
+
 } // namespace memoryindex
 
 } // namespace search
@@ -354,6 +354,20 @@ private:
     void
     trimAbortedDocs();
 
+    /**
+     * Trim aborted documents and sort positions by (word, docId).
+     */
+    void
+    sortPositions();
+
+    /**
+     * Push the positions for the (word, docId) starting at idx.
+     *
+     * @return index of the first position after them
+     */
+    size_t
+    pushWordDocument(size_t idx, IOrderedDocumentInserter &inserter);
+
     /*
      * Abort a pending document that has already been inverted.
      *
@@ -391,6 +405,18 @@ public:
     void
     pushDocuments(IOrderedDocumentInserter &inserter);
 
+    /**
+     * Push inverted documents from several inverters for the same
+     * field to memory index structure.  Each document must have been
+     * inverted by only one of them.
+     *
+     * @param shards    field inverters for the same field
+     * @param inserter  ordered document inserter
+     */
+    static void
+    pushDocuments(const std::vector<FieldInverter *> &shards,
+                  IOrderedDocumentInserter &inserter);
+
     /*
      * Invert a normal text field, based on annotations.
      */
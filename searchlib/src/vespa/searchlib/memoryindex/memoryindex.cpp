@@ -64,7 +64,8 @@ MemoryIndex::MemoryIndex(const Schema &schema,
       _hiddenFields(schema.getNumIndexFields(), false),
       _prunedSchema(),
       _indexedDocs(0),
-      _staticMemoryFootprint(getMemoryUsage().allocatedBytes())
+      _staticMemoryFootprint(getMemoryUsage().allocatedBytes()),
+      _maxPendingBytes(DEFAULT_MAX_PENDING_BYTES)
 {
 }
 
@@ -87,6 +88,10 @@ MemoryIndex::insertDocument(uint32_t docId, const document::Document &doc)
     if (_indexedDocs.insert(docId).second) {
         incNumDocs();
     }
+    if (_maxPendingBytes != 0 && _inverter->getPendingBytes() >= _maxPendingBytes) {
+        // Push in batches of bounded size, while the other inverter is filled.
+        commit(std::shared_ptr<IDestructorCallback>());
+    }
 }
 
 void
@@ -39,6 +39,7 @@ private:
     index::Schema::SP _prunedSchema;
     vespalib::hash_set<uint32_t> _indexedDocs; // documents in memory index
     const uint64_t    _staticMemoryFootprint;
+    size_t            _maxPendingBytes;
 
     MemoryIndex(const MemoryIndex &) = delete;
     MemoryIndex(MemoryIndex &&) = delete;
@@ -69,6 +70,8 @@ public:
     typedef std::unique_ptr<MemoryIndex> UP;
     typedef std::shared_ptr<MemoryIndex> SP;
 
+    static constexpr size_t DEFAULT_MAX_PENDING_BYTES = 64 * 1024 * 1024;
+
     /**
      * Create a new memory index based on the given schema.
      *
@@ -122,6 +125,13 @@ public:
      **/
     void commit(const std::shared_ptr<IDestructorCallback> &onWriteDone);
 
+    /**
+     * Set how many bytes of field values that can be inverted before
+     * they are pushed to the dictionary without waiting for a commit.
+     * 0 means that only commit pushes.
+     **/
+    void setMaxPendingBytes(size_t maxPendingBytes) { _maxPendingBytes = maxPendingBytes; }
+
     /**
      * Freeze this index. Further index updates will be
      * discarded. Extra information kept to wash the posting lists
@@ -3,34 +3,121 @@
 #include "hitcollector.h"
 #include <vespa/searchlib/common/bitvector.h>
 #include <vespa/searchlib/common/sort.h>
+#include <cmath>
+#include <functional>
+#include <limits>
 
 namespace search {
 namespace queryeval {
 
-void
-HitCollector::sortHitsByScore(size_t topn)
+HitCollector::Cut
+HitCollector::findCut(size_t n)
 {
-    topn = std::min(topn, _hits.size());
-    if (topn > _scoreOrder.size()) {
-        _scoreOrder.clear();
-        _scoreOrder.reserve(_hits.size());
-        for (size_t i(0); i < _hits.size(); i++) {
-            _scoreOrder.push_back(i);
+    size_t size = _docIds.size();
+    _scratchScores.assign(_scores.begin(), _scores.end());
+    // NaN scores are ordered last
+    std::nth_element(_scratchScores.begin(), _scratchScores.begin() + (n - 1), _scratchScores.end(),
+                     [](feature_t lhs, feature_t rhs) { return (lhs > rhs) || (!std::isnan(lhs) && std::isnan(rhs)); });
+    Cut cut(_scratchScores[n - 1], std::numeric_limits<uint32_t>::max());
+    size_t numBetter(0);
+    size_t numEqual(0);
+    const feature_t *scores = _scores.data();
+    for (size_t i(0); i < size; i++) {
+        numBetter += cut.better(scores[i]);
+        numEqual += cut.equal(scores[i]);
+    }
+    if (numBetter + numEqual > n) {
+        // keep the tied hits with the lowest doc ids
+        _scratchDocIds.clear();
+        for (size_t i(0); i < size; i++) {
+            if (cut.equal(scores[i])) {
+                _scratchDocIds.push_back(_docIds[i]);
+            }
         }
-        ShiftBasedRadixSorter<uint32_t, IndirectScoreRadix, IndirectScoreComparator, 56, true>::
-           radix_sort(IndirectScoreRadix(&_hits[0]), IndirectScoreComparator(&_hits[0]), &_scoreOrder[0], _scoreOrder.size(), 16, topn);
-        _scoreOrder.resize(topn);
+        size_t numTiesToKeep = n - numBetter;
+        std::nth_element(_scratchDocIds.begin(), _scratchDocIds.begin() + (numTiesToKeep - 1), _scratchDocIds.end());
+        cut._docId = _scratchDocIds[numTiesToKeep - 1];
     }
+    return cut;
 }
 
 void
-HitCollector::sortHitsByDocId()
+HitCollector::compactHits()
 {
-    if (_hitsSortOrder != SortOrder::DOC_ID) {
-        ShiftBasedRadixSorter<Hit, DocIdRadix, DocIdComparator, 24>::
-           radix_sort(DocIdRadix(), DocIdComparator(), &_hits[0], _hits.size(), 16);
-        _hitsSortOrder = SortOrder::DOC_ID;
-        _scoreOrder.clear();
+    size_t size = _docIds.size();
+    if (size <= _maxHitsSize) {
+        return;
+    }
+    Cut cut = findCut(_maxHitsSize);
+    uint32_t *docIds = _docIds.data();
+    feature_t *scores = _scores.data();
+    size_t numKept(0);
+    for (size_t i(0); i < size; i++) {
+        uint32_t docId = docIds[i];
+        feature_t score = scores[i];
+        docIds[numKept] = docId;
+        scores[numKept] = score;
+        numKept += cut.keep(docId, score);
+    }
+    _docIds.resize(numKept);
+    _scores.resize(numKept);
+    // with a NaN cut, any hit with a real score is better than the worst kept one
+    _hitsThreshold = ((numKept == _maxHitsSize) && !cut._nan) ? cut._score : -std::numeric_limits<feature_t>::max();
+}
+
+void
+HitCollector::selectBestHits(size_t n)
+{
+    size_t size = _docIds.size();
+    if (n >= size) {
+        return;
+    }
+    Cut cut = findCut(n);
+    _scratchDocIds.resize(size);
+    _scratchScores.resize(size);
+    uint32_t *docIds = _docIds.data();
+    feature_t *scores = _scores.data();
+    uint32_t *restDocIds = _scratchDocIds.data();
+    feature_t *restScores = _scratchScores.data();
+    size_t numBest(0);
+    size_t numRest(0);
+    bool moved(false);
+    for (size_t i(0); i < size; i++) {
+        uint32_t docId = docIds[i];
+        feature_t score = scores[i];
+        bool best = cut.keep(docId, score);
+        docIds[numBest] = docId;
+        scores[numBest] = score;
+        restDocIds[numRest] = docId;
+        restScores[numRest] = score;
+        moved |= (best && (numRest > 0));
+        numBest += best;
+        numRest += !best;
+    }
+    std::copy(restDocIds, restDocIds + numRest, docIds + numBest);
+    std::copy(restScores, restScores + numRest, scores + numBest);
+    if (moved) {
+        // both ranges keep their relative order, but the hits as a whole are no longer sorted
+        _hitsOrdered = false;
+    }
+}
+
+void
+HitCollector::sortHitsByDocId(size_t begin, size_t end)
+{
+    if (end - begin < 2) {
+        return;
+    }
+    std::vector<Hit> hits;
+    hits.reserve(end - begin);
+    for (size_t i(begin); i < end; i++) {
+        hits.emplace_back(_docIds[i], _scores[i]);
+    }
+    ShiftBasedRadixSorter<Hit, DocIdRadix, DocIdComparator, 24>::
+       radix_sort(DocIdRadix(), DocIdComparator(), &hits[0], hits.size(), 16);
+    for (size_t i(begin); i < end; i++) {
+        _docIds[i] = hits[i - begin].first;
+        _scores[i] = hits[i - begin].second;
     }
 }
 
@@ -41,12 +128,16 @@ HitCollector::HitCollector(uint32_t numDocs,
       _maxHitsSize(maxHitsSize),
       _maxReRankHitsSize(maxReRankHitsSize),
       _maxDocIdVectorSize((numDocs + 31) / 32),
-      _hits(),
-      _hitsSortOrder(SortOrder::DOC_ID),
+      _docIds(),
+      _scores(),
+      _hitsThreshold(-std::numeric_limits<feature_t>::max()),
+      _hitsOrdered(true),
+      _numReRanked(0),
       _unordered(false),
       _docIdVector(),
       _bitVector(),
-      _reRankedHits(),
+      _scratchDocIds(),
+      _scratchScores(),
       _scale(1.0),
       _adjust(0),
       _hasReRanked(false),
@@ -57,7 +148,8 @@ HitCollector::HitCollector(uint32_t numDocs,
     } else {
         _collector.reset(new DocIdCollector<false>(*this));
     }
-    _hits.reserve(maxHitsSize);
+    _docIds.reserve(2 * size_t(maxHitsSize));
+    _scores.reserve(2 * size_t(maxHitsSize));
 }
 
 HitCollector::~HitCollector()
@@ -68,15 +160,16 @@ void
 HitCollector::RankedHitCollector::collect(uint32_t docId, feature_t score)
 {
     HitCollector & hc = this->_hc;
-    if (hc._hits.size() < hc._maxHitsSize) {
-        if (__builtin_expect(((hc._hits.size() > 0) &&
-                              (docId < hc._hits.back().first) &&
-                              (hc._hitsSortOrder == SortOrder::DOC_ID)), false))
+    if (hc._docIds.size() < hc._maxHitsSize) {
+        if (__builtin_expect(((hc._docIds.size() > 0) &&
+                              (docId < hc._docIds.back()) &&
+                              hc._hitsOrdered), false))
         {
-            hc._hitsSortOrder = SortOrder::NONE;
+            hc._hitsOrdered = false;
             hc._unordered = true;
         }
-        hc._hits.push_back(std::make_pair(docId, score));
+        hc._docIds.push_back(docId);
+        hc._scores.push_back(score);
     } else {
         collectAndChangeCollector(docId, score);
     }
@@ -92,12 +185,16 @@ HitCollector::BitVectorCollector<CollectRankedHit>::collect(uint32_t docId, feat
 }
 
 void
-HitCollector::CollectorBase::replaceHitInVector(uint32_t docId, feature_t score) {
-    // replace lowest scored hit in hit vector
-    std::pop_heap(_hc._hits.begin(), _hc._hits.end(), ScoreComparator());
-    _hc._hits.back().first = docId;
-    _hc._hits.back().second = score;
-    std::push_heap(_hc._hits.begin(), _hc._hits.end(), ScoreComparator());
+HitCollector::CollectorBase::addHitToVector(uint32_t docId, feature_t score) {
+    if (!_hc._docIds.empty() && (docId < _hc._docIds.back())) {
+        _hc._hitsOrdered = false;
+    }
+    _hc._docIds.push_back(docId);
+    _hc._scores.push_back(score);
+    if (_hc._docIds.size() >= 2 * size_t(_hc._maxHitsSize)) {
+        // keep the best hits, and raise the bar for new ones
+        _hc.compactHits();
+    }
 }
 
 void
@@ -108,26 +205,28 @@ HitCollector::RankedHitCollector::collectAndChangeCollector(uint32_t docId, feat
     if (hc._maxDocIdVectorSize > hc._maxHitsSize) {
         // start using docid vector
         hc._docIdVector.reserve(hc._maxDocIdVectorSize);
-        uint32_t iSize = hc._hits.size();
-        for (uint32_t i = 0; i < iSize; ++i) {
-            hc._docIdVector.push_back(hc._hits[i].first);
-        }
+        hc._docIdVector.insert(hc._docIdVector.end(), hc._docIds.begin(), hc._docIds.end());
         hc._docIdVector.push_back(docId);
         newCollector.reset(new DocIdCollector<true>(hc));
     } else {
         // start using bit vector
         hc._bitVector = BitVector::create(hc._numDocs);
         hc._bitVector->invalidateCachedCount();
-        uint32_t iSize = hc._hits.size();
-        for (uint32_t i = 0; i < iSize; ++i) {
-            hc._bitVector->setBit(hc._hits[i].first);
+        for (uint32_t hitDocId : hc._docIds) {
+            hc._bitVector->setBit(hitDocId);
         }
         hc._bitVector->setBit(docId);
         newCollector.reset(new BitVectorCollector<true>(hc));
     }
-    // treat hit vector as a heap
-    std::make_heap(hc._hits.begin(), hc._hits.end(), ScoreComparator());
-    hc._hitsSortOrder = SortOrder::HEAP;
+    // from now on only hits better than the worst one in the hit vector are considered
+    feature_t minScore = std::numeric_limits<feature_t>::max();
+    bool hasNaN(false);
+    for (feature_t hitScore : hc._scores) {
+        minScore = std::min(minScore, hitScore);
+        hasNaN |= std::isnan(hitScore);
+    }
+    // NaN scores are ordered last, so any other score is better
+    hc._hitsThreshold = hasNaN ? -std::numeric_limits<feature_t>::max() : minScore;
     this->considerForHitVector(docId, score);
     hc._collector = std::move(newCollector);
 }
@@ -175,12 +274,13 @@ std::vector<feature_t>
 HitCollector::getSortedHeapScores()
 {
     std::vector<feature_t> scores;
-    size_t scoresToReturn = std::min(_hits.size(), static_cast<size_t>(_maxReRankHitsSize));
-    scores.reserve(scoresToReturn);
-    sortHitsByScore(scoresToReturn);
-    for (size_t i = 0; i < scoresToReturn; ++i) {
-        scores.push_back(_hits[_scoreOrder[i]].second);
+    compactHits();
+    size_t scoresToReturn = std::min(_docIds.size(), static_cast<size_t>(_maxReRankHitsSize));
+    if ( ! _hasReRanked) {
+        selectBestHits(scoresToReturn);
     }
+    scores.assign(_scores.begin(), _scores.begin() + scoresToReturn);
+    std::sort(scores.begin(), scores.end(), std::greater<feature_t>());
     return scores;
 }
 
@@ -193,29 +293,32 @@ HitCollector::reRank(DocumentScorer &scorer)
 size_t
 HitCollector::reRank(DocumentScorer &scorer, size_t count)
 {
-    size_t hitsToReRank = std::min(_hits.size(), count);
+    compactHits();
+    size_t hitsToReRank = std::min(_docIds.size(), count);
     if (_hasReRanked || hitsToReRank == 0) {
         return 0;
     }
-    sortHitsByScore(hitsToReRank);
-    _reRankedHits.reserve(_reRankedHits.size() + hitsToReRank);
-    for (size_t i(0); i < hitsToReRank; i++) {
-        _reRankedHits.push_back(_hits[_scoreOrder[i]]);
+    // the best hits are moved to the front, in doc id order
+    selectBestHits(hitsToReRank);
+    if ( ! _hitsOrdered) {
+        sortHitsByDocId(0, hitsToReRank);
     }
 
     Scores &initScores = _ranges.first;
     Scores &finalScores = _ranges.second;
-    initScores = Scores(_reRankedHits.back().second,
-                        _reRankedHits.front().second);
+    initScores = Scores(std::numeric_limits<feature_t>::max(),
+                        -std::numeric_limits<feature_t>::max());
     finalScores = Scores(std::numeric_limits<feature_t>::max(),
                          -std::numeric_limits<feature_t>::max());
 
-    std::sort(_reRankedHits.begin(), _reRankedHits.end()); // sort on docId
-    for (auto &hit : _reRankedHits) {
-        hit.second = scorer.score(hit.first);
-        finalScores.low = std::min(finalScores.low, hit.second);
-        finalScores.high = std::max(finalScores.high, hit.second);
+    for (size_t i(0); i < hitsToReRank; i++) {
+        initScores.low = std::min(initScores.low, _scores[i]);
+        initScores.high = std::max(initScores.high, _scores[i]);
+        _scores[i] = scorer.score(_docIds[i]);
+        finalScores.low = std::min(finalScores.low, _scores[i]);
+        finalScores.high = std::max(finalScores.high, _scores[i]);
     }
+    _numReRanked = hitsToReRank;
     _hasReRanked = true;
     return hitsToReRank;
 }
@@ -234,20 +337,31 @@ HitCollector::setRanges(const std::pair<Scores, Scores> &ranges)
 
 namespace {
 
-void
-mergeHitsIntoResultSet(const std::vector<HitCollector::Hit> &hits, ResultSet &result)
-{
-    RankedHit *rhIter = result.getArray();
-    RankedHit *rhEnd = rhIter + result.getArrayUsed();
-    for (const auto &hit : hits) {
-        while (rhIter != rhEnd && rhIter->_docId != hit.first) {
-            // just set the iterators right
-            ++rhIter;
+/**
+ * Visits the hits in doc id order, merging the re-ranked hits with the rest.
+ */
+class HitMerger {
+    const uint32_t *_docIds;
+    size_t _reRanked;
+    size_t _reRankedEnd;
+    size_t _rest;
+    size_t _restEnd;
+public:
+    HitMerger(const uint32_t *docIds, size_t numReRanked, size_t numHits)
+        : _docIds(docIds),
+          _reRanked(0),
+          _reRankedEnd(numReRanked),
+          _rest(numReRanked),
+          _restEnd(numHits)
+    { }
+    bool hasNext() const { return (_reRanked < _reRankedEnd) || (_rest < _restEnd); }
+    size_t next() {
+        if ((_rest == _restEnd) || ((_reRanked < _reRankedEnd) && (_docIds[_reRanked] < _docIds[_rest]))) {
+            return _reRanked++;
         }
-        assert(rhIter != rhEnd); // the hits should be a subset of the hits in ranked hit array.
-        rhIter->_rankValue = hit.second;
+        return _rest++;
     }
-}
+};
 
 }
 
@@ -269,65 +383,49 @@ HitCollector::getResultSet(HitRank default_value)
         _needReScore = true;
     }
 
-    // destroys the heap property or score sort order
-    sortHitsByDocId();
+    compactHits();
+    if ( ! _hitsOrdered) {
+        sortHitsByDocId(0, _numReRanked);
+        sortHitsByDocId(_numReRanked, _docIds.size());
+        _hitsOrdered = true;
+    }
 
     std::unique_ptr<ResultSet> rs(new ResultSet());
     if ( ! _collector->isDocIdCollector() ) {
-        unsigned int iSize = _hits.size();
+        unsigned int iSize = _docIds.size();
         rs->allocArray(iSize);
         RankedHit * rh = rs->getArray();
-        if (_needReScore) {
-            for (uint32_t i = 0; i < iSize; ++i) {
-                rh[i]._docId = _hits[i].first;
-                rh[i]._rankValue = getReScore(_hits[i].second);
-            }
-        } else {
-            for (uint32_t i = 0; i < iSize; ++i) {
-                rh[i]._docId = _hits[i].first;
-                rh[i]._rankValue = _hits[i].second;
-            }
+        HitMerger hits(_docIds.data(), _numReRanked, iSize);
+        for (uint32_t j = 0; j < iSize; ++j) {
+            size_t i = hits.next();
+            rh[j]._docId = _docIds[i];
+            rh[j]._rankValue = getHitRank(i);
         }
         rs->setArrayUsed(iSize);
     } else {
         if (_unordered) {
             std::sort(_docIdVector.begin(), _docIdVector.end());
         }
-        unsigned int iSize = _hits.size();
         unsigned int jSize = _docIdVector.size();
         rs->allocArray(jSize);
         RankedHit * rh = rs->getArray();
-        uint32_t i = 0;
-        if (_needReScore) {
-            for (uint32_t j = 0; j < jSize; ++j) {
-                uint32_t docId = _docIdVector[j];
-                rh[j]._docId = docId;
-                if (i < iSize && docId == _hits[i].first) {
-                    rh[j]._rankValue = getReScore(_hits[i].second);
-                    ++i;
-                } else {
-                    rh[j]._rankValue = default_value;
-                }
-            }
-        } else {
-            for (uint32_t j = 0; j < jSize; ++j) {
-                uint32_t docId = _docIdVector[j];
-                rh[j]._docId = docId;
-                if (i < iSize && docId == _hits[i].first) {
-                    rh[j]._rankValue = _hits[i].second;
-                    ++i;
-                } else {
-                    rh[j]._rankValue = default_value;
-                }
+        HitMerger hits(_docIds.data(), _numReRanked, _docIds.size());
+        bool hasHit = hits.hasNext();
+        size_t i = hasHit ? hits.next() : 0;
+        for (uint32_t j = 0; j < jSize; ++j) {
+            uint32_t docId = _docIdVector[j];
+            rh[j]._docId = docId;
+            if (hasHit && docId == _docIds[i]) {
+                rh[j]._rankValue = getHitRank(i);
+                hasHit = hits.hasNext();
+                i = hasHit ? hits.next() : 0;
+            } else {
+                rh[j]._rankValue = default_value;
             }
         }
         rs->setArrayUsed(jSize);
     }
 
-    if (_hasReRanked) {
-        mergeHitsIntoResultSet(_reRankedHits, *rs.get());
-    }
-
     if (_bitVector != NULL) {
         rs->setBitOverflow(std::move(_bitVector));
     }
@@ -6,8 +6,8 @@
 #include <vespa/searchlib/common/hitrank.h>
 #include <vespa/searchlib/common/resultset.h>
 #include <algorithm>
+#include <cmath>
 #include <vector>
-#include <vespa/vespalib/util/sort.h>
 #include <vespa/fastos/dynamiclibrary.h>
 
 namespace search {
@@ -30,20 +30,25 @@ public:
     };
 
 private:
-    enum class SortOrder { NONE, DOC_ID, HEAP };
-
     const uint32_t _numDocs;
     const uint32_t _maxHitsSize;
     const uint32_t _maxReRankHitsSize;
     const uint32_t _maxDocIdVectorSize;
 
-    std::vector<Hit>            _hits;  // used as a heap when _hits.size == _maxHitsSize
-    std::vector<uint32_t>       _scoreOrder; // Holds an indirection to the N best hits
-    SortOrder                   _hitsSortOrder;
+    // The best hits are kept as a structure of arrays. When more than
+    // _maxHitsSize hits have been seen, new hits scoring above
+    // _hitsThreshold are appended until the arrays are full, and then
+    // the best _maxHitsSize of them are selected again.
+    std::vector<uint32_t>       _docIds;
+    std::vector<feature_t>      _scores;
+    feature_t                   _hitsThreshold;
+    bool                        _hitsOrdered; // _docIds are in increasing order within each run
+    uint32_t                    _numReRanked; // the first _numReRanked hits have second phase scores
     bool                        _unordered;
     std::vector<uint32_t>       _docIdVector;
     std::unique_ptr<BitVector>  _bitVector;
-    std::vector<Hit>            _reRankedHits;
+    std::vector<uint32_t>       _scratchDocIds;
+    std::vector<feature_t>      _scratchScores;
 
     std::pair<Scores, Scores> _ranges;
     feature_t _scale;
@@ -52,33 +57,6 @@ private:
     bool _hasReRanked;
     bool _needReScore;
 
-    struct ScoreComparator {
-        bool operator() (const Hit & lhs, const Hit & rhs) const {
-            if (lhs.second == rhs.second) {
-                return (lhs.first < rhs.first);
-            }
-            return (lhs.second >= rhs.second); // comparator for min-heap
-        }
-    };
-
-    struct IndirectScoreComparator {
-        IndirectScoreComparator(const Hit * hits) : _hits(hits) { }
-        bool operator() (uint32_t lhs, uint32_t rhs) const {
-            if (_hits[lhs].second == _hits[rhs].second) {
-                return (_hits[lhs].first < _hits[rhs].first);
-            }
-            return (_hits[lhs].second >= _hits[rhs].second); // operator for min-heap
-        }
-        const Hit * _hits;
-    };
-
-    struct IndirectScoreRadix {
-        IndirectScoreRadix(const Hit * hits) : _hits(hits) { }
-        uint64_t operator () (uint32_t v) {
-            return vespalib::convertForSort<double, false>::convert(_hits[v].second);
-        }
-        const Hit * _hits;
-    };
     struct DocIdRadix {
         uint32_t operator () (const Hit & v) { return v.first; }
     };
@@ -88,6 +66,28 @@ private:
         }
     };
 
+    /**
+     * The worst of the n best hits. A hit is among the n best when
+     * its score is better than _score, or equal to it with a doc id
+     * not higher than _docId. NaN scores are ordered last, and are
+     * equal to each other.
+     */
+    struct Cut {
+        feature_t _score;
+        uint32_t  _docId;
+        bool      _nan;
+        Cut(feature_t score, uint32_t docId) : _score(score), _docId(docId), _nan(std::isnan(score)) {}
+        bool better(feature_t score) const {
+            return (score > _score) | (_nan & (score == score));
+        }
+        bool equal(feature_t score) const {
+            return (score == _score) | (_nan & (score != score));
+        }
+        bool keep(uint32_t docId, feature_t score) const {
+            return better(score) | (equal(score) & (docId <= _docId));
+        }
+    };
+
     class Collector {
     public:
         typedef std::unique_ptr<Collector> UP;
@@ -103,12 +103,12 @@ private:
     public:
         CollectorBase(HitCollector &hc) : _hc(hc) { }
         void considerForHitVector(uint32_t docId, feature_t score) {
-            if (__builtin_expect((score > _hc._hits[0].second), false)) {
-                replaceHitInVector(docId, score);
+            if (__builtin_expect((score > _hc._hitsThreshold), false)) {
+                addHitToVector(docId, score);
             }
         }
     protected:
-        void replaceHitInVector(uint32_t docId, feature_t score);
+        void addHitToVector(uint32_t docId, feature_t score);
         HitCollector &_hc;
     };
 
@@ -139,8 +139,13 @@ private:
     HitRank getReScore(feature_t score) const {
         return ((score * _scale) - _adjust);
     }
-    VESPA_DLL_LOCAL void sortHitsByScore(size_t topn);
-    VESPA_DLL_LOCAL void sortHitsByDocId();
+    HitRank getHitRank(size_t idx) const {
+        return (_needReScore && (idx >= _numReRanked)) ? getReScore(_scores[idx]) : _scores[idx];
+    }
+    VESPA_DLL_LOCAL Cut findCut(size_t n);
+    VESPA_DLL_LOCAL void compactHits();
+    VESPA_DLL_LOCAL void selectBestHits(size_t n);
+    VESPA_DLL_LOCAL void sortHitsByDocId(size_t begin, size_t end);
 
 public:
     /**
@@ -169,8 +174,8 @@ public:
     }
 
     /**
-     * Returns a sorted vector of scores for the hits that are stored
-     * in the heap. These are the candidates for re-ranking.
+     * Returns a sorted vector of scores for the m (=maxReRankHitsSize)
+     * best hits. These are the candidates for re-ranking.
      */
     std::vector<feature_t> getSortedHeapScores();
 
@@ -187,8 +192,7 @@ public:
 
     /**
      * Returns a result set based on the content of this collector.
-     * Invoking this method will destroy the heap property of the
-     * ranked hits and the match data heap.
+     * Invoking this method will reorder the ranked hits.
      *
      * @param auto pointer to the result set
      * @param default_value rank value to be used for results without rank value
@@ -14,6 +14,8 @@
 namespace search {
 namespace queryeval {
 
+using vespalib::hwaccelrated::IAccelrated;
+
 namespace {
 
 template<typename Update>
@@ -74,9 +76,19 @@ template<typename Update>
 void
 MultiBitVectorIterator<Update>::strictSeek(uint32_t docId)
 {
-    for (updateLastValue(docId), _lastValue=_lastValue & checkTab(docId);
-         (_lastValue == 0) && __builtin_expect(! isAtEnd(), true);
-         updateLastValue(_lastMaxDocIdLimit));
+    updateLastValue(docId);
+    _lastValue = _lastValue & checkTab(docId);
+    if ((_lastValue == 0) && __builtin_expect(! isAtEnd(), true)) {
+        // Scan the following words in blocks for the next non zero one.
+        const size_t numWords((uint64_t(_numDocs) + WordLen - 1) / WordLen);
+        const size_t index = Update::nextWord(*_accel, &_bvs[0], _bvs.size(), wordNum(_lastMaxDocIdLimit),
+                                              numWords, _lastValue);
+        if (index < numWords) {
+            _lastMaxDocIdLimit = (index + 1) * WordLen;
+        } else {
+            setAtEnd();
+        }
+    }
     if (__builtin_expect(!isAtEnd(), true)) {
         docId = _lastMaxDocIdLimit - WordLen + vespalib::Optimized::lsbIdx(_lastValue);
         if (__builtin_expect(docId >= _numDocs, false)) {
@@ -92,6 +104,10 @@ struct And {
     Word operator () (const Word a, const Word b) {
         return a & b;
     }
+    static size_t nextWord(const IAccelrated & accel, const Word * const * bvs, size_t numBvs,
+                           size_t index, size_t end, Word & word) {
+        return accel.andNextWord(bvs, numBvs, index, end, word);
+    }
     static bool isAnd() { return true; }
 };
 
@@ -100,6 +116,10 @@ struct Or {
     Word operator () (const Word a, const Word b) {
         return a | b;
     }
+    static size_t nextWord(const IAccelrated & accel, const Word * const * bvs, size_t numBvs,
+                           size_t index, size_t end, Word & word) {
+        return accel.orNextWord(bvs, numBvs, index, end, word);
+    }
     static bool isAnd() { return false; }
 };
 
@@ -137,7 +157,8 @@ MultiBitVectorIteratorBase::MultiBitVectorIteratorBase(const Children & children
     _numDocs(std::numeric_limits<unsigned int>::max()),
     _lastValue(0),
     _lastMaxDocIdLimit(0),
-    _bvs(children.size())
+    _bvs(children.size()),
+    _accel(IAccelrated::getAccelrator())
 {
     for (size_t i(0); i < children.size(); i++) {
         const BitVectorIterator * bv = static_cast<const BitVectorIterator *>(children[i]);
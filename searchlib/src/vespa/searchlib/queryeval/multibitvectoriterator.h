@@ -5,6 +5,7 @@
 #include "multisearch.h"
 #include "unpackinfo.h"
 #include <vespa/searchlib/common/bitword.h>
+#include <vespa/vespalib/hwaccelrated/iaccelrated.h>
 
 namespace search {
 namespace queryeval {
@@ -27,6 +28,7 @@ protected:
     Word                    _lastValue; // Last value computed
     uint32_t                _lastMaxDocIdLimit; // next documentid requiring recomputation.
     std::vector<const Word  *> _bvs;
+    vespalib::hwaccelrated::IAccelrated::UP _accel; // combines blocks of words when searching for the next hit
 private:
     virtual bool acceptExtraFilter() const = 0;
     UP andWith(UP filter, uint32_t estimate) override;
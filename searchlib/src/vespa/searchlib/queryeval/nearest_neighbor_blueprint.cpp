@@ -0,0 +1,113 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "nearest_neighbor_blueprint.h"
+#include "emptysearch.h"
+#include <vespa/searchlib/fef/termfieldmatchdataarray.h>
+#include <vespa/searchlib/tensor/dense_tensor_attribute.h>
+#include <algorithm>
+#include <cassert>
+
+using search::tensor::DenseTensorAttribute;
+using search::tensor::DistanceFunction;
+
+namespace search {
+namespace queryeval {
+
+namespace {
+
+/**
+ * Search iterator over a precomputed set of nearest neighbors sorted on doc id.
+ */
+class NearestNeighborIterator : public SearchIterator
+{
+    using NeighborVector = NearestNeighborBlueprint::NeighborVector;
+    const NeighborVector   &_hits;
+    const DistanceFunction &_distanceFunction;
+    fef::TermFieldMatchData &_tfmd;
+    size_t                  _pos;
+public:
+    NearestNeighborIterator(const NeighborVector &hits, const DistanceFunction &distanceFunction,
+                            fef::TermFieldMatchData &tfmd)
+        : _hits(hits),
+          _distanceFunction(distanceFunction),
+          _tfmd(tfmd),
+          _pos(0)
+    {
+    }
+    void initRange(uint32_t beginId, uint32_t endId) override {
+        SearchIterator::initRange(beginId, endId);
+        _pos = 0;
+    }
+    void doSeek(uint32_t docId) override {
+        while (_pos < _hits.size() && _hits[_pos].docId < docId) {
+            ++_pos;
+        }
+        if (_pos < _hits.size() && _hits[_pos].docId < getEndId()) {
+            setDocId(_hits[_pos].docId);
+        } else {
+            setAtEnd();
+        }
+    }
+    void doUnpack(uint32_t docId) override {
+        _tfmd.setRawScore(docId, _distanceFunction.toRawScore(_hits[_pos].distance));
+    }
+};
+
+struct LowerDocId {
+    bool operator()(const NearestNeighborBlueprint::Neighbor &lhs,
+                    const NearestNeighborBlueprint::Neighbor &rhs) const {
+        return lhs.docId < rhs.docId;
+    }
+};
+
+}
+
+NearestNeighborBlueprint::NearestNeighborBlueprint(const FieldSpecBase &field,
+                                                   const DenseTensorAttribute &attribute,
+                                                   std::vector<double> queryVector,
+                                                   uint32_t targetNumHits,
+                                                   uint32_t exploreAdditionalHits)
+    : ComplexLeafBlueprint(field),
+      _attribute(attribute),
+      _queryVector(std::move(queryVector)),
+      _targetNumHits(targetNumHits),
+      _exploreAdditionalHits(exploreAdditionalHits),
+      _hits()
+{
+    uint32_t estHits = (_attribute.nearestNeighborIndex() != nullptr)
+                       ? std::min(_targetNumHits, _attribute.getCommittedDocIdLimit())
+                       : 0;
+    setEstimate(HitEstimate(estHits, (estHits == 0)));
+}
+
+NearestNeighborBlueprint::~NearestNeighborBlueprint() { }
+
+void
+NearestNeighborBlueprint::fetchPostings(bool)
+{
+    const tensor::HnswIndex *index = _attribute.nearestNeighborIndex();
+    if (index == nullptr) {
+        return;
+    }
+    tensor::DistanceFunction::Vector vector(_queryVector.data(), _queryVector.size());
+    _hits = index->findTopK(_targetNumHits, vector, _targetNumHits + _exploreAdditionalHits);
+    uint32_t docIdLimit = _attribute.getCommittedDocIdLimit();
+    _hits.erase(std::remove_if(_hits.begin(), _hits.end(),
+                               [docIdLimit](const Neighbor &hit) { return hit.docId >= docIdLimit; }),
+                _hits.end());
+    std::sort(_hits.begin(), _hits.end(), LowerDocId());
+}
+
+SearchIterator::UP
+NearestNeighborBlueprint::createLeafSearch(const fef::TermFieldMatchDataArray &tfmda, bool) const
+{
+    const tensor::HnswIndex *index = _attribute.nearestNeighborIndex();
+    if (index == nullptr || _hits.empty()) {
+        return std::make_unique<EmptySearch>();
+    }
+    assert(tfmda.size() == 1);
+    return std::make_unique<NearestNeighborIterator>(_hits, index->getDistanceFunction(), *tfmda[0]);
+}
+
+}  // namespace queryeval
+}  // namespace search
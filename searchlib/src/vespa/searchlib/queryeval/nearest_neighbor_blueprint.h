@@ -0,0 +1,48 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "blueprint.h"
+#include "searchiterator.h"
+#include <vespa/searchlib/tensor/hnsw_index.h>
+#include <vector>
+
+namespace search {
+namespace tensor { class DenseTensorAttribute; }
+
+namespace queryeval {
+
+/**
+ * Blueprint for an approximate nearest neighbor search in a dense
+ * tensor attribute. The nearest documents are found in the attribute's
+ * HNSW index when fetching postings, and the search iterator matches
+ * exactly those documents. The raw score of a hit is its closeness to
+ * the query vector.
+ *
+ * The attribute blueprint factory creates it for a term on a dense tensor
+ * attribute, with the query vector and target hits in the term text.
+ */
+class NearestNeighborBlueprint : public ComplexLeafBlueprint {
+public:
+    using Neighbor = tensor::HnswIndex::Neighbor;
+    using NeighborVector = tensor::HnswIndex::NeighborVector;
+private:
+    const tensor::DenseTensorAttribute &_attribute;
+    std::vector<double> _queryVector;
+    uint32_t _targetNumHits;
+    uint32_t _exploreAdditionalHits;
+    NeighborVector _hits; // sorted on doc id
+public:
+    NearestNeighborBlueprint(const FieldSpecBase &field,
+                             const tensor::DenseTensorAttribute &attribute,
+                             std::vector<double> queryVector,
+                             uint32_t targetNumHits,
+                             uint32_t exploreAdditionalHits);
+    ~NearestNeighborBlueprint();
+    void fetchPostings(bool strict) override;
+    SearchIterator::UP createLeafSearch(const fef::TermFieldMatchDataArray &tfmda, bool strict) const override;
+    const NeighborVector &getHits() const { return _hits; }
+};
+
+}  // namespace queryeval
+}  // namespace search
@@ -41,4 +41,20 @@ public:
     int32_t getMaxWeight() const { return _maxWeight; }
 };
 
+/**
+ * Interface for getting an upper bound on the weights within the
+ * posting list block a search iterator is currently positioned in.
+ *
+ * The bound covers all documents from the current position up to and
+ * including the last document id of the block, allowing WAND style
+ * operators to skip whole blocks that cannot beat their threshold.
+ */
+class BlockMaxWeightInfo {
+public:
+    virtual ~BlockMaxWeightInfo() { }
+    virtual bool hasBlockMaxWeights() const = 0;
+    virtual int32_t getBlockMaxWeight() const = 0;
+    virtual uint32_t getBlockLastDocId() const = 0;
+};
+
 }
@@ -41,10 +41,27 @@ private:
         }
     }
 
+    bool check_block_max() {
+        if (!_terms.has_block_max()) {
+            return true;
+        }
+        // terms behind the candidate are bounded by their max score until stepped
+        if (!GreaterThan(_boostedThreshold)(_algo.get_block_max_upper_bound(_terms, _heaps))) {
+            return false;
+        }
+        if (!_algo.has_past_block_max(_terms, _heaps)) {
+            return true; // stepping the past terms is left to check_score, which does it lazily
+        }
+        _algo.find_matching_terms(_terms, _heaps);
+        return GreaterThan(_boostedThreshold)(_algo.get_block_max_upper_bound(_terms, _heaps));
+    }
+
     void seek_strict(uint32_t docid) {
         _algo.set_candidate(_terms, _heaps, docid);
         while (_algo.solve_wand_constraint(_terms, _heaps, GreaterThan(_boostedThreshold))) {
-            if (_algo.check_score(_terms, _heaps, DotProductScorer(), GreaterThan(_threshold))) {
+            if (!check_block_max()) {
+                _algo.skip_blocks(_terms, _heaps);
+            } else if (_algo.check_score(_terms, _heaps, DotProductScorer(), GreaterThan(_threshold))) {
                 setDocId(_algo.get_candidate());
                 return;
             } else {
@@ -57,7 +74,7 @@ private:
     void seek_unstrict(uint32_t docid) {
         if (docid > _algo.get_candidate()) {
             _algo.set_candidate(_terms, _heaps, docid);
-            if (_algo.check_wand_constraint(_terms, _heaps, GreaterThan(_boostedThreshold))) {
+            if (_algo.check_wand_constraint(_terms, _heaps, GreaterThan(_boostedThreshold)) && check_block_max()) {
                 if (_algo.check_score(_terms, _heaps, DotProductScorer(), GreaterThan(_threshold))) {
                     setDocId(_algo.get_candidate());
                 }
@@ -12,6 +12,21 @@ VectorizedIteratorTerms::visit_members(vespalib::ObjectVisitor &visitor) const {
     visit(visitor, "children", _terms);
 }
 
+void
+VectorizedIteratorTerms::init_block_max() {
+    _blockMax.clear();
+    _blockMax.reserve(_terms.size());
+    for (const Term &term: _terms) {
+        const BlockMaxWeightInfo *info = dynamic_cast<const BlockMaxWeightInfo *>(term.search);
+        if ((info != nullptr) && info->hasBlockMaxWeights()) {
+            _blockMax.push_back(info);
+            _hasBlockMax = true;
+        } else {
+            _blockMax.push_back(nullptr);
+        }
+    }
+}
+
 VectorizedIteratorTerms::VectorizedIteratorTerms(VectorizedIteratorTerms &&) = default;
 VectorizedIteratorTerms & VectorizedIteratorTerms::operator=(VectorizedIteratorTerms &&) = default;
 VectorizedIteratorTerms::~VectorizedIteratorTerms() { }
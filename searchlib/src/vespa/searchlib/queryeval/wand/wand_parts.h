@@ -8,6 +8,7 @@
 #include <vespa/searchlib/fef/termfieldmatchdata.h>
 #include <vespa/searchlib/queryeval/searchiterator.h>
 #include <vespa/searchlib/queryeval/iterator_pack.h>
+#include <vespa/searchlib/queryeval/posting_info.h>
 #include <vespa/searchlib/attribute/iterator_pack.h>
 #include <vespa/vespalib/objects/objectvisitor.h>
 #include <vespa/vespalib/util/array.h>
@@ -177,6 +178,12 @@ public:
 
     uint32_t seek(uint16_t ref, uint32_t docid) { return _iteratorPack.seek(ref, docid); }
     int32_t get_weight(uint16_t ref, uint32_t docid) { return _iteratorPack.get_weight(ref, docid); }
+
+    // no block max information by default; each term is bounded by its max score
+    bool has_block_max() const { return false; }
+    bool has_block_max(ref_t) const { return false; }
+    score_t block_max_score(ref_t ref) const { return _maxScore[ref]; }
+    docid_t block_last_docid(ref_t ref) const { return _docId[ref]; }
     
     vespalib::string stringify_docid() const;
 };
@@ -234,6 +241,10 @@ class VectorizedIteratorTerms : public VectorizedState<SearchIteratorPack>
 {
 private:
     Terms _terms; // TODO: want to get rid of this
+    std::vector<const BlockMaxWeightInfo *> _blockMax; // nullptr for terms without block max weights
+    bool _hasBlockMax;
+
+    void init_block_max();
 
 public:
     template <typename Scorer>
@@ -246,18 +257,35 @@ public:
     void unpack(uint16_t ref, uint32_t docid) { iteratorPack().unpack(ref, docid); }
     void visit_members(vespalib::ObjectVisitor &visitor) const;
     const Terms &input_terms() const { return _terms; }
+
+    bool has_block_max() const { return _hasBlockMax; }
+    bool has_block_max(ref_t ref) const { return (_blockMax[ref] != nullptr); }
+    score_t block_max_score(ref_t ref) const {
+        const BlockMaxWeightInfo *info = _blockMax[ref];
+        if (info == nullptr || weight(ref) < 0) {
+            return maxScore(ref);
+        }
+        return std::min(maxScore(ref), weight(ref) * (score_t)info->getBlockMaxWeight());
+    }
+    docid_t block_last_docid(ref_t ref) const {
+        const BlockMaxWeightInfo *info = _blockMax[ref];
+        return (info != nullptr) ? info->getBlockLastDocId() : _terms[ref].search->getDocId();
+    }
 };
 
 template <typename Scorer>
 VectorizedIteratorTerms::VectorizedIteratorTerms(const Terms &t, const Scorer &, uint32_t docIdLimit,
                                                  fef::MatchData::UP childrenMatchData)
-    : _terms()
+    : _terms(),
+      _blockMax(),
+      _hasBlockMax(false)
 {
     std::vector<ref_t> order = init_state<Scorer>(TermInput(t), docIdLimit);
     _terms = assemble([&t](ref_t ref){ return t[ref]; }, order);
     iteratorPack() = SearchIteratorPack(assemble([&t](ref_t ref){ return t[ref].search; }, order),
                                         assemble([&t](ref_t ref){ return t[ref].matchData; }, order),
                                         std::move(childrenMatchData));
+    init_block_max();
 }
 
 //-----------------------------------------------------------------------------
@@ -336,6 +364,8 @@ public:
     }
     ref_t *present_begin() const { return _present; }
     ref_t *present_end() const { return _past; }
+    ref_t *past_begin() const { return _past; }
+    ref_t *past_end() const { return _trash; }
     vespalib::string stringify() const;
 };
 
@@ -616,6 +646,60 @@ public:
         return true;
     }
 
+    /**
+     * Upper bound for the current candidate where the terms matching
+     * the candidate are bounded by the max score of their current
+     * posting list block instead of the max score of the whole posting
+     * list.
+     **/
+    template <typename VectorizedTerms, typename Heaps>
+    score_t get_block_max_upper_bound(VectorizedTerms &terms, Heaps &heaps) const {
+        score_t bound = _maxUpperBound;
+        ref_t *end = heaps.present_end();
+        for (ref_t *ref = heaps.present_begin(); ref != end; ++ref) {
+            bound -= (terms.maxScore(*ref) - terms.block_max_score(*ref));
+        }
+        return bound;
+    }
+
+    /**
+     * Check if any term behind the candidate has block max information.
+     * Only then is it worth stepping all of them to the candidate to
+     * tighten the block max upper bound.
+     **/
+    template <typename VectorizedTerms, typename Heaps>
+    bool has_past_block_max(const VectorizedTerms &terms, const Heaps &heaps) const {
+        ref_t *end = heaps.past_end();
+        for (ref_t *ref = heaps.past_begin(); ref != end; ++ref) {
+            if (terms.has_block_max(*ref)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Move the candidate past the current blocks of the terms matching
+     * the candidate. Used when the block max upper bound cannot beat the
+     * threshold. Terms still behind the candidate count with their max
+     * score in that bound, so no document before the end of the first of
+     * these blocks (or the next document of any future term) can beat it
+     * either.
+     **/
+    template <typename VectorizedTerms, typename Heaps>
+    void skip_blocks(VectorizedTerms &terms, Heaps &heaps) {
+        docid_t last = search::endDocId - 1;
+        ref_t *end = heaps.present_end();
+        for (ref_t *ref = heaps.present_begin(); ref != end; ++ref) {
+            last = std::min(last, terms.block_last_docid(*ref));
+        }
+        docid_t next = std::max(last, _candidate) + 1;
+        if (heaps.has_future()) {
+            next = std::min(next, terms.docId(heaps.future()));
+        }
+        set_candidate(terms, heaps, next);
+    }
+
     template <typename VectorizedTerms, typename Heaps, typename Scorer, typename AboveThreshold>
     bool check_score(VectorizedTerms &terms, Heaps &heaps, Scorer &&scorer, AboveThreshold &&aboveThreshold) {
         _partial_score = 0;
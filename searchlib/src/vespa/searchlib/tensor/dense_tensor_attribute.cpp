@@ -7,6 +7,10 @@
 #include <vespa/eval/tensor/dense/mutable_dense_tensor_view.h>
 #include <vespa/fastlib/io/bufferedfile.h>
 #include <vespa/searchlib/attribute/readerbase.h>
+#include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
+#include <algorithm>
+#include <thread>
 
 using vespalib::eval::ValueType;
 using vespalib::tensor::MutableDenseTensorView;
@@ -21,6 +25,14 @@ namespace {
 
 constexpr uint32_t DENSE_TENSOR_ATTRIBUTE_VERSION = 1;
 const vespalib::string tensorTypeTag("tensortype");
+constexpr uint32_t MAX_INDEX_BUILD_THREADS = 8;
+constexpr uint32_t INDEX_BUILD_BATCH_SIZE = 256;
+
+bool
+supportsNearestNeighborIndex(const ValueType &tensorType)
+{
+    return tensorType.is_dense() && !tensorType.is_abstract();
+}
 
 class TensorReader : public ReaderBase
 {
@@ -86,8 +98,15 @@ TensorReader::getNumCells() {
 DenseTensorAttribute::DenseTensorAttribute(const vespalib::stringref &baseFileName,
                                  const Config &cfg)
     : TensorAttribute(baseFileName, cfg, _denseTensorStore),
-      _denseTensorStore(cfg.tensorType())
+      _denseTensorStore(cfg.tensorType()),
+      _distanceFunction(),
+      _index()
 {
+    const auto &params = cfg.hnswIndexParams();
+    if (params.enabled() && supportsNearestNeighborIndex(cfg.tensorType())) {
+        _distanceFunction = DistanceFunction::create(params.distanceMetric());
+        _index = std::make_unique<HnswIndex>(*this, *_distanceFunction, getGenerationHolder(), params);
+    }
 }
 
 
@@ -102,7 +121,61 @@ DenseTensorAttribute::setTensor(DocId docId, const Tensor &tensor)
 {
     RefType ref = _denseTensorStore.setTensor(
             (_tensorMapper ? *_tensorMapper->map(tensor) : tensor));
+    if (_index) {
+        _index->removeDocument(docId);
+    }
     setTensorRef(docId, ref);
+    if (_index) {
+        _index->addDocument(docId);
+    }
+}
+
+uint32_t
+DenseTensorAttribute::clearDoc(DocId docId)
+{
+    if (_index) {
+        _index->removeDocument(docId);
+    }
+    return TensorAttribute::clearDoc(docId);
+}
+
+void
+DenseTensorAttribute::clearDocs(DocId lidLow, DocId lidLimit)
+{
+    if (_index) {
+        for (DocId lid = lidLow; lid < lidLimit; ++lid) {
+            _index->removeDocument(lid);
+        }
+    }
+    TensorAttribute::clearDocs(lidLow, lidLimit);
+}
+
+void
+DenseTensorAttribute::removeOldGenerations(generation_t firstUsed)
+{
+    TensorAttribute::removeOldGenerations(firstUsed);
+    if (_index) {
+        _index->trimHoldLists(firstUsed);
+    }
+}
+
+void
+DenseTensorAttribute::onGenerationChange(generation_t generation)
+{
+    TensorAttribute::onGenerationChange(generation);
+    if (_index) {
+        _index->transferHoldLists(generation - 1);
+    }
+}
+
+MemoryUsage
+DenseTensorAttribute::memoryUsage() const
+{
+    MemoryUsage result = TensorAttribute::memoryUsage();
+    if (_index) {
+        result.merge(_index->getMemoryUsage());
+    }
+    return result;
 }
 
 
@@ -129,6 +202,20 @@ DenseTensorAttribute::getTensor(DocId docId, MutableDenseTensorView &tensor) con
     _denseTensorStore.getTensor(ref, tensor);
 }
 
+vespalib::ConstArrayRef<double>
+DenseTensorAttribute::getVector(uint32_t docId) const
+{
+    RefType ref;
+    if (docId < _refVector.size()) {
+        ref = _refVector[docId];
+    }
+    if (!ref.valid()) {
+        return vespalib::ConstArrayRef<double>();
+    }
+    auto raw = _denseTensorStore.getRawBuffer(ref);
+    return vespalib::ConstArrayRef<double>(static_cast<const double *>(raw), _denseTensorStore.getNumCells(raw));
+}
+
 bool
 DenseTensorAttribute::onLoad()
 {
@@ -158,9 +245,45 @@ DenseTensorAttribute::onLoad()
     }
     setNumDocs(numDocs);
     setCommittedDocIdLimit(numDocs);
+    if (_index) {
+        // The graph is not saved, it is built again from the loaded tensors.
+        buildIndex(numDocs);
+    }
     return true;
 }
 
+void
+DenseTensorAttribute::buildIndex(uint32_t docIdLimit)
+{
+    // The candidate neighbors of a batch of documents are found in parallel while
+    // the graph is left untouched, then this thread links the documents in one by one.
+    // Documents in the same batch do not see each other as candidates.
+    uint32_t numThreads = std::max(1u, std::min(std::thread::hardware_concurrency(), MAX_INDEX_BUILD_THREADS));
+    vespalib::ThreadStackExecutor executor(numThreads, 128 * 1024);
+    std::vector<HnswIndex::PreparedAddDoc> batch;
+    batch.reserve(INDEX_BUILD_BATCH_SIZE);
+    for (uint32_t lid = 0; lid < docIdLimit; ) {
+        batch.clear();
+        for (; lid < docIdLimit && batch.size() < INDEX_BUILD_BATCH_SIZE; ++lid) {
+            if (_refVector[lid].valid()) {
+                batch.emplace_back(lid, _index->drawLevel(), 0);
+            }
+        }
+        for (uint32_t thread = 0; thread < numThreads; ++thread) {
+            executor.execute(vespalib::makeLambdaTask([this, &batch, thread, numThreads]() {
+                for (size_t i = thread; i < batch.size(); i += numThreads) {
+                    batch[i] = _index->prepareAddDocument(batch[i].docId, batch[i].level);
+                }
+            }));
+        }
+        executor.sync();
+        for (const auto &prepared : batch) {
+            _index->completeAddDocument(prepared);
+        }
+    }
+    executor.shutdown();
+}
+
 
 std::unique_ptr<AttributeSaver>
 DenseTensorAttribute::onInitSave()
@@ -4,6 +4,8 @@
 
 #include "tensor_attribute.h"
 #include "dense_tensor_store.h"
+#include "doc_vector_access.h"
+#include "hnsw_index.h"
 
 namespace vespalib { namespace tensor { class MutableDenseTensorView; }}
 
@@ -14,20 +16,39 @@ namespace tensor {
 /**
  * Attribute vector class used to store dense tensors for all
  * documents in memory.
+ *
+ * When enabled in the config, and the tensor type has only bound
+ * dimensions, an approximate nearest neighbor index is maintained
+ * over the tensors.
  */
-class DenseTensorAttribute : public TensorAttribute
+class DenseTensorAttribute : public TensorAttribute,
+                             public DocVectorAccess
 {
     DenseTensorStore _denseTensorStore;
+    std::unique_ptr<DistanceFunction> _distanceFunction;
+    std::unique_ptr<HnswIndex> _index;
+
+    MemoryUsage memoryUsage() const override;
+    void buildIndex(uint32_t docIdLimit);
 public:
     DenseTensorAttribute(const vespalib::stringref &baseFileName, const Config &cfg);
     virtual ~DenseTensorAttribute();
     virtual void setTensor(DocId docId, const Tensor &tensor) override;
     virtual std::unique_ptr<Tensor> getTensor(DocId docId) const override;
+    virtual uint32_t clearDoc(DocId docId) override;
+    virtual void clearDocs(DocId lidLow, DocId lidLimit) override;
+    virtual void removeOldGenerations(generation_t firstUsed) override;
+    virtual void onGenerationChange(generation_t generation) override;
     virtual bool onLoad() override;
     virtual std::unique_ptr<AttributeSaver> onInitSave() override;
     virtual void compactWorst() override;
     virtual uint32_t getVersion() const override;
     void getTensor(DocId docId, vespalib::tensor::MutableDenseTensorView &tensor) const;
+    vespalib::ConstArrayRef<double> getVector(uint32_t docId) const override;
+    /**
+     * Returns the nearest neighbor index, or nullptr if there is none.
+     */
+    const HnswIndex *nearestNeighborIndex() const { return _index.get(); }
 };
 
 
@@ -0,0 +1,68 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "distance_function.h"
+#include <vespa/vespalib/hwaccelrated/iaccelrated.h>
+#include <cassert>
+#include <cmath>
+
+namespace search {
+namespace tensor {
+
+DistanceFunction::UP
+DistanceFunction::create(DistanceMetric metric)
+{
+    if (metric == DistanceMetric::INNER_PRODUCT) {
+        return std::make_unique<InnerProductDistance>();
+    }
+    return std::make_unique<SquaredEuclideanDistance>();
+}
+
+double
+SquaredEuclideanDistance::calc(const Vector &lhs, const Vector &rhs) const
+{
+    assert(lhs.size() == rhs.size());
+    // Independent partial sums let the compiler keep several lanes busy.
+    double sum[4] = { 0.0, 0.0, 0.0, 0.0 };
+    size_t sz = lhs.size();
+    size_t i = 0;
+    for (; i + 4 <= sz; i += 4) {
+        for (size_t j = 0; j < 4; ++j) {
+            double diff = lhs[i + j] - rhs[i + j];
+            sum[j] += diff * diff;
+        }
+    }
+    for (; i < sz; ++i) {
+        double diff = lhs[i] - rhs[i];
+        sum[0] += diff * diff;
+    }
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+double
+SquaredEuclideanDistance::toRawScore(double distance) const
+{
+    return 1.0 / (1.0 + std::sqrt(distance));
+}
+
+InnerProductDistance::InnerProductDistance()
+    : _accel(vespalib::hwaccelrated::IAccelrated::getAccelrator())
+{
+}
+
+InnerProductDistance::~InnerProductDistance() { }
+
+double
+InnerProductDistance::calc(const Vector &lhs, const Vector &rhs) const
+{
+    assert(lhs.size() == rhs.size());
+    return -_accel->dotProduct(lhs.cbegin(), rhs.cbegin(), lhs.size());
+}
+
+double
+InnerProductDistance::toRawScore(double distance) const
+{
+    return -distance;
+}
+
+}  // namespace search::tensor
+}  // namespace search
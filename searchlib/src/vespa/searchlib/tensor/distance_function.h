@@ -0,0 +1,55 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/searchcommon/attribute/hnsw_index_params.h>
+#include <vespa/vespalib/util/arrayref.h>
+#include <memory>
+
+namespace vespalib { namespace hwaccelrated { class IAccelrated; } }
+
+namespace search {
+namespace tensor {
+
+/**
+ * Interface for calculating the distance between two vectors of equal size.
+ * A smaller distance means the vectors are closer.
+ */
+class DistanceFunction {
+public:
+    using UP = std::unique_ptr<DistanceFunction>;
+    using Vector = vespalib::ConstArrayRef<double>;
+    using DistanceMetric = attribute::HnswIndexParams::DistanceMetric;
+    virtual ~DistanceFunction() {}
+    virtual double calc(const Vector &lhs, const Vector &rhs) const = 0;
+    /**
+     * Converts a distance to a raw score where a higher score means closer.
+     */
+    virtual double toRawScore(double distance) const = 0;
+    static UP create(DistanceMetric metric);
+};
+
+/**
+ * Squared euclidean distance. The square root is only taken when
+ * converting to a raw score since it does not change the ordering.
+ */
+class SquaredEuclideanDistance : public DistanceFunction {
+public:
+    double calc(const Vector &lhs, const Vector &rhs) const override;
+    double toRawScore(double distance) const override;
+};
+
+/**
+ * Negated dot product, used when a larger dot product means closer.
+ */
+class InnerProductDistance : public DistanceFunction {
+    std::unique_ptr<vespalib::hwaccelrated::IAccelrated> _accel;
+public:
+    InnerProductDistance();
+    ~InnerProductDistance();
+    double calc(const Vector &lhs, const Vector &rhs) const override;
+    double toRawScore(double distance) const override;
+};
+
+}  // namespace search::tensor
+}  // namespace search
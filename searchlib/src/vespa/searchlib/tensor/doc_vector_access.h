@@ -0,0 +1,25 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/util/arrayref.h>
+#include <cstdint>
+
+namespace search {
+namespace tensor {
+
+/**
+ * Interface that provides access to the vector that is associated
+ * with the given document id.
+ */
+class DocVectorAccess {
+public:
+    virtual ~DocVectorAccess() {}
+    /**
+     * Returns an empty array if the document has no vector.
+     */
+    virtual vespalib::ConstArrayRef<double> getVector(uint32_t docId) const = 0;
+};
+
+}  // namespace search::tensor
+}  // namespace search
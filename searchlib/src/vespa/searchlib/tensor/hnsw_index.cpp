@@ -0,0 +1,465 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "hnsw_index.h"
+#include <vespa/searchlib/common/rcuvector.hpp>
+#include <vespa/searchlib/datastore/array_store.hpp>
+#include <vespa/vespalib/stllike/hash_set.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+namespace search {
+
+namespace tensor {
+
+namespace {
+
+constexpr size_t HUGE_MEMORY_PAGE_SIZE = 2 * 1024 * 1024;
+constexpr size_t SMALL_MEMORY_PAGE_SIZE = 4 * 1024;
+constexpr size_t MIN_NUM_ARRAYS_FOR_NEW_BUFFER = 8 * 1024;
+// Levels are drawn from an exponential distribution, this is far beyond what is ever drawn in practice.
+constexpr uint32_t MAX_LEVEL = 31;
+constexpr uint64_t NO_ENTRY = std::numeric_limits<uint64_t>::max();
+
+using Neighbor = HnswIndex::Neighbor;
+using NeighborVector = HnswIndex::NeighborVector;
+
+struct CloserFirst {
+    bool operator()(const Neighbor &lhs, const Neighbor &rhs) const { return lhs.distance < rhs.distance; }
+};
+
+struct FurtherFirst {
+    bool operator()(const Neighbor &lhs, const Neighbor &rhs) const { return lhs.distance > rhs.distance; }
+};
+
+// Top of the queue is the closest candidate.
+using CandidateQueue = std::priority_queue<Neighbor, NeighborVector, FurtherFirst>;
+// Top of the queue is the furthest of the best candidates found so far.
+using BestQueue = std::priority_queue<Neighbor, NeighborVector, CloserFirst>;
+
+datastore::ArrayStoreConfig
+makeStoreConfig(size_t maxSmallArraySize)
+{
+    return datastore::ArrayStore<uint32_t>::optimizedConfigForHugePage(maxSmallArraySize,
+                                                                      HUGE_MEMORY_PAGE_SIZE,
+                                                                      SMALL_MEMORY_PAGE_SIZE,
+                                                                      MIN_NUM_ARRAYS_FOR_NEW_BUFFER);
+}
+
+bool
+contains(vespalib::ConstArrayRef<uint32_t> links, uint32_t docId)
+{
+    return std::find(links.cbegin(), links.cend(), docId) != links.cend();
+}
+
+}
+
+HnswIndex::HnswIndex(const DocVectorAccess &vectors, const DistanceFunction &distanceFunction,
+                     vespalib::GenerationHolder &genHolder, const HnswIndexParams &params)
+    : _vectors(vectors),
+      _distanceFunction(distanceFunction),
+      _params(params),
+      _levelMultiplier(1.0 / std::log(std::max(params.maxLinksPerNode(), 2u))),
+      _levelGenerator(),
+      _nodeRefs(genHolder),
+      _nodes(makeStoreConfig(MAX_LEVEL + 1)),
+      _links(makeStoreConfig(2 * params.maxLinksPerNode())),
+      _entry(NO_ENTRY)
+{
+}
+
+HnswIndex::~HnswIndex() = default;
+
+uint32_t
+HnswIndex::drawLevel()
+{
+    // Uniform in (0, 1] so that the logarithm is finite.
+    double uniform = double(_levelGenerator() - _levelGenerator.min() + 1) /
+                     double(_levelGenerator.max() - _levelGenerator.min() + 1);
+    double level = std::floor(-std::log(uniform) * _levelMultiplier);
+    return std::min(uint32_t(level), MAX_LEVEL);
+}
+
+uint32_t
+HnswIndex::getNumLevels(uint32_t docId) const
+{
+    if (!isIndexed(docId)) {
+        return 0;
+    }
+    return _nodes.get(_nodeRefs[docId]).size();
+}
+
+HnswIndex::LinkArrayRef
+HnswIndex::getLinks(uint32_t docId, uint32_t level) const
+{
+    if (!isIndexed(docId)) {
+        return LinkArrayRef();
+    }
+    auto levels = _nodes.get(_nodeRefs[docId]);
+    if (level >= levels.size()) {
+        return LinkArrayRef();
+    }
+    return _links.get(levels[level]);
+}
+
+void
+HnswIndex::setLinks(uint32_t docId, uint32_t level, const std::vector<uint32_t> &links)
+{
+    EntryRef oldNodeRef = _nodeRefs[docId];
+    auto oldLevels = _nodes.get(oldNodeRef);
+    std::vector<EntryRef> levels(oldLevels.cbegin(), oldLevels.cend());
+    EntryRef oldLinksRef = levels[level];
+    levels[level] = _links.add(links);
+    EntryRef nodeRef = _nodes.add(levels);
+    std::atomic_thread_fence(std::memory_order_release);
+    _nodeRefs[docId] = nodeRef;
+    _nodes.remove(oldNodeRef);
+    if (oldLinksRef.valid()) {
+        _links.remove(oldLinksRef);
+    }
+}
+
+HnswIndex::NeighborVector
+HnswIndex::searchLayer(const Vector &vector, const NeighborVector &entryPoints,
+                       uint32_t neighborsToExplore, uint32_t level) const
+{
+    vespalib::hash_set<uint32_t> visited(neighborsToExplore * 8);
+    CandidateQueue candidates;
+    BestQueue best;
+    for (const Neighbor &entry : entryPoints) {
+        visited.insert(entry.docId);
+        candidates.push(entry);
+        best.push(entry);
+        if (best.size() > neighborsToExplore) {
+            best.pop();
+        }
+    }
+    while (!candidates.empty()) {
+        Neighbor candidate = candidates.top();
+        if (candidate.distance > best.top().distance && best.size() >= neighborsToExplore) {
+            break;
+        }
+        candidates.pop();
+        for (uint32_t neighbor : getLinks(candidate.docId, level)) {
+            if (!visited.insert(neighbor).second || !isIndexedOnLevel(neighbor, level)) {
+                continue;
+            }
+            Vector neighborVector = _vectors.getVector(neighbor);
+            if (neighborVector.size() != vector.size()) {
+                continue;
+            }
+            double distance = _distanceFunction.calc(vector, neighborVector);
+            if (best.size() < neighborsToExplore || distance < best.top().distance) {
+                candidates.emplace(neighbor, distance);
+                best.emplace(neighbor, distance);
+                if (best.size() > neighborsToExplore) {
+                    best.pop();
+                }
+            }
+        }
+    }
+    NeighborVector result;
+    result.reserve(best.size());
+    for (; !best.empty(); best.pop()) {
+        result.push_back(best.top());
+    }
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+HnswIndex::NeighborVector
+HnswIndex::selectNeighbors(const NeighborVector &candidates, uint32_t maxLinks) const
+{
+    // Keep a candidate only if it is closer to the node than to any already kept neighbor.
+    // This spreads the links in different directions instead of into a single cluster.
+    NeighborVector result;
+    for (const Neighbor &candidate : candidates) {
+        if (result.size() >= maxLinks) {
+            break;
+        }
+        Vector candidateVector = _vectors.getVector(candidate.docId);
+        bool keep = true;
+        for (const Neighbor &kept : result) {
+            if (calcDistance(candidateVector, kept.docId) < candidate.distance) {
+                keep = false;
+                break;
+            }
+        }
+        if (keep) {
+            result.push_back(candidate);
+        }
+    }
+    return result;
+}
+
+void
+HnswIndex::addLink(uint32_t docId, uint32_t level, uint32_t newLink)
+{
+    auto oldLinks = getLinks(docId, level);
+    if (oldLinks.size() < maxLinksOnLevel(level)) {
+        std::vector<uint32_t> links;
+        links.reserve(oldLinks.size() + 1);
+        links.assign(oldLinks.cbegin(), oldLinks.cend());
+        links.push_back(newLink);
+        setLinks(docId, level, links);
+        return;
+    }
+    Vector vector = _vectors.getVector(docId);
+    NeighborVector candidates;
+    candidates.reserve(oldLinks.size() + 1);
+    for (uint32_t link : oldLinks) {
+        candidates.emplace_back(link, calcDistance(vector, link));
+    }
+    candidates.emplace_back(newLink, calcDistance(vector, newLink));
+    std::sort(candidates.begin(), candidates.end(), CloserFirst());
+    std::vector<uint32_t> links;
+    for (const Neighbor &neighbor : selectNeighbors(candidates, maxLinksOnLevel(level))) {
+        links.push_back(neighbor.docId);
+    }
+    setLinks(docId, level, links);
+    // Keep the links symmetric by dropping the reverse of each link that was pruned away.
+    for (const Neighbor &candidate : candidates) {
+        if (std::find(links.cbegin(), links.cend(), candidate.docId) == links.cend()) {
+            removeLink(candidate.docId, level, docId);
+        }
+    }
+}
+
+void
+HnswIndex::removeLink(uint32_t docId, uint32_t level, uint32_t link)
+{
+    auto oldLinks = getLinks(docId, level);
+    std::vector<uint32_t> links;
+    links.reserve(oldLinks.size());
+    for (uint32_t oldLink : oldLinks) {
+        if (oldLink != link) {
+            links.push_back(oldLink);
+        }
+    }
+    setLinks(docId, level, links);
+}
+
+void
+HnswIndex::mutualReconnect(const std::vector<uint32_t> &cluster, uint32_t level)
+{
+    // Link the former neighbors of a removed node to each other, closest pairs first,
+    // as long as both sides of a pair have room for another link.
+    struct LinkCandidate {
+        double distance;
+        uint32_t from;
+        uint32_t to;
+        LinkCandidate(double distance_in, uint32_t from_in, uint32_t to_in)
+            : distance(distance_in), from(from_in), to(to_in) {}
+        bool operator<(const LinkCandidate &rhs) const { return distance < rhs.distance; }
+    };
+    std::vector<LinkCandidate> pairs;
+    for (size_t i = 0; i < cluster.size(); ++i) {
+        uint32_t from = cluster[i];
+        if (!isIndexedOnLevel(from, level)) {
+            continue;
+        }
+        Vector vector = _vectors.getVector(from);
+        auto links = getLinks(from, level);
+        for (size_t j = i + 1; j < cluster.size(); ++j) {
+            uint32_t to = cluster[j];
+            if (isIndexedOnLevel(to, level) && !contains(links, to)) {
+                pairs.emplace_back(calcDistance(vector, to), from, to);
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    uint32_t maxLinks = maxLinksOnLevel(level);
+    for (const LinkCandidate &pair : pairs) {
+        auto fromLinks = getLinks(pair.from, level);
+        if (fromLinks.size() < maxLinks && getLinks(pair.to, level).size() < maxLinks &&
+            !contains(fromLinks, pair.to))
+        {
+            addLink(pair.from, level, pair.to);
+            addLink(pair.to, level, pair.from);
+        }
+    }
+}
+
+void
+HnswIndex::addDocument(uint32_t docId)
+{
+    completeAddDocument(prepareAddDocument(docId, drawLevel()));
+}
+
+HnswIndex::PreparedAddDoc
+HnswIndex::prepareAddDocument(uint32_t docId, uint32_t level) const
+{
+    Vector vector = _vectors.getVector(docId);
+    assert(vector.size() != 0);
+    uint64_t entry = _entry.load(std::memory_order_acquire);
+    PreparedAddDoc prepared(docId, level, entry);
+    if (entry == NO_ENTRY) {
+        return prepared;
+    }
+    uint32_t entryDoc = entryDocId(entry);
+    uint32_t topLevel = entryLevel(entry);
+    NeighborVector entryPoints;
+    entryPoints.emplace_back(entryDoc, calcDistance(vector, entryDoc));
+    for (uint32_t searchLevel = topLevel; searchLevel > level; --searchLevel) {
+        entryPoints = searchLayer(vector, entryPoints, 1, searchLevel);
+    }
+    prepared.candidates.resize(std::min(level, topLevel) + 1);
+    for (uint32_t linkLevel = prepared.candidates.size(); linkLevel-- > 0; ) {
+        entryPoints = searchLayer(vector, entryPoints, _params.neighborsToExploreAtInsert(), linkLevel);
+        prepared.candidates[linkLevel] = entryPoints;
+    }
+    return prepared;
+}
+
+void
+HnswIndex::completeAddDocument(const PreparedAddDoc &prepared)
+{
+    if (_entry.load(std::memory_order_relaxed) != prepared.entry) {
+        // The candidates were found from an entry node that has since been replaced,
+        // they may be missing levels or come from a part of the graph that is gone.
+        completeAddDocument(prepareAddDocument(prepared.docId, prepared.level));
+        return;
+    }
+    uint32_t docId = prepared.docId;
+    uint32_t level = prepared.level;
+    assert(!isIndexed(docId));
+    _nodeRefs.ensure_size(docId + 1);
+    std::vector<EntryRef> levels(level + 1);
+    EntryRef nodeRef = _nodes.add(levels);
+    std::atomic_thread_fence(std::memory_order_release);
+    _nodeRefs[docId] = nodeRef;
+
+    if (prepared.entry == NO_ENTRY) {
+        _entry.store(makeEntry(docId, level), std::memory_order_release);
+        return;
+    }
+    for (uint32_t linkLevel = prepared.candidates.size(); linkLevel-- > 0; ) {
+        NeighborVector candidates;
+        candidates.reserve(prepared.candidates[linkLevel].size());
+        for (const Neighbor &candidate : prepared.candidates[linkLevel]) {
+            if (candidate.docId != docId && isIndexedOnLevel(candidate.docId, linkLevel)) {
+                candidates.push_back(candidate);
+            }
+        }
+        std::vector<uint32_t> links;
+        for (const Neighbor &neighbor : selectNeighbors(candidates, maxLinksOnLevel(linkLevel))) {
+            links.push_back(neighbor.docId);
+        }
+        setLinks(docId, linkLevel, links);
+        for (uint32_t link : links) {
+            addLink(link, linkLevel, docId);
+        }
+    }
+    if (level > entryLevel(prepared.entry)) {
+        _entry.store(makeEntry(docId, level), std::memory_order_release);
+    }
+}
+
+void
+HnswIndex::removeDocument(uint32_t docId)
+{
+    if (!isIndexed(docId)) {
+        return;
+    }
+    uint32_t numLevels = getNumLevels(docId);
+    for (uint32_t level = 0; level < numLevels; ++level) {
+        std::vector<uint32_t> neighbors = getLinksCopy(docId, level);
+        for (uint32_t neighbor : neighbors) {
+            removeLink(neighbor, level, docId);
+        }
+        mutualReconnect(neighbors, level);
+    }
+    uint64_t entry = _entry.load(std::memory_order_relaxed);
+    if (entryDocId(entry) == docId) {
+        // Promote the neighbor on the highest level, which is on at least that level itself.
+        uint64_t newEntry = NO_ENTRY;
+        for (uint32_t level = numLevels; level-- > 0 && newEntry == NO_ENTRY; ) {
+            for (uint32_t neighbor : getLinks(docId, level)) {
+                if (neighbor != docId && isIndexed(neighbor)) {
+                    newEntry = makeEntry(neighbor, getNumLevels(neighbor) - 1);
+                    break;
+                }
+            }
+        }
+        if (newEntry == NO_ENTRY) {
+            // The node was not linked to anything, fall back to scanning all nodes.
+            for (uint32_t candidate = 0; candidate < _nodeRefs.size(); ++candidate) {
+                if (candidate != docId && isIndexed(candidate)) {
+                    uint32_t candidateLevel = getNumLevels(candidate) - 1;
+                    if (newEntry == NO_ENTRY || candidateLevel > entryLevel(newEntry)) {
+                        newEntry = makeEntry(candidate, candidateLevel);
+                    }
+                }
+            }
+        }
+        _entry.store(newEntry, std::memory_order_release);
+    }
+    EntryRef nodeRef = _nodeRefs[docId];
+    _nodeRefs[docId] = EntryRef();
+    for (EntryRef linksRef : _nodes.get(nodeRef)) {
+        if (linksRef.valid()) {
+            _links.remove(linksRef);
+        }
+    }
+    _nodes.remove(nodeRef);
+}
+
+HnswIndex::NeighborVector
+HnswIndex::findTopK(uint32_t k, const Vector &vector, uint32_t exploreK) const
+{
+    uint64_t entry = _entry.load(std::memory_order_acquire);
+    if (entry == NO_ENTRY || k == 0) {
+        return NeighborVector();
+    }
+    uint32_t entryDoc = entryDocId(entry);
+    Vector entryVector = _vectors.getVector(entryDoc);
+    if (entryVector.size() != vector.size()) {
+        return NeighborVector();
+    }
+    NeighborVector entryPoints;
+    entryPoints.emplace_back(entryDoc, _distanceFunction.calc(vector, entryVector));
+    for (uint32_t level = entryLevel(entry); level > 0; --level) {
+        entryPoints = searchLayer(vector, entryPoints, 1, level);
+    }
+    NeighborVector result = searchLayer(vector, entryPoints, std::max(k, exploreK), 0);
+    if (result.size() > k) {
+        result.resize(k, Neighbor(0, 0.0));
+    }
+    return result;
+}
+
+void
+HnswIndex::transferHoldLists(generation_t generation)
+{
+    _nodes.transferHoldLists(generation);
+    _links.transferHoldLists(generation);
+}
+
+void
+HnswIndex::trimHoldLists(generation_t firstUsed)
+{
+    _nodes.trimHoldLists(firstUsed);
+    _links.trimHoldLists(firstUsed);
+}
+
+MemoryUsage
+HnswIndex::getMemoryUsage() const
+{
+    MemoryUsage result = _nodeRefs.getMemoryUsage();
+    result.merge(_nodes.getMemoryUsage());
+    result.merge(_links.getMemoryUsage());
+    return result;
+}
+
+std::vector<uint32_t>
+HnswIndex::getLinksCopy(uint32_t docId, uint32_t level) const
+{
+    auto links = getLinks(docId, level);
+    return std::vector<uint32_t>(links.cbegin(), links.cend());
+}
+
+}  // namespace search::tensor
+
+}  // namespace search
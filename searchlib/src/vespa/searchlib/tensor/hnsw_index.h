@@ -0,0 +1,157 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "distance_function.h"
+#include "doc_vector_access.h"
+#include <vespa/searchcommon/attribute/hnsw_index_params.h>
+#include <vespa/searchlib/common/rcuvector.h>
+#include <vespa/searchlib/datastore/array_store.h>
+#include <vespa/searchlib/datastore/entryref.h>
+#include <atomic>
+#include <random>
+#include <vector>
+
+namespace search {
+namespace tensor {
+
+/**
+ * Approximate nearest neighbor index over the vectors of a dense tensor attribute.
+ *
+ * This is a hierarchical navigable small world (HNSW) graph. Each document is a node
+ * that lives on level 0 and up to a randomly drawn top level. On each level a node
+ * links to a small set of close nodes. A search descends greedily from the single
+ * entry node on the top level and does a wider best-first search on level 0.
+ *
+ * Links are kept symmetric: if a links to b on a level, b also links to a. This makes
+ * it cheap to find and repair all nodes linking to a removed node.
+ *
+ * All changes are done by a single writer thread. Link arrays are never changed in
+ * place; a new node is published with a single store to the node reference vector
+ * and the old arrays are put on hold until no reader can see them. This lets search
+ * threads read the graph without locking, as for the rest of the attribute.
+ */
+class HnswIndex {
+public:
+    using generation_t = vespalib::GenerationHandler::generation_t;
+    using HnswIndexParams = attribute::HnswIndexParams;
+
+    struct Neighbor {
+        uint32_t docId;
+        double distance;
+        Neighbor(uint32_t docId_in, double distance_in) : docId(docId_in), distance(distance_in) {}
+    };
+    using NeighborVector = std::vector<Neighbor>;
+
+    /**
+     * The result of the read-only part of adding a document: the candidate
+     * neighbors on each level it will be linked on, found from the given entry.
+     */
+    struct PreparedAddDoc {
+        uint32_t docId;
+        uint32_t level;
+        uint64_t entry;
+        std::vector<NeighborVector> candidates; // indexed by level
+        PreparedAddDoc(uint32_t docId_in, uint32_t level_in, uint64_t entry_in)
+            : docId(docId_in), level(level_in), entry(entry_in), candidates() {}
+    };
+
+private:
+    using EntryRef = datastore::EntryRef;
+    using NodeRefVector = attribute::RcuVectorBase<EntryRef>;
+    // A node is an array with one links reference per level.
+    using NodeStore = datastore::ArrayStore<EntryRef>;
+    using LinkStore = datastore::ArrayStore<uint32_t>;
+    using LinkArrayRef = LinkStore::ConstArrayRef;
+    using Vector = DistanceFunction::Vector;
+
+    const DocVectorAccess &_vectors;
+    const DistanceFunction &_distanceFunction;
+    HnswIndexParams _params;
+    double _levelMultiplier;
+    std::minstd_rand _levelGenerator;
+    NodeRefVector _nodeRefs; // docId -> ref in node store
+    NodeStore _nodes;
+    LinkStore _links;
+    // Doc id of the entry node in the low 32 bits and its top level in the high 32 bits.
+    std::atomic<uint64_t> _entry;
+
+    static uint64_t makeEntry(uint32_t docId, uint32_t level) { return (uint64_t(level) << 32) | docId; }
+    static uint32_t entryDocId(uint64_t entry) { return entry & 0xffffffffu; }
+    static uint32_t entryLevel(uint64_t entry) { return entry >> 32; }
+
+    uint32_t maxLinksOnLevel(uint32_t level) const {
+        return (level == 0) ? 2 * _params.maxLinksPerNode() : _params.maxLinksPerNode();
+    }
+    bool isIndexed(uint32_t docId) const {
+        return (docId < _nodeRefs.size()) && _nodeRefs[docId].valid();
+    }
+    uint32_t getNumLevels(uint32_t docId) const;
+    bool isIndexedOnLevel(uint32_t docId, uint32_t level) const { return level < getNumLevels(docId); }
+    LinkArrayRef getLinks(uint32_t docId, uint32_t level) const;
+    void setLinks(uint32_t docId, uint32_t level, const std::vector<uint32_t> &links);
+    double calcDistance(const Vector &lhs, uint32_t rhsDocId) const {
+        return _distanceFunction.calc(lhs, _vectors.getVector(rhsDocId));
+    }
+    NeighborVector searchLayer(const Vector &vector, const NeighborVector &entryPoints,
+                               uint32_t neighborsToExplore, uint32_t level) const;
+    NeighborVector selectNeighbors(const NeighborVector &candidates, uint32_t maxLinks) const;
+    void addLink(uint32_t docId, uint32_t level, uint32_t newLink);
+    void removeLink(uint32_t docId, uint32_t level, uint32_t link);
+    void mutualReconnect(const std::vector<uint32_t> &cluster, uint32_t level);
+
+public:
+    HnswIndex(const DocVectorAccess &vectors, const DistanceFunction &distanceFunction,
+              vespalib::GenerationHolder &genHolder, const HnswIndexParams &params);
+    ~HnswIndex();
+
+    /**
+     * Links the vector of the given document into the graph.
+     * The vector must already be available from the doc vector access.
+     */
+    void addDocument(uint32_t docId);
+    /**
+     * Draws the top level of a new node. Must be called by the writer thread.
+     */
+    uint32_t drawLevel();
+    /**
+     * Finds the candidate neighbors of a document that is about to be added on the
+     * given level. This does not change the graph and can run in other threads
+     * than the writer, as long as hold lists are not trimmed meanwhile.
+     */
+    PreparedAddDoc prepareAddDocument(uint32_t docId, uint32_t level) const;
+    /**
+     * Links in a document using candidates from prepareAddDocument(). Documents
+     * added since the candidates were found are not considered. If the entry node
+     * has changed, the candidates are found again.
+     */
+    void completeAddDocument(const PreparedAddDoc &prepared);
+    /**
+     * Unlinks the given document from the graph. Its neighbors are linked to each
+     * other where they have room, so the graph stays navigable.
+     */
+    void removeDocument(uint32_t docId);
+
+    /**
+     * Returns the k approximately nearest documents to the given vector, sorted
+     * on increasing distance. Exploring more candidates than k gives better recall.
+     * This is safe to call from reader threads.
+     */
+    NeighborVector findTopK(uint32_t k, const Vector &vector, uint32_t exploreK) const;
+
+    void transferHoldLists(generation_t generation);
+    void trimHoldLists(generation_t firstUsed);
+    MemoryUsage getMemoryUsage() const;
+
+    const HnswIndexParams &getParams() const { return _params; }
+    const DistanceFunction &getDistanceFunction() const { return _distanceFunction; }
+
+    // Should only be used for unit testing
+    std::vector<uint32_t> getLinksCopy(uint32_t docId, uint32_t level) const;
+    uint32_t getEntryDocId() const { return entryDocId(_entry.load(std::memory_order_acquire)); }
+    uint32_t getEntryLevel() const { return entryLevel(_entry.load(std::memory_order_acquire)); }
+    uint32_t getLevels(uint32_t docId) const { return getNumLevels(docId); }
+};
+
+}  // namespace search::tensor
+}  // namespace search
@@ -93,12 +93,19 @@ TensorAttribute::onCommit()
 }
 
 
+MemoryUsage
+TensorAttribute::memoryUsage() const
+{
+    MemoryUsage result = _refVector.getMemoryUsage();
+    result.merge(_tensorStore.getMemoryUsage());
+    return result;
+}
+
 void
 TensorAttribute::onUpdateStat()
 {
     // update statistics
-    MemoryUsage total = _refVector.getMemoryUsage();
-    total.merge(_tensorStore.getMemoryUsage());
+    MemoryUsage total = memoryUsage();
     total.mergeGenerationHeldBytes(getGenerationHolder().getHeldBytes());
     this->updateStatistics(_refVector.size(),
                            _refVector.size(),
@@ -30,6 +30,7 @@ protected:
     template <typename RefType>
     void doCompactWorst();
     void setTensorRef(DocId docId, RefType ref);
+    virtual MemoryUsage memoryUsage() const;
 public:
     DECLARE_IDENTIFIABLE_ABSTRACT(TensorAttribute);
     using RefCopyVector = vespalib::Array<RefType>;
@@ -63,7 +63,8 @@ private:
          vespalib::alloc::Alloc &buf,
          bool allowTruncate);
 
-    void write(FastOS_FileInterface &file, const Packet::Entry &entry);
+    void serialize(vespalib::nbostream & os, const Packet::Entry &entry) const;
+    void write(FastOS_FileInterface &file, const vespalib::nbostream & os, const Packet::Entry &firstEntry, SerialNum lastSerial);
     static int32_t calcCrc(Crc crc, const void * buf, size_t len);
     void writeHeader(const common::FileHeaderContext &fileHeaderContext);
 
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "docsumstorevalue.h"
+#include <vector>
 
 namespace search::docsummary {
 
@@ -38,6 +39,14 @@ public:
      **/
     virtual DocsumStoreValue getMappedDocsum(uint32_t docid) = 0;
 
+    /**
+     * Tell the store which docids will be asked for next, so that it
+     * can fetch them all at once. Default is to do nothing.
+     *
+     * @param docids local document ids of the coming requests
+     **/
+    virtual void prefetch(const std::vector<uint32_t> & docids) { (void) docids; }
+
     /**
      * Will return default input class used.
      **/
@@ -41,6 +41,8 @@ private:
     void testCacheEntriesHonoured();
     void testCacheMaxSizeHonoured();
     void testThatMultipleRemoveOnOverflowIsFine();
+    void testThatAdmissionCanRejectInsertWhenFull();
+    void testThatPopulateInsertsWithoutWritingToBackingStore();
 };
 
 int
@@ -53,6 +55,8 @@ Test::Main()
     testCacheEntriesHonoured();
     testCacheMaxSizeHonoured();
     testThatMultipleRemoveOnOverflowIsFine();
+    testThatAdmissionCanRejectInsertWhenFull();
+    testThatPopulateInsertsWithoutWritingToBackingStore();
     TEST_DONE();
 }
 
@@ -159,5 +163,57 @@ void Test::testThatMultipleRemoveOnOverflowIsFine()
     EXPECT_EQUAL(2924u, cache.sizeBytes());
 }
 
+namespace {
+
+template <typename P>
+class OddOnlyCache : public cache<P> {
+public:
+    OddOnlyCache(typename P::BackingStore & b, size_t maxBytes) : cache<P>(b, maxBytes) { }
+private:
+    bool admit(const uint32_t & candidate, const uint32_t & victim) override {
+        (void) victim;
+        return (candidate % 2) == 1;
+    }
+};
+
+}
+
+void Test::testThatAdmissionCanRejectInsertWhenFull()
+{
+    B m;
+    OddOnlyCache< CacheParam<P, B> > cache(m, -1);
+    cache.maxElements(2);
+    for (uint32_t i(1); i <= 6; i++) {
+        m[i] = "a";
+    }
+    EXPECT_EQUAL("a", cache.read(1));
+    EXPECT_EQUAL("a", cache.read(2));
+    EXPECT_EQUAL("a", cache.read(4));
+    EXPECT_EQUAL(2u, cache.size());
+    EXPECT_TRUE(cache.hasKey(1));
+    EXPECT_TRUE(cache.hasKey(2));
+    EXPECT_EQUAL(1u, cache.getReject());
+    EXPECT_EQUAL(0u, cache.getEvict());
+    EXPECT_EQUAL("a", cache.read(5));
+    EXPECT_EQUAL(2u, cache.size());
+    EXPECT_FALSE(cache.hasKey(1));
+    EXPECT_TRUE(cache.hasKey(5));
+    EXPECT_EQUAL(1u, cache.getEvict());
+}
+
+void Test::testThatPopulateInsertsWithoutWritingToBackingStore()
+{
+    B m;
+    cache< CacheParam<P, B> > cache(m, -1);
+    cache.populate(1, "fetched string");
+    EXPECT_TRUE(cache.hasKey(1));
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQUAL(1u, cache.getInsert());
+    cache.populate(1, "other string");
+    EXPECT_EQUAL(1u, cache.getRace());
+    EXPECT_EQUAL(1u, cache.size());
+    EXPECT_EQUAL(80u, cache.sizeBytes());
+    EXPECT_EQUAL("fetched string", cache.read(1));
+}
 
 TEST_APPHOOK(Test)
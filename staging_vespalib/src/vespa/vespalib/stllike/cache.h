@@ -101,6 +101,12 @@ public:
      */
     void write(const K & key, const V & value);
 
+    /**
+     * Insert an object the caller has already fetched from the backing store, as a miss in read() would.
+     * Nothing is done if the object is already cached. Does not write to the backing store.
+     */
+    void populate(const K & key, const V & value);
+
     /**
      * Tell if an object with given key exists in the cache.
      * Does not alter the LRU list.
@@ -116,13 +122,23 @@ public:
     size_t        getErase() const { return _erase; }
     size_t   getInvalidate() const { return _invalidate; }
     size_t       getlookup() const { return _lookup; }
+    size_t        getEvict() const { return _evict; }
+    size_t       getReject() const { return _reject; }
 
 protected:
     vespalib::LockGuard getGuard();
     void invalidate(const vespalib::LockGuard & guard, const K & key);
     bool hasKey(const vespalib::LockGuard & guard, const K & key) const;
     bool hasLock() const;
+    /**
+     * Called with the lock held when an object fetched from the backing store would
+     * push the cache past its limits. Return false to hand the object to the caller
+     * without caching it, keeping the victim that would otherwise be evicted.
+     * Default is to admit everything, which gives plain LRU.
+     */
+    virtual bool admit(const K & candidate, const K & victim);
 private:
+    void insertFetched(const vespalib::LockGuard & guard, const K & key, const V & value);
     /**
      * Called when an object is inserted, to see if the LRU should be removed.
      * Default is to obey the maxsize given in constructor.
@@ -149,6 +165,8 @@ private:
     mutable size_t      _erase;
     mutable size_t      _invalidate;
     mutable size_t      _lookup;
+    size_t              _evict;
+    size_t              _reject;
     BackingStore      & _store;
     vespalib::Lock      _hashLock;
     /// Striped locks that can be used for having a locked access to the backing store.
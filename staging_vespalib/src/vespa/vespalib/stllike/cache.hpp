@@ -57,6 +57,8 @@ cache<P>::cache(BackingStore & b, size_t maxBytes) :
     _erase(0),
     _invalidate(0),
     _lookup(0),
+    _evict(0),
+    _reject(0),
     _store(b)
 { }
 
@@ -66,10 +68,19 @@ cache<P>::removeOldest(const value_type & v) {
     bool remove(Lru::removeOldest(v) || (sizeBytes() >= capacityBytes()));
     if (remove) {
         _sizeBytes -= calcSize(v.first, v.second._value);
+        _evict++;
     }
     return remove;
 }
 
+template< typename P >
+bool
+cache<P>::admit(const K & candidate, const K & victim) {
+    (void) candidate;
+    (void) victim;
+    return true;
+}
+
 template< typename P >
 vespalib::LockGuard
 cache<P>::getGuard() {
@@ -102,15 +113,44 @@ cache<P>::read(const K & key)
     V value;
     if (_store.read(key, value)) {
         vespalib::LockGuard guard(_hashLock);
-        Lru::insert(key, value);
-        _sizeBytes += calcSize(key, value);
-        _insert++;
+        insertFetched(guard, key, value);
     } else {
         _noneExisting.fetch_add(1);
     }
     return value;
 }
 
+template< typename P >
+void
+cache<P>::populate(const K & key, const V & value)
+{
+    vespalib::LockGuard storeGuard(getLock(key));
+    vespalib::LockGuard guard(_hashLock);
+    if (Lru::hasKey(key)) {
+        // Somebody else just fetched it ahead of me.
+        _race++;
+        return;
+    }
+    insertFetched(guard, key, value);
+}
+
+template< typename P >
+void
+cache<P>::insertFetched(const vespalib::LockGuard & guard, const K & key, const V & value)
+{
+    assert(guard.locks(_hashLock));
+    (void) guard;
+    // Same condition as removeOldest, which is consulted right after the insert.
+    bool full = ! Lru::empty() && ((sizeBytes() >= capacityBytes()) || (size() >= capacity()));
+    if (full && ! admit(key, Lru::getOldestKey())) {
+        _reject++;
+        return;
+    }
+    Lru::insert(key, value);
+    _sizeBytes += calcSize(key, value);
+    _insert++;
+}
+
 template< typename P >
 void
 cache<P>::write(const K & key, const V & value)
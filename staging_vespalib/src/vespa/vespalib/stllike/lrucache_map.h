@@ -153,6 +153,12 @@ public:
      */
     bool hasKey(const K & key) const { return HashTable::find(key) != HashTable::end(); }
 
+    /**
+     * Return the key of the least recently used object, the one next in line for removal.
+     * Must not be called on an empty cache.
+     */
+    const K & getOldestKey() const { return HashTable::getByInternalIndex(_tail).first; }
+
     /**
      * Called when an object is inserted, to see if the LRU should be removed.
      * Default is to obey the maxsize given in constructor.
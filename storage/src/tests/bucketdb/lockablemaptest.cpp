@@ -7,6 +7,7 @@
 #include <vespa/vdstestlib/cppunit/macros.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include <boost/operators.hpp>
+#include <algorithm>
 
 namespace storage {
 
@@ -34,6 +35,7 @@ struct LockableMapTest : public CppUnit::TestFixture {
     void testFindAllInconsistentlySplit5();
     void testFindAllInconsistentlySplit6();
     void testFindAllInconsistentBelow16Bits();
+    void testFindAllAcrossStripes();
     void testCreate();
     void testCreate2();
     void testCreate3();
@@ -67,6 +69,7 @@ struct LockableMapTest : public CppUnit::TestFixture {
     CPPUNIT_TEST(testFindAllInconsistentlySplit5);
     CPPUNIT_TEST(testFindAllInconsistentlySplit6);
     CPPUNIT_TEST(testFindAllInconsistentBelow16Bits);
+    CPPUNIT_TEST(testFindAllAcrossStripes);
     CPPUNIT_TEST(testCreate);
     CPPUNIT_TEST(testCreate2);
     CPPUNIT_TEST(testCreate3);
@@ -1042,6 +1045,67 @@ LockableMapTest::testFindAllInconsistentBelow16Bits()
     CPPUNIT_ASSERT_EQUAL(A(3,4,5), *results[id3.stripUnused()]); // sub bucket
 }
 
+void
+LockableMapTest::testFindAllAcrossStripes()
+{
+    typedef LockableMap<JudyMultiMap<A> > Map;
+    Map map;
+
+    // Buckets using fewer bits than the map stripes on end up in a separate
+    // stripe from their sub buckets, which are spread over several stripes.
+    document::BucketId id1(1, 0x0); // contains id2-id5
+    document::BucketId id2(2, 0x2); // contains id4
+    document::BucketId id3(16, 0x1234);
+    document::BucketId id4(16, 0x5676);
+    document::BucketId id5(17, 0x1234);
+    document::BucketId id6(16, 0x1235);
+
+    bool preExisted;
+    map.insert(id1.stripUnused().toKey(), A(1,2,3), "foo", preExisted);
+    map.insert(id2.stripUnused().toKey(), A(2,3,4), "foo", preExisted);
+    map.insert(id3.stripUnused().toKey(), A(3,4,5), "foo", preExisted);
+    map.insert(id4.stripUnused().toKey(), A(4,5,6), "foo", preExisted);
+    map.insert(id5.stripUnused().toKey(), A(5,6,7), "foo", preExisted);
+    map.insert(id6.stripUnused().toKey(), A(6,7,8), "foo", preExisted);
+
+    {
+        std::map<document::BucketId, Map::WrappedEntry> results =
+            map.getAll(id1, "foo");
+
+        CPPUNIT_ASSERT_EQUAL(size_t(5), results.size());
+        CPPUNIT_ASSERT_EQUAL(A(1,2,3), *results[id1.stripUnused()]);
+        CPPUNIT_ASSERT_EQUAL(A(2,3,4), *results[id2.stripUnused()]);
+        CPPUNIT_ASSERT_EQUAL(A(3,4,5), *results[id3.stripUnused()]);
+        CPPUNIT_ASSERT_EQUAL(A(4,5,6), *results[id4.stripUnused()]);
+        CPPUNIT_ASSERT_EQUAL(A(5,6,7), *results[id5.stripUnused()]);
+    }
+    {
+        std::map<document::BucketId, Map::WrappedEntry> results =
+            map.getAll(id3, "foo", id6);
+
+        CPPUNIT_ASSERT_EQUAL(size_t(4), results.size());
+        CPPUNIT_ASSERT_EQUAL(A(1,2,3), *results[id1.stripUnused()]); // super bucket
+        CPPUNIT_ASSERT_EQUAL(A(3,4,5), *results[id3.stripUnused()]); // exact match
+        CPPUNIT_ASSERT_EQUAL(A(5,6,7), *results[id5.stripUnused()]); // sub bucket
+        CPPUNIT_ASSERT_EQUAL(A(6,7,8), *results[id6.stripUnused()]); // in another stripe
+    }
+
+    // Iteration visits the stripes in key order.
+    EntryProcessor proc;
+    map.all(proc, "foo");
+    std::ostringstream expected;
+    std::vector<document::BucketId> ids({id1, id2, id3, id4, id5, id6});
+    std::vector<document::BucketId::Type> keys;
+    for (const document::BucketId& id : ids) {
+        keys.push_back(id.stripUnused().toKey());
+    }
+    std::sort(keys.begin(), keys.end());
+    for (document::BucketId::Type key : keys) {
+        expected << key << " - " << *map.get(key, "foo") << "\n";
+    }
+    CPPUNIT_ASSERT_EQUAL(expected.str(), proc.toString());
+}
+
 void
 LockableMapTest::testCreate() {
 #if __WORDSIZE == 64
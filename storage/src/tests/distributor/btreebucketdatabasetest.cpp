@@ -0,0 +1,71 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/vdstestlib/cppunit/macros.h>
+#include <vespa/storage/bucketdb/btree_bucket_database.h>
+#include <tests/distributor/bucketdatabasetest.h>
+
+namespace storage {
+namespace distributor {
+
+struct BTreeBucketDatabaseTest : public BucketDatabaseTest {
+    BTreeBucketDatabase _db;
+    BucketDatabase& db() override { return _db; };
+
+    void testReadGuardSeesSnapshot();
+
+    CPPUNIT_TEST_SUITE(BTreeBucketDatabaseTest);
+    SETUP_DATABASE_TESTS();
+    CPPUNIT_TEST(testReadGuardSeesSnapshot);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BTreeBucketDatabaseTest);
+
+namespace {
+
+BucketInfo
+infoOnNode(uint16_t node, uint32_t checksum)
+{
+    BucketInfo info;
+    info.addNode(BucketCopy(0, node, api::BucketInfo(checksum, 1, 1)), toVector<uint16_t>(0));
+    return info;
+}
+
+struct Collector : public BucketDatabase::EntryProcessor {
+    std::vector<BucketDatabase::Entry> entries;
+    bool process(const BucketDatabase::Entry& e) override {
+        entries.push_back(e);
+        return true;
+    }
+};
+
+}
+
+void
+BTreeBucketDatabaseTest::testReadGuardSeesSnapshot()
+{
+    document::BucketId b1(16, 1);
+    document::BucketId b2(16, 2);
+    _db.update(BucketDatabase::Entry(b1, infoOnNode(0, 0x1)));
+    _db.update(BucketDatabase::Entry(b2, infoOnNode(1, 0x2)));
+
+    auto guard = _db.acquireReadGuard();
+    _db.update(BucketDatabase::Entry(b1, infoOnNode(2, 0x3)));
+    _db.remove(b2);
+    _db.update(BucketDatabase::Entry(document::BucketId(16, 3), infoOnNode(3, 0x4)));
+
+    CPPUNIT_ASSERT_EQUAL(uint64_t(2), guard.size());
+    CPPUNIT_ASSERT_EQUAL(infoOnNode(0, 0x1), guard.get(b1).getBucketInfo());
+    CPPUNIT_ASSERT_EQUAL(infoOnNode(1, 0x2), guard.get(b2).getBucketInfo());
+    CPPUNIT_ASSERT(!guard.get(document::BucketId(16, 3)).valid());
+
+    Collector collector;
+    guard.forEach(collector);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), collector.entries.size());
+
+    CPPUNIT_ASSERT_EQUAL(uint64_t(2), _db.size());
+    CPPUNIT_ASSERT_EQUAL(infoOnNode(2, 0x3), _db.get(b1).getBucketInfo());
+    CPPUNIT_ASSERT(!_db.get(b2).valid());
+}
+
+}
+}
@@ -66,6 +66,27 @@ BucketDatabaseTest::testUpdateGetAndRemove() {
     CPPUNIT_ASSERT_EQUAL(0, (int)db().size());
 }
 
+void
+BucketDatabaseTest::testApplyChanges() {
+    db().update(BucketDatabase::Entry(document::BucketId(16, 16), BI(1)));
+    db().update(BucketDatabase::Entry(document::BucketId(16, 11), BI(2)));
+    db().update(BucketDatabase::Entry(document::BucketId(16, 42), BI(3)));
+
+    std::vector<document::BucketId> removed;
+    removed.push_back(document::BucketId(16, 16));
+    removed.push_back(document::BucketId(16, 12));
+    std::vector<BucketDatabase::Entry> changed;
+    changed.push_back(BucketDatabase::Entry(document::BucketId(16, 11), BI(4)));
+    changed.push_back(BucketDatabase::Entry(document::BucketId(16, 13), BI(5)));
+    db().applyChanges(removed, changed);
+
+    CPPUNIT_ASSERT_EQUAL(3, (int)db().size());
+    CPPUNIT_ASSERT(!db().get(document::BucketId(16, 16)).valid());
+    CPPUNIT_ASSERT_EQUAL(BI(4), db().get(document::BucketId(16, 11)).getBucketInfo());
+    CPPUNIT_ASSERT_EQUAL(BI(5), db().get(document::BucketId(16, 13)).getBucketInfo());
+    CPPUNIT_ASSERT_EQUAL(BI(3), db().get(document::BucketId(16, 42)).getBucketInfo());
+}
+
 namespace {
 
 struct ModifyProcessor : public BucketDatabase::MutableEntryProcessor
@@ -9,6 +9,7 @@
 
 #define SETUP_DATABASE_TESTS() \
     CPPUNIT_TEST(testUpdateGetAndRemove); \
+    CPPUNIT_TEST(testApplyChanges); \
     CPPUNIT_TEST(testClear); \
     CPPUNIT_TEST(testIterating); \
     CPPUNIT_TEST(testFindParents); \
@@ -26,6 +27,7 @@ struct BucketDatabaseTest : public CppUnit::TestFixture {
     void setUp() override ;
 
     void testUpdateGetAndRemove();
+    void testApplyChanges();
     void testClear();
     void testIterating();
     void testFindParents();
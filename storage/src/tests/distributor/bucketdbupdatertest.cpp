@@ -11,6 +11,7 @@
 #include <vespa/storage/distributor/simpleclusterinformation.h>
 #include <vespa/storage/distributor/distributor.h>
 #include <vespa/vespalib/text/stringtokenizer.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
 
 using namespace storage::api;
 using namespace storage::lib;
@@ -77,6 +78,7 @@ class BucketDBUpdaterTest : public CppUnit::TestFixture,
     CPPUNIT_TEST(identity_update_of_diverging_untrusted_replicas_does_not_mark_any_as_trusted);
     CPPUNIT_TEST(adding_diverging_replica_to_existing_trusted_does_not_remove_trusted);
     CPPUNIT_TEST(batch_update_from_distributor_change_does_not_mark_diverging_replicas_as_trusted);
+    CPPUNIT_TEST(parallel_merge_gives_same_result_as_single_threaded_merge);
     CPPUNIT_TEST_SUITE_END();
 
 protected:
@@ -138,6 +140,7 @@ protected:
     void identity_update_of_diverging_untrusted_replicas_does_not_mark_any_as_trusted();
     void adding_diverging_replica_to_existing_trusted_does_not_remove_trusted();
     void batch_update_from_distributor_change_does_not_mark_diverging_replicas_as_trusted();
+    void parallel_merge_gives_same_result_as_single_threaded_merge();
 
     bool bucketExistsThatHasNode(int bucketCount, uint16_t node) const;
 
@@ -436,7 +439,8 @@ public:
             const std::string& existingData,
             const lib::ClusterState& newState,
             const std::string& newData,
-            bool includeBucketInfo = false);
+            bool includeBucketInfo = false,
+            vespalib::Executor* executor = nullptr);
 
     std::string mergeBucketLists(
             const std::string& existingData,
@@ -1785,7 +1789,8 @@ BucketDBUpdaterTest::mergeBucketLists(
         const std::string& existingData,
         const lib::ClusterState& newState,
         const std::string& newData,
-        bool includeBucketInfo)
+        bool includeBucketInfo,
+        vespalib::Executor* executor)
 {
     framework::defaultimplementation::FakeClock clock;
     framework::MilliSecTimer timer(clock);
@@ -1805,7 +1810,7 @@ BucketDBUpdaterTest::mergeBucketLists(
                         beforeTime));
 
         parseInputData(existingData, beforeTime, *state, includeBucketInfo);
-        state->mergeInto(getBucketDBUpdater().getDistributorComponent().getBucketDatabase());
+        state->mergeInto(getBucketDBUpdater().getDistributorComponent().getBucketDatabase(), executor);
     }
 
     BucketDumper dumper_tmp(true);
@@ -1825,7 +1830,7 @@ BucketDBUpdaterTest::mergeBucketLists(
 
         parseInputData(newData, afterTime, *state, includeBucketInfo);
         state->mergeInto(getBucketDBUpdater().getDistributorComponent()
-                .getBucketDatabase());
+                .getBucketDatabase(), executor);
     }
 
     BucketDumper dumper(includeBucketInfo);
@@ -2493,5 +2498,52 @@ void BucketDBUpdaterTest::batch_update_from_distributor_change_does_not_mark_div
                     "0:5/1/2/3|1:5/7/8/9", true));
 }
 
+namespace {
+
+// Bucket lists large enough to be merged in parallel when given an executor.
+// Each node has every bucket whose index is not divisible by (node + 2), and
+// the bucket info depends on the generation so that replicas get updated.
+std::string
+generateBucketLists(uint32_t numBuckets, uint32_t generation)
+{
+    std::ostringstream ost;
+    for (uint32_t node = 0; node < 3; ++node) {
+        if (node > 0) {
+            ost << "|";
+        }
+        ost << node << ":";
+        bool first = true;
+        for (uint32_t bucket = 1; bucket <= numBuckets; ++bucket) {
+            if ((bucket + generation) % (node + 2) == 0) {
+                continue;
+            }
+            if (!first) {
+                ost << ",";
+            }
+            first = false;
+            uint32_t checksum = ((bucket + generation * node) % 3) + 1;
+            ost << bucket << "/" << checksum << "/" << checksum << "/" << checksum;
+        }
+    }
+    return ost.str();
+}
+
+}
+
+void BucketDBUpdaterTest::parallel_merge_gives_same_result_as_single_threaded_merge() {
+    const std::string existingData(generateBucketLists(20000, 0));
+    const std::string newData(generateBucketLists(20000, 1));
+    // The distributor change marks all nodes as outdated, so buckets not in
+    // the new lists are removed.
+    lib::ClusterState oldState("distributor:2 storage:3");
+    lib::ClusterState newState("distributor:1 storage:3");
+
+    std::string expected(mergeBucketLists(oldState, existingData, newState, newData, true));
+    vespalib::ThreadStackExecutor executor(4, 64 * 1024);
+    std::string actual(mergeBucketLists(oldState, existingData, newState, newData, true, &executor));
+    CPPUNIT_ASSERT(!expected.empty());
+    CPPUNIT_ASSERT(expected == actual);
+}
+
 } // distributor
 } // storage
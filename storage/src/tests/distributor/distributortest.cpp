@@ -12,6 +12,8 @@
 #include <vespa/storage/config/config-stor-distributormanager.h>
 #include <tests/common/dummystoragelink.h>
 #include <vespa/storage/distributor/distributor.h>
+#include <vespa/storage/bucketdb/btree_bucket_database.h>
+#include <vespa/storage/bucketdb/mapbucketdatabase.h>
 #include <vespa/vespalib/text/stringtokenizer.h>
 
 namespace storage {
@@ -48,6 +50,10 @@ class Distributor_Test : public CppUnit::TestFixture,
     CPPUNIT_TEST(sequencing_config_is_propagated_to_distributor_config);
     CPPUNIT_TEST(merge_busy_inhibit_duration_config_is_propagated_to_distributor_config);
     CPPUNIT_TEST(merge_busy_inhibit_duration_is_propagated_to_pending_message_tracker);
+    CPPUNIT_TEST(map_bucket_database_is_used_by_default);
+    CPPUNIT_TEST(btree_bucket_database_can_be_enabled_in_config);
+    CPPUNIT_TEST(bucket_database_updates_work_with_btree_bucket_database);
+    CPPUNIT_TEST(bucket_info_merge_works_with_btree_bucket_database);
     CPPUNIT_TEST_SUITE_END();
 
 protected:
@@ -77,6 +83,10 @@ protected:
     void sequencing_config_is_propagated_to_distributor_config();
     void merge_busy_inhibit_duration_config_is_propagated_to_distributor_config();
     void merge_busy_inhibit_duration_is_propagated_to_pending_message_tracker();
+    void map_bucket_database_is_used_by_default();
+    void btree_bucket_database_can_be_enabled_in_config();
+    void bucket_database_updates_work_with_btree_bucket_database();
+    void bucket_info_merge_works_with_btree_bucket_database();
 
 public:
     void setUp() override {
@@ -116,6 +126,13 @@ private:
         return tmp;
     }
 
+    void enableBTreeBucketDatabase() {
+        close();
+        getDirConfig().getConfig("stor-distributormanager")
+                      .set("use_btree_bucket_database", "true");
+        setUp();
+    }
+
     void tickDistributorNTimes(uint32_t n) {
         for (uint32_t i = 0; i < n; ++i) {
             tick();
@@ -867,6 +884,37 @@ void Distributor_Test::merge_busy_inhibit_duration_is_propagated_to_pending_mess
     CPPUNIT_ASSERT(!node_info.isBusy(0));
 }
 
+void Distributor_Test::map_bucket_database_is_used_by_default() {
+    CPPUNIT_ASSERT(dynamic_cast<MapBucketDatabase*>(&getBucketDatabase()) != nullptr);
+}
+
+void Distributor_Test::btree_bucket_database_can_be_enabled_in_config() {
+    enableBTreeBucketDatabase();
+    CPPUNIT_ASSERT(dynamic_cast<BTreeBucketDatabase*>(&getBucketDatabase()) != nullptr);
+}
+
+void Distributor_Test::bucket_database_updates_work_with_btree_bucket_database() {
+    enableBTreeBucketDatabase();
+    testUpdateBucketDatabase();
+}
+
+void Distributor_Test::bucket_info_merge_works_with_btree_bucket_database() {
+    enableBTreeBucketDatabase();
+    setupDistributor(Redundancy(2), NodeCount(2),
+                     "bits:1 storage:1 distributor:2");
+
+    // Bucket info from a new cluster state is merged into the database
+    // through the same path as with the map based database.
+    sendDownClusterStateCommand();
+    replyToSingleRequestBucketInfoCommandWith1Bucket();
+
+    auto entry = getBucketDatabase().get(document::BucketId(1, 1));
+    CPPUNIT_ASSERT(entry.valid());
+    CPPUNIT_ASSERT_EQUAL(uint32_t(1), entry->getNodeCount());
+    CPPUNIT_ASSERT(entry->getNode(0) != nullptr);
+    CPPUNIT_ASSERT_EQUAL(uint32_t(10), entry->getNode(0)->getDocumentCount());
+}
+
 }
 
 }
@@ -134,6 +134,17 @@ PersistenceProviderWrapper::update(const spi::Bucket& bucket,
     return _spi.update(bucket, timestamp, upd, context);
 }
 
+spi::BatchResult
+PersistenceProviderWrapper::applyBatch(const spi::Bucket& bucket,
+                                       const std::vector<spi::BatchOperation>& ops,
+                                       spi::Context& context)
+{
+    LOG_SPI("applyBatch(" << bucket << ", " << ops.size() << " operations)");
+    // The default implementation applies each operation through this
+    // wrapper, so they are logged and can be failed one by one.
+    return spi::PersistenceProvider::applyBatch(bucket, ops, context);
+}
+
 spi::GetResult
 PersistenceProviderWrapper::get(const spi::Bucket& bucket,
                                 const document::FieldSet& fieldSet,
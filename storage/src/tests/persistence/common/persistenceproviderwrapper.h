@@ -93,6 +93,7 @@ public:
     spi::RemoveResult remove(const spi::Bucket&, spi::Timestamp, const spi::DocumentId&, spi::Context&) override;
     spi::RemoveResult removeIfFound(const spi::Bucket&, spi::Timestamp, const spi::DocumentId&, spi::Context&) override;
     spi::UpdateResult update(const spi::Bucket&, spi::Timestamp, const spi::DocumentUpdateSP&, spi::Context&) override;
+    spi::BatchResult applyBatch(const spi::Bucket&, const std::vector<spi::BatchOperation>&, spi::Context&) override;
     spi::GetResult get(const spi::Bucket&, const document::FieldSet&,
                        const spi::DocumentId&, spi::Context&) const override ;
 
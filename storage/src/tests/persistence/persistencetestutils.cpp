@@ -88,11 +88,18 @@ PersistenceTestUtils::setupDisks(uint32_t numDisks) {
 
 std::unique_ptr<PersistenceThread>
 PersistenceTestUtils::createPersistenceThread(uint32_t disk)
+{
+    return createPersistenceThread(disk, getPersistenceProvider());
+}
+
+std::unique_ptr<PersistenceThread>
+PersistenceTestUtils::createPersistenceThread(uint32_t disk,
+                                              spi::PersistenceProvider& provider)
 {
     return std::unique_ptr<PersistenceThread>(
             new PersistenceThread(_env->_node.getComponentRegister(),
                               _env->_config.getConfigId(),
-                              getPersistenceProvider(),
+                              provider,
                               getEnv()._fileStorHandler,
                               getEnv()._metrics,
                               disk,
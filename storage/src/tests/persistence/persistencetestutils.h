@@ -194,6 +194,8 @@ public:
      * Create a new persistence thread.
      */
     std::unique_ptr<PersistenceThread> createPersistenceThread(uint32_t disk);
+    std::unique_ptr<PersistenceThread> createPersistenceThread(
+            uint32_t disk, spi::PersistenceProvider& provider);
 
     /**
      * In-place modify doc so that it has no more body fields.
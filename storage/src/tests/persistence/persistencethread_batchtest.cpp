@@ -0,0 +1,223 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vdstestlib/cppunit/macros.h>
+#include <vespa/storage/persistence/persistencethread.h>
+#include <vespa/documentapi/messagebus/messages/testandsetcondition.h>
+#include <vespa/document/fieldvalue/intfieldvalue.h>
+#include <tests/persistence/common/persistenceproviderwrapper.h>
+#include <tests/persistence/persistencetestutils.h>
+
+namespace storage {
+
+struct PersistenceThread_BatchTest : public SingleDiskPersistenceTestUtils
+{
+    const document::BucketId BUCKET_ID{16, 4};
+
+    std::unique_ptr<PersistenceProviderWrapper> _spi;
+    std::unique_ptr<PersistenceThread> _thread;
+
+    void setUp() override;
+    void tearDown() override;
+
+    document::Document::SP createDocument(uint32_t seed);
+    std::shared_ptr<api::PutCommand> schedulePut(const document::Document::SP& doc,
+                                                 api::Timestamp timestamp);
+    void scheduleRemove(const document::DocumentId& id, api::Timestamp timestamp);
+    void scheduleUpdate(const document::DocumentId& id, api::Timestamp timestamp);
+    void processMessages();
+    size_t countOperations(const std::string& name) const;
+    std::vector<api::StorageReply::SP> getReplies();
+
+    void testMixedOperationsAreAppliedInOneBatch();
+    void testFailingOperationDoesNotFailRestOfBatch();
+    void testTestAndSetOperationSplitsBatch();
+    void testRepliesShareBucketInfoOfBatch();
+
+    CPPUNIT_TEST_SUITE(PersistenceThread_BatchTest);
+    CPPUNIT_TEST(testMixedOperationsAreAppliedInOneBatch);
+    CPPUNIT_TEST(testFailingOperationDoesNotFailRestOfBatch);
+    CPPUNIT_TEST(testTestAndSetOperationSplitsBatch);
+    CPPUNIT_TEST(testRepliesShareBucketInfoOfBatch);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PersistenceThread_BatchTest);
+
+void
+PersistenceThread_BatchTest::setUp()
+{
+    SingleDiskPersistenceTestUtils::setUp();
+    spi::Context context(spi::LoadType(0, "default"), spi::Priority(0),
+                         spi::Trace::TraceLevel(0));
+    createBucket(BUCKET_ID);
+    getPersistenceProvider().createBucket(
+            spi::Bucket(BUCKET_ID, spi::PartitionId(0)), context);
+    _spi.reset(new PersistenceProviderWrapper(getPersistenceProvider()));
+    _thread = createPersistenceThread(0, *_spi);
+}
+
+void
+PersistenceThread_BatchTest::tearDown()
+{
+    _thread.reset();
+    _spi.reset();
+    SingleDiskPersistenceTestUtils::tearDown();
+}
+
+document::Document::SP
+PersistenceThread_BatchTest::createDocument(uint32_t seed)
+{
+    return document::Document::SP(
+            createRandomDocumentAtLocation(BUCKET_ID.getId(), seed, 0, 128));
+}
+
+std::shared_ptr<api::PutCommand>
+PersistenceThread_BatchTest::schedulePut(const document::Document::SP& doc,
+                                         api::Timestamp timestamp)
+{
+    auto cmd = std::make_shared<api::PutCommand>(BUCKET_ID, doc, timestamp);
+    fsHandler().schedule(cmd, 0);
+    return cmd;
+}
+
+void
+PersistenceThread_BatchTest::scheduleRemove(const document::DocumentId& id,
+                                            api::Timestamp timestamp)
+{
+    fsHandler().schedule(
+            std::make_shared<api::RemoveCommand>(BUCKET_ID, id, timestamp), 0);
+}
+
+void
+PersistenceThread_BatchTest::scheduleUpdate(const document::DocumentId& id,
+                                            api::Timestamp timestamp)
+{
+    fsHandler().schedule(
+            std::make_shared<api::UpdateCommand>(
+                    BUCKET_ID,
+                    createHeaderUpdate(id, document::IntFieldValue(42)),
+                    timestamp), 0);
+}
+
+void
+PersistenceThread_BatchTest::processMessages()
+{
+    FileStorHandler::LockedMessage lock(fsHandler().getNextMessage(0, 255));
+    CPPUNIT_ASSERT(lock.first.get());
+    _thread->processMessages(lock);
+}
+
+size_t
+PersistenceThread_BatchTest::countOperations(const std::string& name) const
+{
+    size_t count = 0;
+    for (const std::string& entry : _spi->getOperationLog()) {
+        if (entry.compare(0, name.size() + 1, name + "(") == 0) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+std::vector<api::StorageReply::SP>
+PersistenceThread_BatchTest::getReplies()
+{
+    std::vector<api::StorageReply::SP> replies;
+    for (const auto& msg : messageKeeper()._msgs) {
+        replies.push_back(std::dynamic_pointer_cast<api::StorageReply>(msg));
+        CPPUNIT_ASSERT(replies.back().get());
+    }
+    return replies;
+}
+
+void
+PersistenceThread_BatchTest::testMixedOperationsAreAppliedInOneBatch()
+{
+    document::Document::SP doc1(createDocument(1));
+    document::Document::SP doc2(createDocument(2));
+    schedulePut(doc1, 1);
+    schedulePut(doc2, 2);
+    scheduleRemove(doc1->getId(), 3);
+    scheduleUpdate(doc2->getId(), 4);
+    processMessages();
+
+    CPPUNIT_ASSERT_EQUAL(size_t(1), countOperations("applyBatch"));
+    CPPUNIT_ASSERT_EQUAL(size_t(2), countOperations("put"));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), countOperations("removeIfFound"));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), countOperations("update"));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), countOperations("flush"));
+
+    std::vector<api::StorageReply::SP> replies(getReplies());
+    CPPUNIT_ASSERT_EQUAL(size_t(4), replies.size());
+    for (const auto& reply : replies) {
+        CPPUNIT_ASSERT_EQUAL(api::ReturnCode::OK, reply->getResult().getResult());
+    }
+    auto& removeReply(dynamic_cast<api::RemoveReply&>(*replies[2]));
+    CPPUNIT_ASSERT_EQUAL(api::Timestamp(1), removeReply.getOldTimestamp());
+    auto& updateReply(dynamic_cast<api::UpdateReply&>(*replies[3]));
+    CPPUNIT_ASSERT_EQUAL(api::Timestamp(2), updateReply.getOldTimestamp());
+}
+
+void
+PersistenceThread_BatchTest::testFailingOperationDoesNotFailRestOfBatch()
+{
+    document::Document::SP doc1(createDocument(1));
+    document::Document::SP doc2(createDocument(2));
+    schedulePut(doc1, 1);
+    scheduleUpdate(doc1->getId(), 2);
+    schedulePut(doc2, 3);
+    _spi->setResult(spi::Result(spi::Result::TRANSIENT_ERROR, "update failed"));
+    _spi->setFailureMask(PersistenceProviderWrapper::FAIL_UPDATE);
+    processMessages();
+
+    CPPUNIT_ASSERT_EQUAL(size_t(1), countOperations("applyBatch"));
+    std::vector<api::StorageReply::SP> replies(getReplies());
+    CPPUNIT_ASSERT_EQUAL(size_t(3), replies.size());
+    CPPUNIT_ASSERT(replies[0]->getResult().success());
+    CPPUNIT_ASSERT(!replies[1]->getResult().success());
+    CPPUNIT_ASSERT(replies[2]->getResult().success());
+    CPPUNIT_ASSERT(doGet(BUCKET_ID, doc1->getId(), false).hasDocument());
+    CPPUNIT_ASSERT(doGet(BUCKET_ID, doc2->getId(), false).hasDocument());
+}
+
+void
+PersistenceThread_BatchTest::testTestAndSetOperationSplitsBatch()
+{
+    document::Document::SP doc1(createDocument(1));
+    document::Document::SP doc2(createDocument(2));
+    schedulePut(doc1, 1);
+    // The condition only matches if the put before it has been applied.
+    schedulePut(doc1, 2)->setCondition(
+            documentapi::TestAndSetCondition("testdoctype1"));
+    schedulePut(doc2, 3);
+    processMessages();
+
+    CPPUNIT_ASSERT_EQUAL(size_t(2), countOperations("applyBatch"));
+    CPPUNIT_ASSERT_EQUAL(size_t(3), countOperations("put"));
+    std::vector<api::StorageReply::SP> replies(getReplies());
+    CPPUNIT_ASSERT_EQUAL(size_t(3), replies.size());
+    for (const auto& reply : replies) {
+        CPPUNIT_ASSERT_EQUAL(api::ReturnCode::OK, reply->getResult().getResult());
+    }
+}
+
+void
+PersistenceThread_BatchTest::testRepliesShareBucketInfoOfBatch()
+{
+    schedulePut(createDocument(1), 1);
+    schedulePut(createDocument(2), 2);
+    schedulePut(createDocument(3), 3);
+    processMessages();
+
+    CPPUNIT_ASSERT_EQUAL(size_t(1), countOperations("applyBatch"));
+    api::BucketInfo info(getBucket(BUCKET_ID)->getBucketInfo());
+    CPPUNIT_ASSERT_EQUAL(uint32_t(3), info.getDocumentCount());
+    std::vector<api::StorageReply::SP> replies(getReplies());
+    CPPUNIT_ASSERT_EQUAL(size_t(3), replies.size());
+    for (const auto& reply : replies) {
+        CPPUNIT_ASSERT_EQUAL(
+                info, dynamic_cast<api::BucketInfoReply&>(*reply).getBucketInfo());
+    }
+}
+
+} // storage
@@ -0,0 +1,435 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "btree_bucket_database.h"
+#include <vespa/searchlib/btree/btreenode.hpp>
+#include <vespa/searchlib/btree/btreenodeallocator.hpp>
+#include <vespa/searchlib/btree/btreenodestore.hpp>
+#include <vespa/searchlib/btree/btreeiterator.hpp>
+#include <vespa/searchlib/btree/btreeroot.hpp>
+#include <vespa/searchlib/btree/btree.hpp>
+#include <vespa/searchlib/datastore/array_store.hpp>
+#include <ostream>
+
+using document::BucketId;
+using search::datastore::ArrayStoreConfig;
+using search::datastore::EntryRef;
+
+namespace storage {
+
+namespace {
+
+constexpr size_t HUGE_MEMORY_PAGE_SIZE = 2 * 1024 * 1024;
+constexpr size_t SMALL_MEMORY_PAGE_SIZE = 4 * 1024;
+constexpr size_t MIN_NUM_ARRAYS_FOR_NEW_BUFFER = 8 * 1024;
+// Buckets rarely have more replicas than this, larger arrays are heap allocated.
+constexpr size_t MAX_SMALL_ARRAY_SIZE = 8;
+
+ArrayStoreConfig
+makeStoreConfig()
+{
+    return BTreeBucketDatabase::ReplicaStore::optimizedConfigForHugePage(MAX_SMALL_ARRAY_SIZE,
+                                                                         HUGE_MEMORY_PAGE_SIZE,
+                                                                         SMALL_MEMORY_PAGE_SIZE,
+                                                                         MIN_NUM_ARRAYS_FOR_NEW_BUFFER);
+}
+
+EntryRef refFromValue(uint64_t value) { return EntryRef(value & 0xffffffffu); }
+uint32_t gcTimeFromValue(uint64_t value) { return value >> 32; }
+
+BucketId
+bucketFromKey(uint64_t key)
+{
+    return BucketId(BucketId::keyToBucketId(key));
+}
+
+/**
+ * Returns the number of lowest bits that the two buckets have in common.
+ * Only meaningful when neither bucket contains the other.
+ */
+uint32_t
+commonBits(const BucketId& a, const BucketId& b)
+{
+    return __builtin_ctzll(a.withoutCountBits() ^ b.withoutCountBits());
+}
+
+/**
+ * Calls func for each bucket in the view that contains the given bucket,
+ * including the bucket itself, in increasing order of used bits.
+ *
+ * The parents of a bucket are ordered before it in key order. Any other
+ * bucket found before it differs from it in one of the lowest bits, and
+ * no parent can exist between that bucket and the parent using one more
+ * bit than the common bits, so we seek directly to that parent.
+ */
+template <typename View, typename Func>
+void
+findParents(const View& view, const BucketId& bucket, Func func)
+{
+    const uint64_t bucketKey = bucket.toKey();
+    auto iter = view.begin();
+    while (iter.valid() && iter.getKey() <= bucketKey) {
+        BucketId candidate = bucketFromKey(iter.getKey());
+        uint32_t nextBits;
+        if (candidate.contains(bucket)) {
+            func(iter.getKey(), iter.getData());
+            nextBits = candidate.getUsedBits() + 1;
+        } else {
+            nextBits = commonBits(candidate, bucket) + 1;
+        }
+        if (nextBits > bucket.getUsedBits()) {
+            break;
+        }
+        iter = view.lowerBound(BucketId(nextBits, bucket.getRawId()).toKey());
+    }
+}
+
+template <typename View, typename Func>
+void
+forEachAfter(const View& view, const BucketId& after, Func func)
+{
+    for (auto iter = view.upperBound(after.toKey()); iter.valid(); ++iter) {
+        if (!func(iter.getKey(), iter.getData())) {
+            break;
+        }
+    }
+}
+
+struct Writer : public BucketDatabase::EntryProcessor {
+    std::ostream& _ost;
+    Writer(std::ostream& ost) : _ost(ost) {}
+    bool process(const BucketDatabase::Entry& e) override {
+        _ost << e.toString() << "\n";
+        return true;
+    }
+};
+
+}
+
+BTreeBucketDatabase::ReadGuard::ReadGuard(const BTreeBucketDatabase& db)
+    : _guard(db._generationHandler.takeGuard()),
+      _db(db),
+      _frozenView(db._tree.getFrozenView())
+{
+}
+
+BTreeBucketDatabase::ReadGuard::ReadGuard(ReadGuard&& rhs) = default;
+
+BTreeBucketDatabase::ReadGuard::~ReadGuard() = default;
+
+BucketDatabase::Entry
+BTreeBucketDatabase::ReadGuard::get(const BucketId& bucket) const
+{
+    const uint64_t key = bucket.toKey();
+    auto iter = _frozenView.find(key);
+    if (!iter.valid()) {
+        return Entry::createInvalid();
+    }
+    return _db.entryFromValue(key, iter.getData());
+}
+
+void
+BTreeBucketDatabase::ReadGuard::getParents(const BucketId& childBucket,
+                                           std::vector<Entry>& entries) const
+{
+    findParents(_frozenView, childBucket, [this, &entries](uint64_t key, uint64_t value) {
+        entries.push_back(_db.entryFromValue(key, value));
+    });
+}
+
+void
+BTreeBucketDatabase::ReadGuard::forEach(EntryProcessor& processor, const BucketId& after) const
+{
+    forEachAfter(_frozenView, after, [this, &processor](uint64_t key, uint64_t value) {
+        return processor.process(_db.entryFromValue(key, value));
+    });
+}
+
+uint64_t
+BTreeBucketDatabase::ReadGuard::size() const
+{
+    return _frozenView.size();
+}
+
+BTreeBucketDatabase::BTreeBucketDatabase()
+    : _tree(),
+      _store(makeStoreConfig()),
+      _generationHandler()
+{
+}
+
+BTreeBucketDatabase::~BTreeBucketDatabase()
+{
+    // No readers remain, so all held nodes and arrays are freed at once.
+    clear();
+}
+
+BucketDatabase::Entry
+BTreeBucketDatabase::entryFromValue(uint64_t key, uint64_t value) const
+{
+    auto replicas = _store.get(refFromValue(value));
+    return Entry(bucketFromKey(key),
+                 BucketInfo(gcTimeFromValue(value),
+                            std::vector<BucketCopy>(replicas.cbegin(), replicas.cend())));
+}
+
+uint64_t
+BTreeBucketDatabase::valueFromEntry(const Entry& entry)
+{
+    const auto& replicas = entry.getBucketInfo().getRawNodes();
+    EntryRef ref;
+    if (!replicas.empty()) {
+        ref = _store.add(ReplicaStore::ConstArrayRef(&replicas[0], replicas.size()));
+    }
+    return (static_cast<uint64_t>(entry.getBucketInfo().getLastGarbageCollectionTime()) << 32) | ref.ref();
+}
+
+void
+BTreeBucketDatabase::removeReplicas(uint64_t value)
+{
+    EntryRef ref = refFromValue(value);
+    if (ref.valid()) {
+        _store.remove(ref);
+    }
+}
+
+void
+BTreeBucketDatabase::commitTreeChanges()
+{
+    _tree.getAllocator().freeze();
+    auto currentGeneration = _generationHandler.getCurrentGeneration();
+    _tree.getAllocator().transferHoldLists(currentGeneration);
+    _store.transferHoldLists(currentGeneration);
+    _generationHandler.incGeneration();
+    auto firstUsed = _generationHandler.getFirstUsedGeneration();
+    _tree.getAllocator().trimHoldLists(firstUsed);
+    _store.trimHoldLists(firstUsed);
+}
+
+BucketDatabase::Entry
+BTreeBucketDatabase::get(const BucketId& bucket) const
+{
+    const uint64_t key = bucket.toKey();
+    auto iter = _tree.find(key);
+    if (!iter.valid()) {
+        return Entry::createInvalid();
+    }
+    return entryFromValue(key, iter.getData());
+}
+
+void
+BTreeBucketDatabase::removeEntry(const BucketId& bucket)
+{
+    auto iter = _tree.find(bucket.toKey());
+    if (!iter.valid()) {
+        return;
+    }
+    removeReplicas(iter.getData());
+    _tree.remove(iter);
+}
+
+void
+BTreeBucketDatabase::remove(const BucketId& bucket)
+{
+    removeEntry(bucket);
+    commitTreeChanges();
+}
+
+void
+BTreeBucketDatabase::getParents(const BucketId& childBucket,
+                                std::vector<Entry>& entries) const
+{
+    findParents(_tree, childBucket, [this, &entries](uint64_t key, uint64_t value) {
+        entries.push_back(entryFromValue(key, value));
+    });
+}
+
+void
+BTreeBucketDatabase::getAll(const BucketId& bucket,
+                            std::vector<Entry>& entries) const
+{
+    getParents(bucket, entries);
+    // The buckets contained in the given bucket directly follow it in key order.
+    for (auto iter = _tree.upperBound(bucket.toKey()); iter.valid(); ++iter) {
+        if (!bucket.contains(bucketFromKey(iter.getKey()))) {
+            break;
+        }
+        entries.push_back(entryFromValue(iter.getKey(), iter.getData()));
+    }
+}
+
+void
+BTreeBucketDatabase::updateEntry(const Entry& newEntry)
+{
+    const uint64_t key = newEntry.getBucketId().toKey();
+    uint64_t value = valueFromEntry(newEntry);
+    auto iter = _tree.lowerBound(key);
+    if (iter.valid() && iter.getKey() == key) {
+        removeReplicas(iter.getData());
+        _tree.thaw(iter);
+        iter.writeData(value);
+    } else {
+        _tree.insert(iter, key, value);
+    }
+}
+
+void
+BTreeBucketDatabase::update(const Entry& newEntry)
+{
+    updateEntry(newEntry);
+    commitTreeChanges();
+}
+
+void
+BTreeBucketDatabase::applyChanges(const std::vector<BucketId>& removedBuckets,
+                                  const std::vector<Entry>& changedEntries)
+{
+    for (const BucketId& bucket : removedBuckets) {
+        removeEntry(bucket);
+    }
+    for (const Entry& entry : changedEntries) {
+        updateEntry(entry);
+    }
+    // Readers see either none or all of the changes.
+    commitTreeChanges();
+}
+
+void
+BTreeBucketDatabase::forEach(EntryProcessor& processor, const BucketId& after) const
+{
+    forEachAfter(_tree, after, [this, &processor](uint64_t key, uint64_t value) {
+        return processor.process(entryFromValue(key, value));
+    });
+}
+
+void
+BTreeBucketDatabase::forEach(MutableEntryProcessor& processor, const BucketId& after)
+{
+    for (auto iter = _tree.upperBound(after.toKey()); iter.valid(); ++iter) {
+        Entry entry = entryFromValue(iter.getKey(), iter.getData());
+        bool proceed = processor.process(entry);
+        // Only store the entry again if the processor changed it.
+        const auto& replicas = entry.getBucketInfo().getRawNodes();
+        auto oldReplicas = _store.get(refFromValue(iter.getData()));
+        bool changed = (entry.getBucketInfo().getLastGarbageCollectionTime() != gcTimeFromValue(iter.getData()))
+                       || (replicas.size() != oldReplicas.size());
+        for (size_t i = 0; !changed && i < replicas.size(); ++i) {
+            changed = !(replicas[i] == oldReplicas[i])
+                      || (replicas[i].getNode() != oldReplicas[i].getNode())
+                      || (replicas[i].getTimestamp() != oldReplicas[i].getTimestamp());
+        }
+        if (changed) {
+            removeReplicas(iter.getData());
+            _tree.thaw(iter);
+            iter.writeData(valueFromEntry(entry));
+        }
+        if (!proceed) {
+            break;
+        }
+    }
+    commitTreeChanges();
+}
+
+uint64_t
+BTreeBucketDatabase::size() const
+{
+    return _tree.size();
+}
+
+void
+BTreeBucketDatabase::clear()
+{
+    for (auto iter = _tree.begin(); iter.valid(); ++iter) {
+        removeReplicas(iter.getData());
+    }
+    _tree.clear();
+    commitTreeChanges();
+}
+
+uint32_t
+BTreeBucketDatabase::childCount(const BucketId& bucket) const
+{
+    const uint32_t usedBits = bucket.getUsedBits();
+    if (usedBits >= BucketId::maxNumBits) {
+        return 0;
+    }
+    uint32_t count = 0;
+    for (uint64_t bit : {uint64_t(0), uint64_t(1)}) {
+        BucketId child(usedBits + 1, bucket.withoutCountBits() | (bit << usedBits));
+        // Any bucket in the subtree of the child directly follows the child in key order.
+        auto iter = _tree.lowerBound(child.toKey());
+        if (iter.valid() && child.contains(bucketFromKey(iter.getKey()))) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+BucketDatabase::Entry
+BTreeBucketDatabase::upperBound(const BucketId& value) const
+{
+    auto iter = _tree.upperBound(value.toKey());
+    if (!iter.valid()) {
+        return Entry::createInvalid();
+    }
+    return entryFromValue(iter.getKey(), iter.getData());
+}
+
+/**
+ * The highest split bit is one more than the deepest level where another
+ * bucket diverges from the path to the given bucket. The closest such
+ * buckets in key order are the one just before the given bucket and its
+ * parents, and the one just after its own subtree.
+ */
+BucketId
+BTreeBucketDatabase::getAppropriateBucket(uint16_t minBits, const BucketId& bid)
+{
+    const uint64_t key = bid.toKey();
+    const uint32_t usedBits = bid.getUsedBits();
+    uint32_t bits = minBits;
+    auto iter = _tree.lowerBound(key);
+    auto before = iter;
+    for (--before; before.valid(); --before) {
+        BucketId candidate = bucketFromKey(before.getKey());
+        if (!candidate.contains(bid)) {
+            bits = std::max(bits, commonBits(candidate, bid) + 1);
+            break;
+        }
+    }
+    bool haveAfter = iter.valid();
+    if (haveAfter && bid.contains(bucketFromKey(iter.getKey()))) {
+        // Skip the subtree of the given bucket, which covers all keys with the same prefix.
+        uint64_t prefix = (usedBits > 0) ? (key >> (64 - usedBits)) : 0;
+        haveAfter = (usedBits > 0) && (prefix + 1 < (uint64_t(1) << usedBits));
+        if (haveAfter) {
+            iter = _tree.lowerBound((prefix + 1) << (64 - usedBits));
+            haveAfter = iter.valid();
+        }
+    }
+    if (haveAfter) {
+        bits = std::max(bits, commonBits(bucketFromKey(iter.getKey()), bid) + 1);
+    }
+    return BucketId(bits, bid.getRawId());
+}
+
+search::MemoryUsage
+BTreeBucketDatabase::getMemoryUsage() const
+{
+    search::MemoryUsage usage = _tree.getMemoryUsage();
+    usage.merge(_store.getMemoryUsage());
+    return usage;
+}
+
+void
+BTreeBucketDatabase::print(std::ostream& out, bool verbose,
+                           const std::string& indent) const
+{
+    (void) indent;
+    if (verbose) {
+        Writer writer(out);
+        forEach(writer);
+    } else {
+        out << "Size(" << size() << ")";
+    }
+}
+
+}
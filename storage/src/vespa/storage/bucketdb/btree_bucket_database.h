@@ -0,0 +1,93 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "bucketdatabase.h"
+#include <vespa/searchlib/btree/btree.h>
+#include <vespa/searchlib/datastore/array_store.h>
+#include <vespa/vespalib/util/generationhandler.h>
+
+namespace storage {
+
+/**
+ * Bucket database implementation built around a B-tree keyed on the bucket
+ * key (i.e. the bit-reversed bucket id), which gives the same iteration order
+ * as MapBucketDatabase. The replicas of a bucket are kept in an array store,
+ * referenced from the tree value together with the last garbage collection
+ * time.
+ *
+ * All changes must be done by a single writer thread, which is the
+ * distributor thread. Tree nodes and replica arrays are never changed in
+ * place while they may be visible to readers; replaced ones are put on hold
+ * until no reader can see them any more. This means that other threads can
+ * take a read guard and scan a consistent snapshot of the database without
+ * blocking the writer.
+ */
+class BTreeBucketDatabase : public BucketDatabase
+{
+public:
+    using ReplicaStore = search::datastore::ArrayStore<BucketCopy>;
+    // Bucket key -> last GC time in the upper 32 bits, replica array ref in the lower 32 bits.
+    using BTree = search::btree::BTree<uint64_t, uint64_t>;
+
+    /**
+     * Read-only snapshot of the database as of when the guard was taken.
+     * Any thread may use it, and it stays valid until the guard is destroyed.
+     */
+    class ReadGuard {
+        vespalib::GenerationHandler::Guard _guard;
+        const BTreeBucketDatabase &_db;
+        BTree::FrozenView _frozenView;
+    public:
+        ReadGuard(const BTreeBucketDatabase &db);
+        ReadGuard(ReadGuard &&rhs);
+        ~ReadGuard();
+
+        Entry get(const document::BucketId& bucket) const;
+        void getParents(const document::BucketId& childBucket, std::vector<Entry>& entries) const;
+        void forEach(EntryProcessor&, const document::BucketId& after = document::BucketId()) const;
+        uint64_t size() const;
+    };
+
+    BTreeBucketDatabase();
+    ~BTreeBucketDatabase();
+
+    Entry get(const document::BucketId& bucket) const override;
+    void remove(const document::BucketId& bucket) override;
+    void getParents(const document::BucketId& childBucket, std::vector<Entry>& entries) const override;
+    void getAll(const document::BucketId& bucket, std::vector<Entry>& entries) const override;
+    void update(const Entry& newEntry) override;
+    void applyChanges(const std::vector<document::BucketId>& removedBuckets,
+                      const std::vector<Entry>& changedEntries) override;
+    void forEach(EntryProcessor&, const document::BucketId& after = document::BucketId()) const override;
+    void forEach(MutableEntryProcessor&, const document::BucketId& after = document::BucketId()) override;
+    uint64_t size() const override;
+    void clear() override;
+
+    uint32_t childCount(const document::BucketId&) const override;
+    Entry upperBound(const document::BucketId& value) const override;
+
+    document::BucketId getAppropriateBucket(uint16_t minBits, const document::BucketId& bid) override;
+    void print(std::ostream& out, bool verbose, const std::string& indent) const override;
+
+    /**
+     * Takes a read guard on the current state of the database. Changes done
+     * after this are not visible through the guard.
+     */
+    ReadGuard acquireReadGuard() const { return ReadGuard(*this); }
+
+    search::MemoryUsage getMemoryUsage() const;
+
+private:
+    BTree _tree;
+    ReplicaStore _store;
+    vespalib::GenerationHandler _generationHandler;
+
+    Entry entryFromValue(uint64_t key, uint64_t value) const;
+    uint64_t valueFromEntry(const Entry& entry);
+    void removeReplicas(uint64_t value);
+    void removeEntry(const document::BucketId& bucket);
+    void updateEntry(const Entry& newEntry);
+    void commitTreeChanges();
+};
+
+}
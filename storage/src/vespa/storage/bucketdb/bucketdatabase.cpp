@@ -21,6 +21,18 @@ BucketDatabase::getNext(const document::BucketId& last) const
     return upperBound(last);
 }
 
+void
+BucketDatabase::applyChanges(const std::vector<document::BucketId>& removedBuckets,
+                             const std::vector<Entry>& changedEntries)
+{
+    for (const document::BucketId& bucketId : removedBuckets) {
+        remove(bucketId);
+    }
+    for (const Entry& e : changedEntries) {
+        update(e);
+    }
+}
+
 BucketDatabase::Entry
 BucketDatabase::createAppropriateBucket(
         uint16_t minBits, const document::BucketId& bid)
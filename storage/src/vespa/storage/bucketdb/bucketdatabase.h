@@ -73,6 +73,15 @@ public:
      */
     virtual void update(const Entry& newEntry) = 0;
 
+    /**
+     * Removes the given buckets and then updates the given entries, with
+     * the same result as calling remove() and update() for each of them.
+     * Implementations may make all the changes visible at once, which is
+     * cheaper than doing so for every single change.
+     */
+    virtual void applyChanges(const std::vector<document::BucketId>& removedBuckets,
+                              const std::vector<Entry>& changedEntries);
+
     virtual void forEach(
             EntryProcessor&,
             const document::BucketId& after = document::BucketId()) const = 0;
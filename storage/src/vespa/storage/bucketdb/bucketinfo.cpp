@@ -9,6 +9,11 @@ BucketInfo::BucketInfo()
     : _lastGarbageCollection(0)
 { }
 
+BucketInfo::BucketInfo(uint32_t lastGarbageCollection, std::vector<BucketCopy> nodes)
+    : _lastGarbageCollection(lastGarbageCollection),
+      _nodes(std::move(nodes))
+{ }
+
 BucketInfo::~BucketInfo() { }
 
 std::string
@@ -17,20 +17,6 @@ getMinDiffBits(uint16_t minBits, const document::BucketId& a, const document::Bu
     return minBits;
 }
 
-bool
-checkContains(document::BucketId::Type key, const document::BucketId& bucket,
-              document::BucketId& result, document::BucketId::Type& keyResult)
-{
-    document::BucketId id = document::BucketId(document::BucketId::keyToBucketId(key));
-    if (id.contains(bucket)) {
-        result = id;
-        keyResult = key;
-        return true;
-    }
-
-    return false;
-}
-
 using bucketdb::StorageBucketInfo;
 
 template class LockableMap<storage::JudyMultiMap<StorageBucketInfo, StorageBucketInfo, StorageBucketInfo, StorageBucketInfo> >;
@@ -11,10 +11,15 @@
  *     wrapper copy dies.
  *   - Built in function for iterating taking a functor. Halts when
  *     encountering locked values.
+ *   - The entries are split into stripes on the bucket bits, each with
+ *     its own mutex, so that users of different buckets rarely contend.
  */
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <map>
+#include <memory>
 #include <vespa/vespalib/util/printable.h>
 #include <vespa/vespalib/util/sync.h>
 #include <vespa/vespalib/stllike/hash_map.h>
@@ -139,6 +144,10 @@ public:
 
     enum Decision { ABORT, UPDATE, REMOVE, CONTINUE, DECISION_COUNT };
 
+    /**
+     * Calls the functor for the entries in key order, locking each entry
+     * while it is processed. No mutex is held during the functor call.
+     */
     template<typename Functor>
     void each(Functor& functor, const char* clientId,
               const key_type& first = key_type(),
@@ -149,6 +158,12 @@ public:
               const key_type& first = key_type(),
               const key_type& last = key_type() - 1 );
 
+    /**
+     * Calls the functor for the entries in key order while holding the mutex
+     * of the stripe the entry belongs to. The stripe is only released when
+     * the iteration moves on to another stripe, so the map is never locked
+     * as a whole.
+     */
     template<typename Functor>
     void all(Functor& functor, const char* clientId,
              const key_type& first = key_type(),
@@ -162,8 +177,8 @@ public:
     static constexpr uint32_t DEFAULT_CHUNK_SIZE = 10000;
 
     /**
-     * Iterate over the entire database contents, holding the global database
-     * mutex for `chunkSize` processed entries at a time, yielding the current
+     * Iterate over the entire database contents, holding the database
+     * mutexes for `chunkSize` processed entries at a time, yielding the current
      * thread between each such such to allow other threads to get a chance
      * at acquiring a bucket lock.
      */
@@ -237,19 +252,92 @@ private:
         WaiterMap _map;
     };
 
-    Map               _map;
-    vespalib::Monitor _lock;
-    LockIdSet         _lockedKeys;
-    LockWaiters       _lockWaiters;
+    /**
+     * The keys are spread over stripes, each with its own map, mutex and key
+     * locks. Keys of buckets using at least STRIPE_BITS bits go to the stripe
+     * given by their lowest STRIPE_BITS bits (the top bits of the key), so
+     * such a bucket shares stripe with all its sub buckets and with its super
+     * buckets using at least STRIPE_BITS bits. The few keys using fewer bits
+     * go to the shallow stripe.
+     *
+     * Stripes are always locked in index order. Keys are only added to the
+     * shallow stripe while holding the locks of all stripes, so anyone holding
+     * the lock of a stripe can trust _shallowSize to tell whether the shallow
+     * stripe must be locked and searched for super buckets.
+     */
+    static constexpr uint32_t STRIPE_BITS = 4;
+    static constexpr size_t NUM_DEEP_STRIPES = size_t(1) << STRIPE_BITS;
+    static constexpr size_t SHALLOW_STRIPE = NUM_DEEP_STRIPES;
+    static constexpr size_t NUM_STRIPES = NUM_DEEP_STRIPES + 1;
+
+    struct Stripe {
+        Map               _map;
+        vespalib::Monitor _lock;
+        LockIdSet         _lockedKeys;
+        LockWaiters       _lockWaiters;
+
+        Stripe();
+        ~Stripe();
+    };
+
+    /**
+     * Holds the locks of a set of stripes, which must be locked in index order.
+     */
+    class StripeGuards {
+    public:
+        explicit StripeGuards(const LockableMap& map);
+        ~StripeGuards();
+        void lock(size_t stripe);
+        void lockAll();
+        /** Releases all other stripes, and locks the given one if not already held. */
+        void lockOnly(size_t stripe);
+        void unlock(size_t stripe) { _guards[stripe].reset(); }
+        void unlockAll();
+        bool holds(size_t stripe) const { return bool(_guards[stripe]); }
+        vespalib::MonitorGuard& operator[](size_t stripe) { return *_guards[stripe]; }
+    private:
+        const LockableMap& _map;
+        std::array<std::unique_ptr<vespalib::MonitorGuard>, NUM_STRIPES> _guards;
+    };
+
+    std::array<Stripe, NUM_STRIPES> _stripes;
+    std::atomic<size_t>             _shallowSize;
+
+    static size_t stripeOf(key_type key) {
+        return ((key & ((key_type(1) << BucketId::CountBits) - 1)) >= STRIPE_BITS)
+                ? size_t(key >> (8 * sizeof(key_type) - STRIPE_BITS))
+                : SHALLOW_STRIPE;
+    }
+    Stripe& stripeFor(key_type key) { return _stripes[stripeOf(key)]; }
+    void updateShallowSize(size_t stripe);
 
     bool erase(const key_type& key, const char* clientId, bool haslock);
     void insert(const key_type& key, const mapped_type& value,
                 const char* clientId, bool haslock, bool& preExisted);
     void unlock(const key_type& key);
     bool findNextKey(key_type& key, mapped_type& val, const char* clientId,
-                     vespalib::MonitorGuard& guard);
+                     StripeGuards& guards);
     bool handleDecision(key_type& key, mapped_type& val, Decision decision);
-    void ackquireKey(const LockId & lid, vespalib::MonitorGuard & guard);
+    void ackquireKey(Stripe& stripe, const LockId & lid, vespalib::MonitorGuard & guard);
+
+    /**
+     * Locks the stripe of the given key, or all stripes if the key is to be
+     * added to or removed from the shallow stripe, and waits until no one
+     * else holds the key unless `haslock`.
+     */
+    void lockKey(const LockId& lid, bool changesKeys, bool haslock, StripeGuards& guards);
+
+    /**
+     * Releases all stripes and waits until no one else holds the given key.
+     */
+    void waitForKey(const LockId& lid, StripeGuards& guards);
+
+    template <typename Functor>
+    void eachImpl(Functor& functor, const char* clientId,
+                  const key_type& first, const key_type& last);
+    template <typename Functor>
+    void allImpl(Functor& functor, const char* clientId,
+                 const key_type& first, const key_type& last);
 
     /**
      * Process up to `chunkSize` bucket database entries from--and possibly
@@ -269,42 +357,34 @@ private:
                           const uint32_t chunkSize);
 
     /**
-     * Returns the given bucket, its super buckets and its sub buckets.
+     * Locks the stripes that may hold the given bucket and its super buckets,
+     * plus its sub buckets and its sibling if asked for.
      */
-    void getAllWithoutLocking(const BucketId& bucket,
-                              const BucketId& sibling,
-                              std::vector<BucketId::Type>& keys);
+    void lockBucketStripes(const BucketId& bucket, bool withSubBuckets,
+                           const BucketId& sibling, StripeGuards& guards);
 
-    /**
-     * Retrieves the most specific bucket id (highest used bits) that matches
-     * the given bucket.
-     *
-     * If a match is found, result is set to the bucket id found, and keyResult
-     * is set to the corresponding key (reversed)
-     *
-     * If not found, nextKey is set to the key after one that could have
-     * matched and we return false.
-     */
-    bool getMostSpecificMatch(const BucketId& bucket,
-                              BucketId& result,
-                              BucketId::Type& keyResult,
-                              BucketId::Type& nextKey);
+    bool existsInLockedStripe(key_type key, const StripeGuards& guards) const;
 
     /**
-     * Finds all buckets that can contain the given bucket, except for the
-     * bucket itself (that is, its super buckets)
+     * Returns the given bucket and its super buckets, plus its sub buckets if
+     * asked for, from the locked stripes.
      */
-    void getAllContaining(const BucketId& bucket,
-                          std::vector<BucketId::Type>& keys);
+    void getAllWithoutLocking(const BucketId& bucket,
+                              bool withSubBuckets,
+                              const BucketId& sibling,
+                              const StripeGuards& guards,
+                              std::vector<BucketId::Type>& keys);
 
     /**
      * Find the given list of keys in the map and add them to the map of
-     * results, locking them in the process.
+     * results, locking them in the process. If any of them is locked by
+     * someone else, all stripes are released to wait for it, and false is
+     * returned so that the caller can start over.
      */
-    void addAndLockResults(const std::vector<BucketId::Type> keys,
+    bool addAndLockResults(const std::vector<BucketId::Type>& keys,
                            const char* clientId,
                            std::map<BucketId, WrappedEntry>& results,
-                           vespalib::MonitorGuard& guard);
+                           StripeGuards& guards);
 };
 
 } // storage
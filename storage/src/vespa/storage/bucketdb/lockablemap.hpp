@@ -6,6 +6,7 @@
 #include <vespa/vespalib/stllike/hash_map.hpp>
 #include <vespa/vespalib/stllike/hash_set.hpp>
 #include <thread>
+#include <type_traits>
 #include <chrono>
 
 namespace storage {
@@ -36,6 +37,69 @@ LockableMap<Map>::LockWaiters::insert(const LockId & lid) {
     return id;
 }
 
+template<typename Map>
+LockableMap<Map>::Stripe::Stripe()
+    : _map(),
+      _lock(),
+      _lockedKeys(),
+      _lockWaiters()
+{}
+
+template<typename Map>
+LockableMap<Map>::Stripe::~Stripe() {}
+
+template<typename Map>
+LockableMap<Map>::StripeGuards::StripeGuards(const LockableMap& map)
+    : _map(map),
+      _guards()
+{}
+
+template<typename Map>
+LockableMap<Map>::StripeGuards::~StripeGuards() {}
+
+template<typename Map>
+void
+LockableMap<Map>::StripeGuards::lock(size_t stripe)
+{
+    for (size_t i = stripe; i < NUM_STRIPES; ++i) {
+        assert(!holds(i));
+    }
+    _guards[stripe] = std::make_unique<vespalib::MonitorGuard>(_map._stripes[stripe]._lock);
+}
+
+template<typename Map>
+void
+LockableMap<Map>::StripeGuards::lockAll()
+{
+    unlockAll();
+    for (size_t i = 0; i < NUM_STRIPES; ++i) {
+        lock(i);
+    }
+}
+
+template<typename Map>
+void
+LockableMap<Map>::StripeGuards::lockOnly(size_t stripe)
+{
+    for (size_t i = 0; i < NUM_STRIPES; ++i) {
+        if (i != stripe) {
+            unlock(i);
+        }
+    }
+    if (!holds(stripe)) {
+        lock(stripe);
+    }
+}
+
+template<typename Map>
+void
+LockableMap<Map>::StripeGuards::unlockAll()
+{
+    for (auto& guard : _guards) {
+        guard.reset();
+    }
+}
+
 template<typename Map>
 void
 LockableMap<Map>::WrappedEntry::write()
@@ -67,10 +131,8 @@ LockableMap<Map>::WrappedEntry::unlock()
 
 template<typename Map>
 LockableMap<Map>::LockableMap()
-    : _map(),
-      _lock(),
-      _lockedKeys(),
-      _lockWaiters()
+    : _stripes(),
+      _shallowSize(0)
 {}
 
 template<typename Map>
@@ -80,64 +142,152 @@ template<typename Map>
 bool
 LockableMap<Map>::operator==(const LockableMap<Map>& other) const
 {
-    vespalib::LockGuard guard(_lock);
-    vespalib::LockGuard guard2(other._lock);
-    return (_map == other._map);
+    StripeGuards guards(*this);
+    StripeGuards otherGuards(other);
+    guards.lockAll();
+    otherGuards.lockAll();
+    for (size_t i = 0; i < NUM_STRIPES; ++i) {
+        if (!(_stripes[i]._map == other._stripes[i]._map)) {
+            return false;
+        }
+    }
+    return true;
 }
 
 template<typename Map>
 bool
 LockableMap<Map>::operator<(const LockableMap<Map>& other) const
 {
-    vespalib::LockGuard guard(_lock);
-    vespalib::LockGuard guard2(other._lock);
-    return (_map < other._map);
+    StripeGuards guards(*this);
+    StripeGuards otherGuards(other);
+    guards.lockAll();
+    otherGuards.lockAll();
+    size_type size = 0;
+    size_type otherSize = 0;
+    for (size_t i = 0; i < NUM_STRIPES; ++i) {
+        size += _stripes[i]._map.size();
+        otherSize += other._stripes[i]._map.size();
+    }
+    if (size != otherSize) {
+        return (size < otherSize);
+    }
+    for (size_t i = 0; i < NUM_STRIPES; ++i) {
+        if (_stripes[i]._map < other._stripes[i]._map) {
+            return true;
+        }
+        if (other._stripes[i]._map < _stripes[i]._map) {
+            return false;
+        }
+    }
+    return false;
 }
 
 template<typename Map>
 typename Map::size_type
 LockableMap<Map>::size() const
 {
-    vespalib::LockGuard guard(_lock);
-    return _map.size();
+    StripeGuards guards(*this);
+    guards.lockAll();
+    size_type result = 0;
+    for (const Stripe& stripe : _stripes) {
+        result += stripe._map.size();
+    }
+    return result;
 }
 
 template<typename Map>
 typename Map::size_type
 LockableMap<Map>::getMemoryUsage() const
 {
-    vespalib::MonitorGuard guard(_lock);
-    return _map.getMemoryUsage()
-            + _lockedKeys.getMemoryUsage()
-            + sizeof(vespalib::Monitor);
+    StripeGuards guards(*this);
+    guards.lockAll();
+    size_type result = 0;
+    for (const Stripe& stripe : _stripes) {
+        result += stripe._map.getMemoryUsage()
+                  + stripe._lockedKeys.getMemoryUsage()
+                  + sizeof(vespalib::Monitor);
+    }
+    return result;
 }
 
 template<typename Map>
 bool
 LockableMap<Map>::empty() const
 {
-    vespalib::LockGuard guard(_lock);
-    return _map.empty();
+    StripeGuards guards(*this);
+    guards.lockAll();
+    for (const Stripe& stripe : _stripes) {
+        if (!stripe._map.empty()) {
+            return false;
+        }
+    }
+    return true;
 }
 
 template<typename Map>
 void
 LockableMap<Map>::swap(LockableMap<Map>& other)
 {
-    vespalib::LockGuard guard(_lock);
-    vespalib::LockGuard guard2(other._lock);
-    return _map.swap(other._map);
+    StripeGuards guards(*this);
+    StripeGuards otherGuards(other);
+    guards.lockAll();
+    otherGuards.lockAll();
+    for (size_t i = 0; i < NUM_STRIPES; ++i) {
+        _stripes[i]._map.swap(other._stripes[i]._map);
+    }
+    updateShallowSize(SHALLOW_STRIPE);
+    other.updateShallowSize(SHALLOW_STRIPE);
+}
+
+template<typename Map>
+void
+LockableMap<Map>::updateShallowSize(size_t stripe)
+{
+    if (stripe == SHALLOW_STRIPE) {
+        _shallowSize = _stripes[SHALLOW_STRIPE]._map.size();
+    }
 }
 
 template<typename Map>
-void LockableMap<Map>::ackquireKey(const LockId & lid, vespalib::MonitorGuard & guard)
+void LockableMap<Map>::ackquireKey(Stripe& stripe, const LockId & lid, vespalib::MonitorGuard & guard)
 {
-    if (_lockedKeys.exist(lid)) {
-        typename LockWaiters::Key waitId(_lockWaiters.insert(lid));
-        while (_lockedKeys.exist(lid)) {
+    if (stripe._lockedKeys.exist(lid)) {
+        typename LockWaiters::Key waitId(stripe._lockWaiters.insert(lid));
+        while (stripe._lockedKeys.exist(lid)) {
             guard.wait();
         }
-        _lockWaiters.erase(waitId);
+        stripe._lockWaiters.erase(waitId);
+    }
+}
+
+template<typename Map>
+void
+LockableMap<Map>::waitForKey(const LockId& lid, StripeGuards& guards)
+{
+    const size_t stripe = stripeOf(lid._key);
+    guards.lockOnly(stripe);
+    ackquireKey(_stripes[stripe], lid, guards[stripe]);
+    guards.unlock(stripe);
+}
+
+template<typename Map>
+void
+LockableMap<Map>::lockKey(const LockId& lid, bool changesKeys, bool haslock, StripeGuards& guards)
+{
+    const size_t stripe = stripeOf(lid._key);
+    if (!changesKeys || (stripe != SHALLOW_STRIPE)) {
+        guards.lock(stripe);
+        if (!haslock) {
+            ackquireKey(_stripes[stripe], lid, guards[stripe]);
+        }
+        return;
+    }
+    while (true) {
+        guards.lockAll();
+        if (haslock || !_stripes[stripe]._lockedKeys.exist(lid)) {
+            return;
+        }
+        waitForKey(lid, guards);
     }
 }
 
@@ -148,20 +298,22 @@ LockableMap<Map>::get(const key_type& key, const char* clientId,
                       bool lockIfNonExistingAndNotCreating)
 {
     LockId lid(key, clientId);
-    vespalib::MonitorGuard guard(_lock);
-    ackquireKey(lid, guard);
+    StripeGuards guards(*this);
+    lockKey(lid, createIfNonExisting, false, guards);
+    Stripe& stripe(stripeFor(key));
     bool preExisted = false;
     typename Map::iterator it =
-        _map.find(key, createIfNonExisting, preExisted);
+        stripe._map.find(key, createIfNonExisting, preExisted);
+    updateShallowSize(stripeOf(key));
 
-    if (it == _map.end()) {
+    if (it == stripe._map.end()) {
         if (lockIfNonExistingAndNotCreating) {
             return WrappedEntry(*this, key, clientId);
         } else {
             return WrappedEntry();
         }
     }
-    _lockedKeys.insert(lid);
+    stripe._lockedKeys.insert(lid);
     return WrappedEntry(*this, key, it->second, clientId, preExisted);
 }
 
@@ -197,14 +349,14 @@ bool
 LockableMap<Map>::erase(const key_type& key, const char* clientId, bool haslock)
 {
     LockId lid(key, clientId);
-    vespalib::MonitorGuard guard(_lock);
-    if (!haslock) {
-        ackquireKey(lid, guard);
-    }
+    StripeGuards guards(*this);
+    lockKey(lid, true, haslock, guards);
 #ifdef ENABLE_BUCKET_OPERATION_LOGGING
     debug::logBucketDbErase(key, debug::TypeTag<mapped_type>());
 #endif
-    return _map.erase(key);
+    bool erased = stripeFor(key)._map.erase(key);
+    updateShallowSize(stripeOf(key));
+    return erased;
 }
 
 template<typename Map>
@@ -213,42 +365,83 @@ LockableMap<Map>::insert(const key_type& key, const mapped_type& value,
                          const char* clientId, bool haslock, bool& preExisted)
 {
     LockId lid(key, clientId);
-    vespalib::MonitorGuard guard(_lock);
-    if (!haslock) {
-        ackquireKey(lid, guard);
-    }
+    StripeGuards guards(*this);
+    lockKey(lid, true, haslock, guards);
 #ifdef ENABLE_BUCKET_OPERATION_LOGGING
     debug::logBucketDbInsert(key, value);
 #endif
-    _map.insert(key, value, preExisted);
+    stripeFor(key)._map.insert(key, value, preExisted);
+    updateShallowSize(stripeOf(key));
 }
 
 template<typename Map>
 void
 LockableMap<Map>::clear()
 {
-    vespalib::LockGuard guard(_lock);
-    _map.clear();
+    StripeGuards guards(*this);
+    guards.lockAll();
+    for (Stripe& stripe : _stripes) {
+        stripe._map.clear();
+    }
+    updateShallowSize(SHALLOW_STRIPE);
 }
 
 template<typename Map>
 bool
 LockableMap<Map>::findNextKey(key_type& key, mapped_type& val,
                               const char* clientId,
-                              vespalib::MonitorGuard& guard)
-{
-    // Wait for next value to unlock.
-    typename Map::iterator it(_map.lower_bound(key));
-    while (it != _map.end() && _lockedKeys.exist(LockId(it->first, ""))) {
-        typename LockWaiters::Key waitId(_lockWaiters.insert(LockId(it->first, clientId)));
-        guard.wait();
-        _lockWaiters.erase(waitId);
-        it = _map.lower_bound(key);
-    }
-    if (it == _map.end()) return true;
-    key = it->first;
-    val = it->second;
-    return false;
+                              StripeGuards& guards)
+{
+    constexpr uint32_t shift = 8 * sizeof(key_type) - STRIPE_BITS;
+    while (true) {
+        // The deep stripes cover consecutive key ranges, so the first one
+        // with a key at or after the given one holds the next deep key.
+        // Shallow keys are spread over all ranges, and must be checked too.
+        // Keys and values are copied out while their stripe is held, since
+        // map iterators can not be default constructed or kept across stripes.
+        size_t found = NUM_STRIPES;
+        key_type foundKey = 0;
+        mapped_type foundVal;
+        for (size_t s = size_t(key >> shift); s < NUM_DEEP_STRIPES; ++s) {
+            guards.lockOnly(s);
+            Map& map(_stripes[s]._map);
+            typename Map::iterator it(map.lower_bound(key));
+            if (it != map.end()) {
+                found = s;
+                foundKey = it->first;
+                foundVal = it->second;
+                break;
+            }
+        }
+        if (_shallowSize > 0) {
+            if (!guards.holds(SHALLOW_STRIPE)) {
+                guards.lock(SHALLOW_STRIPE);
+            }
+            Map& shallow(_stripes[SHALLOW_STRIPE]._map);
+            typename Map::iterator shallowIt(shallow.lower_bound(key));
+            if (shallowIt != shallow.end() && (found == NUM_STRIPES || shallowIt->first < foundKey)) {
+                found = SHALLOW_STRIPE;
+                foundKey = shallowIt->first;
+                foundVal = shallowIt->second;
+            }
+        }
+        if (found == NUM_STRIPES) {
+            guards.unlockAll();
+            return true;
+        }
+        guards.lockOnly(found);
+        Stripe& stripe(_stripes[found]);
+        // Wait for next value to unlock.
+        if (stripe._lockedKeys.exist(LockId(foundKey, ""))) {
+            typename LockWaiters::Key waitId(stripe._lockWaiters.insert(LockId(foundKey, clientId)));
+            guards[found].wait();
+            stripe._lockWaiters.erase(waitId);
+            continue;
+        }
+        key = foundKey;
+        val = foundVal;
+        return false;
+    }
 }
 
 template<typename Map>
@@ -258,9 +451,10 @@ LockableMap<Map>::handleDecision(key_type& key, mapped_type& val,
 {
     bool b;
     switch (decision) {
-        case UPDATE: _map.insert(key, val, b);
+        case UPDATE: stripeFor(key)._map.insert(key, val, b);
                      break;
-        case REMOVE: _map.erase(key);
+        case REMOVE: stripeFor(key)._map.erase(key);
+                     updateShallowSize(stripeOf(key));
                      break;
         case ABORT:  return true;
         case CONTINUE: break;
@@ -272,106 +466,92 @@ LockableMap<Map>::handleDecision(key_type& key, mapped_type& val,
 template<typename Map>
 template<typename Functor>
 void
-LockableMap<Map>::each(Functor& functor, const char* clientId,
-                       const key_type& first, const key_type& last)
+LockableMap<Map>::eachImpl(Functor& functor, const char* clientId,
+                           const key_type& first, const key_type& last)
 {
     key_type key = first;
     mapped_type val;
     Decision decision;
     {
-        vespalib::MonitorGuard guard(_lock);
-        if (findNextKey(key, val, clientId, guard) || key > last) return;
-        _lockedKeys.insert(LockId(key, clientId));
+        StripeGuards guards(*this);
+        if (findNextKey(key, val, clientId, guards) || key > last) return;
+        stripeFor(key)._lockedKeys.insert(LockId(key, clientId));
     }
     try{
         while (true) {
             decision = functor(const_cast<const key_type&>(key), val);
-            vespalib::MonitorGuard guard(_lock);
-            _lockedKeys.erase(LockId(key, clientId));
-            guard.broadcast();
+            StripeGuards guards(*this);
+            const size_t stripe = stripeOf(key);
+            guards.lock(stripe);
+            _stripes[stripe]._lockedKeys.erase(LockId(key, clientId));
+            guards[stripe].broadcast();
             if (handleDecision(key, val, decision)) return;
             ++key;
-            if (findNextKey(key, val, clientId, guard) || key > last) return;
-            _lockedKeys.insert(LockId(key, clientId));
+            if (findNextKey(key, val, clientId, guards) || key > last) return;
+            stripeFor(key)._lockedKeys.insert(LockId(key, clientId));
         }
     } catch (...) {
             // Assuming only the functor call can throw exceptions, we need
             // to unlock the current key before exiting
-        vespalib::MonitorGuard guard(_lock);
-        _lockedKeys.erase(LockId(key, clientId));
+        vespalib::MonitorGuard guard(stripeFor(key)._lock);
+        stripeFor(key)._lockedKeys.erase(LockId(key, clientId));
         guard.broadcast();
         throw;
     }
 }
 
+template<typename Map>
+template<typename Functor>
+void
+LockableMap<Map>::each(Functor& functor, const char* clientId,
+                       const key_type& first, const key_type& last)
+{
+    eachImpl(functor, clientId, first, last);
+}
+
 template<typename Map>
 template<typename Functor>
 void
 LockableMap<Map>::each(const Functor& functor, const char* clientId,
                        const key_type& first, const key_type& last)
 {
-    key_type key = first;
-    mapped_type val;
-    Decision decision;
-    {
-        vespalib::MonitorGuard guard(_lock);
-        if (findNextKey(key, val, clientId, guard) || key > last) return;
-        _lockedKeys.insert(LockId(key, clientId));
-    }
-    try{
-        while (true) {
-            decision = functor(const_cast<const key_type&>(key), val);
-            vespalib::MonitorGuard guard(_lock);
-            _lockedKeys.erase(LockId(key, clientId));
-            guard.broadcast();
-            if (handleDecision(key, val, decision)) return;
-            ++key;
-            if (findNextKey(key, val, clientId, guard) || key > last) return;
-            _lockedKeys.insert(LockId(key, clientId));
-        }
-    } catch (...) {
-            // Assuming only the functor call can throw exceptions, we need
-            // to unlock the current key before exiting
-        vespalib::MonitorGuard guard(_lock);
-        _lockedKeys.erase(LockId(key, clientId));
-        guard.broadcast();
-        throw;
-    }
+    eachImpl(functor, clientId, first, last);
 }
 
 template<typename Map>
 template<typename Functor>
 void
-LockableMap<Map>::all(Functor& functor, const char* clientId,
-                      const key_type& first, const key_type& last)
+LockableMap<Map>::allImpl(Functor& functor, const char* clientId,
+                          const key_type& first, const key_type& last)
 {
     key_type key = first;
     mapped_type val;
-    vespalib::MonitorGuard guard(_lock);
+    StripeGuards guards(*this);
     while (true) {
-        if (findNextKey(key, val, clientId, guard) || key > last) return;
+        if (findNextKey(key, val, clientId, guards) || key > last) return;
         Decision d(functor(const_cast<const key_type&>(key), val));
+        assert(!std::is_const<Functor>::value || d == ABORT || d == CONTINUE);
         if (handleDecision(key, val, d)) return;
         ++key;
     }
 }
 
+template<typename Map>
+template<typename Functor>
+void
+LockableMap<Map>::all(Functor& functor, const char* clientId,
+                      const key_type& first, const key_type& last)
+{
+    allImpl(functor, clientId, first, last);
+}
+
 template<typename Map>
 template<typename Functor>
 void
 LockableMap<Map>::all(const Functor& functor, const char* clientId,
                       const key_type& first, const key_type& last)
 {
-    key_type key = first;
-    mapped_type val;
-    vespalib::MonitorGuard guard(_lock);
-    while (true) {
-        if (findNextKey(key, val, clientId, guard) || key > last) return;
-        Decision d(functor(const_cast<const key_type&>(key), val));
-        assert(d == ABORT || d == CONTINUE);
-        if (handleDecision(key, val, d)) return;
-        ++key;
-    }
+    allImpl(functor, clientId, first, last);
 }
 
 template <typename Map>
@@ -383,9 +563,9 @@ LockableMap<Map>::processNextChunk(Functor& functor,
                                    const uint32_t chunkSize)
 {
     mapped_type val;
-    vespalib::MonitorGuard guard(_lock);
+    StripeGuards guards(*this);
     for (uint32_t processed = 0; processed < chunkSize; ++processed) {
-        if (findNextKey(key, val, clientId, guard)) {
+        if (findNextKey(key, val, clientId, guards)) {
             return false;
         }
         Decision d(functor(const_cast<const key_type&>(key), val));
@@ -407,7 +587,7 @@ LockableMap<Map>::chunkedAll(Functor& functor,
     key_type key{};
     while (processNextChunk(functor, key, clientId, chunkSize)) {
         // Rationale: delay iteration for as short a time as possible while
-        // allowing another thread blocked on the main DB mutex to acquire it
+        // allowing another thread blocked on a DB stripe mutex to acquire it
         // in the meantime. Simply yielding the thread does not have the
         // intended effect with the Linux scheduler.
         // This is a pragmatic stop-gap solution; a more robust change requires
@@ -422,21 +602,28 @@ void
 LockableMap<Map>::print(std::ostream& out, bool verbose,
                         const std::string& indent) const
 {
-    vespalib::LockGuard guard(_lock);
+    StripeGuards guards(*this);
+    guards.lockAll();
     out << "LockableMap {\n" << indent << "  ";
 
     if (verbose) {
-        for (const auto & entry : _map) {
-            out << "Key: " << BucketId(BucketId::keyToBucketId(entry.first))
-                << " Value: " << entry.second << "\n" << indent << "  ";
+        for (const Stripe& stripe : _stripes) {
+            for (const auto & entry : stripe._map) {
+                out << "Key: " << BucketId(BucketId::keyToBucketId(entry.first))
+                    << " Value: " << entry.second << "\n" << indent << "  ";
+            }
         }
 
         out << "\n" << indent << "  Locked keys: ";
-        _lockedKeys.print(out, verbose, indent + "  ");
+        for (const Stripe& stripe : _stripes) {
+            stripe._lockedKeys.print(out, verbose, indent + "  ");
+        }
     }
     out << "} : ";
 
-    out << _map;
+    for (const Stripe& stripe : _stripes) {
+        out << stripe._map;
+    }
 }
 
 template<typename Map>
@@ -462,126 +649,125 @@ template<typename Map>
 void
 LockableMap<Map>::unlock(const key_type& key)
 {
-    vespalib::MonitorGuard guard(_lock);
-    _lockedKeys.erase(LockId(key, ""));
+    Stripe& stripe(stripeFor(key));
+    vespalib::MonitorGuard guard(stripe._lock);
+    stripe._lockedKeys.erase(LockId(key, ""));
     guard.broadcast();
 }
 
-/**
- * Check whether the given key contains the given bucket.
- * Sets result to the bucket corresponding to the key, and keyResult
- * to the key if true.
- */
-bool
-checkContains(document::BucketId::Type key, const document::BucketId& bucket,
-              document::BucketId& result, document::BucketId::Type& keyResult);
-
-/**
- * Retrieves the most specific bucket id (highest used bits) that contains
- * the given bucket.
- *
- * If a match is found, result is set to the bucket id found, and keyResult is
- * set to the corresponding key (reversed)
- *
- * If not found, nextKey is set to the key after one that could have matched
- * and we return false.
- */
 template<typename Map>
-bool
-LockableMap<Map>::getMostSpecificMatch(const BucketId& bucket,
-                                       BucketId& result,
-                                       BucketId::Type& keyResult,
-                                       BucketId::Type& nextKey)
-{
-    typename Map::const_iterator iter = _map.lower_bound(bucket.toKey());
-
-    nextKey = 0;
-
-    // We should now have either the bucket we are looking for
-    // (if the exact bucket exists), or one right after.
-    if (iter != _map.end()) {
-        nextKey = iter->first;
-
-        if (checkContains(iter->first, bucket, result, keyResult)) {
-            return true;
+void
+LockableMap<Map>::lockBucketStripes(const BucketId& bucket, bool withSubBuckets,
+                                    const BucketId& sibling, StripeGuards& guards)
+{
+    const size_t stripe = stripeOf(bucket.stripUnused().toKey());
+    if (stripe == SHALLOW_STRIPE) {
+        // Sub buckets of a shallow bucket may be in any stripe.
+        if (withSubBuckets) {
+            guards.lockAll();
+        } else {
+            guards.lock(SHALLOW_STRIPE);
         }
+        return;
     }
-
-    if (iter != _map.begin()) {
-        --iter; // If iter was map.end(), we should now end up at the last item in the map
-        nextKey = iter->first;
-
-        if (checkContains(iter->first, bucket, result, keyResult)) {
-            return true;
-        }
+    const size_t siblingStripe = (sibling.getRawId() != 0)
+            ? stripeOf(sibling.stripUnused().toKey()) : stripe;
+    guards.lock(std::min(stripe, siblingStripe));
+    if (siblingStripe != stripe) {
+        guards.lock(std::max(stripe, siblingStripe));
     }
+    // Shallow keys are only added while holding all stripes, so this cannot
+    // change from zero while we hold the bucket's stripe.
+    if (_shallowSize > 0 && !guards.holds(SHALLOW_STRIPE)) {
+        guards.lock(SHALLOW_STRIPE);
+    }
+}
 
-    return false;
+template<typename Map>
+bool
+LockableMap<Map>::existsInLockedStripe(key_type key, const StripeGuards& guards) const
+{
+    const size_t stripe = stripeOf(key);
+    if (!guards.holds(stripe)) {
+        return false;
+    }
+    const Map& map(_stripes[stripe]._map);
+    return (map.find(key) != map.end());
 }
 
-/**
- * Finds all buckets that can contain the given bucket, except for the bucket
- * itself.
- */
 template<typename Map>
 void
-LockableMap<Map>::getAllContaining(const BucketId& bucket,
-                                   std::vector<BucketId::Type>& keys)
+LockableMap<Map>::getAllWithoutLocking(const BucketId& bucket,
+                                       bool withSubBuckets,
+                                       const BucketId& sibling,
+                                       const StripeGuards& guards,
+                                       std::vector<BucketId::Type>& keys)
 {
-    BucketId id = bucket;
-
-    // Find other buckets that contain this bucket.
-    // TODO: Optimize?
-    while (id.getUsedBits() > 1) {
-        id.setUsedBits(id.getUsedBits() - 1);
-        id = id.stripUnused();
-        BucketId::Type key = id.toKey();
-
-        typename Map::const_iterator iter = _map.find(key);
-        if (iter != _map.end()) {
+    // The bucket itself and the buckets containing it.
+    for (uint32_t bits = bucket.getUsedBits(); bits > 0; --bits) {
+        BucketId::Type key = BucketId(bits, bucket.getRawId()).stripUnused().toKey();
+        if (existsInLockedStripe(key, guards)) {
             keys.push_back(key);
         }
     }
+
+    if (withSubBuckets) {
+        // Buckets contained in the bucket come immediately after it in
+        // every stripe. Traverse the locked stripes to find them.
+        const BucketId::Type bucketKey = bucket.stripUnused().toKey();
+        for (size_t s = 0; s < NUM_STRIPES; ++s) {
+            if (!guards.holds(s)) {
+                continue;
+            }
+            const Map& map(_stripes[s]._map);
+            for (typename Map::const_iterator it = map.lower_bound(bucketKey);
+                 it != map.end(); ++it)
+            {
+                if (it->first == bucketKey) {
+                    continue;
+                }
+                BucketId id(BucketId(BucketId::keyToBucketId(it->first)));
+                if (bucket.contains(id)) {
+                    keys.push_back(it->first);
+                } else {
+                    break;
+                }
+            }
+        }
+    }
+
+    if (sibling.getRawId() != 0) {
+        keys.push_back(sibling.toKey());
+    }
 }
 
 template<typename Map>
-void
+bool
 LockableMap<Map>::addAndLockResults(
-        const std::vector<BucketId::Type> keys,
+        const std::vector<BucketId::Type>& keys,
         const char* clientId,
         std::map<BucketId, WrappedEntry>& results,
-        vespalib::MonitorGuard& guard)
+        StripeGuards& guards)
 {
     // Wait until all buckets are free to be added, then add them all.
-    while (true) {
-        bool allOk = true;
-        key_type waitingFor(0);
-
-        for (uint32_t i=0; i<keys.size(); i++) {
-            if (_lockedKeys.exist(LockId(keys[i], clientId))) {
-                waitingFor = keys[i];
-                allOk = false;
-                break;
-            }
+    for (uint32_t i=0; i<keys.size(); i++) {
+        LockId lid(keys[i], clientId);
+        if (stripeFor(keys[i])._lockedKeys.exist(lid)) {
+            waitForKey(lid, guards);
+            return false;
         }
-
-        if (!allOk) {
-            typename LockWaiters::Key waitId(_lockWaiters.insert(LockId(waitingFor, clientId)));
-            guard.wait();
-            _lockWaiters.erase(waitId);
-        } else {
-            for (uint32_t i=0; i<keys.size(); i++) {
-                typename Map::iterator it = _map.find(keys[i]);
-                if (it != _map.end()) {
-                    _lockedKeys.insert(LockId(keys[i], clientId));
-                    results[BucketId(BucketId::keyToBucketId(keys[i]))]
-                          = WrappedEntry(*this, keys[i], it->second,
-                                         clientId, true);
-                }
-            }
-            break;
+    }
+    for (uint32_t i=0; i<keys.size(); i++) {
+        Stripe& stripe(stripeFor(keys[i]));
+        typename Map::iterator it = stripe._map.find(keys[i]);
+        if (it != stripe._map.end()) {
+            stripe._lockedKeys.insert(LockId(keys[i], clientId));
+            results[BucketId(BucketId::keyToBucketId(keys[i]))]
+                  = WrappedEntry(*this, keys[i], it->second,
+                                 clientId, true);
         }
     }
+    return true;
 }
 
 uint8_t getMinDiffBits(uint16_t minBits, const document::BucketId& a, const document::BucketId& b);
@@ -593,31 +779,70 @@ LockableMap<Map>::createAppropriateBucket(
         const char* clientId,
         const BucketId& bucket)
 {
-    vespalib::MonitorGuard guard(_lock);
-    typename Map::const_iterator iter = _map.lower_bound(bucket.toKey());
-
-    // Find the two buckets around the possible new bucket. The new
-    // bucket's used bits should be the highest used bits it can be while
-    // still being different from both of these.
-    if (iter != _map.end()) {
-        newBucketBits = getMinDiffBits(newBucketBits, BucketId(BucketId::keyToBucketId(iter->first)), bucket);
-    }
+    // With at least STRIPE_BITS bits, the new bucket ends up in the stripe
+    // of the given bucket, and buckets in other stripes already differ from
+    // it in the used bits, so only that stripe needs to be considered.
+    const size_t bucketStripe = (newBucketBits >= STRIPE_BITS)
+            ? stripeOf(BucketId(newBucketBits, bucket.getRawId()).stripUnused().toKey())
+            : SHALLOW_STRIPE;
+    const key_type bucketKey = bucket.toKey();
+    while (true) {
+        StripeGuards guards(*this);
+        if (bucketStripe == SHALLOW_STRIPE) {
+            guards.lockAll();
+        } else {
+            guards.lock(bucketStripe);
+        }
 
-    if (iter != _map.begin()) {
-        --iter;
-        newBucketBits = getMinDiffBits(newBucketBits, BucketId(BucketId::keyToBucketId(iter->first)), bucket);
-    }
+        // Find the two buckets around the possible new bucket. The new
+        // bucket's used bits should be the highest used bits it can be while
+        // still being different from both of these.
+        bool hasNext = false;
+        bool hasPrev = false;
+        key_type next(0);
+        key_type prev(0);
+        for (size_t s = 0; s < NUM_STRIPES; ++s) {
+            if (!guards.holds(s)) {
+                continue;
+            }
+            const Map& map(_stripes[s]._map);
+            typename Map::const_iterator iter = map.lower_bound(bucketKey);
+            if (iter != map.end() && (!hasNext || iter->first < next)) {
+                hasNext = true;
+                next = iter->first;
+            }
+            if (iter != map.begin()) {
+                --iter;
+                if (!hasPrev || iter->first > prev) {
+                    hasPrev = true;
+                    prev = iter->first;
+                }
+            }
+        }
+        uint16_t bits = newBucketBits;
+        if (hasNext) {
+            bits = getMinDiffBits(bits, BucketId(BucketId::keyToBucketId(next)), bucket);
+        }
+        if (hasPrev) {
+            bits = getMinDiffBits(bits, BucketId(BucketId::keyToBucketId(prev)), bucket);
+        }
 
-    BucketId newBucket(newBucketBits, bucket.getRawId());
-    newBucket.setUsedBits(newBucketBits);
-    BucketId::Type key = newBucket.stripUnused().toKey();
+        BucketId newBucket(bits, bucket.getRawId());
+        newBucket.setUsedBits(bits);
+        BucketId::Type key = newBucket.stripUnused().toKey();
 
-    LockId lid(key, clientId);
-    ackquireKey(lid, guard);
-    bool preExisted;
-    typename Map::iterator it = _map.find(key, true, preExisted);
-    _lockedKeys.insert(LockId(key, clientId));
-    return WrappedEntry(*this, key, it->second, clientId, preExisted);
+        LockId lid(key, clientId);
+        Stripe& stripe(stripeFor(key));
+        if (stripe._lockedKeys.exist(lid)) {
+            waitForKey(lid, guards);
+            continue;
+        }
+        bool preExisted;
+        typename Map::iterator it = stripe._map.find(key, true, preExisted);
+        updateShallowSize(stripeOf(key));
+        stripe._lockedKeys.insert(lid);
+        return WrappedEntry(*this, key, it->second, clientId, preExisted);
+    }
 }
 
 template<typename Map>
@@ -625,89 +850,18 @@ std::map<document::BucketId, typename LockableMap<Map>::WrappedEntry>
 LockableMap<Map>::getContained(const BucketId& bucket,
                                const char* clientId)
 {
-    vespalib::MonitorGuard guard(_lock);
     std::map<BucketId, WrappedEntry> results;
+    while (true) {
+        StripeGuards guards(*this);
+        lockBucketStripes(bucket, false, BucketId(0), guards);
 
-    BucketId result;
-    BucketId::Type keyResult;
-    BucketId::Type nextKey;
-
-    std::vector<BucketId::Type> keys;
-
-    if (getMostSpecificMatch(bucket, result, keyResult, nextKey)) {
-        keys.push_back(keyResult);
-
-        // Find the super buckets for the most specific match
-        getAllContaining(result, keys);
-    } else {
-        // Find the super buckets for the input bucket
-        // because getMostSpecificMatch() might not find the most specific
-        // match in all cases of inconsistently split buckets
-        getAllContaining(bucket, keys);
-    }
-
-    if (!keys.empty()) {
-        addAndLockResults(keys, clientId, results, guard);
-    }
-
-    return results;
-}
-
-template<typename Map>
-void
-LockableMap<Map>::getAllWithoutLocking(const BucketId& bucket,
-                                       const BucketId& sibling,
-                                       std::vector<BucketId::Type>& keys)
-{
-    BucketId result;
-    BucketId::Type keyResult;
-    BucketId::Type nextKey;
-
-    typename Map::iterator it = _map.end();
-
-    if (getMostSpecificMatch(bucket, result, keyResult, nextKey)) {
-        keys.push_back(keyResult);
-
-        // Find the super buckets for the most specific match
-        getAllContaining(result, keys);
-
-        it = _map.find(keyResult);
-        if (it != _map.end()) {
-            // Skipping nextKey, since it was equal to keyResult
-            ++it;
-        }
-    } else {
-        // Find the super buckets for the input bucket
-        // because getMostSpecificMatch() might not find the most specific
-        // match in all cases of inconsistently split buckets
-        getAllContaining(bucket, keys);
+        std::vector<BucketId::Type> keys;
+        getAllWithoutLocking(bucket, false, BucketId(0), guards, keys);
 
-        it = _map.find(nextKey);
-        if (it != _map.end()) {
-            // Nextkey might be contained in the imput bucket,
-            // e.g. if it is the first bucket in bucketdb
-            BucketId id = BucketId(BucketId::keyToBucketId(it->first));
-            if (!bucket.contains(id)) {
-                ++it;
-            }
+        if (keys.empty() || addAndLockResults(keys, clientId, results, guards)) {
+            return results;
         }
     }
-
-    // Buckets contained in the found bucket will come immediately after it.
-    // Traverse the map to find them.
-    for (; it != _map.end(); ++it) {
-        BucketId id(BucketId(BucketId::keyToBucketId(it->first)));
-
-        if (bucket.contains(id)) {
-            keys.push_back(it->first);
-        } else {
-            break;
-        }
-    }
-
-    if (sibling.getRawId() != 0) {
-        keys.push_back(sibling.toKey());
-    }
 }
 
 /**
@@ -718,28 +872,29 @@ std::map<document::BucketId, typename LockableMap<Map>::WrappedEntry>
 LockableMap<Map>::getAll(const BucketId& bucket, const char* clientId,
                          const BucketId& sibling)
 {
-    vespalib::MonitorGuard guard(_lock);
-
     std::map<BucketId, WrappedEntry> results;
-    std::vector<BucketId::Type> keys;
-
-    getAllWithoutLocking(bucket, sibling, keys);
+    while (true) {
+        StripeGuards guards(*this);
+        lockBucketStripes(bucket, true, sibling, guards);
 
-    addAndLockResults(keys, clientId, results, guard);
+        std::vector<BucketId::Type> keys;
+        getAllWithoutLocking(bucket, true, sibling, guards, keys);
 
-    return results;
+        if (addAndLockResults(keys, clientId, results, guards)) {
+            return results;
+        }
+    }
 }
 
 template<typename Map>
 bool
 LockableMap<Map>::isConsistent(const typename LockableMap<Map>::WrappedEntry& entry)
 {
-    vespalib::MonitorGuard guard(_lock);
+    StripeGuards guards(*this);
+    lockBucketStripes(entry.getBucketId(), true, BucketId(0), guards);
 
-    BucketId sibling(0);
     std::vector<BucketId::Type> keys;
-
-    getAllWithoutLocking(entry.getBucketId(), sibling, keys);
+    getAllWithoutLocking(entry.getBucketId(), true, BucketId(0), guards, keys);
     assert(keys.size() >= 1);
     assert(keys.size() != 1 || keys[0] == entry.getKey());
 
@@ -750,22 +905,27 @@ template<typename Map>
 void
 LockableMap<Map>::showLockClients(vespalib::asciistream & out) const
 {
-    vespalib::MonitorGuard guard(_lock);
+    StripeGuards guards(*this);
+    guards.lockAll();
     out << "Currently grabbed locks:";
-    for (typename LockIdSet::const_iterator it = _lockedKeys.begin();
-         it != _lockedKeys.end(); ++it)
-    {
-        out << "\n  "
-            << BucketId(BucketId::keyToBucketId(it->_key))
-            << " - " << it->_owner;
+    for (const Stripe& stripe : _stripes) {
+        for (typename LockIdSet::const_iterator it = stripe._lockedKeys.begin();
+             it != stripe._lockedKeys.end(); ++it)
+        {
+            out << "\n  "
+                << BucketId(BucketId::keyToBucketId(it->_key))
+                << " - " << it->_owner;
+        }
     }
     out << "\nClients waiting for keys:";
-    for (typename LockWaiters::const_iterator it = _lockWaiters.begin();
-         it != _lockWaiters.end(); ++it)
-    {
-        out << "\n  "
-            << BucketId(BucketId::keyToBucketId(it->second._key))
-            << " - " << it->second._owner;
+    for (const Stripe& stripe : _stripes) {
+        for (typename LockWaiters::const_iterator it = stripe._lockWaiters.begin();
+             it != stripe._lockWaiters.end(); ++it)
+        {
+            out << "\n  "
+                << BucketId(BucketId::keyToBucketId(it->second._key))
+                << " - " << it->second._owner;
+        }
     }
 }
 
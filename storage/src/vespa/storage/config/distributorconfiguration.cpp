@@ -3,6 +3,7 @@
 #include <vespa/document/select/parser.h>
 #include <vespa/document/select/traversingvisitor.h>
 #include <vespa/vespalib/util/exceptions.h>
+#include <algorithm>
 #include <sstream>
 
 #include <vespa/log/log.h>
@@ -20,6 +21,7 @@ DistributorConfiguration::DistributorConfiguration(StorageComponent& component)
       _maxIdealStateOperations(100),
       _idealStateChunkSize(1000),
       _maxNodesPerMerge(16),
+      _bucketDbMergeThreads(4),
       _lastGarbageCollectionChange(0),
       _garbageCollectionInterval(0),
       _minPendingMaintenanceOps(100),
@@ -155,6 +157,7 @@ DistributorConfiguration::configure(const vespa::config::content::core::StorDist
     if (config.inhibitMergeSendingOnBusyNodeDurationSec >= 0) {
         _inhibitMergeSendingOnBusyNodeDuration = std::chrono::seconds(config.inhibitMergeSendingOnBusyNodeDurationSec);
     }
+    _bucketDbMergeThreads = std::max(config.bucketDbMergeThreads, 1);
     
     LOG(debug,
         "Distributor now using new configuration parameters. Split limits: %d docs/%d bytes. "
@@ -235,6 +235,9 @@ public:
     void setSequenceMutatingOperations(bool sequenceMutations) noexcept {
         _sequenceMutatingOperations = sequenceMutations;
     }
+    uint32_t getBucketDbMergeThreads() const noexcept {
+        return _bucketDbMergeThreads;
+    }
     
 private:
     DistributorConfiguration(const DistributorConfiguration& other);
@@ -250,6 +253,7 @@ private:
     uint32_t _maxIdealStateOperations;
     uint32_t _idealStateChunkSize;
     uint32_t _maxNodesPerMerge;
+    uint32_t _bucketDbMergeThreads;
 
     std::string _garbageCollectionSelection;
 
@@ -22,7 +22,9 @@ BucketDBUpdater::BucketDBUpdater(Distributor& owner, ManagedBucketSpace& bucketS
     : framework::StatusReporter("bucketdb", "Bucket DB Updater"),
       _bucketSpaceComponent(owner, bucketSpace, compReg, "Bucket DB Updater"),
       _sender(sender),
-      _transitionTimer(_bucketSpaceComponent.getClock())
+      _transitionTimer(_bucketSpaceComponent.getClock()),
+      _mergeThreads(1),
+      _mergeExecutor()
 {
 }
 
@@ -44,6 +46,20 @@ BucketDBUpdater::flush()
     _sentMessages.clear();
 }
 
+void
+BucketDBUpdater::setMergeThreads(uint32_t numThreads)
+{
+    if (numThreads == _mergeThreads) {
+        return;
+    }
+    // Merges only run from the distributor thread, so none are in progress here.
+    _mergeExecutor.reset();
+    if (numThreads > 1) {
+        _mergeExecutor = std::make_unique<vespalib::ThreadStackExecutor>(numThreads, 128 * 1024);
+    }
+    _mergeThreads = numThreads;
+}
+
 void
 BucketDBUpdater::print(std::ostream& out, bool verbose,
                        const std::string& indent) const
@@ -523,7 +539,7 @@ BucketDBUpdater::isPendingClusterStateCompleted() const
 void
 BucketDBUpdater::processCompletedPendingClusterState()
 {
-    _pendingClusterState->mergeInto(_bucketSpaceComponent.getBucketDatabase());
+    _pendingClusterState->mergeInto(_bucketSpaceComponent.getBucketDatabase(), _mergeExecutor.get());
 
     if (_pendingClusterState->getCommand().get()) {
         enableCurrentClusterStateInDistributor();
@@ -15,6 +15,7 @@
 #include <vespa/storageframework/generic/clock/timer.h>
 #include <vespa/storageframework/generic/memory/memorymanagerinterface.h>
 #include <vespa/storageapi/messageapi/messagehandler.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
 #include <set>
 #include <deque>
 #include <list>
@@ -51,6 +52,13 @@ public:
     void resendDelayedMessages();
     void storageDistributionChanged(const lib::Distribution&);
 
+    /**
+     * Sets the number of threads used to merge a completed pending cluster
+     * state into the bucket database. With less than 2 threads the merge is
+     * done by the calling thread alone.
+     */
+    void setMergeThreads(uint32_t numThreads);
+
     vespalib::string reportXmlStatus(vespalib::xml::XmlOutputStream&, const framework::HttpUrlPath&) const;
     vespalib::string getReportContentType(const framework::HttpUrlPath&) const override;
     bool reportStatus(std::ostream&, const framework::HttpUrlPath&) const override;
@@ -259,6 +267,8 @@ private:
     std::set<EnqueuedBucketRecheck> _enqueuedRechecks;
     std::unordered_set<uint16_t> _outdatedNodes;
     framework::MilliSecTimer _transitionTimer;
+    uint32_t _mergeThreads;
+    std::unique_ptr<vespalib::ThreadStackExecutor> _mergeExecutor;
 };
 
 }
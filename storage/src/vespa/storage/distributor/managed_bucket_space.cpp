@@ -1,11 +1,18 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "managed_bucket_space.h"
+#include <vespa/storage/bucketdb/btree_bucket_database.h>
+#include <vespa/storage/bucketdb/mapbucketdatabase.h>
 
 namespace storage {
 namespace distributor {
 
-ManagedBucketSpace::ManagedBucketSpace() {
+ManagedBucketSpace::ManagedBucketSpace(bool useBTreeDatabase)
+    : _bucketDatabase(useBTreeDatabase
+                      ? std::unique_ptr<BucketDatabase>(std::make_unique<BTreeBucketDatabase>())
+                      : std::unique_ptr<BucketDatabase>(std::make_unique<MapBucketDatabase>())),
+      _distribution()
+{
 }
 
 ManagedBucketSpace::~ManagedBucketSpace() {
@@ -1,7 +1,7 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #pragma once
 
-#include <vespa/storage/bucketdb/mapbucketdatabase.h>
+#include <vespa/storage/bucketdb/bucketdatabase.h>
 #include <vespa/vdslib/distribution/distribution.h>
 #include <memory>
 
@@ -18,17 +18,18 @@ namespace distributor {
  * keeping track of, and computing operations for, a single bucket space:
  *
  * Bucket database instance
- *   Each bucket space has its own entirely separate bucket database.
+ *   Each bucket space has its own entirely separate bucket database. It is
+ *   either a map or a B-tree bucket database, chosen by config at startup.
  * Distribution config
  *   Each bucket space _may_ operate with its own distribution config, in
  *   particular so that redundancy, ready copies etc can differ across
  *   bucket spaces.
  */
 class ManagedBucketSpace {
-    MapBucketDatabase _bucketDatabase;
+    std::unique_ptr<BucketDatabase> _bucketDatabase;
     std::shared_ptr<lib::Distribution> _distribution;
 public:
-    ManagedBucketSpace();
+    explicit ManagedBucketSpace(bool useBTreeDatabase = false);
     ~ManagedBucketSpace();
 
     ManagedBucketSpace(const ManagedBucketSpace&) = delete;
@@ -37,10 +38,10 @@ public:
     ManagedBucketSpace& operator=(ManagedBucketSpace&&) = delete;
 
     BucketDatabase& getBucketDatabase() noexcept {
-        return _bucketDatabase;
+        return *_bucketDatabase;
     }
     const BucketDatabase& getBucketDatabase() const noexcept {
-        return _bucketDatabase;
+        return *_bucketDatabase;
     }
 
     void setDistribution(lib::Distribution::SP distribution) {
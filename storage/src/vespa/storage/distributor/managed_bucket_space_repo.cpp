@@ -9,7 +9,9 @@ LOG_SETUP(".distributor.managed_bucket_space_repo");
 namespace storage {
 namespace distributor {
 
-ManagedBucketSpaceRepo::ManagedBucketSpaceRepo() {
+ManagedBucketSpaceRepo::ManagedBucketSpaceRepo(bool useBTreeDatabase)
+    : _defaultSpace(useBTreeDatabase)
+{
 }
 
 ManagedBucketSpaceRepo::~ManagedBucketSpaceRepo() {
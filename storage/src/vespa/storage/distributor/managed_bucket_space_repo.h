@@ -12,7 +12,7 @@ class ManagedBucketSpaceRepo {
     // TODO: multiple spaces. This is just to start re-wiring things.
     ManagedBucketSpace _defaultSpace;
 public:
-    ManagedBucketSpaceRepo();
+    explicit ManagedBucketSpaceRepo(bool useBTreeDatabase = false);
     ~ManagedBucketSpaceRepo();
 
     ManagedBucketSpaceRepo(const ManagedBucketSpaceRepo&&) = delete;
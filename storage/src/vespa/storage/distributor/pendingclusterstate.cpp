@@ -4,7 +4,11 @@
 #include "bucketdbupdater.h"
 #include <vespa/storageframework/defaultimplementation/clock/realclock.h>
 #include <vespa/storage/common/bucketoperationlogger.h>
+#include <vespa/vespalib/util/executor.h>
+#include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/sync.h>
 #include <vespa/vespalib/util/xmlstream.hpp>
+#include <algorithm>
 #include <climits>
 
 #include <vespa/log/log.h>
@@ -16,6 +20,16 @@ using lib::Node;
 using lib::NodeType;
 using lib::NodeState;
 
+namespace {
+
+// Merges smaller than this (counting both database and pending entries) are
+// not worth splitting across threads.
+constexpr size_t MIN_ENTRIES_FOR_PARALLEL_MERGE = 8192;
+// A parallel merge is split into 2^MERGE_RANGE_BITS bucket key ranges.
+constexpr uint32_t MERGE_RANGE_BITS = 6;
+
+}
+
 PendingClusterState::PendingClusterState(
         const framework::Clock& clock,
         const ClusterInformation::CSP& clusterInfo,
@@ -26,7 +40,6 @@ PendingClusterState::PendingClusterState(
     : _cmd(newStateCmd),
       _requestedNodes(newStateCmd->getSystemState().getNodeCount(lib::NodeType::STORAGE)),
       _outdatedNodes(newStateCmd->getSystemState().getNodeCount(lib::NodeType::STORAGE)),
-      _iter(0),
       _prevClusterState(clusterInfo->getClusterState()),
       _newClusterState(newStateCmd->getSystemState()),
       _clock(clock),
@@ -54,7 +67,6 @@ PendingClusterState::PendingClusterState(
         api::Timestamp creationTimestamp)
     : _requestedNodes(clusterInfo->getStorageNodeCount()),
       _outdatedNodes(clusterInfo->getStorageNodeCount()),
-      _iter(0),
       _prevClusterState(clusterInfo->getClusterState()),
       _newClusterState(clusterInfo->getClusterState()),
       _clock(clock),
@@ -394,13 +406,69 @@ PendingClusterState::addNodeInfo(
     _entries.push_back(Entry(id, copy));
 }
 
+/**
+ * Merges the sorted entries in [begin, end> of the pending cluster state
+ * with the bucket database entries in the same part of the key space, which
+ * must be given to process() in key order. Changes to existing entries are
+ * either done in place, or kept along with the new entries until commit().
+ */
+class PendingClusterState::BucketMerger : public BucketDatabase::MutableEntryProcessor {
+public:
+    BucketMerger(const PendingClusterState& state, uint32_t begin, uint32_t end, bool keepChangedEntries)
+        : _state(state),
+          _entries(state._entries),
+          _iter(begin),
+          _end(end),
+          _keepChangedEntries(keepChangedEntries),
+          _changedEntries(),
+          _removedBuckets()
+    {}
+
+    bool process(BucketDatabase::Entry& e) override;
+
+    /**
+     * Merges the database entries in the given key range, which are read
+     * through getAll() on the range bucket.
+     */
+    void mergeKeyRange(const BucketDatabase& db, uint32_t rangeBits, uint64_t rangeIndex);
+
+    /** Creates entries for the remaining buckets, which are not in the database. */
+    void finish();
+
+    void commit(BucketDatabase& db) const;
+
+private:
+    /**
+     * Skips through all entries for the same bucket and returns
+     * the range in the entry list for which they were found.
+     * The range is [from, to>
+     */
+    Range skipAllForSameBucket();
+
+    bool databaseIteratorHasPassedBucketInfoIterator(const document::BucketId& bucketId) const {
+        return (_iter < _end && _entries[_iter].bucketId.toKey() < bucketId.toKey());
+    }
+
+    bool bucketInfoIteratorPointsToBucket(const document::BucketId& bucketId) const {
+        return _iter < _end && _entries[_iter].bucketId == bucketId;
+    }
+
+    const PendingClusterState& _state;
+    const EntryList& _entries;
+    uint32_t _iter;
+    uint32_t _end;
+    bool _keepChangedEntries;
+    std::vector<BucketDatabase::Entry> _changedEntries;
+    std::vector<document::BucketId> _removedBuckets;
+};
+
 PendingClusterState::Range
-PendingClusterState::skipAllForSameBucket()
+PendingClusterState::BucketMerger::skipAllForSameBucket()
 {
     Range r(_iter, _iter);
 
-    for (document::BucketId& bid = _entries[_iter].bucketId;
-         _iter < _entries.size() && _entries[_iter].bucketId == bid;
+    for (const document::BucketId& bid = _entries[_iter].bucketId;
+         _iter < _end && _entries[_iter].bucketId == bid;
          ++_iter)
     {
     }
@@ -409,10 +477,91 @@ PendingClusterState::skipAllForSameBucket()
     return r;
 }
 
+bool
+PendingClusterState::BucketMerger::process(BucketDatabase::Entry& e)
+{
+    document::BucketId bucketId(e.getBucketId());
+
+    LOG(spam,
+        "Before merging info from nodes [%s], bucket %s had info %s",
+        _state.requestNodesToString().c_str(),
+        bucketId.toString().c_str(),
+        e.getBucketInfo().toString().c_str());
+
+    while (databaseIteratorHasPassedBucketInfoIterator(bucketId)) {
+        LOG(spam, "Found new bucket %s, adding",
+            _entries[_iter].bucketId.toString().c_str());
+
+        _changedEntries.push_back(_state.createNewEntry(skipAllForSameBucket()));
+    }
+
+    bool updated(_state.removeCopiesFromNodesThatWereRequested(e, bucketId));
+
+    if (bucketInfoIteratorPointsToBucket(bucketId)) {
+        LOG(spam, "Updating bucket %s",
+            _entries[_iter].bucketId.toString().c_str());
+
+        _state.insertInfo(e, skipAllForSameBucket());
+        updated = true;
+    }
+
+    if (updated) {
+        // Remove bucket if we've previously removed all nodes from it
+        if (e->getNodeCount() == 0) {
+            _removedBuckets.push_back(bucketId);
+        } else {
+            e.getBucketInfo().updateTrusted();
+            if (_keepChangedEntries) {
+                _changedEntries.push_back(e);
+            }
+        }
+    }
+
+    LOG(spam,
+        "After merging info from nodes [%s], bucket %s had info %s",
+        _state.requestNodesToString().c_str(),
+        bucketId.toString().c_str(),
+        e.getBucketInfo().toString().c_str());
+
+    return true;
+}
+
+void
+PendingClusterState::BucketMerger::mergeKeyRange(const BucketDatabase& db, uint32_t rangeBits, uint64_t rangeIndex)
+{
+    // getAll() on the bucket covering the key range gives the buckets in the
+    // range in key order, but also parents of it that belong to earlier ranges.
+    const uint32_t shift = 64 - rangeBits;
+    document::BucketId rangeBucket(document::BucketId::keyToBucketId((rangeIndex << shift) | rangeBits));
+    std::vector<BucketDatabase::Entry> existing;
+    db.getAll(rangeBucket, existing);
+    for (BucketDatabase::Entry& e : existing) {
+        if ((e.getBucketId().toKey() >> shift) == rangeIndex) {
+            process(e);
+        }
+    }
+    finish();
+}
+
+void
+PendingClusterState::BucketMerger::finish()
+{
+    // All of the remaining were not already in the bucket database.
+    while (_iter < _end) {
+        _changedEntries.push_back(_state.createNewEntry(skipAllForSameBucket()));
+    }
+}
+
+void
+PendingClusterState::BucketMerger::commit(BucketDatabase& db) const
+{
+    db.applyChanges(_removedBuckets, _changedEntries);
+}
+
 void
 PendingClusterState::insertInfo(
         BucketDatabase::Entry& info,
-        const Range& range)
+        const Range& range) const
 {
     std::vector<BucketCopy> copiesToAddOrUpdate(
             getCopiesThatAreNewOrAltered(info, range));
@@ -432,7 +581,7 @@ PendingClusterState::insertInfo(
 std::vector<BucketCopy>
 PendingClusterState::getCopiesThatAreNewOrAltered(
         BucketDatabase::Entry& info,
-        const Range& range)
+        const Range& range) const
 {
     std::vector<BucketCopy> copiesToAdd;
     for (uint32_t i = range.first; i < range.second; ++i) {
@@ -447,7 +596,7 @@ PendingClusterState::getCopiesThatAreNewOrAltered(
 }
 
 std::string
-PendingClusterState::requestNodesToString()
+PendingClusterState::requestNodesToString() const
 {
     std::ostringstream ost;
     for (uint32_t i = 0; i < _requestedNodes.size(); ++i) {
@@ -464,7 +613,7 @@ PendingClusterState::requestNodesToString()
 bool
 PendingClusterState::removeCopiesFromNodesThatWereRequested(
         BucketDatabase::Entry& e,
-        const document::BucketId& bucketId)
+        const document::BucketId& bucketId) const
 {
     bool updated = false;
     for (uint32_t i = 0; i < e->getNodeCount();) {
@@ -492,70 +641,8 @@ PendingClusterState::removeCopiesFromNodesThatWereRequested(
     return updated;
 }
 
-bool
-PendingClusterState::databaseIteratorHasPassedBucketInfoIterator(
-        const document::BucketId& bucketId) const
-{
-    return (_iter < _entries.size()
-            && _entries[_iter].bucketId.toKey() < bucketId.toKey());
-}
-
-bool
-PendingClusterState::bucketInfoIteratorPointsToBucket(
-        const document::BucketId& bucketId) const
-{
-    return _iter < _entries.size() && _entries[_iter].bucketId == bucketId;
-}
-
-bool
-PendingClusterState::process(BucketDatabase::Entry& e)
-{
-    document::BucketId bucketId(e.getBucketId());
-
-    LOG(spam,
-        "Before merging info from nodes [%s], bucket %s had info %s",
-        requestNodesToString().c_str(),
-        bucketId.toString().c_str(),
-        e.getBucketInfo().toString().c_str());
-
-    while (databaseIteratorHasPassedBucketInfoIterator(bucketId)) {
-        LOG(spam, "Found new bucket %s, adding",
-            _entries[_iter].bucketId.toString().c_str());
-
-        _missingEntries.push_back(skipAllForSameBucket());
-    }
-
-    bool updated(removeCopiesFromNodesThatWereRequested(e, bucketId));
-
-    if (bucketInfoIteratorPointsToBucket(bucketId)) {
-        LOG(spam, "Updating bucket %s",
-            _entries[_iter].bucketId.toString().c_str());
-
-        insertInfo(e, skipAllForSameBucket());
-        updated = true;
-    }
-
-    if (updated) {
-        // Remove bucket if we've previously removed all nodes from it
-        if (e->getNodeCount() == 0) {
-            _removedBuckets.push_back(bucketId);
-        } else {
-            e.getBucketInfo().updateTrusted();
-        }
-    }
-
-    LOG(spam,
-        "After merging info from nodes [%s], bucket %s had info %s",
-        requestNodesToString().c_str(),
-        bucketId.toString().c_str(),
-        e.getBucketInfo().toString().c_str());
-
-    return true;
-}
-
-void
-PendingClusterState::addToBucketDB(BucketDatabase& db,
-                                   const Range& range)
+BucketDatabase::Entry
+PendingClusterState::createNewEntry(const Range& range) const
 {
     LOG(spam, "Adding new bucket %s with %d copies",
         _entries[range.first].bucketId.toString().c_str(),
@@ -569,29 +656,76 @@ PendingClusterState::addToBucketDB(BucketDatabase& db,
                     .getSeconds().getTime());
     }
     e.getBucketInfo().updateTrusted();
-    db.update(e);
+    return e;
 }
 
-void
-PendingClusterState::mergeInto(BucketDatabase& db)
+std::vector<uint32_t>
+PendingClusterState::partitionEntriesByKeyRange(uint32_t rangeBits)
 {
-    std::sort(_entries.begin(), _entries.end());
-
-    db.forEach(*this);
+    const uint32_t shift = 64 - rangeBits;
+    std::vector<EntryList> ranges(1u << rangeBits);
+    for (const Entry& entry : _entries) {
+        ranges[entry.bucketId.toKey() >> shift].push_back(entry);
+    }
+    std::vector<uint32_t> bounds;
+    bounds.reserve(ranges.size() + 1);
+    _entries.clear();
+    for (const EntryList& range : ranges) {
+        bounds.push_back(_entries.size());
+        _entries.insert(_entries.end(), range.begin(), range.end());
+    }
+    bounds.push_back(_entries.size());
+    return bounds;
+}
 
-    for (uint32_t i = 0; i < _removedBuckets.size(); ++i) {
-        db.remove(_removedBuckets[i]);
+void
+PendingClusterState::mergeKeyRangesInParallel(BucketDatabase& db, vespalib::Executor& executor)
+{
+    const std::vector<uint32_t> bounds(partitionEntriesByKeyRange(MERGE_RANGE_BITS));
+    const size_t numRanges = bounds.size() - 1;
+    std::vector<std::unique_ptr<BucketMerger>> mergers(numRanges);
+    vespalib::CountDownLatch done(numRanges);
+    const BucketDatabase& readOnlyDb(db);
+    // The workers only use this object through const members, and each of
+    // them sorts and reads its own part of _entries. The distributor thread
+    // waits below, so neither the database nor _clusterInfo can change while
+    // they run. Ideal node lookups through _clusterInfo only read the
+    // distribution and cluster state, which have no lazily computed state.
+    // The clock is not used; new entries get _creationTimestamp. Bucket
+    // operation logging is compiled out by default, and takes a global lock
+    // when enabled.
+    for (size_t i = 0; i < numRanges; ++i) {
+        auto task = vespalib::makeLambdaTask([this, &readOnlyDb, &bounds, &mergers, &done, i]() {
+            std::sort(_entries.begin() + bounds[i], _entries.begin() + bounds[i + 1]);
+            mergers[i] = std::make_unique<BucketMerger>(*this, bounds[i], bounds[i + 1], true);
+            mergers[i]->mergeKeyRange(readOnlyDb, MERGE_RANGE_BITS, i);
+            done.countDown();
+        });
+        vespalib::Executor::Task::UP rejected(executor.execute(std::move(task)));
+        if (rejected) {
+            rejected->run();
+        }
     }
-    _removedBuckets.clear();
+    done.await();
 
-    // All of the remaining were not already in the bucket database.
-    while (_iter < _entries.size()) {
-        _missingEntries.push_back(skipAllForSameBucket());
+    for (const auto& merger : mergers) {
+        merger->commit(db);
     }
+}
 
-    for (uint32_t i = 0; i < _missingEntries.size(); ++i) {
-        addToBucketDB(db, _missingEntries[i]);
+void
+PendingClusterState::mergeInto(BucketDatabase& db, vespalib::Executor* executor)
+{
+    if ((executor != nullptr) && (db.size() + _entries.size() >= MIN_ENTRIES_FOR_PARALLEL_MERGE)) {
+        mergeKeyRangesInParallel(db, *executor);
+        return;
     }
+    std::sort(_entries.begin(), _entries.end());
+
+    BucketMerger merger(*this, 0, _entries.size(), false);
+    db.forEach(merger);
+    merger.finish();
+    merger.commit(db);
 }
 
 void
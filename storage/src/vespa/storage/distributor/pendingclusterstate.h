@@ -12,6 +12,8 @@
 #include <unordered_set>
 #include <deque>
 
+namespace vespalib { class Executor; }
+
 namespace storage::distributor {
 
 class DistributorMessageSender;
@@ -20,8 +22,7 @@ class DistributorMessageSender;
  * Class used by BucketDBUpdater to track request bucket info
  * messages sent to the storage nodes.
  */
-class PendingClusterState : public vespalib::XmlSerializable,
-                            public BucketDatabase::MutableEntryProcessor {
+class PendingClusterState : public vespalib::XmlSerializable {
 public:
     struct Entry {
         Entry(const document::BucketId& bid,
@@ -144,9 +145,13 @@ public:
 
     /**
      * Merges all the results with the given bucket database.
+     *
+     * If an executor is given and there is enough to merge, the work is split
+     * by bucket key range and the ranges are merged against the database
+     * concurrently. The database is only read while this happens, and all
+     * changes are written back by the calling thread afterwards.
      */
-    void mergeInto(BucketDatabase& db);
-    bool process(BucketDatabase::Entry& e) override;
+    void mergeInto(BucketDatabase& db, vespalib::Executor* executor = nullptr);
     const EntryList& results() const { return _entries; }
 
     /**
@@ -204,27 +209,26 @@ private:
 
     typedef std::pair<uint32_t, uint32_t> Range;
 
-    /**
-     * Skips through all entries for the same bucket and returns
-     * the range in the entry list for which they were found.
-     * The range is [from, to>
-     */
-    Range skipAllForSameBucket();
+    class BucketMerger;
 
-    void insertInfo(BucketDatabase::Entry& info, const Range& range);
-    void addToBucketDB(BucketDatabase& db, const Range& range);
+    void insertInfo(BucketDatabase::Entry& info, const Range& range) const;
+    BucketDatabase::Entry createNewEntry(const Range& range) const;
 
-    std::vector<BucketCopy> getCopiesThatAreNewOrAltered(BucketDatabase::Entry& info, const Range& range);
+    std::vector<BucketCopy> getCopiesThatAreNewOrAltered(BucketDatabase::Entry& info, const Range& range) const;
 
-    std::string requestNodesToString();
+    std::string requestNodesToString() const;
 
     // Returns whether at least one replica was removed from the entry.
     // Does NOT implicitly update trusted status on remaining replicas; caller must do
     // this explicitly.
-    bool removeCopiesFromNodesThatWereRequested(BucketDatabase::Entry& e, const document::BucketId& bucketId);
+    bool removeCopiesFromNodesThatWereRequested(BucketDatabase::Entry& e, const document::BucketId& bucketId) const;
 
-    bool databaseIteratorHasPassedBucketInfoIterator(const document::BucketId& bucketId) const;
-    bool bucketInfoIteratorPointsToBucket(const document::BucketId& bucketId) const;
+    /**
+     * Reorders the entries so that the entries for each bucket key range are
+     * contiguous, and returns where each range starts (plus the end).
+     */
+    std::vector<uint32_t> partitionEntriesByKeyRange(uint32_t rangeBits);
+    void mergeKeyRangesInParallel(BucketDatabase& db, vespalib::Executor& executor);
 
     bool nodeIsOutdated(uint16_t node) const {
         return (_outdatedNodes.find(node) != _outdatedNodes.end());
@@ -236,7 +240,6 @@ private:
 
     std::map<uint64_t, uint16_t> _sentMessages;
     std::vector<bool> _requestedNodes;
-    std::vector<document::BucketId> _removedBuckets;
     std::deque<std::pair<framework::MilliSecTime, uint16_t> > _delayedRequests;
 
     // Set for all nodes that may have changed state since that previous
@@ -247,9 +250,6 @@ private:
     std::unordered_set<uint16_t> _outdatedNodes;
 
     EntryList _entries;
-    uint32_t _iter;
-
-    std::vector<Range> _missingEntries;
 
     lib::ClusterState _prevClusterState;
     lib::ClusterState _newClusterState;
@@ -34,6 +34,7 @@ PersistenceThread::PersistenceThread(ServiceLayerComponentRegister& compReg,
            lowestPriority,
            provider),
       _warnOnSlowOperations(5000),
+      _maxFeedBatchSize(std::max(1, _env._config.maxFeedOpBatchSize)),
       _spi(provider),
       _processAllHandler(_env, provider),
       _mergeHandler(_spi, _env),
@@ -153,15 +154,23 @@ PersistenceThread::handleRemove(api::RemoveCommand& cmd)
         _spi.removeIfFound(getBucket(cmd.getDocumentId(), cmd.getBucketId()),
                     spi::Timestamp(cmd.getTimestamp()),
                     cmd.getDocumentId(), _context);
-    if (checkForError(response, *tracker)) {
+    completeRemove(cmd, response, *tracker);
+    return tracker;
+}
+
+void
+PersistenceThread::completeRemove(api::RemoveCommand& cmd,
+                                  const spi::RemoveResult& response,
+                                  MessageTracker& tracker)
+{
+    if (checkForError(response, tracker)) {
         api::RemoveReply* reply(new api::RemoveReply(
                 cmd, response.wasFound() ? cmd.getTimestamp() : 0));
-        tracker->setReply(api::StorageReply::SP(reply));
+        tracker.setReply(api::StorageReply::SP(reply));
     }
     if (!response.wasFound()) {
         ++_env._metrics.remove[cmd.getLoadType()].notFound;
     }
-    return tracker;
 }
 
 MessageTracker::UP
@@ -179,12 +188,20 @@ PersistenceThread::handleUpdate(api::UpdateCommand& cmd)
         _spi.update(getBucket(cmd.getUpdate()->getId(), cmd.getBucketId()),
                     spi::Timestamp(cmd.getTimestamp()),
                     cmd.getUpdate(), _context);
-    if (checkForError(response, *tracker)) {
+    completeUpdate(cmd, response, *tracker);
+    return tracker;
+}
+
+void
+PersistenceThread::completeUpdate(api::UpdateCommand& cmd,
+                                  const spi::UpdateResult& response,
+                                  MessageTracker& tracker)
+{
+    if (checkForError(response, tracker)) {
         api::UpdateReply* reply = new api::UpdateReply(cmd);
         reply->setOldTimestamp(response.getExistingTimestamp());
-        tracker->setReply(api::StorageReply::SP(reply));
+        tracker.setReply(api::StorageReply::SP(reply));
     }
-    return tracker;
 }
 
 MessageTracker::UP
@@ -1117,6 +1134,202 @@ bool hasBucketInfo(const api::StorageMessage& msg)
              msg.getType().getId() == api::MessageType::JOINBUCKETS_ID));
 }
 
+/**
+ * Puts, removes and updates can be given to the provider in one batch,
+ * unless they have a test-and-set condition, which must be evaluated
+ * against the result of the operations before it.
+ */
+bool isFeedBatchable(const api::StorageMessage& msg)
+{
+    switch (msg.getType().getId()) {
+    case api::MessageType::PUT_ID:
+    case api::MessageType::REMOVE_ID:
+    case api::MessageType::UPDATE_ID:
+        return !static_cast<const api::TestAndSetCommand&>(msg)
+                .getCondition().isPresent();
+    default:
+        return false;
+    }
+}
+
+}
+
+FileStorThreadMetrics::Op&
+PersistenceThread::getFeedMetric(const api::StorageCommand& cmd)
+{
+    switch (cmd.getType().getId()) {
+    case api::MessageType::PUT_ID:
+        return _env._metrics.put[cmd.getLoadType()];
+    case api::MessageType::REMOVE_ID:
+        return _env._metrics.remove[cmd.getLoadType()];
+    default:
+        return _env._metrics.update[cmd.getLoadType()];
+    }
+}
+
+spi::BatchOperation
+PersistenceThread::toBatchOperation(const api::StorageCommand& cmd) const
+{
+    switch (cmd.getType().getId()) {
+    case api::MessageType::PUT_ID:
+    {
+        const api::PutCommand& put(static_cast<const api::PutCommand&>(cmd));
+        getBucket(put.getDocumentId(), put.getBucketId());
+        return spi::BatchOperation::put(spi::Timestamp(put.getTimestamp()),
+                                        put.getDocument());
+    }
+    case api::MessageType::REMOVE_ID:
+    {
+        const api::RemoveCommand& remove(
+                static_cast<const api::RemoveCommand&>(cmd));
+        getBucket(remove.getDocumentId(), remove.getBucketId());
+        return spi::BatchOperation::remove(
+                spi::Timestamp(remove.getTimestamp()), remove.getDocumentId());
+    }
+    default:
+    {
+        const api::UpdateCommand& update(
+                static_cast<const api::UpdateCommand&>(cmd));
+        getBucket(update.getUpdate()->getId(), update.getBucketId());
+        return spi::BatchOperation::update(
+                spi::Timestamp(update.getTimestamp()), update.getUpdate());
+    }
+    }
+}
+
+void
+PersistenceThread::completeFeedOperation(api::StorageCommand& cmd,
+                                         const spi::Result& response,
+                                         MessageTracker& tracker)
+{
+    switch (cmd.getType().getId()) {
+    case api::MessageType::PUT_ID:
+        checkForError(response, tracker);
+        break;
+    case api::MessageType::REMOVE_ID:
+        completeRemove(static_cast<api::RemoveCommand&>(cmd),
+                       static_cast<const spi::RemoveResult&>(response),
+                       tracker);
+        break;
+    default:
+        completeUpdate(static_cast<api::UpdateCommand&>(cmd),
+                       static_cast<const spi::UpdateResult&>(response),
+                       tracker);
+        break;
+    }
+}
+
+void
+PersistenceThread::applyFeedBatch(
+        const document::BucketId& bucketId,
+        std::vector<std::shared_ptr<api::StorageMessage> >& batch,
+        std::vector<MessageTracker::UP>& replies)
+{
+    if (batch.empty()) {
+        return;
+    }
+    int64_t startTime(_component->getClock().getTimeInMillis().getTime());
+    LOG(debug, "Applying batch of %zu feed operations to bucket %s",
+        batch.size(), bucketId.toString().c_str());
+
+    api::StorageCommand& first(static_cast<api::StorageCommand&>(*batch[0]));
+    uint32_t traceLevel = 0;
+    for (const auto& msg : batch) {
+        traceLevel = std::max(traceLevel, msg->getTrace().getLevel());
+    }
+    _context = spi::Context(first.getLoadType(), first.getPriority(),
+                            traceLevel);
+
+    // Operations that do not belong in the bucket fail on their own,
+    // the others are given to the provider.
+    std::vector<MessageTracker::UP> trackers;
+    std::vector<size_t> opIndexes;
+    std::vector<spi::BatchOperation> ops;
+    trackers.reserve(batch.size());
+    opIndexes.reserve(batch.size());
+    ops.reserve(batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        ++_env._metrics.operations;
+        api::StorageCommand& cmd(static_cast<api::StorageCommand&>(*batch[i]));
+        trackers.push_back(std::make_unique<MessageTracker>(
+                getFeedMetric(cmd), _env._component.getClock()));
+        try {
+            ops.push_back(toBatchOperation(cmd));
+            opIndexes.push_back(i);
+        } catch (std::exception& e) {
+            trackers.back()->fail(api::ReturnCode::INTERNAL_FAILURE, e.what());
+        }
+    }
+
+    if (!ops.empty()) {
+        try {
+            spi::BatchResult result(_spi.applyBatch(
+                    spi::Bucket(bucketId, spi::PartitionId(_env._partition)),
+                    ops, _context));
+            if (result.hasError() || result.getResults().size() != ops.size()) {
+                for (size_t index : opIndexes) {
+                    if (result.hasError()) {
+                        checkForError(result, *trackers[index]);
+                    } else {
+                        trackers[index]->fail(api::ReturnCode::INTERNAL_FAILURE,
+                                              "Provider returned wrong number "
+                                              "of batch results");
+                    }
+                }
+            } else {
+                for (size_t j = 0; j < opIndexes.size(); ++j) {
+                    size_t index = opIndexes[j];
+                    completeFeedOperation(
+                            static_cast<api::StorageCommand&>(*batch[index]),
+                            *result.getResults()[j], *trackers[index]);
+                }
+            }
+        } catch (std::exception& e) {
+            for (size_t index : opIndexes) {
+                trackers[index]->fail(api::ReturnCode::INTERNAL_FAILURE,
+                                      e.what());
+            }
+        }
+    }
+
+    bool bucketInfoChanged = false;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        api::StorageCommand& cmd(static_cast<api::StorageCommand&>(*batch[i]));
+        trackers[i]->generateReply(cmd);
+        api::StorageReply& reply(*trackers[i]->getReply());
+        reply.getTrace().getRoot().addChild(_context.getTrace().getRoot());
+        if (reply.getResult().success()) {
+            bucketInfoChanged = true;
+        } else {
+            ++_env._metrics.failedOperations;
+        }
+    }
+
+    // All replies in the batch get the bucket info as of after the batch.
+    if (bucketInfoChanged) {
+        api::BucketInfo info(_env.getBucketInfo(bucketId));
+        _env.updateBucketDatabase(bucketId, info);
+        for (auto& tracker : trackers) {
+            if (tracker->getReply()->getResult().success()) {
+                static_cast<api::BucketInfoReply&>(*tracker->getReply())
+                    .setBucketInfo(info);
+            }
+        }
+    }
+
+    int64_t stopTime(_component->getClock().getTimeInMillis().getTime());
+    if (stopTime - startTime >= _warnOnSlowOperations) {
+        LOGBT(warning, first.getType().toString(),
+              "Slow processing of batch of %zu feed operations to bucket %s "
+              "on disk %u. Processing time: %" PRId64 " ms (>=%d ms)",
+              batch.size(), bucketId.toString().c_str(), _env._partition,
+              stopTime - startTime, _warnOnSlowOperations);
+    }
+
+    for (auto& tracker : trackers) {
+        replies.push_back(std::move(tracker));
+    }
+    batch.clear();
 }
 
 void
@@ -1187,12 +1400,27 @@ PersistenceThread::flushAllReplies(
 void PersistenceThread::processMessages(FileStorHandler::LockedMessage & lock)
 {
     std::vector<MessageTracker::UP> trackers;
+    std::vector<std::shared_ptr<api::StorageMessage> > feedBatch;
     document::BucketId bucketId = lock.first->getBucketId();
 
     while (lock.second.get() != 0) {
         LOG(debug, "Inside while loop %d, nodeIndex %d, ptr=%p",
             _env._partition, _env._nodeIndex, lock.second.get());
         std::shared_ptr<api::StorageMessage> msg(lock.second);
+
+        // Collect feed operations until something else shows up, and give
+        // them to the provider together.
+        if (isFeedBatchable(*msg)) {
+            feedBatch.push_back(msg);
+            if (feedBatch.size() >= _maxFeedBatchSize) {
+                break;
+            }
+            _env._fileStorHandler.getNextMessage(
+                    _env._partition, lock, _env._lowestPriority);
+            continue;
+        }
+        applyFeedBatch(bucketId, feedBatch, trackers);
+
         bool batchable = isBatchable(*msg);
 
         // If the next operation wasn't batchable, we should flush
@@ -1238,6 +1466,7 @@ void PersistenceThread::processMessages(FileStorHandler::LockedMessage & lock)
         }
     }
 
+    applyFeedBatch(bucketId, feedBatch, trackers);
     flushAllReplies(bucketId, trackers);
 }
 
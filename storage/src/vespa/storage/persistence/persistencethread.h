@@ -56,9 +56,16 @@ public:
     MessageTracker::UP handleRepairBucket(RepairBucketCommand& cmd);
     MessageTracker::UP handleRecheckBucketInfo(RecheckBucketInfoCommand& cmd);
 
+    /**
+     * Handles the locked message and the queued messages for its bucket
+     * that follow it, batching feed operations where possible.
+     */
+    void processMessages(FileStorHandler::LockedMessage & lock);
+
 private:
     PersistenceUtil _env;
     uint32_t _warnOnSlowOperations;
+    size_t _maxFeedBatchSize;
 
     spi::PersistenceProvider& _spi;
     ProcessAllHandler _processAllHandler;
@@ -95,7 +102,6 @@ private:
     void handleReply(api::StorageReply&);
 
     MessageTracker::UP processMessage(api::StorageMessage& msg);
-    void processMessages(FileStorHandler::LockedMessage & lock);
 
     // Thread main loop
     void run(framework::ThreadHandle&) override;
@@ -105,6 +111,26 @@ private:
     void flushAllReplies(const document::BucketId& bucketId,
                          std::vector<MessageTracker::UP>& trackers);
 
+    /**
+     * Gives the queued puts, removes and updates for the bucket to the
+     * provider in one call, and adds their replies to the given trackers.
+     * Clears the batch.
+     */
+    void applyFeedBatch(const document::BucketId& bucketId,
+                        std::vector<std::shared_ptr<api::StorageMessage> >& batch,
+                        std::vector<MessageTracker::UP>& trackers);
+    FileStorThreadMetrics::Op& getFeedMetric(const api::StorageCommand& cmd);
+    spi::BatchOperation toBatchOperation(const api::StorageCommand& cmd) const;
+    void completeFeedOperation(api::StorageCommand& cmd,
+                               const spi::Result& response,
+                               MessageTracker& tracker);
+    void completeRemove(api::RemoveCommand& cmd,
+                        const spi::RemoveResult& response,
+                        MessageTracker& tracker);
+    void completeUpdate(api::UpdateCommand& cmd,
+                        const spi::UpdateResult& response,
+                        MessageTracker& tracker);
+
     friend class TestAndSetHelper;
     bool tasConditionExists(const api::TestAndSetCommand & cmd);
     bool tasConditionMatches(const api::TestAndSetCommand & cmd, MessageTracker & tracker);
@@ -109,6 +109,18 @@ ProviderErrorWrapper::update(const spi::Bucket& bucket,
     return checkResult(_impl.update(bucket, ts, docUpdate, context));
 }
 
+spi::BatchResult
+ProviderErrorWrapper::applyBatch(const spi::Bucket& bucket,
+                                 const std::vector<spi::BatchOperation>& ops,
+                                 spi::Context& context)
+{
+    spi::BatchResult result(_impl.applyBatch(bucket, ops, context));
+    for (const auto& opResult : result.getResults()) {
+        checkResult(spi::Result(*opResult));
+    }
+    return checkResult(std::move(result));
+}
+
 spi::GetResult
 ProviderErrorWrapper::get(const spi::Bucket& bucket,
                              const document::FieldSet& fieldSet,
@@ -2,6 +2,7 @@
 
 #include "avx512.h"
 #include "avxprivate.hpp"
+#include "rangematch.hpp"
 
 namespace vespalib {
 
@@ -19,5 +20,55 @@ Avx512Accelrator::dotProduct(const double * af, const double * bf, size_t sz) co
     return avx::dotProductSelectAlignment<double, 64>(af, bf, sz);
 }
 
+size_t
+Avx512Accelrator::andNextWord(const uint64_t * const * bitVectors, size_t numVectors,
+                               size_t index, size_t end, uint64_t & word) const
+{
+    return avx::nextWord<uint64_t, 64>([](const auto & a, const auto & b) { return a & b; }, bitVectors, numVectors, index, end, word);
+}
+
+size_t
+Avx512Accelrator::orNextWord(const uint64_t * const * bitVectors, size_t numVectors,
+                              size_t index, size_t end, uint64_t & word) const
+{
+    return avx::nextWord<uint64_t, 64>([](const auto & a, const auto & b) { return a | b; }, bitVectors, numVectors, index, end, word);
+}
+
+void
+Avx512Accelrator::rangeMatchWords(const int8_t * values, int8_t low, int8_t high, size_t numWords, uint64_t * words) const
+{
+    helper::rangeMatchWords(values, low, high, numWords, words);
+}
+
+void
+Avx512Accelrator::rangeMatchWords(const int16_t * values, int16_t low, int16_t high, size_t numWords, uint64_t * words) const
+{
+    helper::rangeMatchWords(values, low, high, numWords, words);
+}
+
+void
+Avx512Accelrator::rangeMatchWords(const int32_t * values, int32_t low, int32_t high, size_t numWords, uint64_t * words) const
+{
+    helper::rangeMatchWords(values, low, high, numWords, words);
+}
+
+void
+Avx512Accelrator::rangeMatchWords(const int64_t * values, int64_t low, int64_t high, size_t numWords, uint64_t * words) const
+{
+    helper::rangeMatchWords(values, low, high, numWords, words);
+}
+
+void
+Avx512Accelrator::rangeMatchWords(const float * values, float low, float high, size_t numWords, uint64_t * words) const
+{
+    helper::rangeMatchWords(values, low, high, numWords, words);
+}
+
+void
+Avx512Accelrator::rangeMatchWords(const double * values, double low, double high, size_t numWords, uint64_t * words) const
+{
+    helper::rangeMatchWords(values, low, high, numWords, words);
+}
+
 }
 }
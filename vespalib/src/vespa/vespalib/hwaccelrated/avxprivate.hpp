@@ -76,4 +76,52 @@ T dotProductSelectAlignment(const T * af, const T * bf, size_t sz)
     }
 }
 
+/**
+ * Combines VLEN bytes of words from all the bit vectors per step,
+ * and only looks at the single words when some of them are non zero.
+ */
+template <typename T, size_t VLEN, typename Operation>
+VESPA_DLL_LOCAL size_t nextWord(Operation operation, const T * const * bitVectors, size_t numVectors,
+                                size_t index, size_t end, T & word);
+
+template <typename T, size_t VLEN, typename Operation>
+size_t nextWord(Operation operation, const T * const * bitVectors, size_t numVectors,
+                size_t index, size_t end, T & word)
+{
+    constexpr const size_t WordsPerVector = VLEN/sizeof(T);
+    typedef T V __attribute__ ((vector_size (VLEN)));
+    typedef T U __attribute__ ((vector_size (VLEN), aligned(sizeof(T))));
+    for (; index + WordsPerVector <= end; index += WordsPerVector) {
+        V combined = *reinterpret_cast<const U *>(bitVectors[0] + index);
+        for (size_t i(1); i < numVectors; i++) {
+            const V other = *reinterpret_cast<const U *>(bitVectors[i] + index);
+            combined = operation(combined, other);
+        }
+        T any(0);
+        for (size_t j(0); j < WordsPerVector; j++) {
+            any |= combined[j];
+        }
+        if (any != 0) {
+            for (size_t j(0); j < WordsPerVector; j++) {
+                if (combined[j] != 0) {
+                    word = combined[j];
+                    return index + j;
+                }
+            }
+        }
+    }
+    for (; index < end; index++) {
+        T combined(bitVectors[0][index]);
+        for (size_t i(1); i < numVectors; i++) {
+            combined = operation(combined, bitVectors[i][index]);
+        }
+        if (combined != 0) {
+            word = combined;
+            return index;
+        }
+    }
+    word = 0;
+    return end;
+}
+
 }
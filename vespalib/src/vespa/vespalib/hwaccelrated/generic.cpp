@@ -1,6 +1,7 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "generic.h"
+#include "rangematch.hpp"
 
 namespace vespalib {
 
@@ -58,6 +59,25 @@ bitOperation(Operation operation, void * aOrg, const void * bOrg, size_t bytes)
     }
 }
 
+template<typename Operation>
+size_t
+nextWord(Operation operation, const uint64_t * const * bitVectors, size_t numVectors,
+         size_t index, size_t end, uint64_t & word)
+{
+    for (; index < end; index++) {
+        uint64_t combined(bitVectors[0][index]);
+        for (size_t i(1); i < numVectors; i++) {
+            combined = operation(combined, bitVectors[i][index]);
+        }
+        if (combined != 0) {
+            word = combined;
+            return index;
+        }
+    }
+    word = 0;
+    return end;
+}
+
 }
 
 float
@@ -115,5 +135,55 @@ GenericAccelrator::notBit(void * aOrg, size_t bytes) const
     }
 }
 
+size_t
+GenericAccelrator::andNextWord(const uint64_t * const * bitVectors, size_t numVectors,
+                               size_t index, size_t end, uint64_t & word) const
+{
+    return nextWord([](uint64_t a, uint64_t b) { return a & b; }, bitVectors, numVectors, index, end, word);
+}
+
+size_t
+GenericAccelrator::orNextWord(const uint64_t * const * bitVectors, size_t numVectors,
+                              size_t index, size_t end, uint64_t & word) const
+{
+    return nextWord([](uint64_t a, uint64_t b) { return a | b; }, bitVectors, numVectors, index, end, word);
+}
+
+void
+GenericAccelrator::rangeMatchWords(const int8_t * values, int8_t low, int8_t high, size_t numWords, uint64_t * words) const
+{
+    helper::rangeMatchWords(values, low, high, numWords, words);
+}
+
+void
+GenericAccelrator::rangeMatchWords(const int16_t * values, int16_t low, int16_t high, size_t numWords, uint64_t * words) const
+{
+    helper::rangeMatchWords(values, low, high, numWords, words);
+}
+
+void
+GenericAccelrator::rangeMatchWords(const int32_t * values, int32_t low, int32_t high, size_t numWords, uint64_t * words) const
+{
+    helper::rangeMatchWords(values, low, high, numWords, words);
+}
+
+void
+GenericAccelrator::rangeMatchWords(const int64_t * values, int64_t low, int64_t high, size_t numWords, uint64_t * words) const
+{
+    helper::rangeMatchWords(values, low, high, numWords, words);
+}
+
+void
+GenericAccelrator::rangeMatchWords(const float * values, float low, float high, size_t numWords, uint64_t * words) const
+{
+    helper::rangeMatchWords(values, low, high, numWords, words);
+}
+
+void
+GenericAccelrator::rangeMatchWords(const double * values, double low, double high, size_t numWords, uint64_t * words) const
+{
+    helper::rangeMatchWords(values, low, high, numWords, words);
+}
+
 }
 }
@@ -22,6 +22,16 @@ public:
     void andBit(void * a, const void * b, size_t bytes) const override;
     void andNotBit(void * a, const void * b, size_t bytes) const override;
     void notBit(void * a, size_t bytes) const override;
+    size_t andNextWord(const uint64_t * const * bitVectors, size_t numVectors,
+                       size_t index, size_t end, uint64_t & word) const override;
+    size_t orNextWord(const uint64_t * const * bitVectors, size_t numVectors,
+                      size_t index, size_t end, uint64_t & word) const override;
+    void rangeMatchWords(const int8_t * values, int8_t low, int8_t high, size_t numWords, uint64_t * words) const override;
+    void rangeMatchWords(const int16_t * values, int16_t low, int16_t high, size_t numWords, uint64_t * words) const override;
+    void rangeMatchWords(const int32_t * values, int32_t low, int32_t high, size_t numWords, uint64_t * words) const override;
+    void rangeMatchWords(const int64_t * values, int64_t low, int64_t high, size_t numWords, uint64_t * words) const override;
+    void rangeMatchWords(const float * values, float low, float high, size_t numWords, uint64_t * words) const override;
+    void rangeMatchWords(const double * values, double low, double high, size_t numWords, uint64_t * words) const override;
 };
 
 }
@@ -4,6 +4,7 @@
 
 #include <memory>
 #include <stdint.h>
+#include <cstddef>
 
 namespace vespalib {
 
@@ -26,6 +27,27 @@ public:
     virtual void andBit(void * a, const void * b, size_t bytes) const = 0;
     virtual void andNotBit(void * a, const void * b, size_t bytes) const = 0;
     virtual void notBit(void * a, size_t bytes) const = 0;
+    /**
+     * Finds the first word in [index, end) where the and of all the given bit vectors is non zero.
+     * The combined word is returned in word, and its index is returned. end is returned if there is none.
+     */
+    virtual size_t andNextWord(const uint64_t * const * bitVectors, size_t numVectors,
+                               size_t index, size_t end, uint64_t & word) const = 0;
+    /**
+     * As andNextWord, but for the or of all the given bit vectors.
+     */
+    virtual size_t orNextWord(const uint64_t * const * bitVectors, size_t numVectors,
+                              size_t index, size_t end, uint64_t & word) const = 0;
+    /**
+     * Sets bit i in words[i/64] when low <= values[i] <= high, and clears it otherwise,
+     * for all i in [0, 64*numWords). Values that do not compare, like NaN, never match.
+     */
+    virtual void rangeMatchWords(const int8_t * values, int8_t low, int8_t high, size_t numWords, uint64_t * words) const = 0;
+    virtual void rangeMatchWords(const int16_t * values, int16_t low, int16_t high, size_t numWords, uint64_t * words) const = 0;
+    virtual void rangeMatchWords(const int32_t * values, int32_t low, int32_t high, size_t numWords, uint64_t * words) const = 0;
+    virtual void rangeMatchWords(const int64_t * values, int64_t low, int64_t high, size_t numWords, uint64_t * words) const = 0;
+    virtual void rangeMatchWords(const float * values, float low, float high, size_t numWords, uint64_t * words) const = 0;
+    virtual void rangeMatchWords(const double * values, double low, double high, size_t numWords, uint64_t * words) const = 0;
 
     static IAccelrated::UP getAccelrator() __attribute__((noinline));
 };
@@ -0,0 +1,34 @@
+// Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vespalib::hwaccelrated::helper {
+
+namespace {
+
+/**
+ * Branch free range match of 64 values per word. The inner loop is
+ * left to the compiler to vectorize, so each accelerator gets the
+ * vector width of the instruction set its source file is compiled for.
+ * This has internal linkage so the differently compiled copies are
+ * never merged by the linker.
+ */
+template <typename T>
+void rangeMatchWords(const T * values, T low, T high, size_t numWords, uint64_t * words)
+{
+    for (size_t w(0); w < numWords; w++) {
+        const T * v = values + w*64;
+        uint64_t word(0);
+        for (size_t i(0); i < 64; i++) {
+            word |= uint64_t((low <= v[i]) & (v[i] <= high)) << i;
+        }
+        words[w] = word;
+    }
+}
+
+}
+
+}